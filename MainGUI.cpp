@@ -4,6 +4,7 @@
 // This file launches the graphical user interface and handles application lifecycle
 
 #include "include/GameGUI.hpp"
+#include "include/Logger.hpp"
 #include <iostream>
 
 int main() {
@@ -15,7 +16,7 @@ int main() {
         
         // Attempt to load fonts and initialize the graphics subsystem
         if (!gui.initialize()) {
-            std::cout << "Error! Something is wrong." << std::endl;
+            COUP_LOG_ERROR("GUI initialization failed");
             return 1; // Exit with error code if initialization fails
         }
         
@@ -25,7 +26,7 @@ int main() {
     }
     
     catch (const std::exception& e) {
-        std::cout << "Error! Something is wrong." << std::endl;
+        COUP_LOG_ERROR("Unhandled exception: {}", e.what());
         return 1; // Exit with error code if an exception occurs
     }
     
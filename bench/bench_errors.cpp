@@ -0,0 +1,82 @@
+// Email: razcohenp@gmail.com
+
+// bench_errors.cpp - Cost of rejected actions on the throwing and no-throw paths
+// Fires the same stream of mostly illegal probes at applyAction (exceptions)
+// and tryApplyAction (ActionError results) and reports nanoseconds per probe
+
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double nanosecondsPerProbe(Clock::time_point start, size_t probes) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / probes;
+    }
+}
+
+int main() {
+    const size_t probes = 1000000;
+
+    Game game;
+    std::vector<std::unique_ptr<Player>> roster;
+    const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+    for (int i = 0; i < 6; i++) {
+        roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(i + 1), roles[i]));
+    }
+    game.startGame();
+
+    GameSnapshot initial;
+    game.saveSnapshot(initial);
+
+    // Same probe stream for both paths; successful probes change the state, so restore it
+    std::mt19937 rng(7);
+    std::vector<Action> stream(probes);
+    for (Action& probe : stream) {
+        probe = {static_cast<ActionType>(rng() % ACTION_TYPE_COUNT),
+                 static_cast<uint8_t>(rng() % 6), static_cast<uint8_t>(rng() % 6)};
+    }
+
+    size_t thrown = 0;
+    auto start = Clock::now();
+    for (const Action& probe : stream) {
+        try {
+            applyAction(game, probe);
+            game.loadSnapshot(initial);
+        }
+        catch (const std::exception&) {
+            thrown++;
+        }
+    }
+    double throw_ns = nanosecondsPerProbe(start, probes);
+
+    game.loadSnapshot(initial);
+    size_t rejected = 0;
+    start = Clock::now();
+    for (const Action& probe : stream) {
+        if (tryApplyAction(game, probe)) {
+            game.loadSnapshot(initial);
+        }
+        else {
+            rejected++;
+        }
+    }
+    double expected_ns = nanosecondsPerProbe(start, probes);
+
+    std::cout << "Rejected action benchmark (" << probes << " probes, " << rejected << " rejected)\n";
+    std::cout << "  throwing applyAction:   " << throw_ns << " ns/probe (" << thrown << " exceptions)\n";
+    std::cout << "  no-throw tryApplyAction: " << expected_ns << " ns/probe\n";
+    std::cout << "  speedup:                 " << throw_ns / expected_ns << "x\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Email: razcohenp@gmail.com
+
+// bench_evaluate.cpp - Cost of scoring every legal action of the current player
+// Compares one fresh copy of the table per action (how hints were computed)
+// with Game::evaluateAllActions on the per-thread scratch clone
+
+#include "../include/Game.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/ActionEvaluator.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double nanosecondsPerQuery(Clock::time_point start, size_t queries) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / queries;
+    }
+}
+
+int main() {
+    const size_t positions = 2000;
+    const size_t repeats = 20;
+
+    Game game;
+    std::vector<std::unique_ptr<Player>> roster;
+    const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+    for (int i = 0; i < 6; i++) {
+        roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(i + 1), roles[i]));
+    }
+    game.startGame();
+
+    // Positions from one random game, restarted whenever it ends
+    GameSnapshot initial;
+    game.saveSnapshot(initial, false);
+    std::vector<GameSnapshot> states(positions);
+    std::mt19937 rng(11);
+    std::vector<Action> scratch;
+    Action chosen;
+    for (GameSnapshot& state : states) {
+        if (isGameOver(game)) {
+            game.loadSnapshot(initial);
+        }
+        playRandomAction(game, rng, scratch, chosen);
+        game.saveSnapshot(state, false);
+    }
+
+    const MaterialEvaluator evaluator;
+    std::vector<Action> actions;
+    std::vector<ActionScore> scores;
+    double checksum = 0.0;
+    size_t evaluated = 0;
+
+    auto start = Clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        for (const GameSnapshot& state : states) {
+            game.loadSnapshot(state);
+            const uint8_t seat = static_cast<uint8_t>(game.getCurrentPlayerIndex());
+            legalActions(game, seat, actions);
+            for (const Action& action : actions) {
+                GameClone copy(game); // A full copy of the table per action
+                applyAction(copy.game(), action);
+                checksum += evaluator.evaluate(copy.game(), action, seat);
+            }
+            evaluated += actions.size();
+        }
+    }
+    const double copy_ns = nanosecondsPerQuery(start, repeats * positions);
+
+    start = Clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        for (const GameSnapshot& state : states) {
+            game.loadSnapshot(state);
+            game.evaluateAllActions(evaluator, scores);
+            for (const ActionScore& score : scores) {
+                checksum -= score.score;
+            }
+        }
+    }
+    const double scratch_ns = nanosecondsPerQuery(start, repeats * positions);
+
+    std::cout << "What-if evaluation benchmark (" << repeats * positions << " queries, "
+              << static_cast<double>(evaluated) / (repeats * positions) << " actions per query, checksum " << checksum << ")\n";
+    std::cout << "  copy per action:       " << copy_ns << " ns/query\n";
+    std::cout << "  evaluateAllActions:    " << scratch_ns << " ns/query\n";
+    std::cout << "  speedup:               " << copy_ns / scratch_ns << "x\n";
+    return 0;
+}
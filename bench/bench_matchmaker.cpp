@@ -0,0 +1,104 @@
+// Email: razcohenp@gmail.com
+
+// bench_matchmaker.cpp - Cost of queue operations with a large matchmaking backlog
+// Usage: ./bench_matchmaker [queued] [operations]
+// Fills the queue with entries of random table sizes and ratings spread so thinly that most
+// wait, then keeps it at that size with arrivals and cancels while simulated time advances
+// 1 ms per operation and polls widen the tolerances. Reports the mean, p99 and worst cost of
+// every operation type (latencies go through the wait-time histogram, in ns) and the wait times
+
+#include "../include/server/Matchmaker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    void measure(WaitHistogram& cost, Clock::time_point start) {
+        cost.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+    }
+
+    void report(const char* name, const WaitHistogram& cost) {
+        std::cout << "  " << name << ": " << cost.mean() << " ns mean, p99 <= " << cost.percentile(0.99) << " ns, worst "
+                  << cost.longest() / 1000.0 << " us (" << cost.count() << " calls)\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t queued = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t operations = argc > 2 ? std::stoul(argv[2]) : 1000000;
+
+    MatchmakerConfig config;
+    config.base_tolerance = 5;
+    config.widen_per_second = 10;
+    config.max_tolerance = 300;
+    Matchmaker queue(config);
+    std::mt19937_64 random(3);
+    std::uniform_real_distribution<double> ratings(0, 100.0 * queued); // About 500 apart within a table size
+    std::vector<MatchGroup> formed;
+    std::vector<uint64_t> ids; // Ids that may still be queued, for cancels
+    uint64_t next_id = 1;
+    uint64_t now = 0;
+    uint64_t tables = 0;
+
+    WaitHistogram enqueues;
+    WaitHistogram cancels;
+    WaitHistogram polls;
+    const auto fill_start = Clock::now();
+    for (size_t i = 0; i < queued; i++) {
+        now = i / 100; // A hundred arrivals per ms, so widening steps are spread like in service
+        const auto start = Clock::now();
+        queue.enqueue(next_id, ratings(random), static_cast<uint8_t>(2 + random() % 5), now, formed);
+        measure(enqueues, start);
+        ids.push_back(next_id++);
+    }
+    const double fill_seconds = std::chrono::duration<double>(Clock::now() - fill_start).count();
+    std::cout << "Matchmaker benchmark (" << queued << " entries queued in " << fill_seconds * 1000 << " ms, "
+              << queue.size() << " waiting, " << operations << " operations)\n";
+
+    for (size_t op = 0; op < operations; op++) {
+        now++;
+        formed.clear();
+        auto start = Clock::now();
+        if (queue.size() >= queued && !ids.empty()) { // Someone gives up, keeping the backlog at its size
+            const size_t pick = random() % ids.size();
+            queue.cancel(ids[pick]);
+            measure(cancels, start);
+            ids[pick] = ids.back();
+            ids.pop_back();
+        }
+        else {
+            queue.enqueue(next_id, ratings(random), static_cast<uint8_t>(2 + random() % 5), now, formed);
+            measure(enqueues, start);
+            ids.push_back(next_id++);
+        }
+        start = Clock::now();
+        queue.poll(now, formed);
+        measure(polls, start);
+        tables += formed.size();
+        if (ids.size() > 4 * queued) { // Forget ids that were seated long ago
+            ids.erase(std::remove_if(ids.begin(), ids.end(), [&](uint64_t id) { return !queue.isQueued(id); }), ids.end());
+        }
+    }
+
+    report("enqueue", enqueues);
+    report("cancel", cancels);
+    report("poll", polls);
+    const WaitHistogram& waits = queue.waitTimes();
+    std::cout << "  " << tables << " tables formed, " << queue.size() << " still waiting\n"
+              << "  wait ms: mean " << waits.mean() << ", p50 <= " << waits.percentile(0.5) << ", p90 <= "
+              << waits.percentile(0.9) << ", p99 <= " << waits.percentile(0.99) << ", longest " << waits.longest() << "\n";
+    for (uint8_t seats = 2; seats <= SNAPSHOT_MAX_PLAYERS; seats++) {
+        const WaitHistogram& table_waits = queue.waitTimes(seats);
+        std::cout << "  " << static_cast<int>(seats) << " seats: " << table_waits.count() << " seated, p50 <= "
+                  << table_waits.percentile(0.5) << " ms, p99 <= " << table_waits.percentile(0.99) << " ms\n";
+    }
+    return 0;
+}
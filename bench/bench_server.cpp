@@ -0,0 +1,157 @@
+// Email: razcohenp@gmail.com
+
+// bench_server.cpp - Throughput of the game server on loopback
+// Usage: ./bench_server [tables] [connections] [players] [shards]
+// Every client connection holds all seats of its share of the tables and pipelines
+// one move per table per round; reports moves per second and round-trip times
+
+#include "../include/server/GameServer.hpp"
+#include "../include/server/ServerClient.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Pass every window, coup when affordable, gather otherwise
+    Move simpleMove(const Message& state) {
+        if (state.window) {
+            return Move::decline(state.seat);
+        }
+        if (state.seats[state.seat].coins >= 7) {
+            for (uint8_t target = 0; target < state.seat_count; target++) {
+                if (target != state.seat && state.seats[target].active) {
+                    return Move::play({ActionType::COUP, state.seat, target});
+                }
+            }
+        }
+        return Move::play({ActionType::GATHER, state.seat, NO_TARGET});
+    }
+
+    struct Client {
+        ServerClient socket;
+        std::vector<Message> tables; // Latest state of every running table of this client
+        std::vector<uint8_t> batch; // Frames of one round
+    };
+
+    void receiveOrThrow(ServerClient& socket, Message& message) {
+        if (!socket.receive(message, 10000)) {
+            throw std::runtime_error("Server did not answer");
+        }
+        if (message.type == MessageType::ERROR) {
+            throw std::runtime_error("Server error: " + std::string(message.text));
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const size_t table_count = argc > 1 ? std::stoul(argv[1]) : 2000;
+        const size_t connection_count = argc > 2 ? std::stoul(argv[2]) : 32;
+        const uint8_t players = static_cast<uint8_t>(argc > 3 ? std::stoul(argv[3]) : 2);
+        ServerConfig config;
+        config.shards = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 1;
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+
+        GameServer server(config);
+        std::thread loop([&] { server.run(); });
+
+        // Seat every table and start it
+        std::vector<std::unique_ptr<Client>> clients;
+        for (size_t c = 0; c < connection_count; c++) {
+            clients.emplace_back(new Client());
+            clients.back()->socket.connectTcp("127.0.0.1", server.getPort());
+        }
+        Message message;
+        for (size_t t = 0; t < table_count; t++) {
+            Client& client = *clients[t % connection_count];
+            Message request;
+            request.type = MessageType::JOIN;
+            uint32_t table = 0;
+            for (uint8_t seat = 0; seat < players; seat++) {
+                request.table = table;
+                request.role = roles[seat % 6];
+                const std::string name = "P" + std::to_string(seat + 1);
+                request.text = name;
+                client.socket.send(request);
+                receiveOrThrow(client.socket, message);
+                table = message.table;
+            }
+            request.type = MessageType::START;
+            request.table = table;
+            client.socket.send(request);
+            receiveOrThrow(client.socket, message);
+            client.tables.push_back(message);
+        }
+
+        // Rounds: every client sends one move per running table, then reads the new states
+        uint64_t moves = 0;
+        uint64_t games = 0;
+        uint64_t rounds = 0;
+        std::vector<double> round_trips_us;
+        const auto start = Clock::now();
+        bool running = true;
+        while (running) {
+            running = false;
+            for (auto& client : clients) {
+                if (client->tables.empty()) continue;
+                running = true;
+                const auto sent = Clock::now();
+                client->batch.clear();
+                Message request;
+                request.type = MessageType::MOVE;
+                for (const Message& state : client->tables) {
+                    request.table = state.table;
+                    request.move = simpleMove(state);
+                    encodeMessage(request, client->batch);
+                }
+                client->socket.sendRaw(client->batch.data(), client->batch.size());
+
+                std::vector<Message> next;
+                for (size_t i = 0; i < client->tables.size(); i++) {
+                    receiveOrThrow(client->socket, message);
+                    moves++;
+                    if (message.seat == NO_WINNER) {
+                        receiveOrThrow(client->socket, message); // GAME_OVER
+                        games++;
+                    }
+                    else {
+                        next.push_back(message);
+                    }
+                }
+                client->tables.swap(next);
+                round_trips_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+                rounds++;
+            }
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        server.stop();
+        loop.join();
+
+        std::sort(round_trips_us.begin(), round_trips_us.end());
+        std::cout << "Server benchmark (" << table_count << " tables of " << static_cast<int>(players) << ", "
+                  << connection_count << " connections, " << server.shardCount() << " shards)\n";
+        std::cout << "  games: " << games << ", moves: " << moves << " in " << seconds << " s\n";
+        std::cout << "  throughput: " << moves / seconds << " moves/s\n";
+        if (!round_trips_us.empty()) {
+            std::cout << "  batch round trip: median " << round_trips_us[round_trips_us.size() / 2] << " us, p99 "
+                      << round_trips_us[round_trips_us.size() * 99 / 100] << " us over " << rounds << " batches\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
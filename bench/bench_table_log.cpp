@@ -0,0 +1,161 @@
+// Email: razcohenp@gmail.com
+
+// bench_table_log.cpp - Cost of the write-ahead table log and of recovering from it
+// Usage: ./bench_table_log [tables] [events] [batch] [directory]
+// Plays random moves on many tables the way one shard would: batch events per loop round,
+// then one group commit. Compares events per second without a log, with a log that only
+// writes, with one fdatasync per round and with one fdatasync per event, then times the
+// recovery of what was logged (directory defaults to a fresh one under /tmp)
+
+#include "../include/server/TableLog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const RoleType ROLES[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+
+    struct Run {
+        double seconds;
+        uint64_t syncs;
+        uint64_t records;
+    };
+
+    std::unique_ptr<Table> newTable(uint32_t id, std::mt19937& random) {
+        std::unique_ptr<Table> table(new Table(id, 1000, GameRules(), id));
+        const size_t seats = 2 + random() % 5;
+        for (size_t seat = 0; seat < seats; seat++) {
+            table->join("P" + std::to_string(seat), ROLES[random() % 6]);
+        }
+        table->start();
+        return table;
+    }
+
+    // Plays events on random tables, replacing finished ones; log may be null, batch 1 syncs every event
+    Run play(size_t tables, size_t events, size_t batch, TableLog* log) {
+        std::mt19937 random(7);
+        std::vector<std::unique_ptr<Table>> running;
+        uint32_t next_id = 1;
+        for (size_t i = 0; i < tables; i++) {
+            running.push_back(newTable(next_id++, random));
+        }
+        if (log) {
+            std::vector<const Table*> all;
+            for (const auto& table : running) {
+                all.push_back(table.get());
+            }
+            log->checkpoint(all);
+        }
+
+        std::vector<Move> moves;
+        const auto start = Clock::now();
+        for (size_t event = 0; event < events; event++) {
+            std::unique_ptr<Table>& slot = running[random() % tables];
+            slot->getMatch()->moves(moves);
+            const Move move = moves[random() % moves.size()];
+            slot->play(move.action.actor, move);
+            if (log) {
+                log->logEvent(*slot);
+            }
+            if (slot->isOver()) {
+                if (log) {
+                    log->logEnd(slot->getId());
+                }
+                slot = newTable(next_id++, random);
+                if (log) {
+                    log->logSnapshot(*slot);
+                }
+            }
+            if (log && (event + 1) % batch == 0) {
+                log->commit();
+                if (log->needsCheckpoint()) {
+                    std::vector<const Table*> all;
+                    for (const auto& table : running) {
+                        all.push_back(table.get());
+                    }
+                    log->checkpoint(all);
+                }
+            }
+        }
+        if (log) {
+            log->commit();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return {seconds, log ? log->syncCount() : 0, log ? log->recordCount() : 0};
+    }
+
+    void report(const char* name, size_t events, const Run& run) {
+        std::cout << "  " << name << ": " << events / run.seconds << " events/s";
+        if (run.syncs > 0) {
+            std::cout << " (" << run.records << " records, " << run.syncs << " commits)";
+        }
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t tables = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t events = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    const size_t batch = argc > 3 ? std::stoul(argv[3]) : 1000;
+    std::string directory;
+    if (argc > 4) {
+        directory = argv[4];
+    }
+    else {
+        char path[] = "/tmp/coup_bench_wal_XXXXXX";
+        if (!::mkdtemp(path)) {
+            std::cerr << "Cannot create a log directory\n";
+            return 1;
+        }
+        directory = path;
+    }
+    const size_t synced_events = std::min<size_t>(events, 2000); // One fdatasync each is slow
+
+    std::cout << "Table log benchmark (" << tables << " tables, " << events << " events, " << batch
+              << " events per commit, in " << directory << ")\n";
+    report("no log", events, play(tables, events, batch, nullptr));
+    {
+        TableLog log(directory, 0, 1, 64 << 20, false);
+        report("log, no sync", events, play(tables, events, batch, &log));
+    }
+    TableLog::removeGenerations(directory, UINT32_MAX);
+    {
+        TableLog log(directory, 0, 1, 64 << 20, true);
+        report("log, group commit", events, play(tables, events, batch, &log));
+    }
+    TableLog::removeGenerations(directory, UINT32_MAX);
+    {
+        TableLog log(directory, 0, 1, 64 << 20, true);
+        report("log, sync per event", synced_events, play(tables, synced_events, 1, &log));
+    }
+    TableLog::removeGenerations(directory, UINT32_MAX);
+    {
+        TableLog log(directory, 0, 1, 64 << 20, true);
+        play(tables, events, batch, &log);
+    }
+
+    std::vector<std::unique_ptr<Table>> recovered;
+    RecoveryStats stats;
+    const auto start = Clock::now();
+    TableLog::recover(directory, recovered, stats);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "  recovery: " << stats.tables << " tables from " << stats.records << " records in "
+              << stats.segments << " segments, " << seconds * 1000 << " ms\n";
+    TableLog::removeGenerations(directory, UINT32_MAX);
+    if (argc <= 4) {
+        ::rmdir(directory.c_str());
+    }
+    return 0;
+}
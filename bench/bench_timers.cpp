@@ -0,0 +1,114 @@
+// Email: razcohenp@gmail.com
+
+// bench_timers.cpp - Cost of re-arming and expiring table deadlines
+// Usage: ./bench_timers [timers] [operations]
+// Every table holds one deadline that is re-armed on each move (cancel + schedule);
+// time advances one tick per thousand moves and expired tables are re-armed.
+// Compares the timer wheel with a binary heap that cancels lazily by generation
+
+#include "../include/server/TimerWheel.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint64_t MAX_DELAY = 30000; // Ticks a deadline lies ahead at most
+    constexpr size_t MOVES_PER_TICK = 1000;
+
+    struct Result {
+        double seconds;
+        uint64_t expired;
+        size_t peak; // Largest number of stored entries
+    };
+
+    Result runWheel(size_t timers, size_t operations) {
+        std::mt19937_64 random(7);
+        TimerWheel wheel;
+        std::vector<TimerId> handles(timers);
+        std::vector<uint64_t> expired;
+        Result result{0, 0, 0};
+        const auto start = Clock::now();
+        for (size_t t = 0; t < timers; t++) {
+            handles[t] = wheel.schedule(1 + random() % MAX_DELAY, t);
+        }
+        uint64_t now = 0;
+        for (size_t op = 0; op < operations; op++) {
+            const size_t t = random() % timers;
+            wheel.cancel(handles[t]);
+            handles[t] = wheel.schedule(now + 1 + random() % MAX_DELAY, t);
+            if (op % MOVES_PER_TICK == 0) {
+                expired.clear();
+                wheel.advance(++now, expired);
+                for (uint64_t e : expired) {
+                    handles[e] = wheel.schedule(now + 1 + random() % MAX_DELAY, e);
+                }
+                result.expired += expired.size();
+            }
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.peak = wheel.size();
+        return result;
+    }
+
+    Result runHeap(size_t timers, size_t operations) {
+        using Entry = std::pair<uint64_t, std::pair<uint32_t, uint32_t>>; // Due, (timer, generation)
+        std::mt19937_64 random(7);
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        std::vector<uint32_t> generations(timers, 0);
+        Result result{0, 0, 0};
+        const auto start = Clock::now();
+        for (size_t t = 0; t < timers; t++) {
+            heap.push({1 + random() % MAX_DELAY, {static_cast<uint32_t>(t), 0}});
+        }
+        uint64_t now = 0;
+        for (size_t op = 0; op < operations; op++) {
+            const size_t t = random() % timers;
+            generations[t]++; // Cancels the stored entry, which stays in the heap until it surfaces
+            heap.push({now + 1 + random() % MAX_DELAY, {static_cast<uint32_t>(t), generations[t]}});
+            if (heap.size() > result.peak) {
+                result.peak = heap.size();
+            }
+            if (op % MOVES_PER_TICK == 0) {
+                ++now;
+                while (!heap.empty() && heap.top().first <= now) {
+                    const Entry entry = heap.top();
+                    heap.pop();
+                    const uint32_t timer = entry.second.first;
+                    if (entry.second.second != generations[timer]) {
+                        continue;
+                    }
+                    generations[timer]++;
+                    heap.push({now + 1 + random() % MAX_DELAY, {timer, generations[timer]}});
+                    result.expired++;
+                }
+            }
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    }
+
+    void report(const char* name, const Result& result, size_t operations) {
+        std::cout << "  " << name << ": " << result.seconds * 1e9 / operations << " ns per re-arm, "
+                  << result.expired << " expired, " << result.peak << " entries at peak\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t timers = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t operations = argc > 2 ? std::stoul(argv[2]) : 10000000;
+
+    std::cout << "Timer benchmark (" << timers << " deadlines, " << operations << " re-arms)\n";
+    report("timer wheel", runWheel(timers, operations), operations);
+    report("binary heap", runHeap(timers, operations), operations);
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Email: razcohenp@gmail.com
+
+// bench_trace.cpp - Throughput benchmark of the compact trace format
+// Plays random 6-player games, records them and reports bytes per action and
+// encode/decode throughput in actions per second
+
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/Trace.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Play games on the table, optionally recording every action
+    // Returns the number of recorded actions
+    size_t playGames(Game& game, const GameSnapshot& initial, int games, uint32_t seed,
+                     TraceWriter* writer, std::vector<std::vector<unsigned char>>* traces) {
+        std::mt19937 rng(seed);
+        std::vector<Action> scratch;
+        Action chosen;
+        size_t total = 0;
+
+        for (int g = 0; g < games; g++) {
+            game.loadSnapshot(initial);
+            if (writer) writer->begin(game);
+
+            int steps = 0;
+            while (!isGameOver(game) && steps++ < 5000) {
+                if (playRandomAction(game, rng, scratch, chosen)) {
+                    if (writer) writer->record(chosen, game);
+                    total++;
+                }
+            }
+
+            if (writer) {
+                writer->finish();
+                traces->push_back(writer->data());
+            }
+        }
+        return total;
+    }
+}
+
+int main() {
+    const int games = 20000;
+
+    Game game;
+    std::vector<std::unique_ptr<Player>> roster;
+    const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+    for (int i = 0; i < 6; i++) {
+        roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(i + 1), roles[i]));
+    }
+    game.startGame();
+
+    GameSnapshot initial;
+    game.saveSnapshot(initial);
+
+    // Baseline: the same games without recording, to isolate the encoder cost
+    auto start = Clock::now();
+    size_t actions = playGames(game, initial, games, 42, nullptr, nullptr);
+    double play_seconds = secondsSince(start);
+
+    TraceWriter writer;
+    std::vector<std::vector<unsigned char>> traces;
+    traces.reserve(games);
+    start = Clock::now();
+    playGames(game, initial, games, 42, &writer, &traces);
+    double record_seconds = secondsSince(start);
+
+    size_t bytes = 0;
+    for (const auto& trace : traces) {
+        bytes += trace.size();
+    }
+
+    // Sequential decode of every trace
+    start = Clock::now();
+    size_t decoded = 0;
+    for (const auto& trace : traces) {
+        TraceReader reader(trace.data(), trace.size());
+        reader.forEachAction([&](size_t, const Action&, const GameSnapshot&) { decoded++; });
+    }
+    double decode_seconds = secondsSince(start);
+
+    // Random access: reconstruct the middle step of every trace from its keyframe
+    start = Clock::now();
+    GameSnapshot state;
+    for (const auto& trace : traces) {
+        TraceReader reader(trace.data(), trace.size());
+        reader.stateAt(reader.actionCount() / 2, state);
+    }
+    double seek_seconds = secondsSince(start);
+
+    double encode_seconds = record_seconds - play_seconds;
+    std::cout << "Trace benchmark (" << games << " games, " << actions << " actions)\n";
+    std::cout << "  bytes/action (incl. headers, keyframes, index): " << static_cast<double>(bytes) / actions << "\n";
+    std::cout << "  encode: " << (encode_seconds > 0 ? actions / encode_seconds : 0) << " actions/sec\n";
+    std::cout << "  decode: " << decoded / decode_seconds << " actions/sec\n";
+    std::cout << "  seek:   " << traces.size() / seek_seconds << " lookups/sec\n";
+    return 0;
+}
@@ -0,0 +1,226 @@
+// Email: razcohenp@gmail.com
+
+// fuzz_protocol.cpp - Fuzz harness of the server protocol decoder
+// Usage: ./fuzz_protocol [iterations] [seed]
+// Every input must decode frame by frame, wait for more bytes or throw std::invalid_argument,
+// and every decoded frame must survive an encode/decode round trip unchanged.
+// The standalone driver mutates valid frames; building with clang and
+// -fsanitize=fuzzer -DCOUP_LIBFUZZER keeps only the libFuzzer entry point.
+
+#include "../include/server/Protocol.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    struct Counters {
+        uint64_t decoded; // Frames decoded and round-tripped
+        uint64_t rejected; // Inputs that ended in std::invalid_argument
+        uint64_t incomplete; // Inputs that ended in a partial frame
+    };
+
+    Counters counters{0, 0, 0};
+    std::vector<uint8_t> encoded; // Reused re-encode buffer
+
+    [[noreturn]] void fail(const char* what, const uint8_t* data, size_t size) {
+        std::fprintf(stderr, "fuzz_protocol: %s\ninput (%zu bytes):", what, size);
+        for (size_t i = 0; i < size; i++) {
+            std::fprintf(stderr, " %02x", data[i]);
+        }
+        std::fprintf(stderr, "\n");
+        std::abort();
+    }
+
+    bool sameMessage(const Message& a, const Message& b) {
+        if (a.type != b.type || a.table != b.table) {
+            return false;
+        }
+        switch (a.type) {
+            case MessageType::JOIN:
+                return a.role == b.role && a.text == b.text;
+            case MessageType::MOVE:
+                return a.move == b.move;
+            case MessageType::REJOIN:
+            case MessageType::JOINED:
+                return a.seat == b.seat && a.token == b.token;
+            case MessageType::GAME_OVER:
+                return a.seat == b.seat;
+            case MessageType::STATE:
+                if (a.seat != b.seat || a.step != b.step || a.window != b.window || !(a.move == b.move) ||
+                    a.seat_count != b.seat_count || a.changed != b.changed) {
+                    return false;
+                }
+                for (uint8_t seat = 0; seat < a.seat_count; seat++) {
+                    if ((a.changed & (1u << seat)) && a.seats[seat] != b.seats[seat]) {
+                        return false;
+                    }
+                }
+                return true;
+            case MessageType::ERROR:
+                return a.error == b.error && a.text == b.text;
+            case MessageType::SETUP:
+                if (a.seed != b.seed || a.max_steps != b.max_steps || a.hash_interval != b.hash_interval ||
+                    a.rules != b.rules || a.hash != b.hash || a.seat_count != b.seat_count) {
+                    return false;
+                }
+                for (uint8_t seat = 0; seat < a.seat_count; seat++) {
+                    if (a.seats[seat].role != b.seats[seat].role) {
+                        return false;
+                    }
+                }
+                return true;
+            case MessageType::ACTION:
+                return a.step == b.step && a.move == b.move && a.expiry == b.expiry && a.has_hash == b.has_hash &&
+                       (!a.has_hash || a.hash == b.hash);
+            default:
+                return true;
+        }
+    }
+
+    void checkInput(const uint8_t* data, size_t size) {
+        size_t offset = 0;
+        while (offset < size) {
+            Message message;
+            size_t used;
+            try {
+                used = decodeMessage(data + offset, size - offset, message);
+            }
+            catch (const std::invalid_argument&) {
+                counters.rejected++;
+                return;
+            }
+            if (used == 0) {
+                counters.incomplete++;
+                return;
+            }
+            if (used > size - offset) {
+                fail("decoder consumed more bytes than it was given", data, size);
+            }
+
+            // Whatever the decoder accepts, the encoder must write back and read again identically
+            encoded.clear();
+            try {
+                encodeMessage(message, encoded);
+            }
+            catch (const std::invalid_argument&) {
+                fail("decoded message cannot be encoded", data, size);
+            }
+            Message again;
+            if (decodeMessage(encoded.data(), encoded.size(), again) != encoded.size() || !sameMessage(message, again)) {
+                fail("round trip changed the message", data, size);
+            }
+            counters.decoded++;
+            offset += used;
+        }
+    }
+
+    // Valid frames of every message type, the starting points of the mutations
+    std::vector<std::vector<uint8_t>> seedFrames(std::mt19937& random) {
+        std::vector<std::vector<uint8_t>> frames;
+        const MessageType types[] = {MessageType::JOIN, MessageType::START, MessageType::MOVE, MessageType::WATCH,
+                                     MessageType::REJOIN, MessageType::JOINED, MessageType::STATE, MessageType::GAME_OVER,
+                                     MessageType::ERROR, MessageType::SETUP, MessageType::ACTION};
+        const std::string names[] = {"", "A", "Alice", "123456789"};
+        for (int round = 0; round < 16; round++) {
+            for (MessageType type : types) {
+                Message message;
+                message.type = type;
+                message.table = random();
+                message.seat = static_cast<uint8_t>(random() % 7);
+                message.role = static_cast<RoleType>(random() % 6);
+                message.text = names[round % 4];
+                message.move = Move::play({static_cast<ActionType>(random() % ACTION_TYPE_COUNT),
+                                           static_cast<uint8_t>(random() % 6), static_cast<uint8_t>(random() % 6)});
+                message.error = static_cast<ServerError>(random() % 9);
+                message.step = random();
+                message.window = random() % 2 == 0;
+                message.seat_count = static_cast<uint8_t>(random() % (SNAPSHOT_MAX_PLAYERS + 1));
+                message.changed = static_cast<uint8_t>(random() & ((1u << message.seat_count) - 1));
+                message.seed = random();
+                message.max_steps = random() % 1000;
+                message.hash_interval = static_cast<uint16_t>(random() % 16);
+                message.hash = (static_cast<uint64_t>(random()) << 32) | random();
+                message.has_hash = random() % 2 == 0;
+                message.expiry = random() % 4 == 0;
+                message.token = (static_cast<uint64_t>(random()) << 32) | random();
+                for (uint8_t seat = 0; seat < message.seat_count; seat++) {
+                    message.seats[seat] = {static_cast<uint8_t>(random() % 6), random() % 2 == 0,
+                                           static_cast<uint16_t>(random() % 20)};
+                }
+                frames.emplace_back();
+                encodeMessage(message, frames.back());
+            }
+        }
+        return frames;
+    }
+
+    void mutate(std::vector<uint8_t>& input, const std::vector<std::vector<uint8_t>>& frames, std::mt19937& random) {
+        const int edits = 1 + static_cast<int>(random() % 4);
+        for (int edit = 0; edit < edits; edit++) {
+            switch (random() % 6) {
+                case 0: // Flip a bit
+                    if (!input.empty()) {
+                        input[random() % input.size()] ^= static_cast<uint8_t>(1u << (random() % 8));
+                    }
+                    break;
+                case 1: // Overwrite a byte with a boundary value
+                    if (!input.empty()) {
+                        const uint8_t values[] = {0, 1, 6, 7, 0x7F, 0x80, 0xFF, PROTOCOL_VERSION};
+                        input[random() % input.size()] = values[random() % 8];
+                    }
+                    break;
+                case 2: // Truncate
+                    input.resize(random() % (input.size() + 1));
+                    break;
+                case 3: // Insert random bytes
+                    for (size_t count = 1 + random() % 4; count > 0; count--) {
+                        input.insert(input.begin() + static_cast<long>(random() % (input.size() + 1)),
+                                     static_cast<uint8_t>(random()));
+                    }
+                    break;
+                case 4: { // Append another frame, so several frames share one buffer
+                    const std::vector<uint8_t>& other = frames[random() % frames.size()];
+                    input.insert(input.end(), other.begin(), other.end());
+                    break;
+                }
+                default: // Rewrite the length of the first frame
+                    if (input.size() >= 2) {
+                        const uint16_t length = static_cast<uint16_t>(random() % 64);
+                        input[0] = static_cast<uint8_t>(length);
+                        input[1] = static_cast<uint8_t>(length >> 8);
+                    }
+                    break;
+            }
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    checkInput(data, size);
+    return 0;
+}
+
+#ifndef COUP_LIBFUZZER
+int main(int argc, char* argv[]) {
+    const uint64_t iterations = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    std::mt19937 random(argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1);
+
+    const std::vector<std::vector<uint8_t>> frames = seedFrames(random);
+    std::vector<uint8_t> input;
+    for (uint64_t i = 0; i < iterations; i++) {
+        input = frames[random() % frames.size()];
+        mutate(input, frames, random);
+        checkInput(input.data(), input.size());
+    }
+    std::printf("Protocol fuzzing (%llu inputs): %llu frames decoded, %llu rejected, %llu incomplete\n",
+                static_cast<unsigned long long>(iterations), static_cast<unsigned long long>(counters.decoded),
+                static_cast<unsigned long long>(counters.rejected), static_cast<unsigned long long>(counters.incomplete));
+    return 0;
+}
+#endif
@@ -0,0 +1,104 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Action.hpp
+ * Compact description of a single game action.
+ * Lets simulations, traces and bots enumerate and apply actions by seat index
+ * instead of calling the Player and role methods directly.
+ */
+
+#ifndef ACTION_HPP
+#define ACTION_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#include "ActionError.hpp"
+
+namespace coup {
+    class Game; // Forward declaration to avoid circular dependency
+
+    /**
+     * Enumeration of every action a seat can take.
+     * Covers the basic actions of Player and the role abilities.
+     */
+    enum class ActionType : uint8_t {
+        GATHER, // Player::gather
+        TAX, // Player::tax (Governor takes 3)
+        BRIBE, // Player::bribe
+        ARREST, // Player::arrest
+        SANCTION, // Player::sanction
+        COUP, // Player::coup
+        INVEST, // Baron::invest
+        SPY_ON, // Spy::spy_on
+        BLOCK_COUP, // General::block_coup (reactive)
+        BLOCK_BRIBE, // Judge::block_bribe (reactive)
+        UNDO // Governor::undo (reactive)
+    };
+
+    constexpr size_t ACTION_TYPE_COUNT = 11; // Number of values in ActionType
+    constexpr uint8_t NO_TARGET = 0xFF; // Target seat of actions without a target
+
+    /**
+     * A single action: who acts, what they do and against which seat.
+     */
+    struct Action {
+        ActionType type; // What is done
+        uint8_t actor; // Seat of the acting player
+        uint8_t target; // Seat of the target, NO_TARGET when the action has none
+
+        bool operator==(const Action& other) const {
+            return type == other.type && actor == other.actor && target == other.target;
+        }
+        bool operator!=(const Action& other) const { return !(*this == other); }
+    };
+
+    /**
+     * Returns whether the action type requires a target seat.
+     */
+    bool actionHasTarget(ActionType type);
+
+    /**
+     * Returns whether the action type can be used outside the actor's turn.
+     */
+    bool isReactiveAction(ActionType type);
+
+    /**
+     * Converts an action type to its display name.
+     */
+    std::string getActionName(ActionType type);
+
+    /**
+     * Applies the action by calling the matching Player or role method.
+     * Throws the same exceptions as the underlying method when the action is illegal.
+     */
+    void applyAction(Game& game, const Action& action);
+
+    /**
+     * No-throw version of applyAction.
+     * Returns the rule that rejected the action instead of throwing; the game is unchanged on failure.
+     */
+    ActionResult tryApplyAction(Game& game, const Action& action);
+
+    /**
+     * Writes every action the seat may legally take right now into out (cleared first).
+     * On the seat's turn this lists its turn actions; reactive abilities are listed at any time.
+     * Pointless repeats (a second bribe, spying on an already spied target) are left out.
+     */
+    void legalActions(const Game& game, uint8_t seat, std::vector<Action>& out);
+
+    /**
+     * Applies a uniformly random legal action of the current player and stores it in chosen.
+     * Uses scratch as the action buffer so repeated calls do not allocate.
+     * Returns false when the current player has no legal action; the turn is then passed.
+     */
+    bool playRandomAction(Game& game, std::mt19937& rng, std::vector<Action>& scratch, Action& chosen);
+
+    /**
+     * Returns whether at most one player is still active.
+     */
+    bool isGameOver(const Game& game);
+}
+
+#endif
@@ -0,0 +1,83 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * ActionError.hpp
+ * Error codes of rejected actions for the no-throw entry points.
+ * Every try* method of Player and the roles reports failures with these codes;
+ * the throwing methods convert them to std::runtime_error with the same messages.
+ */
+
+#ifndef ACTION_ERROR_HPP
+#define ACTION_ERROR_HPP
+
+#include <cstdint>
+#include "Expected.hpp"
+
+namespace coup {
+    /**
+     * Reason an action was rejected.
+     */
+    enum class ActionError : uint8_t {
+        NONE, // No error
+        GAME_NOT_STARTED, // The game has not started
+        NOT_YOUR_TURN, // Turn action outside the actor's turn
+        PLAYER_ELIMINATED, // The actor is eliminated
+        MUST_COUP, // The actor holds 10 or more coins and must coup
+        SANCTIONED, // Economic action while sanctioned
+        ARREST_UNAVAILABLE, // The actor was spied on and cannot arrest
+        SELF_TARGET, // The actor targeted itself
+        TARGET_ELIMINATED, // The target is eliminated
+        CONSECUTIVE_ARREST, // The target was the last player arrested
+        NOT_ENOUGH_COINS_BRIBE, // Fewer than 4 coins for bribe
+        NOT_ENOUGH_COINS_SANCTION, // Fewer than 3 coins for sanction
+        NOT_ENOUGH_COINS_SANCTION_JUDGE, // Fewer than 4 coins to sanction a Judge
+        NOT_ENOUGH_COINS_COUP, // Fewer than 7 coins for coup
+        NOT_ENOUGH_COINS_INVEST, // Fewer than 3 coins for invest
+        NOT_ENOUGH_COINS_BLOCK_COUP, // Fewer than 5 coins to block a coup
+        TARGET_NOT_ENOUGH_COINS, // The target cannot pay the coins the action takes
+        TARGET_NOT_COUPED, // Block coup on an active target
+        COUP_WINDOW_CLOSED, // Block coup after the blocking window expired
+        NO_TAX_TO_UNDO, // Undo on a target whose last action was not tax
+        NO_BRIBE_TO_BLOCK, // Block bribe on a target that did not bribe
+        INVALID_ACTOR, // Actor seat out of range (seat-based actions)
+        INVALID_TARGET, // Target seat out of range (seat-based actions)
+        ROLE_REQUIRED, // The actor lacks the role of the ability
+        INVALID_ACTION // Unknown action type
+    };
+
+    /**
+     * Result of a no-throw action entry point.
+     */
+    using ActionResult = Expected<void, ActionError>;
+
+    /**
+     * Returns a failed ActionResult (or any Expected<T, ActionError>) carrying error.
+     */
+    inline Unexpected<ActionError> actionFailure(ActionError error) {
+        return makeUnexpected(error);
+    }
+
+    /**
+     * Returns the message of an error code. The message is a static string,
+     * so nothing is formatted or allocated until it is requested.
+     */
+    const char* getActionErrorMessage(ActionError error);
+
+    /**
+     * Throws std::runtime_error with the message of error.
+     * Kept out of line so the throwing wrappers stay small.
+     */
+    [[noreturn]] void throwActionError(ActionError error);
+
+    /**
+     * Throws if result holds an error - bridges try* methods to the throwing API.
+     */
+    template <typename T>
+    void throwIfFailed(const Expected<T, ActionError>& result) {
+        if (!result) {
+            throwActionError(result.error());
+        }
+    }
+}
+
+#endif
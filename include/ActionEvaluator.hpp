@@ -0,0 +1,52 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * ActionEvaluator.hpp
+ * Pluggable scoring of "what-if" positions.
+ * Game::evaluateAllActions applies every legal action of the current player to a
+ * scratch clone and asks an evaluator to score the resulting position; advisors
+ * and one-ply bots read the scores from a caller-owned buffer.
+ */
+
+#ifndef ACTION_EVALUATOR_HPP
+#define ACTION_EVALUATOR_HPP
+
+#include <cstdint>
+#include "Action.hpp"
+
+namespace coup {
+    class Game;
+
+    /**
+     * Score of one legal action.
+     */
+    struct ActionScore {
+        Action action; // Evaluated action
+        double score; // Evaluator output, higher is better for the acting seat
+    };
+
+    /**
+     * Scores a position reached by one action. Implementations must be thread-safe
+     * when shared between threads (evaluateAllActions never copies them).
+     */
+    class ActionEvaluator {
+    public:
+        virtual ~ActionEvaluator() = default;
+
+        /**
+         * Scores the position after the action from the point of view of seat.
+         */
+        virtual double evaluate(const Game& after, const Action& action, uint8_t seat) const = 0;
+    };
+
+    /**
+     * Default material evaluator - own coins against the richest opponent, with a
+     * large bonus per eliminated opponent and a large penalty when eliminated.
+     */
+    class MaterialEvaluator : public ActionEvaluator {
+    public:
+        double evaluate(const Game& after, const Action& action, uint8_t seat) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,161 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * ColumnarExport.hpp
+ * Columnar analytics export of simulated games.
+ * Every column is written to its own contiguous binary file of fixed-width values
+ * (host byte order), so downstream tools can memory-map or scan a single column.
+ * A schema.txt file in the output directory lists every column and its type.
+ */
+
+#ifndef COLUMNAR_EXPORT_HPP
+#define COLUMNAR_EXPORT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Snapshot.hpp"
+#include "Action.hpp"
+
+namespace coup {
+    class Game; // Forward declaration to avoid circular dependency
+    class TraceReader;
+
+    /**
+     * Buffered writer of one column file.
+     * Values are collected in memory and appended to the file in chunks.
+     */
+    template <typename T>
+    class ColumnFile {
+    private:
+        std::string path; // For error messages
+        std::ofstream out; // Column file
+        std::vector<T> buffer; // Values not yet written
+        size_t chunk_rows; // Buffered values before a write
+
+    public:
+        ColumnFile(const std::string& path, size_t chunk_rows)
+        : path(path), out(path, std::ios::binary | std::ios::trunc), chunk_rows(chunk_rows) {
+            if (!out) {
+                throw std::runtime_error("Cannot open column file " + path);
+            }
+            buffer.reserve(chunk_rows);
+        }
+
+        void push(T value) {
+            buffer.push_back(value);
+            if (buffer.size() >= chunk_rows) {
+                flush();
+            }
+        }
+
+        /**
+         * Writes the buffered values. Throws std::runtime_error when the file refuses them (e.g. a full disk).
+         */
+        void flush() {
+            if (!buffer.empty()) {
+                out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(T));
+                buffer.clear();
+            }
+            out.flush();
+            if (!out) {
+                throw std::runtime_error("Failed to write column file " + path);
+            }
+        }
+    };
+
+    /**
+     * Writes per-action and per-game columns for batches of games.
+     *
+     * Action columns (one row per action): game_id, turn (action index within the game),
+     * seat, role, action, target, coins_before and coins_after of the acting seat.
+     * Game columns (one row per game): game_id, player_count, action_count, winner seat and winner role.
+     * Games are fed either live through beginGame/recordAction/endGame or from recorded traces.
+     */
+    class ColumnarExporter {
+    private:
+        std::string directory; // Output directory
+
+        // Per-action columns
+        ColumnFile<uint32_t> action_game_id;
+        ColumnFile<uint32_t> action_turn;
+        ColumnFile<uint8_t> action_seat;
+        ColumnFile<uint8_t> action_role;
+        ColumnFile<uint8_t> action_type;
+        ColumnFile<uint8_t> action_target;
+        ColumnFile<int16_t> action_coins_before;
+        ColumnFile<int16_t> action_coins_after;
+
+        // Per-game columns
+        ColumnFile<uint32_t> game_id;
+        ColumnFile<uint8_t> game_player_count;
+        ColumnFile<uint32_t> game_action_count;
+        ColumnFile<uint8_t> game_winner_seat;
+        ColumnFile<uint8_t> game_winner_role;
+
+        uint32_t next_game_id; // Id assigned to the next game
+        uint32_t current_game_id; // Id of the game being recorded
+        uint32_t current_turn; // Actions recorded in the current game
+        bool in_game; // Whether beginGame has been called without endGame
+        GameSnapshot previous; // State before the next action (live recording)
+        GameSnapshot scratch; // Scratch snapshot for the state after an action
+
+        /**
+         * Appends one action row from the states before and after it.
+         */
+        void addActionRow(const Action& action, const GameSnapshot& before, const GameSnapshot& after);
+
+        /**
+         * Appends one game row from the final state.
+         */
+        void addGameRow(const GameSnapshot& final_state);
+
+        /**
+         * Writes schema.txt describing every column file.
+         */
+        void writeSchema() const;
+
+    public:
+        /**
+         * Creates the output directory (if needed) and opens every column file.
+         * chunk_rows is the number of values buffered per column before writing.
+         */
+        explicit ColumnarExporter(const std::string& directory, size_t chunk_rows = 65536, uint32_t first_game_id = 0);
+
+        /**
+         * Flushes all buffered values. Write errors are swallowed here; call flush() first to see them.
+         */
+        ~ColumnarExporter();
+
+        /**
+         * Starts recording a live game in its current state and returns its id.
+         */
+        uint32_t beginGame(const Game& game);
+
+        /**
+         * Records an action that has just been applied to the live game.
+         */
+        void recordAction(const Action& action, const Game& game);
+
+        /**
+         * Finishes the live game and writes its game row.
+         */
+        void endGame(const Game& game);
+
+        /**
+         * Exports a complete recorded game and returns its id.
+         */
+        uint32_t exportTrace(const TraceReader& trace);
+
+        /**
+         * Writes all buffered values to the column files.
+         * Throws std::runtime_error when a file cannot be written.
+         */
+        void flush();
+    };
+}
+
+#endif
@@ -0,0 +1,96 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Expected.hpp
+ * Minimal expected-style result type (C++17 has no std::expected).
+ * Holds either a value or an error code, so hot paths can report failures
+ * without throwing exceptions.
+ */
+
+#ifndef EXPECTED_HPP
+#define EXPECTED_HPP
+
+#include <stdexcept>
+#include <utility>
+
+namespace coup {
+    /**
+     * Wrapper marking a value as the error of an Expected.
+     */
+    template <typename E>
+    struct Unexpected {
+        E error;
+    };
+
+    /**
+     * Creates an Unexpected from an error code.
+     */
+    template <typename E>
+    Unexpected<E> makeUnexpected(E error) {
+        return Unexpected<E>{error};
+    }
+
+    /**
+     * Either a value of type T or an error of type E.
+     * T must be default constructible; E is expected to be a small enum.
+     */
+    template <typename T, typename E>
+    class [[nodiscard]] Expected {
+    private:
+        T stored_value; // Valid when has_value is set
+        E stored_error; // Valid when has_value is clear
+        bool has_value; // Which member is valid
+
+    public:
+        Expected(const T& value) : stored_value(value), stored_error(), has_value(true) {}
+        Expected(T&& value) : stored_value(std::move(value)), stored_error(), has_value(true) {}
+        Expected(Unexpected<E> error) : stored_value(), stored_error(error.error), has_value(false) {}
+
+        bool hasValue() const { return has_value; }
+        explicit operator bool() const { return has_value; }
+
+        /**
+         * Returns the value. Throws std::logic_error if the result holds an error.
+         */
+        const T& value() const {
+            if (!has_value) {
+                throw std::logic_error("Expected holds an error");
+            }
+            return stored_value;
+        }
+
+        /**
+         * Returns the value, or fallback if the result holds an error.
+         */
+        T valueOr(T fallback) const { return has_value ? stored_value : fallback; }
+
+        /**
+         * Returns the error. Only meaningful when hasValue() is false.
+         */
+        E error() const { return stored_error; }
+    };
+
+    /**
+     * Specialization for operations that only succeed or fail.
+     */
+    template <typename E>
+    class [[nodiscard]] Expected<void, E> {
+    private:
+        E stored_error; // Valid when has_value is clear
+        bool has_value; // Whether the operation succeeded
+
+    public:
+        Expected() : stored_error(), has_value(true) {}
+        Expected(Unexpected<E> error) : stored_error(error.error), has_value(false) {}
+
+        bool hasValue() const { return has_value; }
+        explicit operator bool() const { return has_value; }
+
+        /**
+         * Returns the error. Only meaningful when hasValue() is false.
+         */
+        E error() const { return stored_error; }
+    };
+}
+
+#endif
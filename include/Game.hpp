@@ -13,9 +13,13 @@
 #include <vector>
 #include <string>
 #include <random> // Random number generation for role assignment
+#include "Snapshot.hpp" // Fixed-layout binary snapshot structures
 
 namespace coup {
     class Player; // Forward declaration to avoid circular dependency
+    class GameClone; // Scratch copies for what-if evaluation
+    class ActionEvaluator; // Scores what-if positions
+    struct ActionScore; // One evaluated action
 
     /**
      * Enumeration of all available character roles in the game.
@@ -30,6 +34,22 @@ namespace coup {
         MERCHANT, // Gets bonus coins and pays treasury when arrested
         PLAYER // Default base player with no special abilities
     };
+
+    /**
+     * Tunable rule parameters. The defaults are the standard rules; balance studies
+     * change them per game through Game::setRules.
+     */
+    struct GameRules {
+        int coup_cost = 7; // Coins paid to coup (at most 10, where the coup becomes mandatory)
+        int tax_bonus = 1; // Extra coins of a Governor's tax
+        int invest_payout = 6; // Coins a Baron receives for investing 3
+        int block_coup_cost = 5; // Coins a General pays to block a coup
+        int merchant_threshold = 3; // Coins a Merchant needs at turn start for the bonus coin
+        int judge_surcharge = 1; // Extra coins to sanction a Judge
+
+        bool operator==(const GameRules& other) const;
+        bool operator!=(const GameRules& other) const { return !(*this == other); }
+    };
     /**
      * Main game controller class for the Coup card game.
      * Manages all aspects of gameplay including player management,
@@ -42,6 +62,7 @@ namespace coup {
         bool game_started; // Flag indicating if the game has begun
         Player* last_arrested_player; // Reference to prevent consecutive arrests
         std::mt19937 random_generator; // Pseudorandom number generator for fair role distribution
+        GameRules rules; // Rule parameters of this game
         
     public:
         /**
@@ -117,6 +138,18 @@ namespace coup {
          * Used to prevent invalid operations during setup phase.
          */
         bool isGameStarted() const;
+
+        /**
+         * Replaces the rule parameters. Only allowed before the game starts.
+         * Throws exception for negative costs, a payout below the investment, a coup cost above
+         * the mandatory coup threshold of 10 coins or a started game.
+         */
+        void setRules(const GameRules& new_rules);
+
+        /**
+         * Returns the rule parameters of this game.
+         */
+        const GameRules& getRules() const { return rules; }
         
         /**
          * Gets a pointer to the player whose turn it currently is.
@@ -130,6 +163,23 @@ namespace coup {
          */
         std::vector<Player*> getAllPlayers() const;
         
+        /**
+         * Returns the number of seats, including eliminated players.
+         * Used by engine code that addresses players by seat index.
+         */
+        size_t getPlayerCount() const { return players_list.size(); }
+
+        /**
+         * Gets the player sitting at the given seat index.
+         * Does not check bounds, seat must be below getPlayerCount().
+         */
+        Player* getPlayer(size_t seat) const { return players_list[seat]; }
+
+        /**
+         * Returns the seat index of the player whose turn it is.
+         */
+        int getCurrentPlayerIndex() const { return current_player_index; }
+
         /**
          * Returns only players who are still in the game.
          * Excludes players who have been eliminated by coup.
@@ -166,6 +216,20 @@ namespace coup {
          */
         bool canGeneralPreventGameEnd() const;
 
+        /**
+         * Scores every legal action of the current player without touching this game.
+         * Each action is applied to the scratch clone (reloaded from one snapshot) and the
+         * evaluator scores the result; out is cleared and refilled, keeping its capacity.
+         * The scratch must be a clone of this game's roster and rules.
+         * Returns the number of actions scored.
+         */
+        size_t evaluateAllActions(GameClone& scratch, const ActionEvaluator& evaluator, std::vector<ActionScore>& out) const;
+
+        /**
+         * Same, with one scratch clone per thread that is rebuilt only when the roster or rules change.
+         */
+        size_t evaluateAllActions(const ActionEvaluator& evaluator, std::vector<ActionScore>& out) const;
+
         /**
          * Provides access to the random number generator.
          * Used for deterministic role assignment in derived classes.
@@ -189,6 +253,38 @@ namespace coup {
          * Used internally for role assignment during game setup.
          */
         Player* createPlayerWithRole(const std::string& name, RoleType role);
+
+        /**
+         * Writes the full game state into a fixed-layout snapshot.
+         * Covers players, roles, coins, flags, turn index, arrest and coup links and the RNG state.
+         * The RNG state can be skipped for callers that take many snapshots and never draw roles.
+         */
+        void saveSnapshot(GameSnapshot& snapshot, bool include_rng = true) const;
+
+        /**
+         * Serializes the full game state into a versioned binary blob.
+         * The buffer is resized to exactly sizeof(GameSnapshot) bytes.
+         */
+        void saveSnapshot(std::vector<unsigned char>& buffer) const;
+
+        /**
+         * Restores the game state from a snapshot taken of the same roster.
+         * Players are not recreated - seat count, names and roles must match the current players.
+         * The RNG is left untouched when the snapshot carries no RNG state.
+         * Throws exception if the snapshot does not match this game.
+         */
+        void loadSnapshot(const GameSnapshot& snapshot);
+
+        /**
+         * Restores the game state from a binary blob produced by saveSnapshot.
+         * Validates size, magic and version before copying.
+         */
+        void loadSnapshot(const unsigned char* data, size_t size);
+
+        /**
+         * Convenience overload for blobs stored in a byte vector.
+         */
+        void loadSnapshot(const std::vector<unsigned char>& buffer);
     };
 }
 
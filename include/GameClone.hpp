@@ -0,0 +1,68 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * GameClone.hpp
+ * Independent copy of a game for simulations.
+ * Owns a Game with the same seats (names and roles) as the source and moves
+ * states in and out through fixed-layout snapshots, so re-cloning a position
+ * is a single memcpy-sized load instead of rebuilding players.
+ */
+
+#ifndef GAME_CLONE_HPP
+#define GAME_CLONE_HPP
+
+#include <memory>
+#include <vector>
+#include "Game.hpp"
+#include "Player.hpp"
+
+namespace coup {
+    /**
+     * A private table mirroring the roster of another game.
+     * Not copyable - every search thread builds its own clone once and reloads it per simulation.
+     */
+    class GameClone {
+    private:
+        Game clone_game; // The simulated game
+        std::vector<std::unique_ptr<Player>> roster; // Players of the clone (owned here, Game does not delete them)
+
+        /**
+         * Adds one seat with the given name and role.
+         */
+        void addSeat(const std::string& name, RoleType role);
+
+    public:
+        /**
+         * Builds the same seats as source and copies its current state.
+         */
+        explicit GameClone(const Game& source);
+
+        /**
+         * Builds the seats described by a snapshot (names and roles) and loads it.
+         * Lets searches simulate sampled positions whose roles differ from the real game.
+         * Snapshots carry no rules, so the rules of the simulated game are passed in.
+         */
+        explicit GameClone(const GameSnapshot& snapshot, const GameRules& rules = GameRules());
+
+        GameClone(const GameClone&) = delete;
+        GameClone& operator=(const GameClone&) = delete;
+
+        /**
+         * Returns the simulated game.
+         */
+        Game& game() { return clone_game; }
+        const Game& game() const { return clone_game; }
+
+        /**
+         * Replaces the simulated state with a snapshot of a game with the same roster.
+         */
+        void load(const GameSnapshot& snapshot) { clone_game.loadSnapshot(snapshot); }
+
+        /**
+         * Replaces the simulated state with the current state of source (same roster).
+         */
+        void copyFrom(const Game& source);
+    };
+}
+
+#endif
@@ -0,0 +1,252 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Logger.hpp
+ * Lightweight asynchronous logger for engine and tool code.
+ * Log calls copy their arguments in binary form into a per-thread lock-free ring buffer;
+ * a background writer thread formats and writes them, so logging costs nanoseconds
+ * instead of a flushing syscall per line. Levels below COUP_LOG_LEVEL compile away
+ * entirely, arguments included.
+ */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Minimum level compiled into the binary: 0 debug, 1 info, 2 warning, 3 error, 4 off.
+ * Override with -DCOUP_LOG_LEVEL=0 to enable debug logging of the engine.
+ */
+#ifndef COUP_LOG_LEVEL
+#define COUP_LOG_LEVEL 1
+#endif
+
+// Log macros - the format must be a string literal and uses {} placeholders
+// Disabled levels are removed by the compiler, their arguments are never evaluated
+#define COUP_LOG_AT(level, ...) \
+    do { if (static_cast<int>(level) >= COUP_LOG_LEVEL) ::coup::Logger::instance().log(level, __VA_ARGS__); } while (0)
+#define COUP_LOG_DEBUG(...) COUP_LOG_AT(::coup::LogLevel::DEBUG, __VA_ARGS__)
+#define COUP_LOG_INFO(...) COUP_LOG_AT(::coup::LogLevel::INFO, __VA_ARGS__)
+#define COUP_LOG_WARNING(...) COUP_LOG_AT(::coup::LogLevel::WARNING, __VA_ARGS__)
+#define COUP_LOG_ERROR(...) COUP_LOG_AT(::coup::LogLevel::ERROR, __VA_ARGS__)
+
+namespace coup {
+    /**
+     * Severity of a log message.
+     */
+    enum class LogLevel : uint8_t {
+        DEBUG, // Engine internals, compiled out by default
+        INFO, // Normal progress messages
+        WARNING, // Unexpected but recoverable situations
+        ERROR // Failures
+    };
+
+    constexpr size_t LOG_MAX_ARGS = 4; // Arguments captured per message
+    constexpr size_t LOG_TEXT_SIZE = 48; // Inline storage for string arguments per message
+    constexpr size_t LOG_RING_CAPACITY = 4096; // Messages buffered per thread (power of two)
+
+    /**
+     * One captured argument in binary form.
+     * Strings are copied into the owning record's text area and referenced by offset and length.
+     */
+    struct LogArg {
+        enum Type : uint8_t { INT, UINT, DOUBLE, BOOL, TEXT } type; // Which value is valid
+        union {
+            int64_t i; // INT and BOOL
+            uint64_t u; // UINT, TEXT (offset << 8 | length)
+            double d; // DOUBLE
+        };
+    };
+
+    /**
+     * One log message as stored in the ring buffer.
+     * Formatting is deferred to the writer thread.
+     */
+    struct LogRecord {
+        uint64_t timestamp_ns; // Steady clock time of the call
+        const char* format; // Format string literal with {} placeholders
+        LogLevel level; // Severity
+        uint8_t arg_count; // Number of valid entries in args
+        uint8_t text_used; // Bytes used in text
+        LogArg args[LOG_MAX_ARGS]; // Captured arguments
+        char text[LOG_TEXT_SIZE]; // Copies of string arguments (truncated when full)
+    };
+
+    /**
+     * Single-producer single-consumer ring buffer owned by one logging thread.
+     * The producer never blocks - messages are dropped and counted when the ring is full.
+     */
+    class LogRing {
+    private:
+        std::vector<LogRecord> slots; // Fixed storage
+        alignas(64) std::atomic<size_t> head; // Next slot to read (consumer)
+        alignas(64) std::atomic<size_t> tail; // Next slot to write (producer)
+        std::atomic<uint64_t> dropped; // Messages lost because the ring was full
+        std::atomic<bool> retired; // Owning thread has exited
+
+    public:
+        LogRing();
+
+        /**
+         * Returns the next free slot, or null if the ring is full. Producer only.
+         */
+        LogRecord* acquire() {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) >= LOG_RING_CAPACITY) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            return &slots[t & (LOG_RING_CAPACITY - 1)];
+        }
+
+        /**
+         * Makes the slot returned by acquire visible to the consumer. Producer only.
+         */
+        void publish() {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * Hands every published message to visit and frees the slots. Consumer only.
+         * Returns the number of messages consumed.
+         */
+        size_t drain(const std::function<void(const LogRecord&)>& visit);
+
+        bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+        uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+        void retire() { retired.store(true, std::memory_order_release); }
+        bool isRetired() const { return retired.load(std::memory_order_acquire); }
+    };
+
+    /**
+     * Process-wide asynchronous logger.
+     * Starts its writer thread on first use and drains all rings on flush() and destruction.
+     */
+    class Logger {
+    private:
+        std::mutex rings_mutex; // Guards rings (taken only when a thread logs for the first time)
+        std::vector<std::shared_ptr<LogRing>> rings; // One ring per logging thread
+        uint64_t retired_dropped; // Drops counted by rings of exited threads (guarded by rings_mutex)
+        std::mutex drain_mutex; // Keeps the writer thread and flush() from consuming concurrently
+        std::function<void(const std::string&)> sink; // Receives formatted batches, null for stdout
+        std::string batch; // Formatted text waiting for the sink
+        std::atomic<bool> running; // Writer thread keeps polling while set
+        std::thread writer; // Background writer thread
+
+        Logger();
+
+        /**
+         * Returns the ring of the calling thread, creating and registering it on first use.
+         */
+        LogRing& localRing();
+
+        /**
+         * Consumes every ring once and writes the formatted text. Returns messages written.
+         */
+        size_t drainAll();
+
+        /**
+         * Writer thread body - drains rings until stopped.
+         */
+        void writerLoop();
+
+        // Argument capture - one overload per supported argument kind
+        static void capture(LogRecord&, LogArg& arg, bool value) { arg.type = LogArg::BOOL; arg.i = value; }
+        static void capture(LogRecord&, LogArg& arg, double value) { arg.type = LogArg::DOUBLE; arg.d = value; }
+        static void capture(LogRecord&, LogArg& arg, float value) { arg.type = LogArg::DOUBLE; arg.d = value; }
+        static void capture(LogRecord& record, LogArg& arg, const char* value) { captureText(record, arg, value, value ? std::strlen(value) : 0); }
+        static void capture(LogRecord& record, LogArg& arg, const std::string& value) { captureText(record, arg, value.data(), value.size()); }
+        static void captureText(LogRecord& record, LogArg& arg, const char* text, size_t length);
+
+        template <typename T>
+        static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+        capture(LogRecord&, LogArg& arg, T value) { arg.type = LogArg::INT; arg.i = value; }
+
+        template <typename T>
+        static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+        capture(LogRecord&, LogArg& arg, T value) { arg.type = LogArg::UINT; arg.u = value; }
+
+        template <typename T>
+        static typename std::enable_if<std::is_enum<T>::value>::type
+        capture(LogRecord&, LogArg& arg, T value) { arg.type = LogArg::INT; arg.i = static_cast<int64_t>(value); }
+
+        static uint64_t now();
+
+    public:
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        /**
+         * Stops the writer thread after writing all pending messages.
+         */
+        ~Logger();
+
+        /**
+         * Returns the process-wide logger.
+         */
+        static Logger& instance();
+
+        /**
+         * Captures a message into the calling thread's ring. Never blocks and never allocates
+         * after the first call on a thread. Prefer the COUP_LOG_* macros for level elimination.
+         */
+        template <typename... Args>
+        void log(LogLevel level, const char* format, const Args&... args) {
+            static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+            LogRing& ring = localRing();
+            LogRecord* record = ring.acquire();
+            if (record == nullptr) {
+                return; // Ring full - dropped and counted
+            }
+
+            record->timestamp_ns = now();
+            record->format = format;
+            record->level = level;
+            record->arg_count = sizeof...(Args);
+            record->text_used = 0;
+            size_t index = 0;
+            (void)index;
+            int expand[] = {0, (capture(*record, record->args[index++], args), 0)...};
+            (void)expand;
+            ring.publish();
+        }
+
+        /**
+         * Replaces the output with a callback that receives formatted text in batches.
+         * Passing null restores the default (stdout).
+         */
+        void setSink(std::function<void(const std::string&)> new_sink);
+
+        /**
+         * Blocks until every message logged before the call has been written.
+         */
+        void flush();
+
+        /**
+         * Returns the number of messages dropped because a ring was full.
+         */
+        uint64_t droppedCount();
+
+        /**
+         * Formats a captured message (without level prefix or newline).
+         */
+        static std::string format(const LogRecord& record);
+
+        /**
+         * Converts a level to its display name.
+         */
+        static const char* getLevelName(LogLevel level);
+    };
+}
+
+#endif
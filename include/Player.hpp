@@ -11,9 +11,10 @@
 #define PLAYER_HPP
 
 #include <string>
+#include "Game.hpp" // For RoleType
+#include "ActionError.hpp"
 
 namespace coup {
-    class Game; // Forward declaration to avoid circular dependency
 
     /**
      * Base player class representing a participant in the Coup game.
@@ -28,9 +29,22 @@ namespace coup {
         bool active; // Whether player is still in the game (not eliminated)
         bool sanctioned; // Whether player is blocked from economic actions
         bool arrest_available; // Whether another player can arrest this player
-        bool bribe_used; // Whether player used bribe action this turn
-        bool used_tax_last_action; // Tracks if tax was the most recent action
-        Player* couped_by; // Pointer to player who performed coup on this player
+        bool bribe_used; // Whether player used bribe action this turn (a Judge may block it until the turn ends)
+        bool used_tax_last_action; // Tracks if tax was the most recent action (a Governor may undo it)
+        Player* couped_by; // Pointer to player who performed coup on this player (a General may block it until Game::nextTurn clears it)
+
+        friend class Game; // Game restores snapshot state directly into the fields
+
+        /**
+         * Checks the preconditions of every turn action (game started, player's turn, player active).
+         * Returns the first violated rule, or ActionError::NONE.
+         */
+        ActionError checkTurnAction() const;
+
+        /**
+         * Ends a turn action - keeps the turn after a bribe, otherwise passes it on.
+         */
+        void finishTurnAction();
 
     public:
         /**
@@ -111,6 +125,12 @@ namespace coup {
          */
         virtual std::string getRoleType() const { return "Player"; }
 
+        /**
+         * Gets the role type as an enumeration value.
+         * Cheaper than getRoleType() for engine code that compares roles often.
+         */
+        virtual RoleType getRole() const { return RoleType::PLAYER; }
+
         /**
          * Gather action - takes 1 coin from the treasury.
          * Basic economic action available to all players.
@@ -120,10 +140,10 @@ namespace coup {
         
         /**
          * Tax action - takes 2 coins from the treasury.
-         * Virtual method as some roles modify the coin amount.
+         * Some roles modify the coin amount by overriding tryTax().
          * Cannot be used when sanctioned.
          */
-        virtual void tax();
+        void tax();
         
         /**
          * Bribe action - pays 4 coins for an additional action.
@@ -150,6 +170,18 @@ namespace coup {
          */
         void coup(Player& target);
 
+        /**
+         * No-throw versions of the actions above.
+         * Apply the action and return success, or leave the game untouched and return
+         * the rule that rejected it. The throwing methods wrap these.
+         */
+        ActionResult tryGather();
+        virtual ActionResult tryTax();
+        ActionResult tryBribe();
+        ActionResult tryArrest(Player& target);
+        ActionResult trySanction(Player& target);
+        ActionResult tryCoup(Player& target);
+
         /**
          * Adds coins to the player's treasury.
          * Used by various actions and role abilities.
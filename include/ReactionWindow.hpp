@@ -0,0 +1,105 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * ReactionWindow.hpp
+ * Explicit arbitration of reactive abilities.
+ * Player methods let a General block a coup, a Judge block a bribe and a Governor
+ * undo a tax whenever the flags left by the action (couped_by, bribe_used, the tax
+ * marker) allow it. The arbiter turns that into one window per action: opened right
+ * after a coup, bribe or tax, it lists the seats that may answer in priority order
+ * (seat order after the actor), takes their answers in any order and resolves
+ * exactly once - the first reaction in priority order wins, as soon as every seat
+ * ahead of it has passed. Seats that miss the deadline are passed by expire().
+ * Eligibility comes from an index of the seats holding each reactive role, so
+ * opening a window never scans the whole table.
+ *
+ * Scope: Game itself never opens a window. Only Match does, so bots, hosted tables
+ * and lockstep replicas share the arbitration. Direct Player calls and the GUI still
+ * react through the implicit flags: couped_by (cleared by Game::nextTurn), bribe_used
+ * and the tax marker (the GUI picks the reacting seat in showReactivePlayerSelection).
+ * The arbiter reads the same flags, so both paths follow the same rules.
+ */
+
+#ifndef REACTION_WINDOW_HPP
+#define REACTION_WINDOW_HPP
+
+#include <cstdint>
+#include "Action.hpp"
+#include "Snapshot.hpp"
+
+namespace coup {
+    class Game;
+
+    /**
+     * State of one window. Plain data, so searches can copy it next to a GameSnapshot.
+     */
+    struct ReactionWindow {
+        Action trigger; // Turn action that opened the window
+        uint8_t responders[SNAPSHOT_MAX_PLAYERS]; // Seats that may answer, in priority order
+        uint8_t responder_count; // Number of valid responders (0 when no window is open)
+        uint8_t next_responder; // Priority index of the first seat still to answer (responder_count once resolved)
+        uint8_t answered; // Bit per priority index: the seat has answered
+        uint8_t reacted; // Bit per priority index: the answer was the reaction
+
+        bool isOpen() const { return next_responder < responder_count; }
+    };
+
+    /**
+     * Opens, collects and resolves windows for one game. Built once the roster is complete.
+     */
+    class ReactionArbiter {
+    private:
+        uint8_t generals[SNAPSHOT_MAX_PLAYERS]; // Seats of every reactive role, in seat order
+        uint8_t general_count;
+        uint8_t judges[SNAPSHOT_MAX_PLAYERS];
+        uint8_t judge_count;
+        uint8_t governors[SNAPSHOT_MAX_PLAYERS];
+        uint8_t governor_count;
+
+        /**
+         * Checks if seat may answer the trigger in the current game state.
+         */
+        bool canAnswer(const Game& game, const Action& trigger, uint8_t seat) const;
+
+        /**
+         * Advances past the passes at the front and applies the winning reaction once decided.
+         */
+        void settle(Game& game, ReactionWindow& window) const;
+
+    public:
+        /**
+         * Indexes the seats of the reactive roles of the game.
+         */
+        explicit ReactionArbiter(const Game& game);
+
+        /**
+         * Builds the reactive action of seat that answers the trigger. Returns false for actions nobody answers.
+         */
+        static bool reactionFor(const Action& trigger, uint8_t seat, Action& reaction);
+
+        /**
+         * Opens the window of a turn action that was just applied. Returns false (and leaves
+         * the window closed) when nobody can answer it.
+         */
+        bool open(const Game& game, ReactionWindow& window, const Action& trigger) const;
+
+        /**
+         * Checks if seat has not answered the open window yet.
+         */
+        static bool isWaitingOn(const ReactionWindow& window, uint8_t seat);
+
+        /**
+         * Records the answer of a seat that is still waiting, in any order. The winning reaction
+         * is applied to the game once no seat ahead of it can still react. Returns true when the
+         * window resolved. Throws std::runtime_error if seat is not waiting in the window.
+         */
+        bool respond(Game& game, ReactionWindow& window, uint8_t seat, bool react) const;
+
+        /**
+         * Deadline reached: every seat that has not answered passes, and the window resolves.
+         */
+        void expire(Game& game, ReactionWindow& window) const;
+    };
+}
+
+#endif
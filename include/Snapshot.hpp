@@ -0,0 +1,80 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Snapshot.hpp
+ * Fixed-layout binary snapshot of a running game.
+ * Used for fast checkpointing of simulations and resuming GUI sessions.
+ * The layout is versioned and written in host byte order.
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <random> // Engine size is part of the layout
+#include <type_traits>
+
+namespace coup {
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x50554F43; // "COUP" in little-endian byte order
+    constexpr uint16_t SNAPSHOT_VERSION = 1; // Bump whenever the layout below changes
+    constexpr size_t SNAPSHOT_MAX_PLAYERS = 6; // Same limit as Game::addPlayer
+    constexpr size_t SNAPSHOT_NAME_SIZE = 10; // Player names are limited to 9 characters plus terminator
+    constexpr uint8_t SNAPSHOT_NO_SEAT = 0xFF; // Marks an empty player reference
+
+    /**
+     * Bit flags packed into PlayerRecord::flags.
+     * One bit per boolean status field of Player.
+     */
+    enum PlayerFlag : uint8_t {
+        FLAG_ACTIVE = 1 << 0, // Player is still in the game
+        FLAG_SANCTIONED = 1 << 1, // Player is blocked from economic actions
+        FLAG_ARREST_AVAILABLE = 1 << 2, // Player may perform arrest
+        FLAG_BRIBE_USED = 1 << 3, // Player has a pending bribe action
+        FLAG_USED_TAX = 1 << 4 // Tax was the player's last action
+    };
+
+    /**
+     * State of a single seat.
+     * Player references are stored as seat indices (SNAPSHOT_NO_SEAT for none).
+     */
+    struct PlayerRecord {
+        char name[SNAPSHOT_NAME_SIZE]; // Null-terminated player name, used to validate the roster
+        uint8_t role; // RoleType value of the seat
+        uint8_t flags; // Combination of PlayerFlag bits
+        int32_t coins; // Current coin count
+        uint8_t couped_by; // Seat of the player who performed coup on this seat
+        uint8_t reserved[3]; // Padding kept explicit so the layout is deterministic
+    };
+
+    /**
+     * Header of the snapshot blob.
+     * Carries the sizes needed to reject blobs written by a different layout.
+     */
+    struct SnapshotHeader {
+        uint32_t magic; // Always SNAPSHOT_MAGIC
+        uint16_t version; // Always SNAPSHOT_VERSION
+        uint16_t header_size; // sizeof(SnapshotHeader)
+        uint32_t total_size; // sizeof(GameSnapshot)
+        uint32_t rng_size; // sizeof(std::mt19937) of the writing build, 0 when the RNG state was not saved
+        uint8_t player_count; // Number of used entries in GameSnapshot::players
+        uint8_t game_started; // 1 if the game has started
+        uint8_t current_player_index; // Seat whose turn it is
+        uint8_t last_arrested; // Seat of the last arrested player
+    };
+
+    /**
+     * Complete fixed-size snapshot of a Game.
+     * Save and restore are plain memcpy operations of this structure.
+     */
+    struct GameSnapshot {
+        SnapshotHeader header; // Versioned header
+        PlayerRecord players[SNAPSHOT_MAX_PLAYERS]; // Seat records, unused entries are zeroed
+        unsigned char rng[sizeof(std::mt19937)]; // Raw random generator state, unspecified bytes when rng_size is 0
+    };
+
+    static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must be memcpy-able");
+    static_assert(std::is_trivially_copyable<std::mt19937>::value, "Random generator state must be memcpy-able");
+}
+
+#endif
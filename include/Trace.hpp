@@ -0,0 +1,149 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Trace.hpp
+ * Compact recording of a game as an action stream.
+ * A keyframe of the full state is written every K actions and every action in between
+ * is stored as one byte plus varint coin and flag deltas against a predicted state.
+ * The reader reconstructs any step by seeking to the nearest keyframe.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <functional>
+#include "Snapshot.hpp"
+#include "Action.hpp"
+
+namespace coup {
+    class Game; // Forward declaration to avoid circular dependency
+
+    constexpr uint32_t TRACE_MAGIC = 0x43525443; // "CTRC" in little-endian byte order
+    constexpr uint16_t TRACE_VERSION = 1; // Bump whenever the encoding below changes
+    constexpr uint16_t TRACE_DEFAULT_KEYFRAME_INTERVAL = 256; // Actions between two keyframes
+
+    /**
+     * Records a single game into a compact binary trace.
+     *
+     * Layout: header with the roster, then keyframe 0 followed by K action records,
+     * keyframe 1 followed by K records and so on, then the keyframe index and a footer.
+     * An action record is a single byte (type, target, residual flag) whenever the state
+     * change matches what the action normally does; anything else is stored as a residual
+     * of varint coin deltas and flag/turn/link changes, so reconstruction is always exact.
+     */
+    class TraceWriter {
+    private:
+        uint16_t keyframe_interval; // Number of actions between keyframes
+        std::vector<unsigned char> buffer; // Encoded trace
+        std::vector<uint64_t> keyframe_offsets; // Byte offset of every keyframe
+        GameSnapshot previous; // State after the last recorded action
+        GameSnapshot current; // Scratch snapshot of the state being recorded
+        GameSnapshot predicted; // Scratch snapshot of the predicted state
+        size_t action_count; // Number of recorded actions
+        bool started; // Whether begin() has been called
+        bool finished; // Whether finish() has been called
+
+        /**
+         * Appends the compact encoding of a full state.
+         */
+        void writeKeyframe(const GameSnapshot& state);
+
+    public:
+        /**
+         * Creates a writer that emits a keyframe every keyframe_interval actions.
+         * Throws exception if the interval is zero.
+         */
+        explicit TraceWriter(uint16_t keyframe_interval = TRACE_DEFAULT_KEYFRAME_INTERVAL);
+
+        /**
+         * Starts a new trace of the game in its current state.
+         * Discards any previously recorded data.
+         */
+        void begin(const Game& game);
+
+        /**
+         * Records an action that has just been applied to the game.
+         * Must be called after every state change to keep deltas small.
+         */
+        void record(const Action& action, const Game& game);
+
+        /**
+         * Appends the keyframe index and footer. No more actions can be recorded afterwards.
+         */
+        void finish();
+
+        /**
+         * Returns the encoded trace. Only complete after finish().
+         */
+        const std::vector<unsigned char>& data() const { return buffer; }
+
+        /**
+         * Returns the number of recorded actions.
+         */
+        size_t actionCount() const { return action_count; }
+    };
+
+    /**
+     * Decodes a trace produced by TraceWriter.
+     * Does not copy the data - the buffer must outlive the reader.
+     */
+    class TraceReader {
+    private:
+        const unsigned char* data; // Encoded trace
+        size_t size; // Size of the encoded trace
+        uint16_t keyframe_interval; // Number of actions between keyframes
+        size_t action_count; // Number of recorded actions
+        std::vector<uint64_t> keyframe_offsets; // Byte offset of every keyframe
+        GameSnapshot roster; // Empty state carrying the header and the seat names and roles
+
+        /**
+         * Decodes the keyframe at pos into state and advances pos.
+         */
+        void readKeyframe(size_t& pos, GameSnapshot& state) const;
+
+        /**
+         * Decodes the action record at pos, applies it to state and advances pos.
+         */
+        void readRecord(size_t& pos, GameSnapshot& state, Action& action) const;
+
+    public:
+        /**
+         * Parses the header, index and footer of a finished trace.
+         * Throws exception if the data is not a valid trace.
+         */
+        TraceReader(const unsigned char* data, size_t size);
+
+        /**
+         * Returns the number of recorded actions.
+         */
+        size_t actionCount() const { return action_count; }
+
+        /**
+         * Returns the number of seats in the traced game.
+         */
+        size_t playerCount() const { return roster.header.player_count; }
+
+        /**
+         * Reconstructs the state after the given number of actions (0 is the initial state).
+         * The result carries no RNG state and can be passed to Game::loadSnapshot.
+         * Throws exception if step is past the end of the trace.
+         */
+        void stateAt(size_t step, GameSnapshot& out) const;
+
+        /**
+         * Returns the action recorded at the given index (0-based).
+         * Throws exception if index is past the end of the trace.
+         */
+        Action actionAt(size_t index) const;
+
+        /**
+         * Decodes the whole trace in order, calling visit with each action and the state after it.
+         */
+        void forEachAction(const std::function<void(size_t, const Action&, const GameSnapshot&)>& visit) const;
+    };
+}
+
+#endif
@@ -0,0 +1,77 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Varint.hpp
+ * LEB128-style variable length integer helpers.
+ * Small values take a single byte, used by the compact binary formats.
+ */
+
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <stdexcept>
+
+namespace coup {
+    /**
+     * Maps signed values to unsigned so small magnitudes stay small (0,-1,1,-2 -> 0,1,2,3).
+     */
+    inline uint64_t zigzagEncode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    /**
+     * Reverses zigzagEncode.
+     */
+    inline int64_t zigzagDecode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /**
+     * Appends an unsigned varint, 7 bits per byte with the high bit as continuation flag.
+     */
+    inline void writeVarint(std::vector<unsigned char>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    /**
+     * Appends a signed value as a zigzag varint.
+     */
+    inline void writeSignedVarint(std::vector<unsigned char>& out, int64_t value) {
+        writeVarint(out, zigzagEncode(value));
+    }
+
+    /**
+     * Reads an unsigned varint starting at pos and advances pos.
+     * Throws exception if the value runs past end or is longer than 10 bytes.
+     */
+    inline uint64_t readVarint(const unsigned char* data, size_t size, size_t& pos) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= size) {
+                throw std::runtime_error("Truncated varint");
+            }
+            unsigned char byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Varint is too long");
+    }
+
+    /**
+     * Reads a zigzag varint starting at pos and advances pos.
+     */
+    inline int64_t readSignedVarint(const unsigned char* data, size_t size, size_t& pos) {
+        return zigzagDecode(readVarint(data, size, pos));
+    }
+}
+
+#endif
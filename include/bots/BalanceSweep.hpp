@@ -0,0 +1,109 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * BalanceSweep.hpp
+ * Role balance under changed rules.
+ * A sweep walks the grid spanned by a few rule parameters (every combination of
+ * their values) and plays a batch of bot games at every grid point, counting how
+ * often each role wins per seat it was dealt. All games of all points are split
+ * into chunks that the worker threads pull from one shared counter, and every game
+ * is seeded by its point and number, so the counts do not depend on the threads.
+ */
+
+#ifndef BALANCE_SWEEP_HPP
+#define BALANCE_SWEEP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../Game.hpp"
+
+namespace coup {
+    constexpr size_t SWEEP_ROLE_COUNT = 6; // Playable roles (RoleType::PLAYER excluded)
+
+    /**
+     * Rule parameters a sweep can vary.
+     */
+    enum class RuleParameter {
+        INVEST_PAYOUT, // GameRules::invest_payout
+        TAX_BONUS, // GameRules::tax_bonus
+        BLOCK_COUP_COST, // GameRules::block_coup_cost
+        MERCHANT_THRESHOLD, // GameRules::merchant_threshold
+        JUDGE_SURCHARGE, // GameRules::judge_surcharge
+        COUP_COST // GameRules::coup_cost
+    };
+
+    /**
+     * Command-line name of a parameter (e.g. "coup_cost").
+     */
+    std::string getRuleParameterName(RuleParameter parameter);
+
+    /**
+     * Parses a parameter name. Throws exception for unknown names.
+     */
+    RuleParameter parseRuleParameter(const std::string& name);
+
+    /**
+     * The field of a rule set that a parameter controls.
+     */
+    int& ruleField(GameRules& rules, RuleParameter parameter);
+
+    /**
+     * One dimension of the grid.
+     */
+    struct SweepAxis {
+        RuleParameter parameter; // Varied parameter
+        std::vector<int> values; // Values tried, in output order
+    };
+
+    /**
+     * Bots seated at every table.
+     */
+    enum class SweepBots {
+        RANDOM, // Uniform random moves
+        HEURISTIC // HeuristicBot with default weights
+    };
+
+    /**
+     * Sweep settings.
+     */
+    struct SweepConfig {
+        std::vector<SweepAxis> axes; // Grid dimensions (none sweeps just the base rules)
+        GameRules base; // Values of the parameters that are not swept
+        unsigned players = 4; // Seats per game (2-6)
+        uint64_t games_per_point = 10000; // Games per grid point
+        unsigned threads = 1; // Worker threads
+        uint32_t chunk = 256; // Games per work item
+        uint32_t max_steps = 300; // Decision cap per game (a draw when reached)
+        SweepBots bots = SweepBots::HEURISTIC; // Policy of every seat
+        uint32_t seed = 1; // Base seed of the deals and the bots
+    };
+
+    /**
+     * Counts of one grid point. Roles are indexed by RoleType.
+     */
+    struct SweepPoint {
+        GameRules rules; // Rules played
+        std::vector<int> values; // Value of every axis
+        uint64_t games = 0; // Games played
+        uint64_t draws = 0; // Games ended by the step cap
+        uint64_t dealt[SWEEP_ROLE_COUNT] = {}; // Seats dealt each role
+        uint64_t wins[SWEEP_ROLE_COUNT] = {}; // Wins of each role
+
+        /**
+         * Wins per seat dealt for a role (0 when never dealt).
+         */
+        double winRate(RoleType role) const;
+    };
+
+    /**
+     * Runs a sweep and returns one point per grid cell, last axis varying fastest.
+     * The callback (optional) is told how many games are done so far.
+     */
+    std::vector<SweepPoint> runBalanceSweep(const SweepConfig& config,
+                                            const std::function<void(uint64_t, uint64_t)>& on_progress = nullptr);
+}
+
+#endif
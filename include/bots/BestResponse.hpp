@@ -0,0 +1,122 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * BestResponse.hpp
+ * Exploitability of a fixed bot policy.
+ * The policy is played by every seat except one responder. A depth-limited
+ * expectimax search takes the best move at the responder's decisions and the
+ * policy's expectation everywhere else; the same search with the responder also
+ * following the policy gives the policy's own value. Their difference is how much
+ * a best-responding opponent gains - the exploitability estimate. Leaves are
+ * scored by policy self-play rollouts seeded from the position, so every value is
+ * deterministic and can be cached.
+ * Root moves are searched in parallel and all threads share one lock-free
+ * transposition table.
+ */
+
+#ifndef BEST_RESPONSE_HPP
+#define BEST_RESPONSE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Match.hpp"
+#include "Cfr.hpp"
+
+namespace coup {
+    /**
+     * A fixed stochastic policy: probabilities of the deciding seat's moves.
+     */
+    class MovePolicy {
+    public:
+        virtual ~MovePolicy() = default;
+
+        /**
+         * Fills out with one probability per move (summing to 1). Must be thread-safe.
+         */
+        virtual void probabilities(const Match& match, const std::vector<Move>& moves, std::vector<double>& out) const = 0;
+    };
+
+    /**
+     * Every legal move is equally likely (the RandomBot policy).
+     */
+    class UniformPolicy : public MovePolicy {
+    public:
+        void probabilities(const Match& match, const std::vector<Move>& moves, std::vector<double>& out) const override;
+    };
+
+    /**
+     * The average strategy of a CFR policy file (the CfrBot policy).
+     */
+    class CfrMovePolicy : public MovePolicy {
+    private:
+        const CfrPolicy& policy; // Trained weights (borrowed)
+
+    public:
+        explicit CfrMovePolicy(const CfrPolicy& policy) : policy(policy) {}
+
+        void probabilities(const Match& match, const std::vector<Move>& moves, std::vector<double>& out) const override;
+    };
+
+    /**
+     * Search settings.
+     */
+    struct BestResponseConfig {
+        unsigned depth = 3; // Decisions searched before leaves are scored by rollouts
+        unsigned leaf_rollouts = 4; // Policy self-play games per leaf
+        uint32_t max_rollout_moves = 200; // Moves per rollout before it is scored as a draw
+        unsigned threads = 1; // Workers sharing the root moves
+        size_t table_entries = 1 << 18; // Transposition table slots (rounded up to a power of two)
+        uint32_t seed = 1; // Mixed into the rollout seeds
+    };
+
+    /**
+     * Values for the responder (expected reward, 1 for a win).
+     */
+    struct BestResponseResult {
+        double best_response = 0; // Value when the responder plays its best response
+        double policy_value = 0; // Value when the responder follows the policy
+        double exploitability = 0; // best_response - policy_value
+        uint64_t nodes = 0; // Positions searched
+        uint64_t table_hits = 0; // Positions answered by the transposition table
+        double elapsed_ms = 0; // Wall-clock time
+    };
+
+    /**
+     * Lock-free transposition table - each slot keeps the value and the key xor the value,
+     * so a torn write from another thread is detected and treated as a miss.
+     */
+    class TranspositionTable {
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> checks; // key ^ value bits per slot
+        std::unique_ptr<std::atomic<uint64_t>[]> values; // Value bits per slot
+        size_t mask; // Slots - 1
+
+    public:
+        explicit TranspositionTable(size_t entries);
+
+        bool probe(uint64_t key, double& value) const;
+        void store(uint64_t key, double value);
+    };
+
+    /**
+     * Best-response search against one policy.
+     */
+    class BestResponse {
+    private:
+        const MovePolicy& policy; // Policy of the other seats
+        BestResponseConfig config; // Search settings
+
+    public:
+        BestResponse(const MovePolicy& policy, const BestResponseConfig& config = BestResponseConfig());
+
+        /**
+         * Evaluates the position of a match for the responder seat.
+         */
+        BestResponseResult evaluate(const Match& match, uint8_t responder) const;
+    };
+}
+
+#endif
@@ -0,0 +1,122 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Bot.hpp
+ * Interface of automated players.
+ * A bot looks at a Match and returns one of the moves of the deciding seat;
+ * it never changes the game itself.
+ */
+
+#ifndef BOT_HPP
+#define BOT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "Match.hpp"
+
+namespace coup {
+    /**
+     * Hard limit of one real-time decision. Anytime bots stop searching at the
+     * deadline, or as soon as the stop flag is raised, and return their best move so far.
+     */
+    struct DecisionLimit {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(); // End of the turn
+        const std::atomic<bool>* stop = nullptr; // Raised by a watchdog to end the search early, may be null
+
+        /**
+         * Limit ending the given number of milliseconds from now.
+         */
+        static DecisionLimit in(double milliseconds);
+
+        /**
+         * Returns true when the deadline has passed or the stop flag is raised.
+         */
+        bool expired() const;
+    };
+
+    /**
+     * Base class of all bots.
+     */
+    class Bot {
+    public:
+        virtual ~Bot() = default;
+
+        /**
+         * Chooses a move for the deciding seat of the match.
+         * The match must not be over.
+         */
+        virtual Move chooseMove(const Match& match) = 0;
+
+        /**
+         * Chooses a move within a hard limit. Anytime bots override this to cut their
+         * search short; by default the limit is ignored and chooseMove is called.
+         */
+        virtual Move chooseMoveWithin(const Match& match, const DecisionLimit& limit) {
+            (void)limit;
+            return chooseMove(match);
+        }
+
+        /**
+         * Called once before the first decision of a match played by playMatch.
+         * Does nothing by default.
+         */
+        virtual void start(const Match& match) { (void)match; }
+
+        /**
+         * Called after every move applied in the match (by any seat), so bots
+         * can follow the public history. Does nothing by default.
+         */
+        virtual void observe(const Match& match, const Move& move) { (void)match; (void)move; }
+
+        /**
+         * Short name for logs and tournament tables.
+         */
+        virtual std::string getName() const = 0;
+    };
+
+    /**
+     * Picks a uniformly random legal move. Baseline opponent and fuzzer.
+     */
+    class RandomBot : public Bot {
+    private:
+        std::mt19937 rng; // Move selection
+        std::vector<Move> options; // Reused move buffer
+
+    public:
+        explicit RandomBot(uint32_t seed = 1) : rng(seed) {}
+
+        Move chooseMove(const Match& match) override;
+        std::string getName() const override { return "Random"; }
+    };
+
+    /**
+     * Scripted player - plays the first legal move whose action type comes earliest
+     * in a fixed priority list, aimed at the richest target. Passes when no listed
+     * action is legal in a reaction window, otherwise plays the first legal move.
+     * Deterministic stand-in for human opening books in tournaments and tests.
+     */
+    class ScriptedBot : public Bot {
+    private:
+        std::vector<ActionType> priorities; // Preferred action types, best first
+        std::string name; // Name in tournament tables
+        std::vector<Move> options; // Reused move buffer
+
+    public:
+        ScriptedBot(const std::vector<ActionType>& priorities, const std::string& name = "Scripted")
+        : priorities(priorities), name(name) {}
+
+        Move chooseMove(const Match& match) override;
+        std::string getName() const override { return name; }
+    };
+
+    /**
+     * Plays the match to the end with one bot per seat (bots may repeat).
+     * Returns the winning seat, or -1 for a draw by step cap.
+     */
+    int playMatch(Match& match, const std::vector<Bot*>& seats);
+}
+
+#endif
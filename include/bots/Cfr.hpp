@@ -0,0 +1,153 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Cfr.hpp
+ * Monte Carlo CFR+ over an abstraction of the game.
+ * Information sets are abstracted to the deciding seat's role, coin bucket and
+ * flags, the richest opponent's role and coin bucket, the number of opponents
+ * and the open reaction window. Abstract actions are the action types plus the
+ * pass; targeted actions aim at the richest legal target. Every abstract
+ * information set has a fixed index, so regrets, strategy sums and the final
+ * policy are flat arrays queried in O(1).
+ * Training uses external sampling near the root of every traversal and
+ * strategy rollouts below it; worker threads update shared atomic regrets
+ * without locks (CFR+ floors regrets at zero, averaging is linear).
+ */
+
+#ifndef CFR_HPP
+#define CFR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Match.hpp"
+
+namespace coup {
+    constexpr size_t CFR_ACTIONS = ACTION_TYPE_COUNT + 1; // Action types plus the pass
+    constexpr size_t CFR_PASS = ACTION_TYPE_COUNT; // Abstract index of declining a window
+    constexpr size_t CFR_COIN_BUCKETS = 6; // 0, 1-2, 3-4, 5-6, 7-9, 10+
+    constexpr size_t CFR_INFOSETS = 7 * CFR_COIN_BUCKETS * CFR_COIN_BUCKETS * 7 * 5 * 4 * 8; // Abstract information sets
+    constexpr uint32_t CFR_POLICY_MAGIC = 0x31504643; // "CFP1" in little-endian byte order
+    constexpr uint32_t CFR_CHECKPOINT_MAGIC = 0x31434643; // "CFC1" in little-endian byte order
+    constexpr uint16_t CFR_VERSION = 1; // Bump whenever a file layout changes
+
+    /**
+     * Concrete move behind every abstract action of a position (-1 when not legal).
+     */
+    struct AbstractMoves {
+        int16_t index[CFR_ACTIONS]; // Index into the move list
+    };
+
+    /**
+     * Returns the abstract information set of the deciding seat.
+     */
+    size_t abstractInfoSet(const Match& match);
+
+    /**
+     * Maps the legal moves of the deciding seat to abstract actions.
+     * Targeted actions keep the move against the richest target.
+     */
+    void abstractMoves(const Match& match, const std::vector<Move>& moves, AbstractMoves& out);
+
+    /**
+     * Training settings.
+     */
+    struct CfrConfig {
+        unsigned players = 2; // Seats per training game (2-6), roles drawn at random
+        unsigned threads = 1; // Workers sharing the regret tables
+        unsigned branch_depth = 2; // Traverser decisions explored with every action before rollouts take over
+        uint32_t prefix_moves = 40; // Traversals start after up to this many strategy moves from the opening
+        uint32_t max_steps = 300; // Step cap of training games (draw)
+        uint64_t checkpoint_every = 0; // Iterations between checkpoints, 0 to disable
+        std::string checkpoint_path; // Checkpoint file (written atomically by rename)
+        uint32_t seed = 1; // Base seed of the workers
+    };
+
+    /**
+     * Fixed-layout header of checkpoint and policy files.
+     * A checkpoint is followed by CFR_INFOSETS * CFR_ACTIONS regrets and strategy sums (float),
+     * a policy by CFR_INFOSETS * CFR_ACTIONS probabilities quantized to uint8_t.
+     */
+    struct CfrFileHeader {
+        uint32_t magic; // CFR_POLICY_MAGIC or CFR_CHECKPOINT_MAGIC
+        uint16_t version; // Always CFR_VERSION
+        uint16_t header_size; // sizeof(CfrFileHeader)
+        uint32_t infosets; // Always CFR_INFOSETS
+        uint32_t actions; // Always CFR_ACTIONS
+        uint64_t iterations; // Iterations trained
+    };
+
+    /**
+     * Multi-threaded MCCFR+ trainer.
+     */
+    class CfrTrainer {
+    private:
+        CfrConfig config; // Training settings
+        std::unique_ptr<std::atomic<float>[]> regrets; // Cumulative positive regrets
+        std::unique_ptr<std::atomic<float>[]> strategy_sums; // Weighted sums of the current strategies
+        std::atomic<uint64_t> iterations; // Iterations finished
+
+    public:
+        explicit CfrTrainer(const CfrConfig& config = CfrConfig());
+
+        CfrTrainer(const CfrTrainer&) = delete;
+        CfrTrainer& operator=(const CfrTrainer&) = delete;
+
+        /**
+         * Runs more iterations (writing checkpoints on the way if configured).
+         */
+        void train(uint64_t count);
+
+        uint64_t getIterations() const { return iterations.load(); }
+        const CfrConfig& getConfig() const { return config; }
+
+        /**
+         * Current regret-matching strategy of an information set over the legal abstract actions.
+         */
+        void currentStrategy(size_t infoset, const AbstractMoves& legal, float* out) const;
+
+        /**
+         * Adds to a regret (floored at zero) and to a strategy sum - safe from any thread.
+         */
+        void addRegret(size_t infoset, size_t action, float delta);
+        void addStrategy(size_t infoset, size_t action, float delta);
+
+        /**
+         * Saves or restores the full training state.
+         */
+        void saveCheckpoint(const std::string& path) const;
+        void loadCheckpoint(const std::string& path);
+
+        /**
+         * Writes the average strategy as a quantized policy file.
+         */
+        void writePolicy(const std::string& path) const;
+    };
+
+    /**
+     * Quantized average strategy loaded from a policy file.
+     */
+    class CfrPolicy {
+    private:
+        std::vector<uint8_t> weights; // CFR_ACTIONS weights per information set
+        uint64_t iterations; // Iterations behind the policy
+
+    public:
+        /**
+         * Loads a policy file. Throws if the file is missing or malformed.
+         */
+        explicit CfrPolicy(const std::string& path);
+
+        /**
+         * Returns the CFR_ACTIONS weights of an information set (all zero if never trained).
+         */
+        const uint8_t* row(size_t infoset) const { return &weights[infoset * CFR_ACTIONS]; }
+
+        uint64_t getIterations() const { return iterations; }
+    };
+}
+
+#endif
@@ -0,0 +1,37 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * CfrBot.hpp
+ * Plays the average strategy of a trained CFR policy.
+ * Every decision is one O(1) row lookup: the abstract information set of the
+ * position selects the weights, an abstract action is sampled among the legal
+ * ones and mapped back to its concrete move.
+ */
+
+#ifndef CFR_BOT_HPP
+#define CFR_BOT_HPP
+
+#include <random>
+#include <vector>
+#include "Bot.hpp"
+#include "Cfr.hpp"
+
+namespace coup {
+    /**
+     * Samples moves from a CfrPolicy.
+     */
+    class CfrBot : public Bot {
+    private:
+        const CfrPolicy& policy; // Trained weights (borrowed, usually shared by many bots)
+        std::mt19937 rng; // Sampling
+        std::vector<Move> options; // Reused move buffer
+
+    public:
+        explicit CfrBot(const CfrPolicy& policy, uint32_t seed = 1) : policy(policy), rng(seed) {}
+
+        Move chooseMove(const Match& match) override;
+        std::string getName() const override { return "CFR"; }
+    };
+}
+
+#endif
@@ -0,0 +1,133 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * DeadlineBot.hpp
+ * Watchdog for real-time turns.
+ * Wraps any bot and guarantees that every decision returns by its deadline, even
+ * when the machine is overloaded and the search thread is not scheduled in time.
+ * The wrapped bot runs on a persistent worker thread against a private copy of the
+ * position. The calling thread computes a heuristic fallback move, waits until
+ * shortly before the deadline, raises the stop flag (anytime bots then return their
+ * best move so far) and waits out the safety margin. If the worker still has not
+ * answered, the fallback is played and the late answer is dropped. Starts and moves
+ * observed while the worker is busy are queued with a copy of the match and handed to
+ * the wrapped bot before its next decision, so the table never waits for a late search.
+ */
+
+#ifndef DEADLINE_BOT_HPP
+#define DEADLINE_BOT_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "Bot.hpp"
+#include "HeuristicBot.hpp"
+
+namespace coup {
+    class GameClone;
+
+    /**
+     * Counters of the watchdog.
+     */
+    struct DeadlineStats {
+        uint64_t decisions = 0; // Decisions requested
+        uint64_t searched = 0; // Decisions answered by the wrapped bot in time
+        uint64_t fallbacks = 0; // Decisions answered by the heuristic fallback
+        uint64_t skipped = 0; // Fallbacks because the worker was still busy with an earlier turn
+        double max_latency_ms = 0; // Slowest decision as seen by the caller
+    };
+
+    /**
+     * Deadline-enforcing wrapper around another bot.
+     */
+    class DeadlineBot : public Bot {
+    private:
+        std::unique_ptr<Bot> inner; // Wrapped bot, only called on the worker thread (or while it is idle)
+        double budget_ms; // Turn length used by chooseMove
+        double margin_ms; // Time kept between the stop signal and the deadline
+        HeuristicWeights weights; // Fallback scoring
+        std::mt19937 rng; // Fallback noise
+        std::vector<Move> options; // Reused move buffer
+        DeadlineStats stats; // Watchdog counters
+
+        // Worker state, guarded by mutex
+        std::mutex mutex;
+        std::condition_variable wake; // Signals a new task or shutdown to the worker
+        std::condition_variable done; // Signals a finished task to the caller
+        bool busy; // The worker is running a task
+        bool quit; // The worker must exit
+        uint64_t task; // Sequence number of the last dispatched task
+        std::unique_ptr<GameClone> clone; // Private copy of the decision position
+        std::unique_ptr<Match> position; // Match over the clone
+        DecisionLimit task_limit; // Limit handed to the wrapped bot
+        Move answer; // Result of the last task
+        std::exception_ptr error; // Failure of the last task
+        std::atomic<bool> stop; // Stop flag of the current task
+        std::thread worker; // Runs the wrapped bot
+
+        /**
+         * A start or an observed move that arrived while the worker was busy.
+         */
+        struct PendingEvent {
+            std::unique_ptr<GameClone> clone; // Game as it was when the event arrived
+            std::unique_ptr<Match> match; // Match over the clone
+            Move move; // Observed move (unused for a start)
+            bool start; // A new match rather than a move
+        };
+        std::deque<PendingEvent> pending; // Events not yet given to the wrapped bot, guarded by mutex
+
+        void workerLoop();
+
+        /**
+         * Copies the match into the queue of events for the wrapped bot.
+         */
+        void enqueue(const Match& match, const Move& move, bool start);
+
+        /**
+         * Gives the queued events to the wrapped bot. The lock must be held and the worker idle.
+         */
+        void replayPending();
+
+        /**
+         * Waits until the worker is idle, up to the given time point. Returns true if it is idle.
+         */
+        bool waitIdle(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point until);
+
+    public:
+        /**
+         * Wraps the bot. budget_ms is the turn length of chooseMove, margin_ms the part of
+         * every turn reserved for stopping the search and handing the move back.
+         */
+        DeadlineBot(std::unique_ptr<Bot> inner, double budget_ms, double margin_ms = 2.0, uint32_t seed = 1);
+        ~DeadlineBot() override;
+
+        DeadlineBot(const DeadlineBot&) = delete;
+        DeadlineBot& operator=(const DeadlineBot&) = delete;
+
+        /**
+         * Decides within budget_ms from now.
+         */
+        Move chooseMove(const Match& match) override;
+
+        /**
+         * Decides by the deadline of the limit or budget_ms from now, whichever comes
+         * first (the stop flag of the limit is not watched).
+         */
+        Move chooseMoveWithin(const Match& match, const DecisionLimit& limit) override;
+
+        void start(const Match& match) override;
+        void observe(const Match& match, const Move& move) override;
+        std::string getName() const override { return inner->getName(); }
+
+        const DeadlineStats& getStats() const { return stats; }
+        Bot& getInner() { return *inner; }
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Evolution.hpp
+ * Evolutionary tuning of HeuristicBot weights.
+ * A population of weight vectors is scored by playing each candidate against a
+ * reference pool, then the next generation keeps the elite and breeds the rest
+ * by tournament selection, uniform crossover and Gaussian mutation. Every candidate
+ * plays the same deals and opponents (common random numbers), so fitness
+ * differences come from the weights rather than the luck of the draw.
+ * Evaluation runs on a persistent pool of workers; each worker keeps one clone per
+ * role deal and reloads its start snapshot, so no game or thread is built per game.
+ * The population is checkpointed to disk after every generation.
+ */
+
+#ifndef EVOLUTION_HPP
+#define EVOLUTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "HeuristicBot.hpp"
+
+namespace coup {
+    constexpr size_t HEURISTIC_GENES = ACTION_TYPE_COUNT + 4; // Action weights, pass, target coins, threat, noise
+    constexpr uint32_t EVOLUTION_MAGIC = 0x31564543; // "CEV1" in little-endian byte order
+    constexpr uint16_t EVOLUTION_VERSION = 1; // Bump whenever the checkpoint layout changes
+
+    /**
+     * Flattens weights into a gene vector and back (actions first, then pass,
+     * target coins, target threat and noise).
+     */
+    void weightsToGenes(const HeuristicWeights& weights, double* genes);
+    HeuristicWeights genesToWeights(const double* genes);
+
+    /**
+     * Tuner settings.
+     */
+    struct EvolutionConfig {
+        unsigned population = 24; // Candidates per generation
+        unsigned elite = 4; // Best candidates copied unchanged
+        unsigned tournament = 3; // Candidates drawn per parent selection
+        double mutation_rate = 0.25; // Chance that a gene mutates
+        double mutation_scale = 0.5; // Standard deviation of a mutation
+        unsigned games = 400; // Games per candidate per generation
+        unsigned players = 2; // Seats per game (2-6)
+        unsigned threads = 1; // Evaluation workers (including the calling thread)
+        uint32_t max_steps = 300; // Decision cap per game (a draw when reached)
+        uint32_t seed = 1; // Seed of the deals, the bots and the breeding
+        std::string checkpoint_path; // Written after every generation when set
+    };
+
+    /**
+     * One weight vector and its latest score.
+     */
+    struct Candidate {
+        double genes[HEURISTIC_GENES]; // Encoded weights
+        double fitness = 0; // Share of games won (draws split among survivors)
+    };
+
+    /**
+     * Header of a population checkpoint, followed by the candidates.
+     */
+    struct EvolutionFileHeader {
+        uint32_t magic; // EVOLUTION_MAGIC
+        uint16_t version; // EVOLUTION_VERSION
+        uint16_t header_size; // sizeof(EvolutionFileHeader)
+        uint32_t genes; // Always HEURISTIC_GENES
+        uint32_t population; // Candidates that follow
+        uint64_t generation; // Generations evaluated so far
+    };
+
+    /**
+     * Generation loop. Not copyable - owns the worker threads.
+     */
+    class EvolutionTuner {
+    private:
+        class Workers; // Persistent evaluation pool
+
+        EvolutionConfig config; // Settings
+        std::vector<HeuristicWeights> pool; // Reference opponents
+        std::vector<Candidate> population; // Current generation
+        uint64_t generation = 0; // Generations evaluated
+        std::unique_ptr<Workers> workers; // Evaluation threads
+
+        void breed();
+
+    public:
+        /**
+         * Starts from the default weights plus mutated copies of them.
+         * An empty pool plays against the default weights.
+         */
+        EvolutionTuner(const EvolutionConfig& config, const std::vector<HeuristicWeights>& pool = {});
+        ~EvolutionTuner();
+
+        EvolutionTuner(const EvolutionTuner&) = delete;
+        EvolutionTuner& operator=(const EvolutionTuner&) = delete;
+
+        /**
+         * Scores every candidate, breeds the next generation and writes the checkpoint.
+         * Returns the best candidate of the scored generation.
+         */
+        Candidate step();
+
+        /**
+         * Fitness of one weight vector against the pool, on the deals of the current generation.
+         */
+        double evaluate(const HeuristicWeights& weights);
+
+        void saveCheckpoint(const std::string& path) const;
+        void loadCheckpoint(const std::string& path);
+
+        const std::vector<Candidate>& getPopulation() const { return population; }
+        uint64_t getGeneration() const { return generation; }
+    };
+}
+
+#endif
@@ -0,0 +1,72 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * HeuristicBot.hpp
+ * Fast rule-of-thumb bot.
+ * Scores every legal move with a small weighted formula and plays the best one.
+ * Used as an opponent on its own and as the rollout policy of the search bots.
+ */
+
+#ifndef HEURISTIC_BOT_HPP
+#define HEURISTIC_BOT_HPP
+
+#include <random>
+#include <vector>
+#include "Bot.hpp"
+
+namespace coup {
+    /**
+     * Tunable weights of the heuristic.
+     */
+    struct HeuristicWeights {
+        double action[ACTION_TYPE_COUNT]; // Base preference of each action type (indexed by ActionType)
+        double pass; // Preference for declining a reaction window
+        double target_coins; // Bonus per coin of the target (hit the rich)
+        double target_threat; // Bonus when the target can already coup (7+ coins)
+        double noise; // Upper bound of the random noise added to every score
+
+        /**
+         * Default weights - coup when possible, block what hurts, otherwise build coins.
+         */
+        HeuristicWeights();
+    };
+
+    /**
+     * Plays the highest scoring move.
+     */
+    class HeuristicBot : public Bot {
+    private:
+        HeuristicWeights weights; // Scoring weights
+        std::mt19937 rng; // Noise
+        std::vector<Move> options; // Reused move buffer
+
+    public:
+        explicit HeuristicBot(uint32_t seed = 1, const HeuristicWeights& weights = HeuristicWeights());
+
+        Move chooseMove(const Match& match) override;
+        std::string getName() const override { return "Heuristic"; }
+
+        /**
+         * Replaces the weights and restarts the noise - lets one bot serve many games.
+         */
+        void reset(const HeuristicWeights& new_weights, uint32_t seed) {
+            weights = new_weights;
+            rng.seed(seed);
+        }
+
+        const HeuristicWeights& getWeights() const { return weights; }
+
+        /**
+         * Scores one move of the deciding seat (higher is better, noise excluded).
+         */
+        static double score(const Game& game, const Move& move, const HeuristicWeights& weights);
+
+        /**
+         * Picks the best of the given moves - shared with search rollouts.
+         */
+        static const Move& pick(const Game& game, const std::vector<Move>& moves,
+                                const HeuristicWeights& weights, std::mt19937& rng);
+    };
+}
+
+#endif
@@ -0,0 +1,58 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * IsmctsBot.hpp
+ * Information-set MCTS bot for hidden-information house rules.
+ * The bot only reads its own seat and the public move stream (through an
+ * ObservationTracker). Every simulation samples a determinization consistent
+ * with what the seat knows, loads it into a cached clone and walks one shared
+ * tree keyed by moves; a child's exploration term counts how often it was
+ * available instead of how often its parent was visited (single-observer ISMCTS).
+ * Threads grow independent trees over different determinizations (root
+ * parallelism) and the root statistics are merged by move.
+ */
+
+#ifndef ISMCTS_BOT_HPP
+#define ISMCTS_BOT_HPP
+
+#include <cstdint>
+#include <memory>
+#include "Bot.hpp"
+#include "MctsBot.hpp"
+#include "Observation.hpp"
+
+namespace coup {
+    /**
+     * ISMCTS player of one seat. Must see every move of the match (playMatch does this).
+     */
+    class IsmctsBot : public Bot {
+    private:
+        uint8_t seat; // Seat played by this bot
+        MctsConfig config; // Search settings (shared with MctsBot)
+        HiddenInfoRules rules; // Information hidden from the bot
+        std::unique_ptr<ObservationTracker> tracker; // Knowledge of the seat, created per match
+        SearchStats stats; // Statistics of the last decision
+        uint32_t decisions; // Decisions made, mixed into the thread seeds
+
+    public:
+        IsmctsBot(uint8_t seat, const MctsConfig& config = MctsConfig(), const HiddenInfoRules& rules = HiddenInfoRules());
+        ~IsmctsBot() override;
+
+        void start(const Match& match) override;
+        void observe(const Match& match, const Move& move) override;
+        Move chooseMove(const Match& match) override;
+        Move chooseMoveWithin(const Match& match, const DecisionLimit& limit) override;
+        std::string getName() const override { return "ISMCTS"; }
+
+        uint8_t getSeat() const { return seat; }
+        const MctsConfig& getConfig() const { return config; }
+        const SearchStats& lastSearch() const { return stats; }
+
+        /**
+         * Returns the knowledge of the seat, or nullptr before the first decision or move.
+         */
+        const ObservationTracker* getTracker() const { return tracker.get(); }
+    };
+}
+
+#endif
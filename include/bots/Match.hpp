@@ -0,0 +1,144 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Match.hpp
+ * Decision sequence of a game played by bots.
+ * The engine lets reactive abilities be used at any time; bots need explicit decision
+ * points instead. After every turn action a Match opens a reaction window through the
+ * engine's ReactionArbiter: each seat that may answer the action (General coup block,
+ * Judge bribe block, Governor undo) decides in priority order to react or pass, until
+ * one reacts or all have passed. Hosted tables may also take the answers out of order.
+ */
+
+#ifndef MATCH_HPP
+#define MATCH_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../Action.hpp"
+#include "../ReactionWindow.hpp"
+#include "../Snapshot.hpp"
+
+namespace coup {
+    class Game; // Forward declaration to avoid circular dependency
+
+    /**
+     * One choice of a bot - an action, or declining a reaction window.
+     */
+    struct Move {
+        Action action; // Action to apply (actor is the deciding seat, type and target unused for a pass)
+        bool pass; // Decline the reaction window
+
+        static Move play(const Action& action) { return {action, false}; }
+        static Move decline(uint8_t seat) { return {{ActionType::GATHER, seat, NO_TARGET}, true}; }
+
+        bool operator==(const Move& other) const {
+            return pass == other.pass && (pass ? action.actor == other.action.actor : action == other.action);
+        }
+        bool operator!=(const Move& other) const { return !(*this == other); }
+    };
+
+    /**
+     * Bookkeeping of a Match that is not part of the Game state.
+     * Plain data, so searches can copy it next to a GameSnapshot.
+     */
+    struct MatchState {
+        ReactionWindow window; // Reaction window of the last turn action
+        uint32_t steps; // Turn actions and skipped turns so far (draw cap)
+    };
+
+    /**
+     * Drives a Game through bot decisions.
+     * The Game is borrowed; the Match only adds the reaction-window bookkeeping.
+     */
+    class Match {
+    private:
+        Game* game; // Game being played
+        MatchState state; // Reaction window and step counter
+        uint32_t max_steps; // Steps before the match is declared a draw
+        ReactionArbiter arbiter; // Reactive role index of the game
+        mutable std::vector<Action> scratch; // Legal action buffer reused by moves()
+
+        /**
+         * Passes turns of players that have no legal turn action.
+         */
+        void skipStuckPlayers();
+
+    public:
+        /**
+         * Starts driving a started game. max_steps bounds the length of the match.
+         */
+        explicit Match(Game& game, uint32_t max_steps = 1000);
+
+        /**
+         * Resumes a match on a game whose state matches the saved bookkeeping.
+         */
+        Match(Game& game, const MatchState& state, uint32_t max_steps = 1000);
+
+        Game& getGame() const { return *game; }
+        const MatchState& getState() const { return state; }
+        uint32_t getMaxSteps() const { return max_steps; }
+
+        /**
+         * Replaces the bookkeeping (used after reloading the game from a snapshot).
+         */
+        void reset(const MatchState& saved) { state = saved; }
+
+        /**
+         * Checks if a reaction window is waiting for answers.
+         */
+        bool inReactionWindow() const { return state.window.isOpen(); }
+
+        /**
+         * Returns the seat that decides next (in a window, the first seat in priority order still to answer).
+         */
+        uint8_t decidingSeat() const;
+
+        /**
+         * Checks if seat may move now: the deciding seat, or any seat still waiting in the reaction window.
+         */
+        bool mayAnswer(uint8_t seat) const;
+
+        /**
+         * Lists the moves of the deciding seat. In a reaction window the first move is the pass.
+         */
+        void moves(std::vector<Move>& out) const;
+
+        /**
+         * Applies a move of a seat that may answer and advances to the next decision. In a
+         * reaction window any waiting seat may answer; a reaction takes effect once every seat
+         * ahead of it in priority has passed. Throws the engine's exceptions for illegal actions.
+         */
+        void apply(const Move& move);
+
+        /**
+         * Passes every seat that has not answered the reaction window (its deadline passed).
+         */
+        void expireWindow();
+
+        /**
+         * Checks if the match has ended - one player left or the step cap reached.
+         */
+        bool isOver() const;
+
+        /**
+         * Returns the winning seat, or -1 while running or after a draw by step cap.
+         */
+        int winner() const;
+
+        /**
+         * Reward of a seat at the end of the match: 1 for the winner, 0 for the others; on a
+         * draw by step cap the survivors share 1 and eliminated seats get 0.
+         */
+        double reward(uint8_t seat) const;
+
+        /**
+         * 64-bit hash of the game and window state and the step counter. Equal hashes on two
+         * machines mean their replicas agree (player names and the RNG are not included).
+         * A nonzero salt gives a separate key space, e.g. for search caches keyed by depth.
+         */
+        uint64_t stateHash(uint64_t salt = 0) const;
+    };
+}
+
+#endif
@@ -0,0 +1,72 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * MctsBot.hpp
+ * Monte Carlo Tree Search bot (UCT).
+ * Every simulation reloads a private clone of the game from a snapshot of the
+ * decision position, walks the tree with UCT, expands one node and finishes the
+ * game with random or heuristic rollouts. With several threads each thread grows
+ * its own tree (root parallelism) and the root visit counts are summed.
+ */
+
+#ifndef MCTS_BOT_HPP
+#define MCTS_BOT_HPP
+
+#include <cstdint>
+#include "Bot.hpp"
+#include "HeuristicBot.hpp"
+
+namespace coup {
+    /**
+     * Policy used to finish a game after the tree.
+     */
+    enum class RolloutPolicy {
+        RANDOM, // Uniform random moves
+        HEURISTIC // HeuristicBot moves (stronger, a bit slower)
+    };
+
+    /**
+     * Search settings. The search stops at whichever budget runs out first.
+     */
+    struct MctsConfig {
+        uint32_t iterations = 0; // Simulations per thread, 0 for no limit
+        double time_budget_ms = 40.0; // Wall-clock budget per decision, 0 for no limit
+        unsigned threads = 1; // Independent trees searched in parallel
+        double exploration = 1.4; // UCT exploration constant
+        RolloutPolicy rollout = RolloutPolicy::HEURISTIC; // Rollout policy
+        uint32_t max_rollout_moves = 200; // Moves per rollout before it is scored as a draw
+        uint32_t seed = 1; // Base seed of the search threads
+        HeuristicWeights weights; // Weights of heuristic rollouts
+    };
+
+    /**
+     * Statistics of the last decision.
+     */
+    struct SearchStats {
+        uint64_t iterations = 0; // Simulations over all threads
+        uint64_t nodes = 0; // Tree nodes over all threads
+        double elapsed_ms = 0; // Wall-clock time of the decision
+    };
+
+    /**
+     * UCT search bot.
+     */
+    class MctsBot : public Bot {
+    private:
+        MctsConfig config; // Search settings
+        SearchStats stats; // Statistics of the last decision
+        uint32_t decisions; // Decisions made, mixed into the thread seeds
+
+    public:
+        explicit MctsBot(const MctsConfig& config = MctsConfig());
+
+        Move chooseMove(const Match& match) override;
+        Move chooseMoveWithin(const Match& match, const DecisionLimit& limit) override;
+        std::string getName() const override { return "MCTS"; }
+
+        const MctsConfig& getConfig() const { return config; }
+        const SearchStats& lastSearch() const { return stats; }
+    };
+}
+
+#endif
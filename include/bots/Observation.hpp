@@ -0,0 +1,105 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Observation.hpp
+ * What one seat knows about the game under hidden-information house rules.
+ * Turn order, eliminations, sanctions and every action taken are public. Coins of
+ * other players can be hidden (a Spy's spy_on reveals them) and so can roles (a
+ * role is revealed when its ability is used). The tracker follows the public move
+ * stream and keeps exact values where they are known and coin bounds elsewhere.
+ * Determinization samples the unknowns straight into a GameSnapshot, so searches
+ * never copy the engine itself.
+ */
+
+#ifndef OBSERVATION_HPP
+#define OBSERVATION_HPP
+
+#include <cstdint>
+#include <random>
+#include "Match.hpp"
+#include "../Game.hpp"
+
+namespace coup {
+    constexpr uint8_t ROLE_UNKNOWN = 0xFF; // Role of a seat that has not been revealed
+
+    /**
+     * House rules for hidden information.
+     */
+    struct HiddenInfoRules {
+        bool hidden_coins = true; // Coins of other players are secret
+        bool hidden_roles = true; // Roles of other players are secret
+    };
+
+    /**
+     * What the observer knows about one seat.
+     */
+    struct SeatObservation {
+        char name[SNAPSHOT_NAME_SIZE]; // Public name
+        uint8_t role; // RoleType value or ROLE_UNKNOWN
+        uint8_t flags; // Public PlayerFlag bits (active, sanctioned, arrest, bribe, tax)
+        uint8_t couped_by; // Public coup reference, SNAPSHOT_NO_SEAT if none
+        int16_t coins_low; // Lowest coin count consistent with the public history
+        int16_t coins_high; // Highest coin count consistent with the public history
+    };
+
+    /**
+     * Fixed-size view of the game from one seat.
+     */
+    struct ObservationView {
+        uint8_t observer; // Seat the view belongs to
+        uint8_t player_count; // Number of seats
+        uint8_t current_player_index; // Public turn
+        uint8_t last_arrested; // Public last arrested seat, SNAPSHOT_NO_SEAT if none
+        SeatObservation seats[SNAPSHOT_MAX_PLAYERS]; // Knowledge per seat
+    };
+
+    /**
+     * Maintains the ObservationView of one seat from the public move stream.
+     */
+    class ObservationTracker {
+    private:
+        HiddenInfoRules rules; // Which information is hidden
+        ObservationView current; // Knowledge so far
+
+        /**
+         * Narrows or shifts the coin bounds of a seat.
+         */
+        void addCoins(uint8_t seat, int low, int high);
+        void requireCoins(uint8_t seat, int minimum);
+        void capCoins(uint8_t seat, int maximum);
+        void revealRole(uint8_t seat, RoleType role);
+        bool roleIs(uint8_t seat, RoleType role) const;
+        bool roleMayBe(uint8_t seat, RoleType role) const;
+
+        /**
+         * Copies the public fields and the observer's own seat from the game.
+         */
+        void syncPublic(const Game& game);
+
+    public:
+        /**
+         * Starts tracking for observer. When tracking from the start of the game every seat
+         * is known to hold 0 coins; otherwise other seats start with wide bounds.
+         */
+        ObservationTracker(const Game& game, uint8_t observer, const HiddenInfoRules& rules = HiddenInfoRules(),
+                           bool from_start = true);
+
+        /**
+         * Updates the knowledge after a move was applied to the game.
+         * Only public information of the game is read (plus the observer's own seat
+         * and the coins revealed by the observer's own spy_on).
+         */
+        void update(const Game& game, const Move& move);
+
+        const ObservationView& view() const { return current; }
+        const HiddenInfoRules& getRules() const { return rules; }
+
+        /**
+         * Samples a full game state consistent with the view: unknown roles uniformly,
+         * unknown coins uniformly within their bounds. The snapshot has no RNG state.
+         */
+        void determinize(std::mt19937& rng, GameSnapshot& out) const;
+    };
+}
+
+#endif
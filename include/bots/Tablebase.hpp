@@ -0,0 +1,140 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tablebase.hpp
+ * Retrograde endgame tablebase for 2- and 3-player tables with bounded coins.
+ * The builder enumerates every position reachable from fresh turns (all coin
+ * splits up to the cap, every seat to move) through the Match decision sequence,
+ * including open reaction windows, so coup blocks by a General are solved like
+ * any other decision. Values are solved by retrograde analysis for every focal
+ * seat (the other seats play together against it), giving win, loss or draw by
+ * step cap plus the distance to the result. Positions whose result hinges on
+ * moves that leave the coin cap are stored as unknown.
+ * The table file is an open-addressing hash of packed positions that is loaded
+ * with mmap and probed in O(1).
+ */
+
+#ifndef TABLEBASE_HPP
+#define TABLEBASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Match.hpp"
+#include "../Game.hpp"
+
+namespace coup {
+    constexpr size_t TABLEBASE_MAX_PLAYERS = 3; // Largest table the key layout supports
+    constexpr uint8_t TABLEBASE_MAX_COINS = 15; // Coins are packed in 4 bits
+    constexpr uint32_t TABLEBASE_MAGIC = 0x31425443; // "CTB1" in little-endian byte order
+    constexpr uint16_t TABLEBASE_VERSION = 2; // Bump whenever the file layout or the meaning of a value changes
+
+    /**
+     * Result of a position for one focal seat under perfect play.
+     */
+    enum class TablebaseValue : uint8_t {
+        DRAW = 0, // Neither side can force a result - the step cap ends the match
+        WIN = 1, // The focal seat can force its win
+        LOSS = 2, // The other seats can prevent the focal seat from winning
+        UNKNOWN = 3 // Position is not in the table, or its result depends on moves that leave it
+    };
+
+    /**
+     * Value and distance (in decisions, saturated at 255) of a position for one seat.
+     */
+    struct TablebaseProbe {
+        TablebaseValue value;
+        uint8_t depth;
+    };
+
+    /**
+     * Fixed-layout file header, followed by capacity keys (uint64_t) and capacity infos (uint32_t).
+     */
+    struct TablebaseHeader {
+        uint32_t magic; // Always TABLEBASE_MAGIC
+        uint16_t version; // Always TABLEBASE_VERSION
+        uint16_t header_size; // sizeof(TablebaseHeader)
+        uint8_t player_count; // Seats of the table
+        uint8_t roles[TABLEBASE_MAX_PLAYERS]; // RoleType of every seat
+        uint8_t coin_cap; // Positions with more coins on any seat are not in the table
+        uint8_t reserved[3]; // Padding kept explicit so the layout is deterministic
+        uint64_t capacity; // Hash slots (power of two)
+        uint64_t entry_count; // Positions stored
+    };
+
+    /**
+     * Settings of a tablebase build.
+     */
+    struct TablebaseConfig {
+        std::vector<RoleType> roles; // Role of every seat (2 or 3 seats)
+        uint8_t coin_cap = 12; // Largest coin count of any seat inside the table
+        unsigned threads = 1; // Worker threads for enumeration and solving
+    };
+
+    /**
+     * Summary of a build.
+     */
+    struct TablebaseStats {
+        uint64_t positions = 0; // Positions in the table
+        uint64_t edges = 0; // Moves between positions (including moves leaving the table)
+        uint64_t wins = 0; // Positions won by the deciding seat
+        uint64_t losses = 0; // Positions lost by the deciding seat
+        uint64_t draws = 0; // Positions drawn for the deciding seat
+        uint64_t unknowns = 0; // Positions whose value for the deciding seat depends on moves leaving the table
+        double elapsed_ms = 0; // Wall-clock build time
+    };
+
+    /**
+     * Packs the position of a match into a table key.
+     * Returns false if the position cannot be in a table with this coin cap
+     * (too many seats or coins, or a window that cannot be packed).
+     */
+    bool packTablePosition(const Match& match, uint8_t coin_cap, uint64_t& key);
+
+    /**
+     * Enumerates, solves and writes a tablebase file. Throws on invalid settings or I/O errors.
+     */
+    TablebaseStats buildTablebase(const TablebaseConfig& config, const std::string& path);
+
+    /**
+     * Read-only tablebase mapped from a file.
+     */
+    class EndgameTable {
+    private:
+        void* mapping; // Whole file mapped read-only
+        size_t mapping_size; // Bytes mapped
+        const TablebaseHeader* header; // Start of the mapping
+        const uint64_t* keys; // Hash slots, 0 when empty
+        const uint32_t* infos; // Packed value and depth of every focal seat per slot
+
+    public:
+        /**
+         * Maps a table file. Throws if the file is missing or malformed.
+         */
+        explicit EndgameTable(const std::string& path);
+        ~EndgameTable();
+
+        EndgameTable(const EndgameTable&) = delete;
+        EndgameTable& operator=(const EndgameTable&) = delete;
+
+        uint8_t getPlayerCount() const { return header->player_count; }
+        uint8_t getCoinCap() const { return header->coin_cap; }
+        RoleType getRole(size_t seat) const { return static_cast<RoleType>(header->roles[seat]); }
+        uint64_t size() const { return header->entry_count; }
+
+        /**
+         * Checks if the table was built for the seats (count and roles) and rules of this game.
+         * Tables are always solved under the standard rules.
+         */
+        bool covers(const Game& game) const;
+
+        /**
+         * Looks up the position of a match for one focal seat.
+         * Returns UNKNOWN when the position is not in the table.
+         */
+        TablebaseProbe probe(const Match& match, uint8_t focal) const;
+    };
+}
+
+#endif
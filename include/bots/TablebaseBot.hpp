@@ -0,0 +1,51 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * TablebaseBot.hpp
+ * Perfect endgame play from an EndgameTable.
+ * While the position is in the table the bot wins as fast as possible, avoids
+ * losing moves when it cannot win and delays a forced loss as long as possible;
+ * moves of unknown value count as drawing ones. Outside the table, or when no
+ * move has a known value, the decision goes to a fallback bot.
+ */
+
+#ifndef TABLEBASE_BOT_HPP
+#define TABLEBASE_BOT_HPP
+
+#include <memory>
+#include <random>
+#include <vector>
+#include "Bot.hpp"
+#include "HeuristicBot.hpp"
+#include "Tablebase.hpp"
+#include "../GameClone.hpp"
+
+namespace coup {
+    /**
+     * Bot that plays table positions perfectly and delegates the rest.
+     */
+    class TablebaseBot : public Bot {
+    private:
+        const EndgameTable& table; // Solved positions (borrowed, usually shared by many bots)
+        Bot& fallback; // Plays positions outside the table
+        std::unique_ptr<GameClone> clone; // Private copy used to look one move ahead
+        std::unique_ptr<Match> sim; // Decision sequence on the clone
+        std::vector<Move> options; // Reused move buffer
+        std::vector<Move> candidates; // Non-losing moves of a drawn position
+        HeuristicWeights weights; // Picks among drawing moves
+        std::mt19937 rng; // Heuristic noise
+        uint64_t table_moves; // Decisions answered by the table
+
+    public:
+        TablebaseBot(const EndgameTable& table, Bot& fallback, uint32_t seed = 1);
+
+        void start(const Match& match) override { fallback.start(match); }
+        void observe(const Match& match, const Move& move) override { fallback.observe(match, move); }
+        Move chooseMove(const Match& match) override;
+        std::string getName() const override { return "Tablebase+" + fallback.getName(); }
+
+        uint64_t tableMoves() const { return table_moves; }
+    };
+}
+
+#endif
@@ -0,0 +1,153 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tournament.hpp
+ * Round-robin and Swiss tournaments between bots.
+ * Every round is scheduled into tables of 2-6 seats, the tables are played in
+ * parallel and the finished games update Elo and Glicko ratings in schedule order,
+ * so a tournament gives the same ratings with any number of threads. Bots are
+ * built per game from a factory and a seed derived from the game number.
+ * The run stops early once the ranking has converged.
+ */
+
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Bot.hpp"
+#include "../Game.hpp"
+
+namespace coup {
+    /**
+     * Builds a fresh bot for one game from the game's seed.
+     */
+    using BotFactory = std::function<std::unique_ptr<Bot>(uint32_t seed)>;
+
+    /**
+     * How the tables of a round are formed.
+     */
+    enum class TournamentFormat {
+        ROUND_ROBIN, // Every group of entrants meets once per round
+        SWISS // Entrants of similar rating meet, ranked by the current Glicko rating
+    };
+
+    /**
+     * Tournament settings.
+     */
+    struct TournamentConfig {
+        TournamentFormat format = TournamentFormat::ROUND_ROBIN; // Pairing system
+        unsigned seats = 2; // Seats per table (2-6)
+        unsigned games_per_table = 1; // Games per table per round, seats rotate between them
+        unsigned max_rounds = 100; // Hard limit on rounds
+        unsigned min_rounds = 3; // Rounds played before early stopping is considered
+        unsigned stable_rounds = 0; // Stop once the ranking is unchanged for this many rounds (0 disables)
+        double stop_rd = 0.0; // Stop once every Glicko deviation is at or below this (0 disables)
+        unsigned threads = 1; // Tables played in parallel
+        uint32_t max_steps = 300; // Decision cap per game (a draw when reached)
+        uint32_t seed = 1; // Base seed of the bots and the role deals
+        std::vector<RoleType> roles; // Roles by seat; empty deals random roles every game
+        double elo_k = 16.0; // Elo update factor per game
+    };
+
+    /**
+     * Rating and record of one entrant.
+     */
+    struct Rating {
+        double elo = 1500.0; // Incremental Elo
+        double glicko = 1500.0; // Glicko rating
+        double rd = 350.0; // Glicko rating deviation
+        uint64_t games = 0; // Games played
+        uint64_t wins = 0; // Games won
+        uint64_t draws = 0; // Games ended by the step cap
+
+        /**
+         * Bounds of the 95% confidence interval of the Glicko rating.
+         */
+        double low() const { return glicko - 1.96 * rd; }
+        double high() const { return glicko + 1.96 * rd; }
+    };
+
+    /**
+     * Ratings of all entrants, updated one game at a time.
+     * Every seat is compared with every other seat of the table: the winner beats
+     * everyone, a draw is a draw between all pairs and two losers are not compared.
+     */
+    class RatingTable {
+    private:
+        std::vector<Rating> ratings; // By entrant
+
+    public:
+        explicit RatingTable(size_t entrants) : ratings(entrants) {}
+
+        /**
+         * Applies one game - entrants by seat and the winning seat (-1 for a draw).
+         */
+        void update(const std::vector<size_t>& table, int winner, double elo_k);
+
+        /**
+         * Entrants from the highest Glicko rating down.
+         */
+        std::vector<size_t> ranking() const;
+
+        const Rating& get(size_t entrant) const { return ratings.at(entrant); }
+        size_t size() const { return ratings.size(); }
+    };
+
+    /**
+     * Final line of one entrant.
+     */
+    struct TournamentStanding {
+        std::string name; // Entrant name
+        Rating rating; // Final rating and record
+    };
+
+    /**
+     * Outcome of a tournament.
+     */
+    struct TournamentResult {
+        std::vector<TournamentStanding> standings; // Highest Glicko rating first
+        uint64_t games = 0; // Games played
+        unsigned rounds = 0; // Rounds played
+        bool converged = false; // Stopped early by a convergence rule
+        double elapsed_ms = 0; // Wall-clock time
+    };
+
+    /**
+     * Tournament runner.
+     */
+    class Tournament {
+    private:
+        struct Entry {
+            std::string name; // Entrant name
+            BotFactory factory; // Builds its bots
+        };
+
+        TournamentConfig config; // Settings
+        std::vector<Entry> entries; // Entrants
+
+        std::vector<std::vector<size_t>> schedule(unsigned round, const RatingTable& ratings) const;
+        int playGame(const std::vector<size_t>& table, uint64_t game_number) const;
+
+    public:
+        explicit Tournament(const TournamentConfig& config = TournamentConfig());
+
+        /**
+         * Adds an entrant. Names must be unique.
+         */
+        void addEntry(const std::string& name, BotFactory factory);
+
+        /**
+         * Plays the tournament. The callback (optional) sees the ratings after every round.
+         */
+        TournamentResult run(const std::function<void(unsigned, const RatingTable&)>& on_round = nullptr) const;
+
+        size_t getEntryCount() const { return entries.size(); }
+    };
+}
+
+#endif
@@ -36,6 +36,11 @@ namespace coup {
          * Used to show role-specific information in the interface.
          */
         std::string getRoleType() const override { return "Baron"; }
+
+        /**
+         * Returns the role enumeration value for engine code.
+         */
+        RoleType getRole() const override { return RoleType::BARON; }
         
         /**
          * Investment action - converts 3 coins into 6 coins.
@@ -43,6 +48,11 @@ namespace coup {
          * Doubles the invested amount for substantial economic advantage.
          */
         void invest();
+
+        /**
+         * No-throw investment - returns the rule that rejected it instead of throwing.
+         */
+        ActionResult tryInvest();
         
         /**
          * Override sanction handling to provide compensation.
@@ -36,6 +36,11 @@ namespace coup {
          * Used to show role-specific information in the interface.
          */
         std::string getRoleType() const override { return "General"; }
+
+        /**
+         * Returns the role enumeration value for engine code.
+         */
+        RoleType getRole() const override { return RoleType::GENERAL; }
         
         /**
          * Block coup action - prevents coup against any player (including self).
@@ -43,6 +48,11 @@ namespace coup {
          * The player attempting coup loses their 7 coins without effect.
          */
         void block_coup(Player& target);
+
+        /**
+         * No-throw coup block - returns the rule that rejected it instead of throwing.
+         */
+        ActionResult tryBlockCoup(Player& target);
     };
 }
 
@@ -36,12 +36,18 @@ namespace coup {
          * Used to show role-specific information in the interface.
          */
         std::string getRoleType() const override { return "Governor"; }
+
+        /**
+         * Returns the role enumeration value for engine code.
+         */
+        RoleType getRole() const override { return RoleType::GOVERNOR; }
         
         /**
          * Enhanced tax action that yields 3 coins instead of 2.
          * Demonstrates the Governor's superior economic influence.
+         * Player::tax() dispatches here, so both entry points get the bonus.
          */
-        void tax() override;
+        ActionResult tryTax() override;
         
         /**
          * Undo action - reverses another player's tax action.
@@ -49,6 +55,11 @@ namespace coup {
          * Represents regulatory power to reverse economic decisions.
          */
         void undo(Player& target);
+
+        /**
+         * No-throw undo - returns the rule that rejected it instead of throwing.
+         */
+        ActionResult tryUndo(Player& target);
     };
 }
 
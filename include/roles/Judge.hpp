@@ -36,6 +36,11 @@ namespace coup {
          * Used to show role-specific information in the interface.
          */
         std::string getRoleType() const override { return "Judge"; }
+
+        /**
+         * Returns the role enumeration value for engine code.
+         */
+        RoleType getRole() const override { return RoleType::JUDGE; }
         
         /**
          * Block bribe action - prevents target's bribe and wastes their coins.
@@ -43,6 +48,11 @@ namespace coup {
          * Represents judicial power to prevent corruption and waste resources.
          */
         void block_bribe(Player& target);
+
+        /**
+         * No-throw bribe block - returns the rule that rejected it instead of throwing.
+         */
+        ActionResult tryBlockBribe(Player& target);
     };
 }
 
@@ -36,6 +36,11 @@ namespace coup {
          * Used to show role-specific information in the interface.
          */
         std::string getRoleType() const override { return "Merchant"; }
+
+        /**
+         * Returns the role enumeration value for engine code.
+         */
+        RoleType getRole() const override { return RoleType::MERCHANT; }
     };
 }
 
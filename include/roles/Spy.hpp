@@ -36,6 +36,11 @@ namespace coup {
          * Used to show role-specific information in the interface.
          */
         std::string getRoleType() const override { return "Spy"; }
+
+        /**
+         * Returns the role enumeration value for engine code.
+         */
+        RoleType getRole() const override { return RoleType::SPY; }
         
         /**
          * Spy action - reveals target's coin count and blocks their next arrest.
@@ -43,6 +48,12 @@ namespace coup {
          * Does not cost coins and doesn't consume the spy's turn.
          */
         void spy_on(Player& target);
+
+        /**
+         * No-throw spy action - returns the target's revealed coin count,
+         * or the rule that rejected it instead of throwing.
+         */
+        Expected<int, ActionError> trySpyOn(Player& target);
     };
 }
 
@@ -0,0 +1,113 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * GameServer.hpp
+ * Headless multi-table game server (Linux).
+ * Clients speak the binary protocol of Protocol.hpp over TCP or a Unix socket:
+ * they join tables, start them and play moves; after every accepted move the
+ * table's new public state is broadcast to all its seats. The work is split over
+ * thread-per-core shards (TableShard): each shard runs its own epoll loop and
+ * owns its tables outright, so the game hot path takes no lock. Every shard has
+ * its own SO_REUSEPORT TCP listener, letting the kernel spread connections; the
+ * Unix socket is accepted by shard 0 and its clients are handed out round-robin.
+ * With a log directory the started tables survive a crash: the constructor
+ * rebuilds them from the log (see TableLog.hpp) before any client connects, and
+ * each recovered table waits for its original clients to reclaim their seats
+ * (REJOIN with the token of their JOINED) before its timeouts play for them.
+ */
+
+#ifndef GAME_SERVER_HPP
+#define GAME_SERVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TableShard.hpp"
+
+namespace coup {
+    /**
+     * Listener, threading and limit settings.
+     */
+    struct ServerConfig {
+        std::string tcp_host = "127.0.0.1"; // Address of the TCP listener
+        int tcp_port = 0; // TCP port, 0 for an ephemeral port, -1 for no TCP listener
+        std::string unix_path; // Path of the Unix socket listener, empty for none
+        unsigned shards = 1; // Event loop threads, each owning a share of the tables
+        bool pin_threads = false; // Pin shard i to CPU i (thread-per-core)
+        size_t shard_queue_capacity = 1024; // Slots of every queue between two shards
+        size_t table_queue_capacity = 64; // Commands a table queue holds before answering TABLE_BUSY
+        size_t max_tables = 100000; // Tables hosted at once (split evenly among shards)
+        size_t max_output = 1 << 20; // Bytes queued for one client before it is dropped as too slow
+        size_t max_spectator_frames = 256; // Updates queued for one spectator before it falls back to a fresh full STATE
+        uint32_t max_steps = 1000; // Step cap of every match
+        uint32_t turn_timeout_ms = 0; // Time for a turn before the server plays the default move, 0 for none
+        uint32_t reaction_timeout_ms = 0; // Time for all answers to a reaction window before the silent seats pass, 0 for none
+        GameRules rules; // Rules of every table
+        uint32_t seed = 1; // Mixed with the table id into the engine seed of every table
+        uint16_t lockstep_interval = 0; // Send SETUP and ACTION (hashed every this many events) instead of STATE, 0 for STATE
+        std::string wal_dir; // Directory of the write-ahead log of started tables, empty for none
+        size_t wal_segment_bytes = 64 << 20; // Logged event bytes per shard before a checkpoint starts a new segment
+        uint32_t rejoin_grace_ms = 60000; // Time a recovered table waits for its seats to be reclaimed before its timeouts resume, 0 to wait for every seat
+        bool wal_sync = true; // fdatasync every group commit (off only for tests and benchmarks; checkpoints always sync)
+    };
+
+    /**
+     * The server. Not copyable; construct, then call run().
+     */
+    class GameServer {
+    private:
+        ServerConfig config; // Settings (shared by reference with the shards)
+        std::vector<std::unique_ptr<TableShard>> shards; // Event loops
+        uint16_t port; // Bound TCP port
+        bool unix_bound; // The Unix socket file was created by this server
+        RecoveryStats recovery; // What the constructor found in the log directory
+
+    public:
+        /**
+         * Opens the listeners and the shards, after recovering the logged tables when a log
+         * directory is set. Throws std::runtime_error when a socket or the log cannot be set up.
+         */
+        explicit GameServer(const ServerConfig& config = ServerConfig());
+        ~GameServer();
+
+        GameServer(const GameServer&) = delete;
+        GameServer& operator=(const GameServer&) = delete;
+
+        /**
+         * Runs every shard until stop() is called (shard 0 on the calling thread).
+         * Rethrows the first failure of a shard after stopping the others.
+         */
+        void run();
+
+        /**
+         * Ends run() from any thread (and from signal handlers).
+         */
+        void stop();
+
+        /**
+         * Returns the bound TCP port (useful with an ephemeral port).
+         */
+        uint16_t getPort() const { return port; }
+
+        size_t shardCount() const { return shards.size(); }
+
+        /**
+         * What recovery found in the log directory (all zero without one).
+         */
+        const RecoveryStats& getRecovery() const { return recovery; }
+
+        /**
+         * Counters summed over the shards. Exact once run() has returned.
+         */
+        ServerStats getStats() const;
+
+        /**
+         * Tables hosted over all shards. Exact once run() has returned.
+         */
+        size_t tableCount() const;
+    };
+}
+
+#endif
@@ -0,0 +1,86 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Lockstep.hpp
+ * Deterministic lockstep replication of hosted tables.
+ * The engine is deterministic: the same seats, rules, seed and events give the same
+ * game. A lockstep table therefore sends its clients one SETUP and then one ACTION per
+ * event (a move, or the deadline of a reaction window) instead of its state, and the
+ * client replays them on its own Game. Every hash_interval events the ACTION carries
+ * the server's state hash; the replica compares it with its own and reports the first
+ * mismatch together with the range of events the divergence happened in. Both sides
+ * can keep the hash of every event, and firstDivergence() compares two such logs to
+ * name the exact event.
+ */
+
+#ifndef LOCKSTEP_HPP
+#define LOCKSTEP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../Game.hpp"
+#include "../Player.hpp"
+#include "../bots/Match.hpp"
+#include "Protocol.hpp"
+
+namespace coup {
+    /**
+     * Outcome of the hash checks of a replica.
+     */
+    struct DesyncReport {
+        bool diverged = false; // A hash check failed (or the replica rejected an event)
+        uint32_t last_verified = 0; // Last event whose hash matched (0 is the setup)
+        uint32_t detected_at = 0; // Event whose check failed; the divergence is in (last_verified, detected_at]
+    };
+
+    /**
+     * Client-side copy of a lockstep table, built from its SETUP and fed its ACTION messages.
+     */
+    class LockstepReplica {
+    private:
+        uint32_t table; // Table being replicated
+        Game game; // Replayed game
+        std::vector<std::unique_ptr<Player>> roster; // Players of the seats, in seat order
+        std::unique_ptr<Match> match; // Decision sequence of the replayed game
+        uint32_t events; // Events applied so far
+        std::vector<uint64_t> hashes; // State hash after every event, [0] after the setup
+        DesyncReport report; // Result of the hash checks
+
+        /**
+         * Compares the replica's hash after an event with the server's.
+         */
+        void verify(uint32_t event, uint64_t expected);
+
+    public:
+        /**
+         * Builds the game of a SETUP message and checks its starting hash.
+         * Throws std::invalid_argument for other message types.
+         */
+        explicit LockstepReplica(const Message& setup);
+
+        LockstepReplica(const LockstepReplica&) = delete;
+        LockstepReplica& operator=(const LockstepReplica&) = delete;
+
+        /**
+         * Applies the next ACTION of the table and checks its hash when it carries one. Returns
+         * false once the replica has diverged; a move the replica's engine rejects counts as a
+         * divergence too. Throws std::invalid_argument for another table or a gap in the stream.
+         */
+        bool apply(const Message& action);
+
+        uint32_t getTable() const { return table; }
+        const Match& getMatch() const { return *match; }
+        uint32_t eventCount() const { return events; }
+        const std::vector<uint64_t>& getHashes() const { return hashes; }
+        const DesyncReport& getReport() const { return report; }
+    };
+
+    /**
+     * Returns the first event whose hash differs between two per-event hash logs
+     * (Table::getHashes() and LockstepReplica::getHashes()), or -1 when the shared prefix agrees.
+     */
+    int64_t firstDivergence(const std::vector<uint64_t>& reference, const std::vector<uint64_t>& replica);
+}
+
+#endif
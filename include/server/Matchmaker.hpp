@@ -0,0 +1,163 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Matchmaker.hpp
+ * Rating-based matchmaking queue for tables of 2-6 seats.
+ * Entries (players or bots) queue with a rating and the table size they want.
+ * Every table size keeps its entries in a tree ordered by rating, so the entries
+ * nearest to a rating are found in O(log n). An entry is matched as soon as it
+ * queues, and again every widen_interval_ms while it waits: each step adds to the
+ * rating difference it accepts, until max_tolerance. A check takes the entry's
+ * seats - 1 nearest neighbours within its tolerance, so the longest waiters
+ * decide who sits together once their tolerance has widened. Rechecks are kept
+ * in due order, so a poll only looks at the entries whose tolerance changed.
+ * Wait times of matched entries feed log2 histograms per table size.
+ */
+
+#ifndef MATCHMAKER_HPP
+#define MATCHMAKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../Snapshot.hpp"
+
+namespace coup {
+    /**
+     * Matchmaking settings.
+     */
+    struct MatchmakerConfig {
+        double base_tolerance = 50.0; // Rating difference accepted right after queueing
+        double widen_per_second = 25.0; // Added to the tolerance for every second of waiting
+        double max_tolerance = 400.0; // Widest rating difference ever accepted
+        uint32_t widen_interval_ms = 1000; // Time between two widening steps (and rechecks) of an entry
+    };
+
+    /**
+     * Table formed by the matchmaker, seats ordered by rating.
+     */
+    struct MatchGroup {
+        uint8_t seats; // Table size
+        uint64_t ids[SNAPSHOT_MAX_PLAYERS]; // Entries seated
+        double ratings[SNAPSHOT_MAX_PLAYERS]; // Their ratings
+        uint64_t formed_ms; // Time the table was formed
+    };
+
+    /**
+     * Histogram of wait times in milliseconds: bucket 0 holds waits of 0 ms and
+     * bucket b >= 1 waits in [2^(b-1), 2^b), the last bucket everything longer.
+     */
+    class WaitHistogram {
+    public:
+        static constexpr unsigned BUCKETS = 32;
+
+    private:
+        uint64_t counts[BUCKETS] = {}; // Waits per bucket
+        uint64_t total = 0; // Waits recorded
+        uint64_t sum_ms = 0; // Sum of the waits
+        uint64_t longest_ms = 0; // Longest wait
+
+    public:
+        void record(uint64_t wait_ms);
+
+        /**
+         * Upper bound of the bucket holding the given quantile (0-1), capped at the longest wait.
+         * 0 when empty.
+         */
+        uint64_t percentile(double quantile) const;
+
+        /**
+         * Largest wait bucket b can hold.
+         */
+        static uint64_t bucketLimit(unsigned bucket);
+
+        uint64_t bucketCount(unsigned bucket) const { return counts[bucket]; }
+        uint64_t count() const { return total; }
+        uint64_t longest() const { return longest_ms; }
+        double mean() const { return total ? static_cast<double>(sum_ms) / total : 0.0; }
+    };
+
+    /**
+     * The queue. Time is in caller-supplied milliseconds that only move forward.
+     */
+    class Matchmaker {
+    private:
+        using Key = std::pair<double, uint64_t>; // Rating, id
+
+        struct Entry {
+            double rating;
+            uint8_t seats; // Table size wanted
+            uint64_t enqueued_ms; // Time it queued
+            uint64_t recheck_ms; // Time of its next widening step, 0 once at max_tolerance
+        };
+
+        MatchmakerConfig config;
+        std::unordered_map<uint64_t, Entry> entries; // Queued entries by id
+        std::set<Key> ladders[SNAPSHOT_MAX_PLAYERS + 1]; // Queued entries by table size, ordered by rating
+        std::set<std::pair<uint64_t, uint64_t>> rechecks; // Due widening steps: time, id
+        WaitHistogram waits[SNAPSHOT_MAX_PLAYERS + 1]; // Wait times of matched entries by table size, [0] for all
+
+        /**
+         * Rating difference an entry accepts at now.
+         */
+        double tolerance(const Entry& entry, uint64_t now_ms) const;
+
+        /**
+         * Queues the entry's next widening step, unless its tolerance cannot widen anymore.
+         */
+        void scheduleRecheck(uint64_t id, Entry& entry, uint64_t now_ms);
+
+        /**
+         * Seats the entry with its nearest neighbours if enough are within its tolerance.
+         */
+        bool tryMatch(uint64_t id, uint64_t now_ms, std::vector<MatchGroup>& formed);
+
+        /**
+         * Removes an entry from every index.
+         */
+        void erase(std::unordered_map<uint64_t, Entry>::iterator found);
+
+    public:
+        /**
+         * Throws std::invalid_argument for a tolerance below 0 or a widening interval of 0.
+         */
+        explicit Matchmaker(const MatchmakerConfig& config = MatchmakerConfig());
+
+        /**
+         * Queues an entry and matches it at once if it can, appending the table to formed.
+         * Returns true when it was seated. Throws std::invalid_argument for a table size
+         * outside 2-6, a NaN rating or an id that is already queued.
+         */
+        bool enqueue(uint64_t id, double rating, uint8_t seats, uint64_t now_ms, std::vector<MatchGroup>& formed);
+
+        /**
+         * Takes an entry out of the queue. Returns false if it is not queued.
+         */
+        bool cancel(uint64_t id);
+
+        /**
+         * Widens the tolerance of every entry whose step is due by now, longest waiters
+         * first, and appends the tables that form to formed.
+         */
+        void poll(uint64_t now_ms, std::vector<MatchGroup>& formed);
+
+        /**
+         * Time of the next widening step, UINT64_MAX when none is pending.
+         */
+        uint64_t nextPoll() const;
+
+        bool isQueued(uint64_t id) const { return entries.count(id) != 0; }
+        size_t size() const { return entries.size(); }
+        size_t size(uint8_t seats) const { return seats <= SNAPSHOT_MAX_PLAYERS ? ladders[seats].size() : 0; }
+
+        /**
+         * Wait times of the entries seated at tables of the given size, 0 for all sizes.
+         */
+        const WaitHistogram& waitTimes(uint8_t seats = 0) const { return waits[seats <= SNAPSHOT_MAX_PLAYERS ? seats : 0]; }
+    };
+}
+
+#endif
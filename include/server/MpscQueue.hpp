@@ -0,0 +1,114 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * MpscQueue.hpp
+ * Bounded lock-free multi-producer single-consumer ring.
+ * Every slot carries a sequence number (Vyukov's bounded queue): producers claim a
+ * slot with one compare-and-swap on the tail and publish it by bumping the slot's
+ * sequence, so concurrent producers never wait on each other and the consumer
+ * never touches the tail. A full ring makes tryPush fail instead of blocking,
+ * which is the caller's backpressure signal.
+ */
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace coup {
+    /**
+     * Ring of copyable values. Capacity is rounded up to a power of two (at least 2).
+     */
+    template <typename T>
+    class MpscQueue {
+    private:
+        static constexpr size_t CACHE_LINE = 64;
+
+        struct Slot {
+            std::atomic<size_t> sequence; // Position the slot is ready for: pos to write, pos + 1 to read
+            T value;
+        };
+
+        std::unique_ptr<Slot[]> slots; // Ring storage
+        size_t mask; // Capacity - 1
+
+        alignas(CACHE_LINE) std::atomic<size_t> tail; // Next position to claim (shared by the producers)
+        alignas(CACHE_LINE) size_t head; // Next position to read (consumer only)
+
+    public:
+        explicit MpscQueue(size_t capacity) : tail(0), head(0) {
+            if (capacity == 0) {
+                throw std::invalid_argument("Queue capacity must be positive");
+            }
+            size_t rounded = 2;
+            while (rounded < capacity) {
+                rounded <<= 1;
+            }
+            slots.reset(new Slot[rounded]);
+            for (size_t i = 0; i < rounded; i++) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            mask = rounded - 1;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        size_t capacity() const { return mask + 1; }
+
+        /**
+         * Producer side, callable from any thread. Returns false when the ring is full.
+         */
+        bool tryPush(const T& value) {
+            size_t position = tail.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots[position & mask];
+                const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0) {
+                    if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (difference < 0) {
+                    return false; // The slot still holds a value from one lap ago
+                }
+                else {
+                    position = tail.load(std::memory_order_relaxed); // Another producer took it
+                }
+            }
+            slot->value = value;
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Consumer side. Returns false when the ring is empty or the next slot is still being written.
+         */
+        bool tryPop(T& out) {
+            Slot& slot = slots[head & mask];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+                return false;
+            }
+            out = slot.value;
+            slot.sequence.store(head + mask + 1, std::memory_order_release);
+            head++;
+            return true;
+        }
+
+        /**
+         * Consumer side. Number of claimed slots, including ones still being written.
+         */
+        size_t size() const {
+            const size_t claimed = tail.load(std::memory_order_acquire);
+            return claimed > head ? claimed - head : 0;
+        }
+    };
+}
+
+#endif
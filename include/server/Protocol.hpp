@@ -0,0 +1,134 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Protocol.hpp
+ * Binary protocol of the game server.
+ * Every message is one frame: a little-endian uint16 length, the protocol version
+ * byte, then the message type byte and the fixed-layout body (the length counts the
+ * type byte and the body). Integers are little-endian, seats and action types are
+ * single bytes and names are length-prefixed. MOVE carries turn actions as well as
+ * reactions and passes.
+ * STATE is a delta: a bit mask names the seats whose view changed since the previous
+ * STATE of the table, and only those seats follow. The first STATE after the start
+ * lists every seat (44 bytes at six seats); a typical move then costs 24-28 bytes.
+ * Decoding works in place: text fields point into the caller's buffer, so reading a
+ * message never allocates.
+ * Lockstep tables send SETUP and ACTION instead of STATE: clients replay the action
+ * stream on their own Game (see Lockstep.hpp), and every few events the ACTION carries
+ * the server's state hash so a diverging replica is caught (17 bytes, 25 with a hash).
+ * Spectators always get STATE deltas; one that falls behind gets a fresh full STATE
+ * once it has caught up instead of every delta it missed.
+ * JOINED hands out a random seat token; after a disconnect or a server restart the
+ * client sends it back in REJOIN to take the same seat again (a JOINED, then a full
+ * STATE).
+ */
+
+#ifndef PROTOCOL_HPP
+#define PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "../Game.hpp"
+#include "../Snapshot.hpp"
+#include "../bots/Match.hpp"
+
+namespace coup {
+    constexpr size_t FRAME_HEADER_SIZE = 3; // Length prefix and version byte of a frame
+    constexpr uint8_t PROTOCOL_VERSION = 0x11; // Version byte of every frame; unversioned frames had a type byte there, never 0x11
+    constexpr size_t MAX_NAME_LENGTH = 9; // Longest player name accepted in JOIN (same limit as Player)
+    constexpr uint8_t NO_WINNER = 0xFF; // Winner byte of GAME_OVER after a draw
+
+    /**
+     * Type byte of a message. Client requests are below 0x80, server messages above.
+     */
+    enum class MessageType : uint8_t {
+        JOIN = 0x01, // Client: take a seat at a table (table 0 creates a new one)
+        START = 0x02, // Client: start the game of a table
+        MOVE = 0x03, // Client: play a move at a table
+        WATCH = 0x04, // Client: spectate a started table (a full STATE, then every STATE and the GAME_OVER)
+        REJOIN = 0x05, // Client: take back a seat with the token of its JOINED (a JOINED, then a full STATE)
+        JOINED = 0x81, // Server: the seat taken by the JOIN or REJOIN, with its token
+        STATE = 0x82, // Server: public state after the start or a move
+        GAME_OVER = 0x83, // Server: the table has finished
+        ERROR = 0x84, // Server: a request was rejected
+        SETUP = 0x85, // Server: a lockstep table started - everything a replica needs
+        ACTION = 0x86 // Server: next event of a lockstep table
+    };
+
+    /**
+     * Reason a request was rejected.
+     */
+    enum class ServerError : uint8_t {
+        NONE, // No error
+        MALFORMED, // The frame could not be decoded (the connection is closed)
+        UNKNOWN_TABLE, // No table with this id
+        TABLE_LIMIT, // The server hosts as many tables as allowed
+        SEAT_UNAVAILABLE, // The table is full or already started
+        NOT_SEATED, // The connection has no seat at the table
+        NOT_STARTED, // The game of the table has not started
+        ILLEGAL_MOVE, // The engine rejected the move (the text has the rule)
+        TABLE_BUSY // The command queue of the table is full - retry after the next STATE
+    };
+
+    /**
+     * Public view of one seat in a STATE message.
+     */
+    struct SeatState {
+        uint8_t role; // RoleType value
+        bool active; // Still in the game
+        uint16_t coins; // Coins held
+
+        bool operator==(const SeatState& other) const {
+            return role == other.role && active == other.active && coins == other.coins;
+        }
+        bool operator!=(const SeatState& other) const { return !(*this == other); }
+    };
+
+    /**
+     * Decoded message. Only the fields of its type are meaningful.
+     */
+    struct Message {
+        MessageType type = MessageType::ERROR; // Kind of message
+        uint32_t table = 0; // Table the message is about
+        uint8_t seat = 0; // JOINED: seat taken, REJOIN: seat to take back, STATE: deciding seat, GAME_OVER: winner or NO_WINNER
+        RoleType role = RoleType::GOVERNOR; // JOIN: role of the new player
+        std::string_view text; // JOIN: player name, ERROR: reason (decoded text points into the frame)
+        Move move = Move::decline(0); // MOVE: move to play (the actor is the sender's seat), STATE: move that led here
+        ServerError error = ServerError::NONE; // ERROR: code
+        uint32_t step = 0; // STATE: turn actions played so far
+        bool window = false; // STATE: a reaction window is open
+        uint8_t seat_count = 0; // STATE: seats at the table
+        uint8_t changed = 0; // STATE: bit per seat whose view is carried in seats
+        SeatState seats[SNAPSHOT_MAX_PLAYERS] = {}; // STATE: per-seat view (decoding fills the changed seats only), SETUP: roles
+        uint32_t seed = 0; // SETUP: engine seed of the table
+        uint32_t max_steps = 0; // SETUP: step cap of the match
+        uint16_t hash_interval = 0; // SETUP: events between two hashed ACTION messages
+        GameRules rules; // SETUP: rules of the table (each field must fit a byte)
+        uint64_t hash = 0; // SETUP: state hash at the start, ACTION: state hash after the event
+        bool has_hash = false; // ACTION: hash is set
+        bool expiry = false; // ACTION: the event is the deadline of the reaction window, not move
+        uint64_t token = 0; // JOINED and REJOIN: seat token
+    };
+
+    /**
+     * Appends the frame of a message to out.
+     * Throws std::invalid_argument for fields the format cannot carry.
+     */
+    void encodeMessage(const Message& message, std::vector<uint8_t>& out);
+
+    /**
+     * Decodes the first frame of data into out. Returns the bytes consumed, or 0 when
+     * the frame is not complete yet. Throws std::invalid_argument for malformed frames
+     * and other protocol versions. out.text stays valid while data is.
+     */
+    size_t decodeMessage(const uint8_t* data, size_t size, Message& out);
+
+    /**
+     * Returns the default message of an error code.
+     */
+    const char* getServerErrorMessage(ServerError error);
+}
+
+#endif
@@ -0,0 +1,81 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * ServerClient.hpp
+ * Blocking client of the game server protocol.
+ * Used by tests, load generators and headless bot clients: send() writes whole
+ * frames, receive() waits for the next decoded message with a timeout.
+ * The client keeps the seat views of the tables it plays at or watches, so every
+ * STATE it returns lists all seats even though the server only sends the changed ones.
+ */
+
+#ifndef SERVER_CLIENT_HPP
+#define SERVER_CLIENT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Protocol.hpp"
+
+namespace coup {
+    /**
+     * One connection to a server.
+     */
+    class ServerClient {
+    private:
+        struct TableView {
+            uint32_t table;
+            SeatState seats[SNAPSHOT_MAX_PLAYERS];
+        };
+
+        int fd; // Socket, -1 when closed
+        std::vector<uint8_t> input; // Received bytes not decoded yet
+        size_t input_offset; // Bytes of input already decoded
+        std::vector<uint8_t> output; // Reused encode buffer
+        std::vector<TableView> views; // Seat views of the running tables STATE messages were received for
+
+        /**
+         * Applies the changed seats of a STATE to the table's view and fills in the others.
+         */
+        void merge(Message& state);
+
+    public:
+        ServerClient();
+        ~ServerClient();
+
+        ServerClient(const ServerClient&) = delete;
+        ServerClient& operator=(const ServerClient&) = delete;
+
+        /**
+         * Connects over TCP. Throws std::runtime_error on failure.
+         */
+        void connectTcp(const std::string& host, uint16_t port);
+
+        /**
+         * Connects to a Unix socket. Throws std::runtime_error on failure.
+         */
+        void connectUnix(const std::string& path);
+
+        /**
+         * Sends one message. Throws std::runtime_error when the connection is lost.
+         */
+        void send(const Message& message);
+
+        /**
+         * Sends raw bytes (for malformed-input tests).
+         */
+        void sendRaw(const uint8_t* data, size_t size);
+
+        /**
+         * Waits up to timeout_ms (-1 forever) for the next message. Returns false on timeout.
+         * The text of the message stays valid until the next call.
+         * Throws std::runtime_error when the server closes the connection.
+         */
+        bool receive(Message& out, int timeout_ms = -1);
+
+        void close();
+        bool isConnected() const { return fd >= 0; }
+    };
+}
+
+#endif
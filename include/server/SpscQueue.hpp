@@ -0,0 +1,97 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * SpscQueue.hpp
+ * Bounded lock-free single-producer single-consumer ring.
+ * Shards of the server talk through one queue per ordered pair of shards, so each
+ * queue has exactly one writer and one reader thread. The head and tail live on
+ * separate cache lines and each side caches the other side's index, so a push or
+ * pop touches shared memory only when the cached view runs out.
+ */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace coup {
+    /**
+     * Ring of copyable values. Capacity is rounded up to a power of two.
+     */
+    template <typename T>
+    class SpscQueue {
+    private:
+        static constexpr size_t CACHE_LINE = 64;
+
+        std::vector<T> slots; // Ring storage
+        size_t mask; // Capacity - 1
+
+        alignas(CACHE_LINE) std::atomic<size_t> head; // Next slot to read (written by the consumer)
+        size_t cached_tail; // Consumer's view of tail
+
+        alignas(CACHE_LINE) std::atomic<size_t> tail; // Next slot to write (written by the producer)
+        size_t cached_head; // Producer's view of head
+
+    public:
+        explicit SpscQueue(size_t capacity) : head(0), cached_tail(0), tail(0), cached_head(0) {
+            if (capacity == 0) {
+                throw std::invalid_argument("Queue capacity must be positive");
+            }
+            size_t rounded = 1;
+            while (rounded < capacity) {
+                rounded <<= 1;
+            }
+            slots.resize(rounded);
+            mask = rounded - 1;
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        size_t capacity() const { return mask + 1; }
+
+        /**
+         * Producer side. Returns false when the ring is full.
+         */
+        bool tryPush(const T& value) {
+            const size_t position = tail.load(std::memory_order_relaxed);
+            if (position - cached_head > mask) {
+                cached_head = head.load(std::memory_order_acquire);
+                if (position - cached_head > mask) {
+                    return false;
+                }
+            }
+            slots[position & mask] = value;
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Consumer side. Returns false when the ring is empty.
+         */
+        bool tryPop(T& out) {
+            const size_t position = head.load(std::memory_order_relaxed);
+            if (position == cached_tail) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (position == cached_tail) {
+                    return false;
+                }
+            }
+            out = slots[position & mask];
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Approximate number of queued values (exact when called by either side while the other is idle).
+         */
+        size_t size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+    };
+}
+
+#endif
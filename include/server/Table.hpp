@@ -0,0 +1,158 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Table.hpp
+ * One hosted game.
+ * A table owns its Game, the players created for the seats and the Match that
+ * tracks reaction windows. Moves are applied through Match::apply, so every
+ * request is validated by the same Player and role methods as local play.
+ * Every accepted move and every expired reaction window is an event; lockstep
+ * tables send their clients the events instead of the state (see Lockstep.hpp),
+ * and the write-ahead log records them to rebuild the table after a crash (see TableLog.hpp).
+ */
+
+#ifndef TABLE_HPP
+#define TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Game.hpp"
+#include "../Player.hpp"
+#include "../bots/Match.hpp"
+#include "Protocol.hpp"
+
+namespace coup {
+    /**
+     * Game hosted by the server.
+     */
+    class Table {
+    private:
+        uint32_t id; // Table id used in the protocol
+        Game game; // Hosted game
+        std::vector<std::unique_ptr<Player>> roster; // Players of the seats, in seat order
+        uint64_t tokens[SNAPSHOT_MAX_PLAYERS]; // Token that reclaims each seat (0 for none)
+        std::unique_ptr<Match> match; // Created when the game starts
+        uint32_t max_steps; // Step cap of the match
+        uint32_t seed; // Engine seed, shipped to lockstep replicas
+        Move last_move; // Move that produced the current state
+        uint32_t events; // Moves and window expiries applied so far
+        bool last_expiry; // The last event was a window expiry rather than last_move
+        bool hashing; // Keep the state hash after every event
+        std::vector<uint64_t> hashes; // State hash after every event, [0] at the start (when hashing)
+        SeatState published[SNAPSHOT_MAX_PLAYERS]; // Seat views as of the last describeChanges()
+        uint8_t published_count; // Seats in published (0 before the first STATE)
+        mutable std::vector<Move> options; // Move buffer reused by defaultMove()
+
+    public:
+        Table(uint32_t id, uint32_t max_steps = 1000, const GameRules& rules = GameRules(), uint32_t seed = 1);
+
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
+
+        uint32_t getId() const { return id; }
+        const Game& getGame() const { return game; }
+        uint32_t getSeed() const { return seed; }
+        uint32_t getMaxSteps() const { return max_steps; }
+
+        /**
+         * Returns the match, or nullptr before the game starts.
+         */
+        const Match* getMatch() const { return match.get(); }
+
+        /**
+         * Adds a player with the role and returns its seat. A nonzero token lets a client
+         * take the seat back later (see ownsSeat).
+         * Throws std::runtime_error when the table is full or started.
+         */
+        uint8_t join(const std::string& name, RoleType role, uint64_t token = 0);
+
+        /**
+         * Returns the token the seat was joined with, 0 for none or no such seat.
+         */
+        uint64_t getToken(uint8_t seat) const { return seat < roster.size() ? tokens[seat] : 0; }
+
+        /**
+         * Returns whether token reclaims the seat (seats joined without a token never match).
+         */
+        bool ownsSeat(uint8_t seat, uint64_t token) const { return token != 0 && getToken(seat) == token; }
+
+        /**
+         * Starts the game. Throws std::runtime_error with fewer than two seats.
+         */
+        void start();
+
+        /**
+         * Plays a move for the seat (the actor of the move is replaced by the seat).
+         * Throws std::runtime_error when the engine rejects it; the game is unchanged then.
+         */
+        void play(uint8_t seat, Move move);
+
+        /**
+         * Passes every seat that has not answered the open reaction window (its deadline passed).
+         */
+        void expireWindow();
+
+        /**
+         * Replaces the state of a started table with a saved one (crash recovery): the seats
+         * from a snapshot of the game, the match bookkeeping, the event count and the last event.
+         * Throws std::runtime_error before the start or when the snapshot does not fit the seats.
+         */
+        void restore(const GameSnapshot& snapshot, const MatchState& state, uint32_t events,
+                     const Move& last_move, bool last_expiry);
+
+        /**
+         * Returns the move played for the deciding seat when it runs out of time: a pass in a
+         * reaction window, otherwise gather when legal, else its first legal action (a forced coup).
+         * (The server closes a timed-out window with expireWindow() instead, passing all silent seats.)
+         * Throws std::runtime_error when the game is not running.
+         */
+        Move defaultMove() const;
+
+        bool isStarted() const { return match != nullptr; }
+        bool isOver() const { return match && match->isOver(); }
+        size_t seatCount() const { return roster.size(); }
+
+        /**
+         * Returns the winning seat, or NO_WINNER while running or after a draw.
+         */
+        uint8_t winner() const;
+
+        /**
+         * Fills a STATE message with the full public state of the table (every seat marked changed).
+         */
+        void describe(Message& out) const;
+
+        /**
+         * Fills the STATE message broadcast after the start or a move: only the seats whose view
+         * changed since the previous call are marked changed (all of them the first time).
+         */
+        void describeChanges(Message& out);
+
+        /**
+         * Fills the SETUP message of a lockstep table (after the start).
+         */
+        void describeSetup(Message& out, uint16_t hash_interval) const;
+
+        /**
+         * Fills the ACTION message of the last event; the state hash is attached every
+         * hash_interval events and to the final one.
+         */
+        void describeEvent(Message& out, uint16_t hash_interval) const;
+
+        uint32_t eventCount() const { return events; }
+        const Move& getLastMove() const { return last_move; }
+        bool lastWasExpiry() const { return last_expiry; }
+
+        /**
+         * Starts keeping the state hash after every event (to locate a replica's divergence).
+         * Must be called before start().
+         */
+        void recordHashes() { hashing = true; }
+
+        const std::vector<uint64_t>& getHashes() const { return hashes; }
+    };
+}
+
+#endif
@@ -0,0 +1,132 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * TableLog.hpp
+ * Write-ahead log of the running tables of one shard.
+ * A table is logged once in full when it starts (a SNAPSHOT record: seats, seed,
+ * rules, the saved Game and Match state and the seat tokens) and then as one small
+ * EVENT record per accepted move or expired reaction window; an END record drops it. Records are
+ * gathered in memory and written with one write and one fdatasync per commit, and
+ * the shard commits once per loop round before any reply leaves, so all tables of
+ * a round share a single sync (group commit). When the events of a segment grow past
+ * its limit the log starts a new one with a SNAPSHOT of every running table (a
+ * checkpoint) and deletes the older segments of the shard once that is durable.
+ *
+ * Segment files are named g<generation>-s<shard>-<segment>.wal; every server start
+ * is a new generation. Recovery reads all segments in name order and keeps, per
+ * table, the last snapshot plus the events after it, so it replays at most one
+ * segment's worth of events. A segment ends at its first partial or corrupt record
+ * (every record carries a checksum), which is where a crash left it.
+ * Game snapshots are stored in host byte order, like Snapshot.hpp.
+ */
+
+#ifndef TABLE_LOG_HPP
+#define TABLE_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Snapshot.hpp"
+#include "Table.hpp"
+
+namespace coup {
+    constexpr uint32_t TABLE_LOG_MAGIC = 0x4C415743; // "CWAL" in little-endian byte order
+    constexpr uint16_t TABLE_LOG_VERSION = 2; // Bump whenever the record layout changes
+
+    /**
+     * What a recovery found.
+     */
+    struct RecoveryStats {
+        size_t segments = 0; // Segment files read
+        size_t records = 0; // Records replayed
+        size_t tables = 0; // Running tables rebuilt
+        size_t dropped = 0; // Tables left out because their events could not be replayed
+        size_t torn = 0; // Segments that ended in a partial or corrupt record
+    };
+
+    /**
+     * Log of one shard. Not thread-safe; used by the shard's own thread only.
+     */
+    class TableLog {
+    private:
+        std::string directory; // Directory of the segment files
+        uint8_t shard; // Shard writing this log
+        uint32_t generation; // Server start this log belongs to
+        size_t segment_limit; // Bytes of events after which needsCheckpoint() turns true
+        bool sync; // fdatasync on every commit (checkpoints always sync)
+        int fd; // Open segment, -1 before the first checkpoint
+        uint32_t segment; // Number of the open segment
+        size_t logged_bytes; // Bytes committed to the open segment after its snapshots
+        std::vector<uint8_t> pending; // Records since the last commit
+        GameSnapshot scratch; // Reused snapshot of the table being logged
+        uint64_t records; // Records appended
+        uint64_t syncs; // Commits written
+
+        std::string segmentPath(uint32_t number) const;
+        size_t beginRecord(uint8_t type);
+        void endRecord(size_t start);
+        void writePending(bool durable);
+
+    public:
+        /**
+         * Creates the log of a shard in directory (which must exist). Nothing is written
+         * before the first checkpoint(), which opens the first segment.
+         */
+        TableLog(const std::string& directory, uint8_t shard, uint32_t generation,
+                 size_t segment_limit = 64 << 20, bool sync = true);
+        ~TableLog();
+
+        TableLog(const TableLog&) = delete;
+        TableLog& operator=(const TableLog&) = delete;
+
+        /**
+         * Appends the full state of a started table (written when it starts, and by checkpoints).
+         */
+        void logSnapshot(const Table& table);
+
+        /**
+         * Appends the table's last event.
+         */
+        void logEvent(const Table& table);
+
+        /**
+         * Appends the end of a table; recovery forgets it.
+         */
+        void logEnd(uint32_t table);
+
+        /**
+         * Writes and syncs the records appended since the last commit. Returns false when
+         * there were none. Throws std::runtime_error when the disk refuses them.
+         */
+        bool commit();
+
+        /**
+         * Starts a new segment holding a snapshot of every given table, commits it and then
+         * deletes the shard's older segments of this generation. The new segment is synced
+         * even without sync on commits, since it is the only copy left of those tables.
+         */
+        void checkpoint(const std::vector<const Table*>& running);
+
+        bool hasPending() const { return !pending.empty(); }
+        bool needsCheckpoint() const { return logged_bytes >= segment_limit; }
+        uint64_t recordCount() const { return records; }
+        uint64_t syncCount() const { return syncs; }
+
+        /**
+         * Rebuilds the running tables from every segment in directory, in id order.
+         * Returns the generation for the next server start.
+         */
+        static uint32_t recover(const std::string& directory, std::vector<std::unique_ptr<Table>>& tables,
+                                RecoveryStats& stats);
+
+        /**
+         * Deletes the segments of generations before the given one (once the new generation's
+         * checkpoints are durable).
+         */
+        static void removeGenerations(const std::string& directory, uint32_t before);
+    };
+}
+
+#endif
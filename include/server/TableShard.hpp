@@ -0,0 +1,379 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * TableShard.hpp
+ * One thread of the sharded game server.
+ * A shard runs its own epoll loop and exclusively owns the tables whose id maps
+ * to it (id % shard count) and the client connections it accepted, so no game
+ * state is ever locked. Every table that has seats held from other shards gets a
+ * bounded lock-free MPSC command queue (TableInbox): those shards push their
+ * clients' commands straight into it and ring the owner once, and the owner drains
+ * it in batches. A full queue is answered with TABLE_BUSY instead of buffering.
+ * Everything else - requests of clients without a seat, replies for clients of
+ * other shards, detaches and Unix socket clients handed out round-robin - goes
+ * through the lock-free SPSC queue of each ordered pair of shards. Turn and
+ * reaction-window deadlines live in the shard's timer wheel; a seat that runs
+ * out of turn time gets the table's default move, and an expired window passes
+ * every seat that stayed silent.
+ * Spectators are listed by the shard that owns their connection; the table's
+ * owner only counts them per shard. Every update is encoded once into a reference
+ * counted SharedFrame that the owner hands to each shard with spectators, which
+ * queues the same frame on all of their sockets and sends it with scatter/gather
+ * writes. A spectator whose queue runs full loses its queued updates and is sent
+ * a fresh full STATE once its socket has drained.
+ * With a log directory configured every started table is written to the shard's
+ * TableLog; the shard commits once per round, before any reply of that round
+ * leaves the process (replies to other shards wait in the overflow until then).
+ * Every JOIN is handed a random seat token, logged with the table, that reclaims
+ * the seat with REJOIN. A table rebuilt after a crash is frozen - its timeouts do
+ * not play for the vacant seats - until every seat is reclaimed or the grace
+ * period of the configuration runs out.
+ */
+
+#ifndef TABLE_SHARD_HPP
+#define TABLE_SHARD_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "MpscQueue.hpp"
+#include "Protocol.hpp"
+#include "SpscQueue.hpp"
+#include "Table.hpp"
+#include "TableLog.hpp"
+#include "TimerWheel.hpp"
+
+namespace coup {
+    struct ServerConfig;
+
+    /**
+     * Counters of the server (per shard, summed by GameServer).
+     */
+    struct ServerStats {
+        uint64_t accepted = 0; // Connections accepted
+        uint64_t closed = 0; // Connections closed (by the client, on errors or as too slow)
+        uint64_t requests = 0; // Client messages handled
+        uint64_t rejected = 0; // Client messages answered with ERROR
+        uint64_t moves = 0; // Moves applied
+        uint64_t games_finished = 0; // Tables that reached the end
+        uint64_t forwarded = 0; // Messages sent to other shards
+        uint64_t queued = 0; // Commands pushed into table queues of other shards
+        uint64_t backpressured = 0; // Commands refused with TABLE_BUSY because a table queue was full
+        uint64_t timeouts = 0; // Default moves played for seats that ran out of time
+        uint64_t spectator_frames = 0; // Updates queued on spectator sockets (shared, not copied)
+        uint64_t resyncs = 0; // Spectators that fell behind and were sent a fresh full STATE
+        uint64_t rejoins = 0; // Seats reclaimed with their token
+        uint64_t logged = 0; // Records appended to the table log
+        uint64_t log_syncs = 0; // Group commits of the table log
+    };
+
+    /**
+     * Client connection as seen from any shard: owning shard, socket and a generation
+     * that tells a reused descriptor from the connection that held it before.
+     */
+    struct ClientRef {
+        uint8_t shard = 0;
+        int32_t fd = -1; // -1 for no connection
+        uint32_t generation = 0;
+
+        bool operator==(const ClientRef& other) const {
+            return fd == other.fd && shard == other.shard && generation == other.generation;
+        }
+    };
+
+    /**
+     * Client command in a table queue (plain data, so the queues never allocate).
+     */
+    struct TableCommand {
+        ClientRef client; // Sender
+        MessageType type = MessageType::MOVE; // JOIN, START, MOVE or REJOIN
+        RoleType role = RoleType::GOVERNOR; // JOIN role
+        Move move = Move::decline(0); // MOVE move
+        uint8_t seat = 0; // REJOIN seat
+        uint64_t token = 0; // REJOIN token
+        uint8_t length = 0; // JOIN name length
+        char name[MAX_NAME_LENGTH]; // JOIN name
+    };
+
+    /**
+     * Command queue of one table, shared by the owning shard and every shard whose
+     * clients hold a seat there. Reference counted: the owner holds one reference
+     * while it hosts the table, each seat entry of a remote connection one, and a
+     * pending doorbell one, so the queue outlives the table until the last sender
+     * lets go. Commands that arrive after the table ended get UNKNOWN_TABLE.
+     */
+    struct TableInbox {
+        const uint32_t table; // Table id
+        MpscQueue<TableCommand> commands; // Filled by other shards, drained by the owner
+        std::atomic<bool> scheduled; // A doorbell for this queue is on its way to the owner
+        std::atomic<uint32_t> references;
+
+        TableInbox(uint32_t table, size_t capacity) : table(table), commands(capacity), scheduled(false), references(1) {}
+
+        void retain() { references.fetch_add(1, std::memory_order_relaxed); }
+
+        void release() {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete this;
+            }
+        }
+    };
+
+    /**
+     * Immutable encoded frame shared by every socket it is queued on. Reference counted
+     * across shards; the bytes follow the header in the same allocation.
+     */
+    struct SharedFrame {
+        std::atomic<uint32_t> references;
+        uint32_t size; // Bytes of the frame
+        uint8_t bytes[1]; // First byte of the frame
+
+        static SharedFrame* create(const uint8_t* data, size_t size) {
+            void* memory = ::operator new(sizeof(SharedFrame) + size);
+            SharedFrame* frame = new (memory) SharedFrame();
+            frame->references.store(1, std::memory_order_relaxed);
+            frame->size = static_cast<uint32_t>(size);
+            std::copy(data, data + size, frame->bytes);
+            return frame;
+        }
+
+        void retain() { references.fetch_add(1, std::memory_order_relaxed); }
+
+        void release() {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                this->~SharedFrame();
+                ::operator delete(this);
+            }
+        }
+
+    private:
+        SharedFrame() = default;
+    };
+
+    /**
+     * Fixed-size message between shards (plain data, so the queues never allocate).
+     */
+    struct ShardMessage {
+        enum Kind : uint8_t {
+            ADOPT, // Take over the accepted socket in client.fd
+            REQUEST, // Client request for a table of the receiving shard
+            REPLY, // Encoded frame for a client of the receiving shard
+            DETACH, // The client of a seat at a table of the receiving shard is gone
+            SCHEDULE, // The table queue in inbox has commands (carries one reference)
+            FANOUT, // Update of a table for the receiving shard's spectators (frame carries one reference)
+            UNWATCH // A spectator of a table of the receiving shard on client.shard is gone
+        };
+        enum Effect : uint8_t {
+            NO_EFFECT, // Plain reply
+            SEATED, // The client now holds table/seat
+            RELEASED, // The client no longer holds any seat at table
+            WATCHING, // The client now spectates table (the reply is its full STATE)
+            FINAL // FANOUT: the table has finished, its spectators are dropped
+        };
+
+        Kind kind = REQUEST;
+        Effect effect = NO_EFFECT; // REPLY: bookkeeping for the client's seat list
+        ClientRef client; // Client the message is from or for
+        uint32_t table = 0; // Table of the request, reply effect or detach
+        uint8_t seat = 0; // Seat of the effect or detach, REQUEST: REJOIN seat
+        MessageType type = MessageType::START; // REQUEST: message type
+        RoleType role = RoleType::GOVERNOR; // REQUEST: JOIN role
+        Move move = Move::decline(0); // REQUEST: MOVE move
+        uint64_t token = 0; // REQUEST: REJOIN token
+        uint8_t length = 0; // REQUEST: JOIN name length
+        uint16_t size = 0; // REPLY: frame size
+        TableInbox* inbox = nullptr; // SCHEDULE: queue to drain, SEATED reply: queue of the table (one reference)
+        SharedFrame* frame = nullptr; // FANOUT: update to queue
+        uint8_t bytes[FRAME_HEADER_SIZE + 7 + 255]; // REQUEST: JOIN name, REPLY: frame (the longest is an ERROR)
+    };
+
+    /**
+     * A shard: event loop, its connections and its tables.
+     */
+    class TableShard {
+    private:
+        // A seat held by a client, with the queue of its table when another shard owns it
+        struct SeatEntry {
+            uint32_t table;
+            uint8_t seat;
+            TableInbox* inbox; // One reference, nullptr for local tables
+        };
+
+        // One client connection owned by this shard
+        struct Connection {
+            int fd; // Socket
+            uint32_t generation; // Distinguishes reuses of fd
+            std::vector<uint8_t> input; // Received bytes not decoded yet
+            std::vector<uint8_t> output; // Encoded bytes not sent yet
+            size_t output_offset = 0; // Bytes of output already sent
+            std::deque<SharedFrame*> frames; // Spectator updates queued after output (one reference each)
+            size_t frame_offset = 0; // Bytes of the first frame already sent
+            bool writing = false; // EPOLLOUT is armed
+            bool dirty = false; // Listed for the end-of-round flush
+            bool closing = false; // Closed after the end-of-round flush (too slow or malformed input)
+            bool lagging = false; // Lost queued updates; watches again once its frames have drained
+            std::vector<SeatEntry> seats; // Seats of this client
+            std::vector<uint32_t> watching; // Tables this client spectates
+        };
+
+        // A connection spectating a table
+        struct Spectator {
+            int fd;
+            uint32_t generation;
+        };
+
+        // A table and the clients of its seats
+        struct Hosted {
+            std::unique_ptr<Table> table;
+            ClientRef seats[SNAPSHOT_MAX_PLAYERS]; // Client of every seat, fd -1 when gone
+            TableInbox* inbox = nullptr; // Command queue, created when another shard's client takes a seat
+            TimerId timer = 0; // Deadline of the current decision (of the grace period while frozen), 0 for none
+            bool timing_window = false; // The timer is the deadline of the open reaction window
+            bool frozen = false; // Recovered and waiting for its seats to be reclaimed; no timeouts are played
+            std::vector<uint32_t> watchers; // Spectators per shard (empty until the first WATCH)
+            uint32_t watcher_total = 0; // Spectators over all shards
+        };
+
+        const ServerConfig& config; // Settings shared by all shards
+        uint8_t index; // This shard
+        uint8_t shard_count; // Shards of the server
+        std::vector<TableShard*> peers; // Every shard, including this one
+        std::vector<std::unique_ptr<SpscQueue<ShardMessage>>> outbox; // To every shard (own slot unused)
+        std::vector<std::vector<ShardMessage>> overflow; // Messages waiting for room in a full outbox
+        std::vector<char> notify; // Peers to wake at the end of the round
+        std::vector<TableInbox*> ready; // Table queues with commands left over from an earlier batch
+        ServerStats stats; // Counters
+        int epoll_fd; // Event loop
+        int wake_fd; // eventfd written by peers and by stop()
+        std::vector<int> listeners; // Listening sockets of this shard
+        int handoff_fd; // Listener whose clients are spread over all shards, -1 for none
+        uint8_t next_handoff; // Shard that adopts the next handed-out client
+        std::atomic<bool> running; // Cleared by stop()
+        uint32_t generation; // Last connection generation handed out
+        std::vector<std::unique_ptr<Connection>> connections; // Indexed by file descriptor
+        std::vector<int> dirty; // Connections with output to flush this round
+        std::vector<int> resyncs; // Lagging connections whose queued frames have drained
+        std::unordered_map<uint32_t, std::vector<Spectator>> spectating; // Spectators among this shard's connections, by table
+        std::chrono::steady_clock::time_point epoch; // Tick 0 of the timer wheel (ticks are milliseconds)
+        TimerWheel timers; // Decision deadlines of the started tables
+        std::vector<uint64_t> expired; // Reused list of tables whose deadline passed
+        std::unordered_map<uint32_t, Hosted> tables; // Tables owned by this shard
+        uint32_t next_table; // Next local table number (ids are number * shard_count + index)
+        Message incoming; // Reused decode target
+        Message outgoing; // Reused encode source
+        std::vector<uint8_t> frame; // Reused encode buffer for replies
+        ShardMessage envelope; // Reused outgoing shard message
+        std::mt19937_64 token_source; // Seat tokens handed out in JOINED
+        std::unique_ptr<TableLog> log; // Write-ahead log of the started tables, nullptr without a log directory
+
+        void adopt(int fd);
+        void acceptFrom(int listener);
+        void readFrom(Connection& connection);
+        void route(Connection& connection, const Message& message);
+        bool enqueue(Connection& connection, const ShardMessage& message);
+        void drainTable(TableInbox* inbox);
+        void process(const ClientRef& client, const ShardMessage& message);
+        void processJoin(const ClientRef& client, const ShardMessage& message);
+        void processStart(const ClientRef& client, const ShardMessage& message);
+        void processMove(const ClientRef& client, const ShardMessage& message);
+        void processWatch(const ClientRef& client, const ShardMessage& message);
+        void processRejoin(const ClientRef& client, const ShardMessage& message);
+        TableInbox* shareInbox(Hosted& hosted, const ClientRef& client);
+        void unwatch(uint32_t table, uint8_t shard);
+        void publish(Hosted& hosted, bool final);
+        void fanOut(uint32_t table, SharedFrame* frame, bool final);
+        void queueFrame(Connection& connection, SharedFrame* frame);
+        void stopWatching(Connection& connection);
+        void resync(int fd);
+        void detach(uint32_t table, uint8_t seat, const ClientRef& client);
+        void broadcastState(Hosted& hosted);
+        void finishTable(uint32_t id);
+        void armTimer(Hosted& hosted);
+        void commitLog();
+        void checkpointLog();
+        void expireTimers();
+        int waitTimeout(bool pending);
+        uint64_t clock() const;
+        void releaseSeats(Connection& connection, uint32_t table);
+        void reply(const ClientRef& client, const Message& message, ShardMessage::Effect effect = ShardMessage::NO_EFFECT,
+                   uint32_t table = 0, uint8_t seat = 0, TableInbox* inbox = nullptr);
+        void replyError(const ClientRef& client, uint32_t table, ServerError error, const char* text = nullptr);
+        void replyToSeats(Hosted& hosted, ShardMessage::Effect effect);
+        void deliver(const ClientRef& client, const uint8_t* data, size_t size, ShardMessage::Effect effect,
+                     uint32_t table, uint8_t seat, TableInbox* inbox = nullptr);
+        void post(uint8_t shard, const ShardMessage& message);
+        void drainInbox();
+        bool flushOutbox();
+        bool flush(Connection& connection);
+        void markDirty(Connection& connection);
+        void close(int fd);
+        Connection* find(const ClientRef& client);
+
+    public:
+        /**
+         * Creates the event loop of shard index out of shard_count.
+         * Throws std::runtime_error when the loop cannot be set up.
+         */
+        TableShard(const ServerConfig& config, uint8_t index, uint8_t shard_count);
+        ~TableShard();
+
+        TableShard(const TableShard&) = delete;
+        TableShard& operator=(const TableShard&) = delete;
+
+        /**
+         * Wires the shards together (creates this shard's outgoing queues). Called once before run().
+         */
+        void connect(const std::vector<TableShard*>& all);
+
+        /**
+         * Adds a listener served by this shard. With handoff, accepted clients are spread
+         * round-robin over all shards instead of staying here.
+         */
+        void listen(int fd, bool handoff);
+
+        /**
+         * Takes over a table rebuilt by crash recovery. Its seats start vacant and it stays
+         * frozen until they are reclaimed with REJOIN (or the grace period ends). Called before run().
+         */
+        void host(std::unique_ptr<Table> table);
+
+        /**
+         * Starts logging to the configured directory as the given generation, beginning with
+         * a checkpoint of the hosted tables. Called after host() and before run().
+         */
+        void openLog(uint32_t generation);
+
+        /**
+         * Runs the loop until stop() is called.
+         */
+        void run();
+
+        /**
+         * Ends run() from any thread (and from signal handlers).
+         */
+        void stop();
+
+        /**
+         * Wakes the loop of this shard (after a peer filled its queue).
+         */
+        void wake();
+
+        /**
+         * Queue from shard `from` to this shard.
+         */
+        SpscQueue<ShardMessage>& inboxFrom(uint8_t from) { return *peers[from]->outbox[index]; }
+
+        const ServerStats& getStats() const { return stats; }
+        size_t tableCount() const { return tables.size(); }
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * TimerWheel.hpp
+ * Hierarchical timing wheel for the deadlines of hosted tables.
+ * Four levels of 64 slots cover 2^24 ticks (about 4.6 hours of 1 ms ticks);
+ * a timer sits in the lowest level whose slot range still contains its due tick
+ * and moves down one level each time the level below wraps around. Timers are
+ * nodes of one pool linked into their slot, so scheduling and cancelling are O(1)
+ * and expiring costs O(1) per timer plus the occasional cascade. Timers further
+ * out than the wheel's range wait in an overflow list that is revisited once per
+ * full turn of the top level.
+ */
+
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace coup {
+    /**
+     * Timer handle: pool index in the low half, reuse generation in the high half. 0 is never a valid timer.
+     */
+    using TimerId = uint64_t;
+
+    /**
+     * The wheel. Time is measured in caller-defined ticks that only move forward.
+     */
+    class TimerWheel {
+    private:
+        static constexpr unsigned SLOT_BITS = 6;
+        static constexpr unsigned SLOTS = 1u << SLOT_BITS; // Slots per level
+        static constexpr unsigned LEVELS = 4;
+        static constexpr unsigned OVERFLOW_SLOT = LEVELS * SLOTS; // List of timers beyond the top level
+        static constexpr uint32_t NIL = 0xFFFFFFFF; // No node
+        static constexpr uint16_t FREE = 0xFFFF; // Slot of a node that is not scheduled
+
+        struct Node {
+            uint64_t due; // Tick the timer expires at
+            uint64_t payload; // Caller's value, handed back on expiry
+            uint32_t prev; // Neighbours in the slot list (or the free list)
+            uint32_t next;
+            uint32_t generation; // Bumped on every reuse, so stale handles fail to cancel
+            uint16_t slot; // List the node is in, FREE when unused
+        };
+
+        std::vector<Node> nodes; // Pool of timers
+        uint32_t free_head; // First unused node
+        uint32_t heads[OVERFLOW_SLOT + 1]; // First node of every slot list
+        uint32_t tails[OVERFLOW_SLOT + 1]; // Last node of every slot list (new timers are appended)
+        uint64_t occupied[LEVELS]; // Bit per non-empty slot of every level
+        uint64_t current; // Next tick to process
+        size_t count; // Scheduled timers
+
+        void link(uint32_t node);
+        void unlink(uint32_t node);
+        void cascade(unsigned level);
+
+    public:
+        /**
+         * Starts the wheel at tick start.
+         */
+        explicit TimerWheel(uint64_t start = 0);
+
+        /**
+         * Schedules a timer for tick due (a due tick in the past expires on the next advance).
+         */
+        TimerId schedule(uint64_t due, uint64_t payload);
+
+        /**
+         * Cancels a pending timer. Returns false if it already expired or was cancelled.
+         */
+        bool cancel(TimerId id);
+
+        /**
+         * Processes every tick up to and including now, appending the payloads of the
+         * expired timers to expired in due order (ties in scheduling order).
+         */
+        void advance(uint64_t now, std::vector<uint64_t>& expired);
+
+        /**
+         * Ticks from the next unprocessed tick until the wheel has work: the next expiry,
+         * or an earlier cascade point where it must look again. UINT64_MAX when empty.
+         */
+        uint64_t ticksUntilNext() const;
+
+        /**
+         * Next tick to be processed.
+         */
+        uint64_t now() const { return current; }
+
+        size_t size() const { return count; }
+    };
+}
+
+#endif
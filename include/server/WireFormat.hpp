@@ -0,0 +1,185 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * WireFormat.hpp
+ * Little-endian encoding shared by the server protocol and the table log.
+ * Used only by the server sources: writers append to a byte vector, and WireReader
+ * walks one frame body or log record with a bounds check before every read.
+ */
+
+#ifndef WIRE_FORMAT_HPP
+#define WIRE_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Game.hpp"
+#include "../bots/Match.hpp"
+
+namespace coup {
+    inline void put8(std::vector<uint8_t>& out, uint8_t value) {
+        out.push_back(value);
+    }
+
+    inline void put16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    inline void put32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    inline void put64(std::vector<uint8_t>& out, uint64_t value) {
+        put32(out, static_cast<uint32_t>(value));
+        put32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    /**
+     * Overwrites four bytes written earlier (lengths and checksums known only at the end).
+     */
+    inline void patch32(std::vector<uint8_t>& out, size_t at, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out[at + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    inline void putMove(std::vector<uint8_t>& out, const Move& move) {
+        put8(out, move.pass ? 1 : 0);
+        put8(out, static_cast<uint8_t>(move.action.type));
+        put8(out, move.action.actor);
+        put8(out, move.action.target);
+    }
+
+    /**
+     * Writes a text with a one-byte length, cut to limit (at most 255) bytes.
+     */
+    inline void putText(std::vector<uint8_t>& out, std::string_view text, size_t limit) {
+        const size_t length = text.size() < limit ? text.size() : limit;
+        put8(out, static_cast<uint8_t>(length));
+        out.insert(out.end(), text.begin(), text.begin() + length);
+    }
+
+    /**
+     * Writes a block of raw bytes with a two-byte length.
+     */
+    inline void putBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+        put16(out, static_cast<uint16_t>(size));
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    constexpr size_t RULE_FIELDS = 6;
+
+    /**
+     * Rule fields in wire order (the protocol and the log share it).
+     */
+    inline int* ruleFields(GameRules& rules, size_t index) {
+        int* const fields[] = {&rules.coup_cost, &rules.tax_bonus, &rules.invest_payout,
+                               &rules.block_coup_cost, &rules.merchant_threshold, &rules.judge_surcharge};
+        return fields[index];
+    }
+
+    /**
+     * Bounds-checked reader over one frame body or log record. Throws
+     * std::invalid_argument naming what it reads (e.g. "message body").
+     */
+    class WireReader {
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t offset;
+        const char* what; // Name of the data in error messages
+
+        void need(size_t count) {
+            if (size - offset < count) {
+                throw std::invalid_argument(std::string("Truncated ") + what);
+            }
+        }
+
+    public:
+        WireReader(const uint8_t* data, size_t size, const char* what)
+        : data(data), size(size), offset(0), what(what) {}
+
+        uint8_t get8() {
+            need(1);
+            return data[offset++];
+        }
+
+        uint16_t get16() {
+            need(2);
+            const uint16_t value = static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+            offset += 2;
+            return value;
+        }
+
+        uint32_t get32() {
+            need(4);
+            uint32_t value = 0;
+            for (int i = 3; i >= 0; i--) {
+                value = (value << 8) | data[offset + i];
+            }
+            offset += 4;
+            return value;
+        }
+
+        uint64_t get64() {
+            const uint64_t low = get32();
+            return low | (static_cast<uint64_t>(get32()) << 32);
+        }
+
+        Move getMove() {
+            const uint8_t pass = get8();
+            const uint8_t type = get8();
+            const uint8_t actor = get8();
+            const uint8_t target = get8();
+            if (pass > 1 || type >= ACTION_TYPE_COUNT) {
+                throw std::invalid_argument(std::string("Invalid move in ") + what);
+            }
+            return {{static_cast<ActionType>(type), actor, target}, pass == 1};
+        }
+
+        /**
+         * Returns a view of a text written by putText, into the data (no copy).
+         */
+        std::string_view getText(size_t limit) {
+            const size_t length = get8();
+            if (length > limit) {
+                throw std::invalid_argument(std::string("Text field too long in ") + what);
+            }
+            need(length);
+            const std::string_view text(reinterpret_cast<const char*>(data + offset), length);
+            offset += length;
+            return text;
+        }
+
+        /**
+         * Copies a block written by putBytes, which must have exactly the expected size.
+         */
+        void getBytes(void* out, size_t expected) {
+            if (get16() != expected) {
+                throw std::invalid_argument(std::string("Block of unexpected size in ") + what + " (written by an incompatible build)");
+            }
+            need(expected);
+            std::memcpy(out, data + offset, expected);
+            offset += expected;
+        }
+
+        /**
+         * Checks that everything was read.
+         */
+        void finish() const {
+            if (offset != size) {
+                throw std::invalid_argument(std::string("Trailing bytes in ") + what);
+            }
+        }
+    };
+}
+
+#endif
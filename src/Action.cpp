@@ -0,0 +1,227 @@
+// Email: razcohenp@gmail.com
+
+// Action.cpp - Implementation of the compact action helpers
+// Dispatches actions to Player and role methods and enumerates legal actions per seat
+
+#include "../include/Action.hpp"
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Governor.hpp"
+
+
+namespace coup {
+    // Check if action type needs a target seat
+    bool actionHasTarget(ActionType type) {
+        switch (type) {
+            case ActionType::GATHER:
+            case ActionType::TAX:
+            case ActionType::BRIBE:
+            case ActionType::INVEST:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    // Check if action type may be used outside the actor's turn
+    bool isReactiveAction(ActionType type) {
+        return type == ActionType::BLOCK_COUP || type == ActionType::BLOCK_BRIBE || type == ActionType::UNDO;
+    }
+
+    // Get action name as string for display
+    std::string getActionName(ActionType type) {
+        switch (type) {
+            case ActionType::GATHER: return "Gather";
+            case ActionType::TAX: return "Tax";
+            case ActionType::BRIBE: return "Bribe";
+            case ActionType::ARREST: return "Arrest";
+            case ActionType::SANCTION: return "Sanction";
+            case ActionType::COUP: return "Coup";
+            case ActionType::INVEST: return "Invest";
+            case ActionType::SPY_ON: return "Spy On";
+            case ActionType::BLOCK_COUP: return "Block Coup";
+            case ActionType::BLOCK_BRIBE: return "Block Bribe";
+            case ActionType::UNDO: return "Undo";
+            default: return "Unknown";
+        }
+    }
+
+    // Apply action through the matching Player or role method, without throwing
+    ActionResult tryApplyAction(Game& game, const Action& action) {
+        if (action.actor >= game.getPlayerCount()) { // Validate actor seat
+            return actionFailure(ActionError::INVALID_ACTOR);
+        }
+
+        if (actionHasTarget(action.type) && action.target >= game.getPlayerCount()) { // Validate target seat
+            return actionFailure(ActionError::INVALID_TARGET);
+        }
+
+        Player* actor = game.getPlayer(action.actor);
+        Player* target = actionHasTarget(action.type) ? game.getPlayer(action.target) : nullptr;
+
+        switch (action.type) {
+            case ActionType::GATHER: return actor->tryGather();
+            case ActionType::TAX: return actor->tryTax(); // Virtual - Governor takes 3
+            case ActionType::BRIBE: return actor->tryBribe();
+            case ActionType::ARREST: return actor->tryArrest(*target);
+            case ActionType::SANCTION: return actor->trySanction(*target);
+            case ActionType::COUP: return actor->tryCoup(*target);
+            default: break;
+        }
+
+        // Role abilities - the actor must hold the matching role
+        const RoleType role = actor->getRole();
+        switch (action.type) {
+            case ActionType::INVEST:
+                if (role != RoleType::BARON) return actionFailure(ActionError::ROLE_REQUIRED);
+                return static_cast<Baron*>(actor)->tryInvest();
+            case ActionType::SPY_ON: {
+                if (role != RoleType::SPY) return actionFailure(ActionError::ROLE_REQUIRED);
+                Expected<int, ActionError> revealed = static_cast<Spy*>(actor)->trySpyOn(*target);
+                if (!revealed) return actionFailure(revealed.error());
+                return {};
+            }
+            case ActionType::BLOCK_COUP:
+                if (role != RoleType::GENERAL) return actionFailure(ActionError::ROLE_REQUIRED);
+                return static_cast<General*>(actor)->tryBlockCoup(*target);
+            case ActionType::BLOCK_BRIBE:
+                if (role != RoleType::JUDGE) return actionFailure(ActionError::ROLE_REQUIRED);
+                return static_cast<Judge*>(actor)->tryBlockBribe(*target);
+            case ActionType::UNDO:
+                if (role != RoleType::GOVERNOR) return actionFailure(ActionError::ROLE_REQUIRED);
+                return static_cast<Governor*>(actor)->tryUndo(*target);
+            default:
+                return actionFailure(ActionError::INVALID_ACTION);
+        }
+    }
+
+    // Throwing version - same messages as the Player and role methods
+    void applyAction(Game& game, const Action& action) {
+        throwIfFailed(tryApplyAction(game, action));
+    }
+
+    // List all legal actions of a seat (mirrors the validation in Player and role methods)
+    void legalActions(const Game& game, uint8_t seat, std::vector<Action>& out) {
+        out.clear();
+
+        if (!game.isGameStarted() || seat >= game.getPlayerCount()) {
+            return;
+        }
+
+        const size_t count = game.getPlayerCount();
+        const Player* self = game.getPlayer(seat);
+        const RoleType role = self->getRole();
+        const int coins = self->coins();
+        const GameRules& rules = game.getRules();
+
+        // Turn actions - only the current active player
+        if (self->isActive() && game.getCurrentPlayerIndex() == seat) {
+            const bool must_coup = coins >= 10 && !self->isBribeUsed(); // Mandatory coup rule
+
+            if (!must_coup) {
+                if (!self->isSanctioned()) { // Sanction blocks economic actions
+                    out.push_back({ActionType::GATHER, seat, NO_TARGET});
+                    out.push_back({ActionType::TAX, seat, NO_TARGET});
+                }
+
+                if (coins >= 4 && !self->isBribeUsed()) {
+                    out.push_back({ActionType::BRIBE, seat, NO_TARGET});
+                }
+
+                if (role == RoleType::BARON && coins >= 3) {
+                    out.push_back({ActionType::INVEST, seat, NO_TARGET});
+                }
+            }
+
+            for (size_t t = 0; t < count; t++) {
+                const Player* target = game.getPlayer(t);
+                if (t == seat || !target->isActive()) {
+                    continue;
+                }
+
+                const uint8_t target_seat = static_cast<uint8_t>(t);
+
+                if (!must_coup) {
+                    if (self->isArrestAvailable() && game.getLastArrestedPlayer() != target) {
+                        out.push_back({ActionType::ARREST, seat, target_seat});
+                    }
+
+                    int sanction_cost = target->getRole() == RoleType::JUDGE ? 3 + rules.judge_surcharge : 3; // Judge fee
+                    if (coins >= sanction_cost) {
+                        out.push_back({ActionType::SANCTION, seat, target_seat});
+                    }
+                }
+
+                if (coins >= rules.coup_cost) {
+                    out.push_back({ActionType::COUP, seat, target_seat});
+                }
+
+                if (role == RoleType::SPY && target->isArrestAvailable()) { // Spying twice has no effect
+                    out.push_back({ActionType::SPY_ON, seat, target_seat});
+                }
+            }
+        }
+
+        // Reactive abilities - available outside the turn as well
+        if (role == RoleType::GENERAL && coins >= rules.block_coup_cost) {
+            for (size_t t = 0; t < count; t++) {
+                const Player* target = game.getPlayer(t);
+                // Only an active General, or the couped General itself, may block
+                if (!target->isActive() && target->getCoupedBy() != nullptr && (self->isActive() || t == seat)) {
+                    out.push_back({ActionType::BLOCK_COUP, seat, static_cast<uint8_t>(t)});
+                }
+            }
+        }
+
+        if (!self->isActive()) {
+            return;
+        }
+
+        if (role == RoleType::JUDGE || role == RoleType::GOVERNOR) {
+            for (size_t t = 0; t < count; t++) {
+                const Player* target = game.getPlayer(t);
+                if (t == seat || !target->isActive()) {
+                    continue;
+                }
+
+                if (role == RoleType::JUDGE && target->isBribeUsed()) {
+                    out.push_back({ActionType::BLOCK_BRIBE, seat, static_cast<uint8_t>(t)});
+                }
+
+                if (role == RoleType::GOVERNOR && target->usedTaxLastAction() && target->coins() >= 2) {
+                    out.push_back({ActionType::UNDO, seat, static_cast<uint8_t>(t)});
+                }
+            }
+        }
+    }
+
+    // Play one random legal action for the current player
+    bool playRandomAction(Game& game, std::mt19937& rng, std::vector<Action>& scratch, Action& chosen) {
+        const uint8_t seat = static_cast<uint8_t>(game.getCurrentPlayerIndex());
+        legalActions(game, seat, scratch);
+
+        if (scratch.empty()) { // Stuck player (sanctioned, spied on and broke) loses the turn
+            game.nextTurn();
+            return false;
+        }
+
+        chosen = scratch[rng() % scratch.size()];
+        applyAction(game, chosen);
+        return true;
+    }
+
+    // Check whether the game has been decided
+    bool isGameOver(const Game& game) {
+        int active_count = 0;
+        for (size_t i = 0; i < game.getPlayerCount(); i++) {
+            if (game.getPlayer(i)->isActive()) {
+                active_count++;
+            }
+        }
+        return active_count <= 1;
+    }
+}
@@ -0,0 +1,46 @@
+// Email: razcohenp@gmail.com
+
+// ActionError.cpp - Messages of action error codes
+// The texts match the exceptions thrown by the Player and role methods
+
+#include "../include/ActionError.hpp"
+
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    // Map error code to its message
+    const char* getActionErrorMessage(ActionError error) {
+        switch (error) {
+            case ActionError::NONE: return "No error";
+            case ActionError::GAME_NOT_STARTED: return "Game has not started yet";
+            case ActionError::NOT_YOUR_TURN: return "Not your turn";
+            case ActionError::PLAYER_ELIMINATED: return "Player is eliminated";
+            case ActionError::MUST_COUP: return "You have 10 or more coins, must perform coup";
+            case ActionError::SANCTIONED: return "Player is sanctioned";
+            case ActionError::ARREST_UNAVAILABLE: return "Arrest action is not available";
+            case ActionError::SELF_TARGET: return "An action against yourself is not allowed";
+            case ActionError::TARGET_ELIMINATED: return "Target player is eliminated";
+            case ActionError::CONSECUTIVE_ARREST: return "This player was the last player to be arrested (consecutive arrest is not allowed)";
+            case ActionError::NOT_ENOUGH_COINS_BRIBE: return "Not enough coins for bribe";
+            case ActionError::NOT_ENOUGH_COINS_SANCTION: return "Not enough coins for sanction";
+            case ActionError::NOT_ENOUGH_COINS_SANCTION_JUDGE: return "Not enough coins for sanction (higher fee)";
+            case ActionError::NOT_ENOUGH_COINS_COUP: return "Not enough coins for coup";
+            case ActionError::NOT_ENOUGH_COINS_INVEST: return "Not enough coins for investment";
+            case ActionError::NOT_ENOUGH_COINS_BLOCK_COUP: return "Not enough coins to block coup";
+            case ActionError::TARGET_NOT_ENOUGH_COINS: return "Not enough coins";
+            case ActionError::TARGET_NOT_COUPED: return "Target player is not couped";
+            case ActionError::COUP_WINDOW_CLOSED: return "Too late, you cannot block this coup anymore";
+            case ActionError::NO_TAX_TO_UNDO: return "Target player did not use tax as his last action";
+            case ActionError::NO_BRIBE_TO_BLOCK: return "Target player has not used bribe as a last action";
+            case ActionError::INVALID_ACTOR: return "Invalid actor seat";
+            case ActionError::INVALID_TARGET: return "Invalid target seat";
+            case ActionError::ROLE_REQUIRED: return "The actor does not have the role of this ability";
+            case ActionError::INVALID_ACTION: return "Invalid action type";
+            default: return "Unknown error";
+        }
+    }
+
+    void throwActionError(ActionError error) {
+        throw std::runtime_error(getActionErrorMessage(error));
+    }
+}
@@ -0,0 +1,33 @@
+// Email: razcohenp@gmail.com
+
+// ActionEvaluator.cpp - Built-in material evaluator for what-if queries
+
+#include "../include/ActionEvaluator.hpp"
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+
+#include <algorithm> // For std::max
+
+namespace coup {
+    double MaterialEvaluator::evaluate(const Game& after, const Action& action, uint8_t seat) const {
+        (void)action;
+        const Player* self = after.getPlayer(seat);
+        if (!self->isActive()) {
+            return -100.0;
+        }
+
+        int richest = 0;
+        int eliminated = 0;
+        for (size_t other = 0; other < after.getPlayerCount(); other++) {
+            if (other == seat) continue;
+            const Player* player = after.getPlayer(other);
+            if (player->isActive()) {
+                richest = std::max(richest, player->coins());
+            }
+            else {
+                eliminated++;
+            }
+        }
+        return 20.0 * eliminated + self->coins() - 0.5 * richest;
+    }
+}
@@ -0,0 +1,190 @@
+// Email: razcohenp@gmail.com
+
+// ColumnarExport.cpp - Implementation of the columnar analytics exporter
+// Turns live games or recorded traces into one binary file per column
+
+#include "../include/ColumnarExport.hpp"
+#include "../include/Game.hpp"
+#include "../include/Trace.hpp"
+
+#include <stdexcept> // For exception handling
+#include <filesystem> // For creating the output directory
+#include <algorithm> // For std::clamp
+
+namespace coup {
+    // Coins are stored as 16-bit values, clamp so an absurd state cannot wrap around
+    static int16_t coinValue(int32_t coins) {
+        return static_cast<int16_t>(std::clamp<int32_t>(coins, INT16_MIN, INT16_MAX));
+    }
+
+    // Create the output directory before the column files are opened
+    static std::string prepareDirectory(const std::string& directory) {
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+
+    // Create the directory and open every column file
+    ColumnarExporter::ColumnarExporter(const std::string& directory, size_t chunk_rows, uint32_t first_game_id)
+    : directory(prepareDirectory(directory)),
+    action_game_id(directory + "/actions.game_id.u32", chunk_rows),
+    action_turn(directory + "/actions.turn.u32", chunk_rows),
+    action_seat(directory + "/actions.seat.u8", chunk_rows),
+    action_role(directory + "/actions.role.u8", chunk_rows),
+    action_type(directory + "/actions.action.u8", chunk_rows),
+    action_target(directory + "/actions.target.u8", chunk_rows),
+    action_coins_before(directory + "/actions.coins_before.i16", chunk_rows),
+    action_coins_after(directory + "/actions.coins_after.i16", chunk_rows),
+    game_id(directory + "/games.game_id.u32", chunk_rows),
+    game_player_count(directory + "/games.player_count.u8", chunk_rows),
+    game_action_count(directory + "/games.action_count.u32", chunk_rows),
+    game_winner_seat(directory + "/games.winner_seat.u8", chunk_rows),
+    game_winner_role(directory + "/games.winner_role.u8", chunk_rows),
+    next_game_id(first_game_id), current_game_id(0), current_turn(0), in_game(false) {
+        if (chunk_rows == 0) {
+            throw std::invalid_argument("Chunk size must be positive");
+        }
+        writeSchema();
+    }
+
+    // Flush remaining values on destruction
+    ColumnarExporter::~ColumnarExporter() {
+        try {
+            flush();
+        }
+        catch (const std::exception&) {
+            // Destructors must not throw; callers that care flush() explicitly
+        }
+    }
+
+    // Describe the column files so analysts do not have to read this code
+    void ColumnarExporter::writeSchema() const {
+        std::ofstream schema(directory + "/schema.txt", std::ios::trunc);
+        schema << "# Coup columnar export - one file per column, fixed-width values in host byte order\n"
+               << "# Rows of files with the same prefix line up by index\n"
+               << "actions.game_id.u32       uint32  game the action belongs to\n"
+               << "actions.turn.u32          uint32  0-based index of the action within its game\n"
+               << "actions.seat.u8           uint8   seat of the acting player\n"
+               << "actions.role.u8           uint8   RoleType of the acting player (0 Governor .. 5 Merchant, 6 Player)\n"
+               << "actions.action.u8         uint8   ActionType (0 Gather .. 10 Undo)\n"
+               << "actions.target.u8         uint8   target seat, 255 when the action has no target\n"
+               << "actions.coins_before.i16  int16   coins of the acting player before the action\n"
+               << "actions.coins_after.i16   int16   coins of the acting player after the action\n"
+               << "games.game_id.u32         uint32  game id\n"
+               << "games.player_count.u8     uint8   number of seats\n"
+               << "games.action_count.u32    uint32  number of actions in the game\n"
+               << "games.winner_seat.u8      uint8   seat of the winner, 255 when the game did not finish\n"
+               << "games.winner_role.u8      uint8   RoleType of the winner, 255 when the game did not finish\n";
+        schema.flush();
+        if (!schema) {
+            throw std::runtime_error("Failed to write " + directory + "/schema.txt");
+        }
+    }
+
+    // Append one action row
+    void ColumnarExporter::addActionRow(const Action& action, const GameSnapshot& before, const GameSnapshot& after) {
+        const uint8_t seat = action.actor < after.header.player_count ? action.actor : 0;
+
+        action_game_id.push(current_game_id);
+        action_turn.push(current_turn++);
+        action_seat.push(action.actor);
+        action_role.push(after.players[seat].role);
+        action_type.push(static_cast<uint8_t>(action.type));
+        action_target.push(actionHasTarget(action.type) ? action.target : NO_TARGET);
+        action_coins_before.push(coinValue(before.players[seat].coins));
+        action_coins_after.push(coinValue(after.players[seat].coins));
+    }
+
+    // Append one game row, the winner is the only active seat (if any)
+    void ColumnarExporter::addGameRow(const GameSnapshot& final_state) {
+        uint8_t winner = SNAPSHOT_NO_SEAT;
+        int active_count = 0;
+        for (uint8_t seat = 0; seat < final_state.header.player_count; seat++) {
+            if (final_state.players[seat].flags & FLAG_ACTIVE) {
+                active_count++;
+                winner = seat;
+            }
+        }
+        if (active_count != 1) {
+            winner = SNAPSHOT_NO_SEAT;
+        }
+
+        game_id.push(current_game_id);
+        game_player_count.push(final_state.header.player_count);
+        game_action_count.push(current_turn);
+        game_winner_seat.push(winner);
+        game_winner_role.push(winner == SNAPSHOT_NO_SEAT ? SNAPSHOT_NO_SEAT : final_state.players[winner].role);
+    }
+
+    // Start a live game
+    uint32_t ColumnarExporter::beginGame(const Game& game) {
+        if (in_game) {
+            throw std::runtime_error("Previous game was not finished");
+        }
+
+        game.saveSnapshot(previous, false);
+        current_game_id = next_game_id++;
+        current_turn = 0;
+        in_game = true;
+        return current_game_id;
+    }
+
+    // Record an applied action of the live game
+    void ColumnarExporter::recordAction(const Action& action, const Game& game) {
+        if (!in_game) {
+            throw std::runtime_error("No game is being recorded");
+        }
+
+        game.saveSnapshot(scratch, false);
+        addActionRow(action, previous, scratch);
+        previous.header = scratch.header; // The RNG area is not used by the exporter
+        std::copy(scratch.players, scratch.players + SNAPSHOT_MAX_PLAYERS, previous.players);
+    }
+
+    // Finish the live game
+    void ColumnarExporter::endGame(const Game& game) {
+        if (!in_game) {
+            throw std::runtime_error("No game is being recorded");
+        }
+
+        game.saveSnapshot(scratch, false);
+        addGameRow(scratch);
+        in_game = false;
+    }
+
+    // Export a whole recorded game
+    uint32_t ColumnarExporter::exportTrace(const TraceReader& trace) {
+        if (in_game) {
+            throw std::runtime_error("Previous game was not finished");
+        }
+
+        current_game_id = next_game_id++;
+        current_turn = 0;
+        trace.stateAt(0, previous);
+
+        trace.forEachAction([&](size_t, const Action& action, const GameSnapshot& after) {
+            addActionRow(action, previous, after);
+            previous.header = after.header;
+            std::copy(after.players, after.players + SNAPSHOT_MAX_PLAYERS, previous.players);
+        });
+
+        addGameRow(previous);
+        return current_game_id;
+    }
+
+    // Write all buffered values
+    void ColumnarExporter::flush() {
+        action_game_id.flush();
+        action_turn.flush();
+        action_seat.flush();
+        action_role.flush();
+        action_type.flush();
+        action_target.flush();
+        action_coins_before.flush();
+        action_coins_after.flush();
+        game_id.flush();
+        game_player_count.flush();
+        game_action_count.flush();
+        game_winner_seat.flush();
+        game_winner_role.flush();
+    }
+}
@@ -11,11 +11,16 @@
 #include "../include/roles/Governor.hpp"
 #include "../include/roles/Baron.hpp"
 #include "../include/roles/Spy.hpp"
+#include "../include/Logger.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/ActionEvaluator.hpp"
 
 #include <iostream> // For console output operations
 #include <stdexcept> // For exception handling
 #include <algorithm> // For STL algorithms like std::find
 #include <chrono> // For high-precision time-based random seeding
+#include <cstring> // For memcpy in snapshot save/restore
+#include <memory> // For the per-thread scratch clone
 
 namespace coup {
     /**
@@ -34,7 +39,7 @@ namespace coup {
     Game::Game(const Game& other)
     : current_player_index(other.current_player_index), game_started(other.game_started),
     last_arrested_player(nullptr), // Will be set after copying players
-    random_generator(other.random_generator) {
+    random_generator(other.random_generator), rules(other.rules) {
         // Deep copy all players
         for (Player* player : other.players_list) {
             Player* new_player = nullptr;
@@ -107,6 +112,7 @@ namespace coup {
         game_started = other.game_started;
         last_arrested_player = nullptr;
         random_generator = other.random_generator;
+        rules = other.rules;
         
         // Deep copy all players
         for (Player* player : other.players_list) {
@@ -165,7 +171,7 @@ namespace coup {
             throw std::runtime_error("No players in game");
         }
         
-        std::cout << players_list[current_player_index]->getName() << std::endl; // Output current player's name
+        std::cout << players_list[current_player_index]->getName() << '\n'; // Output current player's name (no flush per turn)
     }
     
     /**
@@ -268,7 +274,7 @@ namespace coup {
                 for (Player* player : players_list) {
                     if (player->isActive()) {
                         active_count++;
-                        if (player->getRoleType() == "General" && player->coins() >= 5) { // General with blocking capability
+                        if (player->getRoleType() == "General" && player->coins() >= rules.block_coup_cost) { // General with blocking capability
                             has_active_general_with_coins = true;
                         }
                     }
@@ -291,7 +297,7 @@ namespace coup {
         }
 
         if(next_player->getRoleType() == "Merchant") { // Handle Merchant's turn-start bonus
-            if (next_player->coins() >= 3) { // Merchant gains coin if wealthy enough
+            if (next_player->coins() >= rules.merchant_threshold) { // Merchant gains coin if wealthy enough
                 next_player->addCoins(1);
             }
         }
@@ -305,6 +311,8 @@ namespace coup {
                 player->resetCoupedBy(); // Remove coup reference when window expires
             }
         }
+
+        COUP_LOG_DEBUG("Turn passes to {} ({} coins)", next_player->getName(), next_player->coins());
     }
     
     /**
@@ -339,12 +347,34 @@ namespace coup {
         
         game_started = true;
         // current_player_index = 0; // Start with first player
+        COUP_LOG_DEBUG("Game started with {} players", players_list.size());
     }
     
     // Check if game is started
     bool Game::isGameStarted() const {
         return game_started;
     }
+
+    bool GameRules::operator==(const GameRules& other) const {
+        return coup_cost == other.coup_cost && tax_bonus == other.tax_bonus && invest_payout == other.invest_payout &&
+               block_coup_cost == other.block_coup_cost && merchant_threshold == other.merchant_threshold &&
+               judge_surcharge == other.judge_surcharge;
+    }
+
+    // Rules are fixed once play begins
+    void Game::setRules(const GameRules& new_rules) {
+        if (game_started) {
+            throw std::runtime_error("Cannot change rules after the game has started");
+        }
+        if (new_rules.coup_cost < 0 || new_rules.tax_bonus < 0 || new_rules.invest_payout < 3 ||
+            new_rules.block_coup_cost < 0 || new_rules.merchant_threshold < 0 || new_rules.judge_surcharge < 0) {
+            throw std::invalid_argument("Invalid rule parameters (negative cost or a losing investment)");
+        }
+        if (new_rules.coup_cost > 10) { // Players with 10 coins must coup, so they must also afford it
+            throw std::invalid_argument("Coup cost cannot exceed the mandatory coup threshold of 10");
+        }
+        rules = new_rules;
+    }
     
     // Get current player
     Player* Game::getCurrentPlayer() const {
@@ -422,7 +452,7 @@ namespace coup {
         for (Player* player : players_list) {
             if (player->isActive()) {
                 active_count++;
-                if (player->getRoleType() == "General" && player->coins() >= 5) {
+                if (player->getRoleType() == "General" && player->coins() >= rules.block_coup_cost) {
                     has_active_general_with_coins = true;
                 }
             }
@@ -430,7 +460,53 @@ namespace coup {
         
         return (active_count == 2 && has_active_general_with_coins);
     }
-    
+
+    // Same seats (names and roles) and rules - the clone can load this game's snapshots
+    static bool sameTable(const Game& game, const Game& other) {
+        if (game.getPlayerCount() != other.getPlayerCount() || game.getRules() != other.getRules()) {
+            return false;
+        }
+        for (size_t seat = 0; seat < game.getPlayerCount(); seat++) {
+            if (game.getPlayer(seat)->getRole() != other.getPlayer(seat)->getRole() ||
+                game.getPlayer(seat)->getName() != other.getPlayer(seat)->getName()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // One snapshot of this game, reloaded into the scratch before every action
+    size_t Game::evaluateAllActions(GameClone& scratch, const ActionEvaluator& evaluator, std::vector<ActionScore>& out) const {
+        out.clear();
+        if (!game_started || players_list.empty()) {
+            return 0;
+        }
+        if (!sameTable(*this, scratch.game())) {
+            throw std::invalid_argument("Scratch clone does not match this game");
+        }
+
+        thread_local std::vector<Action> actions; // Reused between calls
+        const uint8_t seat = static_cast<uint8_t>(current_player_index);
+        legalActions(*this, seat, actions);
+
+        GameSnapshot position;
+        saveSnapshot(position, false);
+        for (const Action& action : actions) {
+            scratch.load(position);
+            applyAction(scratch.game(), action);
+            out.push_back({action, evaluator.evaluate(scratch.game(), action, seat)});
+        }
+        return out.size();
+    }
+
+    size_t Game::evaluateAllActions(const ActionEvaluator& evaluator, std::vector<ActionScore>& out) const {
+        thread_local std::unique_ptr<GameClone> scratch;
+        if (!scratch || !sameTable(*this, scratch->game())) {
+            scratch.reset(new GameClone(*this));
+        }
+        return evaluateAllActions(*scratch, evaluator, out);
+    }
+
     // Methods for Role Assignment
     // Assign roles to existing players without recreating them
     void Game::assignRolesToExistingPlayers() {
@@ -506,4 +582,133 @@ namespace coup {
                 throw std::runtime_error("Invalid role type");
         }
     }
-}
\ No newline at end of file
+
+    // Methods for Snapshot Save/Restore
+    // Finds the seat of a player, or SNAPSHOT_NO_SEAT for null/unknown players
+    static uint8_t seatOf(const std::vector<Player*>& players_list, const Player* player) {
+        for (size_t i = 0; i < players_list.size(); i++) {
+            if (players_list[i] == player) {
+                return static_cast<uint8_t>(i);
+            }
+        }
+        return SNAPSHOT_NO_SEAT;
+    }
+
+    // Write the full game state into a fixed-layout snapshot
+    void Game::saveSnapshot(GameSnapshot& snapshot, bool include_rng) const {
+        // Zero padding and unused seats for deterministic blobs (the large RNG area only when it is written)
+        std::memset(&snapshot.header, 0, sizeof(snapshot.header));
+        std::memset(snapshot.players, 0, sizeof(snapshot.players));
+
+        snapshot.header.magic = SNAPSHOT_MAGIC;
+        snapshot.header.version = SNAPSHOT_VERSION;
+        snapshot.header.header_size = sizeof(SnapshotHeader);
+        snapshot.header.total_size = sizeof(GameSnapshot);
+        snapshot.header.rng_size = include_rng ? sizeof(std::mt19937) : 0;
+        snapshot.header.player_count = static_cast<uint8_t>(players_list.size());
+        snapshot.header.game_started = game_started ? 1 : 0;
+        snapshot.header.current_player_index = static_cast<uint8_t>(current_player_index);
+        snapshot.header.last_arrested = seatOf(players_list, last_arrested_player);
+
+        for (size_t i = 0; i < players_list.size(); i++) {
+            const Player* player = players_list[i];
+            PlayerRecord& record = snapshot.players[i];
+
+            std::memcpy(record.name, player->name.c_str(), player->name.size()); // Names are shorter than the field
+            record.role = static_cast<uint8_t>(player->getRole());
+            record.flags = (player->active ? FLAG_ACTIVE : 0) | (player->sanctioned ? FLAG_SANCTIONED : 0) |
+                (player->arrest_available ? FLAG_ARREST_AVAILABLE : 0) | (player->bribe_used ? FLAG_BRIBE_USED : 0) |
+                (player->used_tax_last_action ? FLAG_USED_TAX : 0);
+            record.coins = player->coin_count;
+            record.couped_by = seatOf(players_list, player->couped_by);
+        }
+
+        if (include_rng) { // Otherwise the RNG area is left as it was; rng_size 0 tells readers to ignore it
+            std::memcpy(snapshot.rng, &random_generator, sizeof(random_generator)); // Engine is trivially copyable
+        }
+    }
+
+    // Serialize the full game state into a binary blob
+    void Game::saveSnapshot(std::vector<unsigned char>& buffer) const {
+        GameSnapshot snapshot;
+        saveSnapshot(snapshot);
+        buffer.resize(sizeof(GameSnapshot)); // No reallocation when the buffer is reused
+        std::memcpy(buffer.data(), &snapshot, sizeof(GameSnapshot));
+    }
+
+    // Restore the game state from a snapshot of the same roster
+    void Game::loadSnapshot(const GameSnapshot& snapshot) {
+        const SnapshotHeader& header = snapshot.header;
+
+        // Validate everything before touching any state so a bad snapshot leaves the game unchanged
+        if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+            header.header_size != sizeof(SnapshotHeader) || header.total_size != sizeof(GameSnapshot)) {
+            throw std::runtime_error("Snapshot format is not supported");
+        }
+
+        if (header.rng_size != 0 && header.rng_size != sizeof(std::mt19937)) {
+            throw std::runtime_error("Snapshot was written by an incompatible build");
+        }
+
+        if (header.player_count != players_list.size()) {
+            throw std::runtime_error("Snapshot does not match the players in this game");
+        }
+
+        if (!players_list.empty() && header.current_player_index >= header.player_count) {
+            throw std::runtime_error("Snapshot has an invalid current player");
+        }
+
+        if (header.last_arrested != SNAPSHOT_NO_SEAT && header.last_arrested >= header.player_count) {
+            throw std::runtime_error("Snapshot has an invalid last arrested player");
+        }
+
+        for (size_t i = 0; i < players_list.size(); i++) {
+            const PlayerRecord& record = snapshot.players[i];
+
+            if (record.role != static_cast<uint8_t>(players_list[i]->getRole()) ||
+                strncmp(record.name, players_list[i]->name.c_str(), SNAPSHOT_NAME_SIZE) != 0) {
+                throw std::runtime_error("Snapshot does not match the players in this game");
+            }
+
+            if (record.couped_by != SNAPSHOT_NO_SEAT && record.couped_by >= header.player_count) {
+                throw std::runtime_error("Snapshot has an invalid coup reference");
+            }
+        }
+
+        // Apply state directly to the fields (setters would trigger role side effects like Baron compensation)
+        for (size_t i = 0; i < players_list.size(); i++) {
+            const PlayerRecord& record = snapshot.players[i];
+            Player* player = players_list[i];
+
+            player->coin_count = record.coins;
+            player->active = (record.flags & FLAG_ACTIVE) != 0;
+            player->sanctioned = (record.flags & FLAG_SANCTIONED) != 0;
+            player->arrest_available = (record.flags & FLAG_ARREST_AVAILABLE) != 0;
+            player->bribe_used = (record.flags & FLAG_BRIBE_USED) != 0;
+            player->used_tax_last_action = (record.flags & FLAG_USED_TAX) != 0;
+            player->couped_by = record.couped_by == SNAPSHOT_NO_SEAT ? nullptr : players_list[record.couped_by];
+        }
+
+        game_started = header.game_started != 0;
+        current_player_index = header.current_player_index;
+        last_arrested_player = header.last_arrested == SNAPSHOT_NO_SEAT ? nullptr : players_list[header.last_arrested];
+        if (header.rng_size != 0) { // Snapshots taken without RNG keep the current generator
+            std::memcpy(&random_generator, snapshot.rng, sizeof(random_generator));
+        }
+    }
+
+    // Restore the game state from a binary blob
+    void Game::loadSnapshot(const unsigned char* data, size_t size) {
+        if (data == nullptr || size != sizeof(GameSnapshot)) { // Bounds check before copying
+            throw std::runtime_error("Snapshot size is invalid");
+        }
+
+        GameSnapshot snapshot;
+        std::memcpy(&snapshot, data, sizeof(GameSnapshot)); // Copy out to get correct alignment
+        loadSnapshot(snapshot);
+    }
+
+    void Game::loadSnapshot(const std::vector<unsigned char>& buffer) {
+        loadSnapshot(buffer.data(), buffer.size());
+    }
+}
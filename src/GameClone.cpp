@@ -0,0 +1,56 @@
+// Email: razcohenp@gmail.com
+
+// GameClone.cpp - Implementation of the simulation clone
+// Recreates the source roster once, then copies states through snapshots
+
+#include "../include/GameClone.hpp"
+
+#include <cstring> // For strnlen on fixed-size names
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    // Recreate every seat with the same name and role, then copy the state
+    GameClone::GameClone(const Game& source) {
+        roster.reserve(source.getPlayerCount());
+        for (size_t seat = 0; seat < source.getPlayerCount(); seat++) {
+            const Player* player = source.getPlayer(seat);
+            addSeat(player->getName(), player->getRole());
+        }
+        clone_game.setRules(source.getRules());
+        copyFrom(source);
+    }
+
+    // Seats come from the snapshot records
+    GameClone::GameClone(const GameSnapshot& snapshot, const GameRules& rules) {
+        if (snapshot.header.player_count > SNAPSHOT_MAX_PLAYERS) {
+            throw std::runtime_error("Snapshot has too many players");
+        }
+
+        roster.reserve(snapshot.header.player_count);
+        for (size_t seat = 0; seat < snapshot.header.player_count; seat++) {
+            const PlayerRecord& record = snapshot.players[seat];
+            if (record.role > static_cast<uint8_t>(RoleType::PLAYER)) {
+                throw std::runtime_error("Snapshot has an invalid role");
+            }
+            addSeat(std::string(record.name, strnlen(record.name, SNAPSHOT_NAME_SIZE)), static_cast<RoleType>(record.role));
+        }
+        clone_game.setRules(rules);
+        load(snapshot);
+    }
+
+    void GameClone::addSeat(const std::string& name, RoleType role) {
+        if (role == RoleType::PLAYER) { // Plain players have no factory role
+            roster.emplace_back(new Player(clone_game, name));
+        }
+        else {
+            roster.emplace_back(clone_game.createPlayerWithRole(name, role));
+        }
+    }
+
+    // Snapshot without RNG - simulations never draw from the game generator
+    void GameClone::copyFrom(const Game& source) {
+        GameSnapshot snapshot;
+        source.saveSnapshot(snapshot, false);
+        clone_game.loadSnapshot(snapshot);
+    }
+}
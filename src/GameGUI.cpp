@@ -11,6 +11,7 @@
 #include "../include/roles/General.hpp"
 #include "../include/roles/Judge.hpp"
 #include "../include/roles/Merchant.hpp"
+#include "../include/Logger.hpp"
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -425,7 +426,7 @@ namespace coup {
     bool GameGUI::initialize() {
         // Load fonts for consistent typography throughout the application
         if (!mainFont.loadFromFile("resources/tahoma.ttf")) {
-            std::cout << "Error: Could not load Tahoma font. The game UI may not display properly." << std::endl;
+            COUP_LOG_WARNING("Could not load {} - the game UI may not display properly", "resources/tahoma.ttf");
         }
         
         titleFont = mainFont; // Use same font for title (can be customized later)
@@ -557,7 +558,7 @@ namespace coup {
             {"Bribe", "bribe"}, // Pay 2 coins to bribe player (can be blocked by Judge)
             {"Arrest", "arrest"}, // Pay 7 coins to arrest player (can be blocked by Spy)
             {"Sanction", "sanction"}, // Pay 3 coins to steal 2 coins from player
-            {"Coup", "coup"} // Pay 5 coins to eliminate player (can be blocked by General)
+            {"Coup", "coup"} // Pay GameRules::coup_cost coins to eliminate player (can be blocked by General)
         };
         
         // Configure button layout parameters for the action panel
@@ -614,7 +615,7 @@ namespace coup {
                     }
                     break;
                 case RoleType::GENERAL:
-                    if (player->coins() >= 5) { // General needs 5+ coins to block coup attempts
+                    if (player->coins() >= game->getRules().block_coup_cost) { // General needs GameRules::block_coup_cost coins to block coup attempts
                         hasActiveGeneral = true;
                     }
                     break;
@@ -1146,8 +1147,8 @@ namespace coup {
                 updateMessage(currentPlayer->getName() + " sanctioned (3 coins) " + target->getName());
             }
             else if (action == "coup" && target) {
-                currentPlayer->coup(*target); // Pay 7 coins to eliminate target
-                updateMessage(currentPlayer->getName() + " performed coup (7 coins) on " + target->getName());
+                currentPlayer->coup(*target); // Pay GameRules::coup_cost coins to eliminate target
+                updateMessage(currentPlayer->getName() + " performed coup (" + std::to_string(game->getRules().coup_cost) + " coins) on " + target->getName());
             }
             
             // Execute role-specific special abilities
@@ -1191,7 +1192,7 @@ namespace coup {
                 std::vector<Player*> eligiblePlayers = getEligibleReactivePlayers(action);
                 
                 if (eligiblePlayers.empty()) {
-                    updateMessage("No active General with 5+ coins available to block coup!", true); // No eligible Generals
+                    updateMessage("No active General with " + std::to_string(game->getRules().block_coup_cost) + "+ coins available to block coup!", true); // No eligible Generals
                 } else if (eligiblePlayers.size() == 1) {
                     executeReactiveAction(action, eligiblePlayers[0], target);
                 } else {
@@ -1233,7 +1234,7 @@ namespace coup {
                 
                 // Search for active General with sufficient coins to block coup
                 for (Player* player : allPlayers) {
-                    if (player->getRoleType() == "General" && player->coins() >= 5) { // General needs 5+ coins to block
+                    if (player->getRoleType() == "General" && player->coins() >= game->getRules().block_coup_cost) { // General needs GameRules::block_coup_cost coins to block
                         hasGeneralWithCoins = true; // Found eligible General
                         break; // Only need to find one eligible General
                     }
@@ -1501,9 +1502,9 @@ namespace coup {
                     }
                 }
             } else if (button.action == "coup") {
-                // Player can coup if: active, has 7+ coins, and has targets
+                // Player can coup if: active, has GameRules::coup_cost coins, and has targets
                 available = currentPlayer->isActive() && 
-                        currentPlayer->coins() >= 7 && 
+                        currentPlayer->coins() >= game->getRules().coup_cost && 
                         !getTargetablePlayers().empty(); // Need valid targets for coup
             }
             // Role-specific actions validation
@@ -1538,12 +1539,12 @@ namespace coup {
                     }
                 }
             } else if (button.action == "block_coup") {
-                // Find any General player with 5+ coins for coup blocking ability
+                // Find any General player with GameRules::block_coup_cost coins for coup blocking ability
                 std::vector<Player*> allPlayers = game->getAllPlayers();
                 available = false;
                 for (Player* player : allPlayers) {
                     General* general = dynamic_cast<General*>(player); // Check for General role
-                    if (general && player->coins() >= 5) { // General needs 5+ coins to block
+                    if (general && player->coins() >= game->getRules().block_coup_cost) { // General needs GameRules::block_coup_cost coins to block
                         // Check if there are any inactive players that could be revived
                         bool hasInactivePlayers = false;
                         for (Player* otherPlayer : allPlayers) {
@@ -1839,7 +1840,7 @@ namespace coup {
             }
             else if (action == "block_coup") {
                 General* general = dynamic_cast<General*>(player); // Check for General role
-                if (general && player->coins() >= 5) { // General needs 5+ coins to block coup
+                if (general && player->coins() >= game->getRules().block_coup_cost) { // General needs GameRules::block_coup_cost coins to block coup
                     // Allow both active and inactive Generals (inactive can block their own coup)
                     eligiblePlayers.push_back(player); // Add eligible General
                 }
@@ -1929,11 +1930,11 @@ namespace coup {
             // Execute General's coup blocking ability
             else if (action == "block_coup" && target) {
                 General* general = dynamic_cast<General*>(reactivePlayer); // Verify General role
-                if (general && reactivePlayer->coins() >= 5) { // Verify coin requirement
+                if (general && reactivePlayer->coins() >= game->getRules().block_coup_cost) { // Verify the GameRules::block_coup_cost coin requirement
                     general->block_coup(*target); // Execute coup block and revive target
                     updateMessage(general->getName() + " blocked coup and revived " + target->getName());
                 } else {
-                    updateMessage("Selected player is not a General with 5+ coins!", true); // Requirements error
+                    updateMessage("Selected player is not a General with " + std::to_string(game->getRules().block_coup_cost) + "+ coins!", true); // Requirements error
                 }
             }
             // Execute Judge's bribe blocking ability
@@ -1967,7 +1968,7 @@ namespace coup {
         
         // Search for eligible General to make coup blocking decision
         for (Player* player : allPlayers) {
-            if (player->getRoleType() == "General" && player->coins() >= 5) { // General with coin requirement
+            if (player->getRoleType() == "General" && player->coins() >= game->getRules().block_coup_cost) { // General with the GameRules::block_coup_cost coin requirement
                 generalPlayer = player; // Found eligible General
                 break; // Only need one General for decision
             }
@@ -0,0 +1,209 @@
+// Email: razcohenp@gmail.com
+
+// Logger.cpp - Implementation of the asynchronous logger
+// Owns the per-thread rings and the background writer that formats captured messages
+
+#include "../include/Logger.hpp"
+
+#include <chrono> // For timestamps and the writer polling interval
+#include <cstdio> // For the default stdout sink
+
+namespace coup {
+    namespace {
+        // Keeps the calling thread's ring alive and marks it retired when the thread exits,
+        // so the writer can still drain messages logged just before the exit
+        struct LocalRingHolder {
+            std::shared_ptr<LogRing> ring;
+
+            ~LocalRingHolder() {
+                if (ring) {
+                    ring->retire();
+                }
+            }
+        };
+
+        thread_local LocalRingHolder local_ring;
+
+        // Writer sleep when every ring was empty
+        constexpr auto IDLE_INTERVAL = std::chrono::milliseconds(1);
+    }
+
+    LogRing::LogRing() : slots(LOG_RING_CAPACITY), head(0), tail(0), dropped(0), retired(false) {
+        static_assert((LOG_RING_CAPACITY & (LOG_RING_CAPACITY - 1)) == 0, "Ring capacity must be a power of two");
+    }
+
+    // Consume every message published so far
+    size_t LogRing::drain(const std::function<void(const LogRecord&)>& visit) {
+        size_t h = head.load(std::memory_order_relaxed);
+        const size_t t = tail.load(std::memory_order_acquire);
+        const size_t count = t - h;
+
+        for (; h != t; h++) {
+            visit(slots[h & (LOG_RING_CAPACITY - 1)]);
+        }
+
+        head.store(t, std::memory_order_release); // Free the slots for the producer
+        return count;
+    }
+
+    // The writer thread starts with the logger
+    Logger::Logger() : retired_dropped(0), running(true) {
+        writer = std::thread(&Logger::writerLoop, this);
+    }
+
+    // Write whatever is still pending, then stop the writer
+    Logger::~Logger() {
+        running.store(false, std::memory_order_release);
+        if (writer.joinable()) {
+            writer.join();
+        }
+        drainAll();
+    }
+
+    Logger& Logger::instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    // Steady clock in nanoseconds
+    uint64_t Logger::now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // First call on a thread allocates and registers its ring
+    LogRing& Logger::localRing() {
+        if (!local_ring.ring) {
+            local_ring.ring = std::make_shared<LogRing>();
+            std::lock_guard<std::mutex> lock(rings_mutex);
+            rings.push_back(local_ring.ring);
+        }
+        return *local_ring.ring;
+    }
+
+    // Copy a string argument into the record, truncating when the text area is full
+    void Logger::captureText(LogRecord& record, LogArg& arg, const char* text, size_t length) {
+        const size_t available = LOG_TEXT_SIZE - record.text_used;
+        if (length > available) {
+            length = available;
+        }
+        if (length > 0) {
+            std::memcpy(record.text + record.text_used, text, length);
+        }
+
+        arg.type = LogArg::TEXT;
+        arg.u = (static_cast<uint64_t>(record.text_used) << 8) | length;
+        record.text_used = static_cast<uint8_t>(record.text_used + length);
+    }
+
+    // Substitute the captured arguments into the {} placeholders of the format
+    std::string Logger::format(const LogRecord& record) {
+        std::string result;
+        size_t next_arg = 0;
+
+        for (const char* p = record.format; *p != '\0'; p++) {
+            if (p[0] != '{' || p[1] != '}' || next_arg >= record.arg_count) {
+                result += *p;
+                continue;
+            }
+
+            const LogArg& arg = record.args[next_arg++];
+            switch (arg.type) {
+                case LogArg::INT: result += std::to_string(arg.i); break;
+                case LogArg::UINT: result += std::to_string(arg.u); break;
+                case LogArg::DOUBLE: result += std::to_string(arg.d); break;
+                case LogArg::BOOL: result += arg.i ? "true" : "false"; break;
+                case LogArg::TEXT: result.append(record.text + (arg.u >> 8), arg.u & 0xFF); break;
+            }
+            p++; // Skip the closing brace
+        }
+
+        return result;
+    }
+
+    const char* Logger::getLevelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::DEBUG: return "DEBUG";
+            case LogLevel::INFO: return "INFO";
+            case LogLevel::WARNING: return "WARNING";
+            case LogLevel::ERROR: return "ERROR";
+            default: return "UNKNOWN";
+        }
+    }
+
+    // Drain all rings into one batch and hand it to the sink
+    size_t Logger::drainAll() {
+        std::lock_guard<std::mutex> drain_lock(drain_mutex);
+
+        std::vector<std::shared_ptr<LogRing>> current;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex);
+            current = rings;
+        }
+
+        size_t written = 0;
+        batch.clear();
+        for (const auto& ring : current) {
+            written += ring->drain([this](const LogRecord& record) {
+                batch += '[';
+                batch += getLevelName(record.level);
+                batch += "] ";
+                batch += format(record);
+                batch += '\n';
+            });
+        }
+
+        // Forget rings of exited threads once they have been emptied
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex);
+            for (size_t i = 0; i < rings.size();) {
+                if (rings[i]->isRetired() && rings[i]->empty()) {
+                    retired_dropped += rings[i]->droppedCount();
+                    rings[i] = rings.back();
+                    rings.pop_back();
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        if (!batch.empty()) {
+            if (sink) {
+                sink(batch);
+            } else {
+                std::fwrite(batch.data(), 1, batch.size(), stdout);
+                std::fflush(stdout); // One flush per batch instead of one per line
+            }
+        }
+        return written;
+    }
+
+    // Poll the rings, sleeping briefly when there is nothing to write
+    void Logger::writerLoop() {
+        while (running.load(std::memory_order_acquire)) {
+            if (drainAll() == 0) {
+                std::this_thread::sleep_for(IDLE_INTERVAL);
+            }
+        }
+    }
+
+    void Logger::setSink(std::function<void(const std::string&)> new_sink) {
+        drainAll(); // Pending messages go to the previous sink
+        std::lock_guard<std::mutex> drain_lock(drain_mutex);
+        sink = std::move(new_sink);
+    }
+
+    void Logger::flush() {
+        drainAll();
+    }
+
+    // Total of all rings, including rings of exited threads
+    uint64_t Logger::droppedCount() {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        uint64_t total = retired_dropped;
+        for (const auto& ring : rings) {
+            total += ring->droppedCount();
+        }
+        return total;
+    }
+}
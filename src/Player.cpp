@@ -5,6 +5,7 @@
 
 #include "../include/Player.hpp"
 #include "../include/Game.hpp"
+#include "../include/Logger.hpp"
 #include <stdexcept> // For exception handling
 
 namespace coup {
@@ -128,143 +129,152 @@ namespace coup {
     }
 
     /**
-     * Gather action - basic economic action to gain 1 coin.
-     * Available to all players unless sanctioned or under special conditions.
+     * Checks the preconditions shared by every turn action.
+     * Returns the first violated rule, or NONE.
      */
-    void Player::gather() {
+    ActionError Player::checkTurnAction() const {
         if (!game.isGameStarted()) { // Ensure game is in progress
-            throw std::runtime_error("Game has not started yet");
+            return ActionError::GAME_NOT_STARTED;
         }
 
         if (!game.isPlayerTurn(this)) { // Verify it's this player's turn
-            throw std::runtime_error("Not your turn");
+            return ActionError::NOT_YOUR_TURN;
         }
 
         if (!active) { // Ensure player is still in the game
-            throw std::runtime_error("Player is eliminated");
+            return ActionError::PLAYER_ELIMINATED;
         }
 
-        if (coin_count >= 10 && !bribe_used) { // Enforce mandatory coup rule
-            throw std::runtime_error("You have 10 or more coins, must perform coup");
-        }
-
-        if (sanctioned) { // Check if economic actions are blocked
-            throw std::runtime_error("Player is sanctioned");
-        }
-
-        addCoins(1); // Award 1 coin for gather action
+        return ActionError::NONE;
+    }
 
+    /**
+     * Ends a turn action - a bribed extra action keeps the turn, otherwise it passes.
+     */
+    void Player::finishTurnAction() {
         if(bribe_used) { // If player used bribe, allow continued play
             bribe_used = false; // Reset bribe flag for next action
         }
-        
+
         else { // Normal turn progression
             game.nextTurn(); // Advance to next player's turn
         }
     }
 
     /**
-     * Tax action - economic action to gain 2 coins from treasury.
-     * Virtual method as some roles modify the coin amount received.
+     * Gather action - basic economic action to gain 1 coin.
+     * Available to all players unless sanctioned or under special conditions.
      */
-    void Player::tax() {
-        if (!game.isGameStarted()) { // Ensure game is in progress
-            throw std::runtime_error("Game has not started yet");
+    ActionResult Player::tryGather() {
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
-        if (!game.isPlayerTurn(this)) { // Verify it's this player's turn
-            throw std::runtime_error("Not your turn");
+        if (coin_count >= 10 && !bribe_used) { // Enforce mandatory coup rule
+            return actionFailure(ActionError::MUST_COUP);
         }
 
-        if (!active) { // Ensure player is still in the game
-            throw std::runtime_error("Player is eliminated");
+        if (sanctioned) { // Check if economic actions are blocked
+            return actionFailure(ActionError::SANCTIONED);
+        }
+
+        addCoins(1); // Award 1 coin for gather action
+        finishTurnAction();
+        return {};
+    }
+
+    void Player::gather() {
+        throwIfFailed(tryGather());
+    }
+
+    /**
+     * Tax action - economic action to gain 2 coins from treasury.
+     * Virtual method as some roles modify the coin amount received.
+     */
+    ActionResult Player::tryTax() {
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
         if (coin_count >= 10 && !bribe_used) { // Enforce mandatory coup rule
-            throw std::runtime_error("You have 10 or more coins, must perform coup");
+            return actionFailure(ActionError::MUST_COUP);
         }
 
         if (sanctioned) { // Check if economic actions are blocked
-            throw std::runtime_error("Player is sanctioned");
+            return actionFailure(ActionError::SANCTIONED);
         }
 
         addCoins(2); // Award 2 coins for tax action
 
-        if(bribe_used) { // If player used bribe, allow continued play
-            bribe_used = false; // Reset bribe flag for next action
-        }
-        
-        else { // Normal turn progression
+        if (!bribe_used) {
             used_tax_last_action = true; // Mark tax as last action for Governor undo
-            game.nextTurn(); // Advance to next player's turn
         }
+        finishTurnAction();
+        return {};
+    }
+
+    void Player::tax() {
+        throwIfFailed(tryTax()); // Virtual - roles adjust the amount in tryTax
     }
 
     /**
      * Bribe action - pays 4 coins to gain an additional action this turn.
      * Allows strategic flexibility by enabling multiple actions per turn.
      */
-    void Player::bribe() {
-        if (!game.isGameStarted()) { // Ensure game is in progress
-            throw std::runtime_error("Game has not started yet");
-        }
-
-        if (!game.isPlayerTurn(this)) { // Verify it's this player's turn
-            throw std::runtime_error("Not your turn");
-        }
-
-        if (!active) { // Ensure player is still in the game
-            throw std::runtime_error("Player is eliminated");
+    ActionResult Player::tryBribe() {
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
         if (coin_count >= 10 && !bribe_used) { // Enforce mandatory coup rule
-            throw std::runtime_error("You have 10 or more coins, must perform coup");
+            return actionFailure(ActionError::MUST_COUP);
         }
 
         if (coin_count < 4) { // Verify player has sufficient funds
-            throw std::runtime_error("Not enough coins for bribe");
+            return actionFailure(ActionError::NOT_ENOUGH_COINS_BRIBE);
         }
 
         removeCoins(4); // Pay the bribe cost
         bribe_used = true; // Mark bribe as used for this turn
         // Note: No nextTurn() call as player gets another action
+        return {};
+    }
+
+    void Player::bribe() {
+        throwIfFailed(tryBribe());
     }
 
     /**
      * Arrest action - takes 1 coin from target player.
      * Cannot target the same player consecutively to prevent harassment.
      */
-    void Player::arrest(Player& target) {
-        if (!game.isGameStarted()) { // Ensure game is in progress
-            throw std::runtime_error("Game has not started yet");
-        }
-        
-        if (!game.isPlayerTurn(this)) { // Verify it's this player's turn
-            throw std::runtime_error("Not your turn");
-        }
-
-        if (!active) { // Ensure player is still in the game
-            throw std::runtime_error("Player is eliminated");
+    ActionResult Player::tryArrest(Player& target) {
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
         if (!arrest_available) { // Check if arrest is blocked by Spy
-            throw std::runtime_error("Arrest action is not available");
+            return actionFailure(ActionError::ARREST_UNAVAILABLE);
         }
 
         if (coin_count >= 10 && !bribe_used) { // Enforce mandatory coup rule
-            throw std::runtime_error("You have 10 or more coins, must perform coup");
+            return actionFailure(ActionError::MUST_COUP);
         }
 
         if (&target == this) { // Prevent self-targeting
-            throw std::runtime_error("An action against yourself is not allowed");
+            return actionFailure(ActionError::SELF_TARGET);
         }
 
         if (!target.isActive()) { // Ensure target is still in game
-            throw std::runtime_error("Target player is eliminated");
+            return actionFailure(ActionError::TARGET_ELIMINATED);
         }
 
         if (game.getLastArrestedPlayer() == &target) { // Prevent consecutive arrests
-            throw std::runtime_error("This player was the last player to be arrested (consecutive arrest is not allowed)");
+            return actionFailure(ActionError::CONSECUTIVE_ARREST);
         }
 
         if (target.coins() >= 1) { // Only proceed if target has coins to lose
@@ -279,119 +289,98 @@ namespace coup {
         }
         
         game.setLastArrestedPlayer(&target); // Record arrest for consecutive prevention
-        
-        if(bribe_used) { // If player used bribe, allow continued play
-            bribe_used = false; // Reset bribe flag for next action
-        }
-        
-        else { // Normal turn progression
-            game.nextTurn(); // Advance to next player's turn
-        }
+        finishTurnAction();
+        return {};
+    }
+
+    void Player::arrest(Player& target) {
+        throwIfFailed(tryArrest(target));
     }
 
     /**
      * Sanction action - blocks target's economic actions for one turn.
      * Costs 3 coins and prevents gather/tax until target's next turn.
      */
-    void Player::sanction(Player& target) {
-        if (!game.isGameStarted()) { // Ensure game is in progress
-            throw std::runtime_error("Game has not started yet");
-        }
-
-        if (!game.isPlayerTurn(this)) { // Verify it's this player's turn
-            throw std::runtime_error("Not your turn");
-        }
-
-        if (!active) { // Ensure player is still in the game
-            throw std::runtime_error("Player is eliminated");
+    ActionResult Player::trySanction(Player& target) {
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
         if (coin_count >= 10 && !bribe_used) { // Enforce mandatory coup rule
-            throw std::runtime_error("You have 10 or more coins, must perform coup");
+            return actionFailure(ActionError::MUST_COUP);
         }
 
         if (&target == this) { // Prevent self-targeting
-            throw std::runtime_error("An action against yourself is not allowed");
+            return actionFailure(ActionError::SELF_TARGET);
         }
 
         if (!target.isActive()) { // Ensure target is still in game
-            throw std::runtime_error("Target player is eliminated");
+            return actionFailure(ActionError::TARGET_ELIMINATED);
         }
 
         // Ensure player has enough coins
         if (coin_count < 3) {
-            throw std::runtime_error("Not enough coins for sanction");
+            return actionFailure(ActionError::NOT_ENOUGH_COINS_SANCTION);
         }
         
-        // If target is a judge, the player must pay 4 coins
+        // If target is a judge, the player pays the surcharge on top (4 coins by default)
         if(target.getRoleType() == "Judge") {
-            if (coin_count < 4) {
-                throw std::runtime_error("Not enough coins for sanction (higher fee)");
+            const int surcharge = game.getRules().judge_surcharge;
+            if (coin_count < 3 + surcharge) {
+                return actionFailure(ActionError::NOT_ENOUGH_COINS_SANCTION_JUDGE);
             }
 
-            removeCoins(1); // Pay 1 coin now and 3 coins later (4 coins in total)
+            removeCoins(surcharge); // Pay the surcharge now and 3 coins later
         }
 
         removeCoins(3); // Pay 3 coins
 
         target.setSanctionStatus(true); // Mark target as sanctioned
-        
-        // If player used bribe, then let him play another turn
-        if(bribe_used) {
-            bribe_used = false; // Reset bribe used flag
-        }
-        
-        // If player did not use bribe, then move to next player's turn
-        else {
-            game.nextTurn(); // Move to next player's turn
-        }
+        finishTurnAction();
+        return {};
     }
 
-    // Coup action - eliminate target for 7 coins
-    void Player::coup(Player& target) {
-        // Check if game has started
-        if (!game.isGameStarted()) {
-            throw std::runtime_error("Game has not started yet");
-        }
-        
-        // Ensure it's the player's turn
-        if (!game.isPlayerTurn(this)) {
-            throw std::runtime_error("Not your turn");
-        }
+    void Player::sanction(Player& target) {
+        throwIfFailed(trySanction(target));
+    }
 
-        // Ensure player is active
-        if (!active) {
-            throw std::runtime_error("Player is eliminated");
+    /**
+     * Coup action - eliminates target player from the game.
+     * The target stays couped (and blockable by a General) until the couping player's next turn.
+     */
+    ActionResult Player::tryCoup(Player& target) {
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
         // Ensure target is not the current player
         if (&target == this) {
-            throw std::runtime_error("An action against yourself is not allowed");
+            return actionFailure(ActionError::SELF_TARGET);
         }
 
         // Ensure target is active
         if (!target.isActive()) {
-            throw std::runtime_error("Target player is eliminated");
+            return actionFailure(ActionError::TARGET_ELIMINATED);
         }
 
         // Ensure player has enough coins
-        if (coin_count < 7) {
-            throw std::runtime_error("Not enough coins for coup");
+        const int coup_cost = game.getRules().coup_cost;
+        if (coin_count < coup_cost) {
+            return actionFailure(ActionError::NOT_ENOUGH_COINS_COUP);
         }
 
-        removeCoins(7); // Decrease coin count
+        removeCoins(coup_cost); // Decrease coin count
         target.couped_by = this; // Mark this player as the one who performed the coup
         target.setActivityStatus(false); // Eliminate target
-        
-        // If player used bribe, then let him play another turn
-        if(bribe_used) {
-            bribe_used = false; // Reset bribe used flag
-        }
-        
-        // If player did not use bribe, then move to next player's turn
-        else {
-            game.nextTurn(); // Move to next player's turn
-        }
+        COUP_LOG_DEBUG("{} couped {}", name, target.getName());
+        finishTurnAction();
+        return {};
+    }
+
+    void Player::coup(Player& target) {
+        throwIfFailed(tryCoup(target));
     }
 
     // Helper methods
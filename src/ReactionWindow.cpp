@@ -0,0 +1,127 @@
+// Email: razcohenp@gmail.com
+
+// ReactionWindow.cpp - Opening, answering and resolving reaction windows
+// Eligibility mirrors the reactive part of legalActions, checked only for seats of the answering role
+
+#include "../include/ReactionWindow.hpp"
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    ReactionArbiter::ReactionArbiter(const Game& game) : general_count(0), judge_count(0), governor_count(0) {
+        for (uint8_t seat = 0; seat < game.getPlayerCount(); seat++) {
+            switch (game.getPlayer(seat)->getRole()) {
+                case RoleType::GENERAL: generals[general_count++] = seat; break;
+                case RoleType::JUDGE: judges[judge_count++] = seat; break;
+                case RoleType::GOVERNOR: governors[governor_count++] = seat; break;
+                default: break;
+            }
+        }
+    }
+
+    bool ReactionArbiter::reactionFor(const Action& trigger, uint8_t seat, Action& reaction) {
+        switch (trigger.type) {
+            case ActionType::COUP: reaction = {ActionType::BLOCK_COUP, seat, trigger.target}; return true;
+            case ActionType::BRIBE: reaction = {ActionType::BLOCK_BRIBE, seat, trigger.actor}; return true;
+            case ActionType::TAX: reaction = {ActionType::UNDO, seat, trigger.actor}; return true;
+            default: return false;
+        }
+    }
+
+    bool ReactionArbiter::canAnswer(const Game& game, const Action& trigger, uint8_t seat) const {
+        const Player* self = game.getPlayer(seat);
+        switch (trigger.type) {
+            case ActionType::COUP: {
+                // Only an active General, or the couped General itself, may block
+                const Player* target = game.getPlayer(trigger.target);
+                return self->coins() >= game.getRules().block_coup_cost && !target->isActive() &&
+                       target->getCoupedBy() != nullptr && (self->isActive() || seat == trigger.target);
+            }
+            case ActionType::BRIBE: {
+                const Player* target = game.getPlayer(trigger.actor);
+                return self->isActive() && target->isActive() && target->isBribeUsed();
+            }
+            case ActionType::TAX: {
+                const Player* target = game.getPlayer(trigger.actor);
+                return self->isActive() && target->isActive() && target->usedTaxLastAction() && target->coins() >= 2;
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool ReactionArbiter::open(const Game& game, ReactionWindow& window, const Action& trigger) const {
+        window.trigger = trigger;
+        window.responder_count = 0;
+        window.next_responder = 0;
+        window.answered = 0;
+        window.reacted = 0;
+
+        const uint8_t* candidates;
+        uint8_t candidate_count;
+        switch (trigger.type) {
+            case ActionType::COUP: candidates = generals; candidate_count = general_count; break;
+            case ActionType::BRIBE: candidates = judges; candidate_count = judge_count; break;
+            case ActionType::TAX: candidates = governors; candidate_count = governor_count; break;
+            default: return false;
+        }
+
+        // Priority is seat order after the actor: rotate the role's seat list to start past it
+        uint8_t first = 0;
+        while (first < candidate_count && candidates[first] <= trigger.actor) {
+            first++;
+        }
+        for (uint8_t i = 0; i < candidate_count; i++) {
+            const uint8_t seat = candidates[(first + i) % candidate_count];
+            if (seat != trigger.actor && canAnswer(game, trigger, seat)) {
+                window.responders[window.responder_count++] = seat;
+            }
+        }
+        return window.isOpen();
+    }
+
+    bool ReactionArbiter::isWaitingOn(const ReactionWindow& window, uint8_t seat) {
+        for (uint8_t i = window.next_responder; i < window.responder_count; i++) {
+            if (window.responders[i] == seat) {
+                return !(window.answered & (1u << i));
+            }
+        }
+        return false;
+    }
+
+    bool ReactionArbiter::respond(Game& game, ReactionWindow& window, uint8_t seat, bool react) const {
+        for (uint8_t i = window.next_responder; i < window.responder_count; i++) {
+            if (window.responders[i] == seat && !(window.answered & (1u << i))) {
+                window.answered |= static_cast<uint8_t>(1u << i);
+                if (react) {
+                    window.reacted |= static_cast<uint8_t>(1u << i);
+                }
+                settle(game, window);
+                return !window.isOpen();
+            }
+        }
+        throw std::runtime_error("Not your decision");
+    }
+
+    void ReactionArbiter::expire(Game& game, ReactionWindow& window) const {
+        for (uint8_t i = window.next_responder; i < window.responder_count; i++) {
+            window.answered |= static_cast<uint8_t>(1u << i); // Silence is a pass
+        }
+        settle(game, window);
+    }
+
+    void ReactionArbiter::settle(Game& game, ReactionWindow& window) const {
+        while (window.isOpen() && (window.answered & (1u << window.next_responder))) {
+            if (window.reacted & (1u << window.next_responder)) {
+                Action reaction;
+                reactionFor(window.trigger, window.responders[window.next_responder], reaction);
+                applyAction(game, reaction);
+                window.next_responder = window.responder_count; // The first reaction closes the window
+                return;
+            }
+            window.next_responder++;
+        }
+    }
+}
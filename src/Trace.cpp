@@ -0,0 +1,531 @@
+// Email: razcohenp@gmail.com
+
+// Trace.cpp - Implementation of the compact trace writer and reader
+// Keyframes hold the full state, action records hold varint deltas against a predicted state
+
+#include "../include/Trace.hpp"
+#include "../include/Game.hpp"
+#include "../include/Varint.hpp"
+
+#include <stdexcept> // For exception handling
+#include <cstring> // For memcpy of fixed-size fields
+#include <algorithm> // For std::min and std::max
+
+namespace coup {
+    // Residual parts of an action record, combined into a varint mask
+    enum ResidualPart : uint8_t {
+        RESIDUAL_ACTOR = 1 << 0, // Actor is not the current player
+        RESIDUAL_TURN = 1 << 1, // Current player index
+        RESIDUAL_ARRESTED = 1 << 2, // Last arrested seat
+        RESIDUAL_COINS = 1 << 3, // Coin deltas per seat
+        RESIDUAL_FLAGS = 1 << 4, // Flag bits toggled per seat
+        RESIDUAL_COUPED = 1 << 5, // Couped-by links per seat
+        RESIDUAL_STARTED = 1 << 6 // Game started flag
+    };
+
+    constexpr uint8_t TRACE_NO_TARGET_CODE = 7; // 3-bit target code of actions without a target
+    constexpr size_t TRACE_HEADER_SIZE = 4 + 2 + 2 + 1; // Magic, version, interval, player count
+    constexpr size_t TRACE_ROSTER_ENTRY_SIZE = SNAPSHOT_NAME_SIZE + 1; // Name and role per seat
+    constexpr size_t TRACE_FOOTER_SIZE = 8 + 8 + 4; // Index offset, action count, magic
+
+    // Fixed-width little helpers for the header and footer (host byte order, like GameSnapshot)
+    template <typename T>
+    static void appendRaw(std::vector<unsigned char>& out, T value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    static T readRaw(const unsigned char* data, size_t size, size_t pos) {
+        if (pos + sizeof(T) > size) {
+            throw std::runtime_error("Truncated trace");
+        }
+        T value;
+        std::memcpy(&value, data + pos, sizeof(T));
+        return value;
+    }
+
+    static uint8_t readByte(const unsigned char* data, size_t size, size_t& pos) {
+        if (pos >= size) {
+            throw std::runtime_error("Truncated trace");
+        }
+        return data[pos++];
+    }
+
+    // Seat byte of a keyframe or residual; anything past the roster would index outside the players
+    static uint8_t readSeat(const unsigned char* data, size_t size, size_t& pos, uint8_t count, bool allow_none) {
+        const uint8_t seat = readByte(data, size, pos);
+        if (seat >= count && !(allow_none && seat == SNAPSHOT_NO_SEAT)) {
+            throw std::runtime_error("Trace record is invalid");
+        }
+        return seat;
+    }
+
+    // Mirror of the turn advance in Game::nextTurn on a snapshot
+    static void predictNextTurn(GameSnapshot& state) {
+        PlayerRecord* players = state.players;
+        const uint8_t count = state.header.player_count;
+        const uint8_t current = state.header.current_player_index;
+
+        // End-of-turn cleanup of the outgoing player
+        players[current].flags &= ~(FLAG_SANCTIONED | FLAG_BRIBE_USED);
+        players[current].flags |= FLAG_ARREST_AVAILABLE;
+
+        uint8_t next = current;
+        for (uint8_t step = 1; step < count; step++) { // Skip eliminated players
+            uint8_t seat = (current + step) % count;
+            if (players[seat].flags & FLAG_ACTIVE) {
+                next = seat;
+                break;
+            }
+        }
+
+        if (next == current) { // Nobody else left - the game keeps its index
+            return;
+        }
+
+        state.header.current_player_index = next;
+        PlayerRecord& incoming = players[next];
+
+        if (incoming.role == static_cast<uint8_t>(RoleType::MERCHANT) && incoming.coins >= 3) { // Merchant bonus
+            incoming.coins += 1;
+        }
+
+        incoming.flags &= ~FLAG_USED_TAX; // Tax can no longer be undone
+
+        for (uint8_t seat = 0; seat < count; seat++) { // Coup blocking window expires
+            if (players[seat].couped_by == next) {
+                players[seat].couped_by = SNAPSHOT_NO_SEAT;
+            }
+        }
+    }
+
+    // Predict the state after an action, mirroring the Player and role methods
+    // Only used as a compression model - whatever it gets wrong is stored as a residual
+    static void predictAction(GameSnapshot& state, const Action& action) {
+        const uint8_t count = state.header.player_count;
+        if (action.actor >= count || (actionHasTarget(action.type) && action.target >= count)) {
+            return; // Nothing sensible to predict
+        }
+
+        PlayerRecord& actor = state.players[action.actor];
+        PlayerRecord* target = actionHasTarget(action.type) ? &state.players[action.target] : nullptr;
+        bool uses_turn = false; // Whether the action ends the turn (unless bribed)
+
+        switch (action.type) {
+            case ActionType::GATHER:
+                actor.coins += 1;
+                uses_turn = true;
+                break;
+            case ActionType::TAX:
+                actor.coins += actor.role == static_cast<uint8_t>(RoleType::GOVERNOR) ? 3 : 2;
+                uses_turn = true;
+                break;
+            case ActionType::BRIBE:
+                actor.coins -= 4;
+                actor.flags |= FLAG_BRIBE_USED;
+                break;
+            case ActionType::ARREST:
+                if (target->coins >= 1 && target->role != static_cast<uint8_t>(RoleType::GENERAL)) {
+                    target->coins -= 1;
+                    actor.coins += 1;
+                }
+                state.header.last_arrested = action.target;
+                uses_turn = true;
+                break;
+            case ActionType::SANCTION:
+                actor.coins -= target->role == static_cast<uint8_t>(RoleType::JUDGE) ? 4 : 3;
+                target->flags |= FLAG_SANCTIONED;
+                if (target->role == static_cast<uint8_t>(RoleType::BARON)) { // Baron compensation
+                    target->coins += 1;
+                }
+                uses_turn = true;
+                break;
+            case ActionType::COUP:
+                actor.coins -= 7;
+                target->couped_by = action.actor;
+                target->flags &= ~FLAG_ACTIVE;
+                uses_turn = true;
+                break;
+            case ActionType::INVEST:
+                actor.coins += 3;
+                uses_turn = true;
+                break;
+            case ActionType::SPY_ON:
+                target->flags &= ~FLAG_ARREST_AVAILABLE;
+                break;
+            case ActionType::BLOCK_COUP:
+                actor.coins -= 5;
+                target->couped_by = SNAPSHOT_NO_SEAT;
+                target->flags |= FLAG_ACTIVE;
+                break;
+            case ActionType::BLOCK_BRIBE:
+                target->flags &= ~FLAG_BRIBE_USED;
+                break;
+            case ActionType::UNDO:
+                target->coins -= 2;
+                target->flags &= ~FLAG_USED_TAX;
+                break;
+        }
+
+        if (!uses_turn) {
+            return;
+        }
+
+        if (actor.flags & FLAG_BRIBE_USED) { // Bribed extra action keeps the turn
+            actor.flags &= ~FLAG_BRIBE_USED;
+            return;
+        }
+
+        if (action.type == ActionType::TAX) { // Marked for Governor undo
+            actor.flags |= FLAG_USED_TAX;
+        }
+
+        predictNextTurn(state);
+    }
+
+    // Seat mask of players whose field differs between the two states
+    template <typename Field>
+    static uint8_t diffMask(const GameSnapshot& a, const GameSnapshot& b, Field field) {
+        uint8_t mask = 0;
+        for (uint8_t seat = 0; seat < a.header.player_count; seat++) {
+            if (field(a.players[seat]) != field(b.players[seat])) {
+                mask |= 1 << seat;
+            }
+        }
+        return mask;
+    }
+
+    // Initialize TraceWriter with keyframe interval
+    TraceWriter::TraceWriter(uint16_t keyframe_interval)
+    : keyframe_interval(keyframe_interval), action_count(0), started(false), finished(false) {
+        if (keyframe_interval == 0) {
+            throw std::invalid_argument("Keyframe interval must be positive");
+        }
+    }
+
+    // Write compact full state: started, turn, last arrested, then flags, coins and coup link per seat
+    void TraceWriter::writeKeyframe(const GameSnapshot& state) {
+        keyframe_offsets.push_back(buffer.size());
+        buffer.push_back(state.header.game_started);
+        buffer.push_back(state.header.current_player_index);
+        buffer.push_back(state.header.last_arrested);
+
+        for (uint8_t seat = 0; seat < state.header.player_count; seat++) {
+            const PlayerRecord& record = state.players[seat];
+            buffer.push_back(record.flags);
+            writeSignedVarint(buffer, record.coins);
+            buffer.push_back(record.couped_by);
+        }
+    }
+
+    // Start a new trace with the header, roster and first keyframe
+    void TraceWriter::begin(const Game& game) {
+        buffer.clear();
+        keyframe_offsets.clear();
+        action_count = 0;
+        started = true;
+        finished = false;
+
+        game.saveSnapshot(previous, false); // RNG state is not part of traces
+
+        appendRaw<uint32_t>(buffer, TRACE_MAGIC);
+        appendRaw<uint16_t>(buffer, TRACE_VERSION);
+        appendRaw<uint16_t>(buffer, keyframe_interval);
+        buffer.push_back(previous.header.player_count);
+
+        for (uint8_t seat = 0; seat < previous.header.player_count; seat++) {
+            const PlayerRecord& record = previous.players[seat];
+            buffer.insert(buffer.end(), record.name, record.name + SNAPSHOT_NAME_SIZE);
+            buffer.push_back(record.role);
+        }
+
+        writeKeyframe(previous);
+    }
+
+    // Record one applied action as a single byte plus residual against the predicted state
+    void TraceWriter::record(const Action& action, const Game& game) {
+        if (!started || finished) {
+            throw std::runtime_error("Trace is not open for recording");
+        }
+
+        if (action_count > 0 && action_count % keyframe_interval == 0) { // Seek point before this record
+            writeKeyframe(previous);
+        }
+
+        game.saveSnapshot(current, false);
+        if (current.header.player_count != previous.header.player_count) {
+            throw std::runtime_error("Players cannot change during a trace");
+        }
+
+        // Predict what the action normally does, the residual is the difference to what happened
+        std::memcpy(&predicted.header, &previous.header, sizeof(previous.header)); // Skip the unused RNG area
+        std::memcpy(predicted.players, previous.players, sizeof(previous.players));
+        const uint8_t expected_actor = previous.header.current_player_index;
+        predictAction(predicted, action);
+
+        uint8_t residual = 0;
+        if (action.actor != expected_actor) residual |= RESIDUAL_ACTOR;
+        if (current.header.current_player_index != predicted.header.current_player_index) residual |= RESIDUAL_TURN;
+        if (current.header.last_arrested != predicted.header.last_arrested) residual |= RESIDUAL_ARRESTED;
+        if (current.header.game_started != predicted.header.game_started) residual |= RESIDUAL_STARTED;
+
+        const uint8_t coin_mask = diffMask(current, predicted, [](const PlayerRecord& r) { return r.coins; });
+        const uint8_t flag_mask = diffMask(current, predicted, [](const PlayerRecord& r) { return r.flags; });
+        const uint8_t couped_mask = diffMask(current, predicted, [](const PlayerRecord& r) { return r.couped_by; });
+        if (coin_mask) residual |= RESIDUAL_COINS;
+        if (flag_mask) residual |= RESIDUAL_FLAGS;
+        if (couped_mask) residual |= RESIDUAL_COUPED;
+
+        const uint8_t target_code = actionHasTarget(action.type) ? action.target : TRACE_NO_TARGET_CODE;
+        buffer.push_back(static_cast<unsigned char>((static_cast<uint8_t>(action.type) << 4) |
+            ((target_code & 0x7) << 1) | (residual ? 1 : 0)));
+
+        if (residual) {
+            buffer.push_back(residual);
+            if (residual & RESIDUAL_ACTOR) buffer.push_back(action.actor);
+            if (residual & RESIDUAL_TURN) buffer.push_back(current.header.current_player_index);
+            if (residual & RESIDUAL_ARRESTED) buffer.push_back(current.header.last_arrested);
+            if (residual & RESIDUAL_STARTED) buffer.push_back(current.header.game_started);
+
+            if (residual & RESIDUAL_COINS) {
+                buffer.push_back(coin_mask);
+                for (uint8_t seat = 0; seat < current.header.player_count; seat++) {
+                    if (coin_mask & (1 << seat)) {
+                        writeSignedVarint(buffer, static_cast<int64_t>(current.players[seat].coins) - predicted.players[seat].coins);
+                    }
+                }
+            }
+
+            if (residual & RESIDUAL_FLAGS) {
+                buffer.push_back(flag_mask);
+                for (uint8_t seat = 0; seat < current.header.player_count; seat++) {
+                    if (flag_mask & (1 << seat)) {
+                        buffer.push_back(current.players[seat].flags ^ predicted.players[seat].flags);
+                    }
+                }
+            }
+
+            if (residual & RESIDUAL_COUPED) {
+                buffer.push_back(couped_mask);
+                for (uint8_t seat = 0; seat < current.header.player_count; seat++) {
+                    if (couped_mask & (1 << seat)) {
+                        buffer.push_back(current.players[seat].couped_by);
+                    }
+                }
+            }
+        }
+
+        std::memcpy(&previous.header, &current.header, sizeof(current.header)); // Skip the unused RNG area
+        std::memcpy(previous.players, current.players, sizeof(current.players));
+        action_count++;
+    }
+
+    // Append the keyframe index and footer
+    void TraceWriter::finish() {
+        if (!started || finished) {
+            throw std::runtime_error("Trace is not open for recording");
+        }
+
+        const uint64_t index_offset = buffer.size();
+        for (uint64_t offset : keyframe_offsets) {
+            appendRaw<uint64_t>(buffer, offset);
+        }
+
+        appendRaw<uint64_t>(buffer, index_offset);
+        appendRaw<uint64_t>(buffer, action_count);
+        appendRaw<uint32_t>(buffer, TRACE_MAGIC);
+        finished = true;
+    }
+
+    // Parse header, roster, index and footer
+    TraceReader::TraceReader(const unsigned char* data, size_t size)
+    : data(data), size(size), keyframe_interval(0), action_count(0) {
+        if (data == nullptr || size < TRACE_HEADER_SIZE + TRACE_FOOTER_SIZE) {
+            throw std::runtime_error("Trace is too small");
+        }
+
+        if (readRaw<uint32_t>(data, size, 0) != TRACE_MAGIC || readRaw<uint32_t>(data, size, size - 4) != TRACE_MAGIC) {
+            throw std::runtime_error("Not a trace");
+        }
+
+        if (readRaw<uint16_t>(data, size, 4) != TRACE_VERSION) {
+            throw std::runtime_error("Trace version is not supported");
+        }
+
+        keyframe_interval = readRaw<uint16_t>(data, size, 6);
+        const uint8_t player_count = data[8];
+        if (keyframe_interval == 0 || player_count > SNAPSHOT_MAX_PLAYERS) {
+            throw std::runtime_error("Trace header is invalid");
+        }
+
+        // Build the empty state that every reconstructed snapshot starts from
+        std::memset(&roster, 0, sizeof(roster));
+        roster.header.magic = SNAPSHOT_MAGIC;
+        roster.header.version = SNAPSHOT_VERSION;
+        roster.header.header_size = sizeof(SnapshotHeader);
+        roster.header.total_size = sizeof(GameSnapshot);
+        roster.header.rng_size = 0; // Traces carry no RNG state
+        roster.header.player_count = player_count;
+
+        size_t pos = TRACE_HEADER_SIZE;
+        if (pos + player_count * TRACE_ROSTER_ENTRY_SIZE > size - TRACE_FOOTER_SIZE) {
+            throw std::runtime_error("Truncated trace");
+        }
+        for (uint8_t seat = 0; seat < player_count; seat++) {
+            std::memcpy(roster.players[seat].name, data + pos, SNAPSHOT_NAME_SIZE);
+            roster.players[seat].name[SNAPSHOT_NAME_SIZE - 1] = '\0';
+            roster.players[seat].role = data[pos + SNAPSHOT_NAME_SIZE];
+            pos += TRACE_ROSTER_ENTRY_SIZE;
+        }
+
+        const size_t footer = size - TRACE_FOOTER_SIZE;
+        const uint64_t index_offset = readRaw<uint64_t>(data, size, footer);
+        action_count = readRaw<uint64_t>(data, size, footer + 8);
+
+        // Keyframes are written before records 0, K, 2K, ... so a trace of exactly K actions has only one
+        const uint64_t keyframe_count = action_count == 0 ? 1 : (action_count - 1) / keyframe_interval + 1;
+        if (index_offset < pos || index_offset > footer || (footer - index_offset) != keyframe_count * 8) {
+            throw std::runtime_error("Trace index is invalid");
+        }
+
+        keyframe_offsets.resize(keyframe_count);
+        for (uint64_t i = 0; i < keyframe_count; i++) {
+            keyframe_offsets[i] = readRaw<uint64_t>(data, size, index_offset + i * 8);
+            if (keyframe_offsets[i] < pos || keyframe_offsets[i] >= index_offset) {
+                throw std::runtime_error("Trace index is invalid");
+            }
+        }
+
+        this->size = index_offset; // Records never extend into the index
+    }
+
+    // Decode compact full state
+    void TraceReader::readKeyframe(size_t& pos, GameSnapshot& state) const {
+        std::memcpy(&state.header, &roster.header, sizeof(roster.header));
+        std::memcpy(state.players, roster.players, sizeof(roster.players));
+
+        const uint8_t count = state.header.player_count;
+        state.header.game_started = readByte(data, size, pos);
+        state.header.current_player_index = readSeat(data, size, pos, std::max<uint8_t>(count, 1), false); // 0 without players
+        state.header.last_arrested = readSeat(data, size, pos, count, true);
+
+        for (uint8_t seat = 0; seat < count; seat++) {
+            PlayerRecord& record = state.players[seat];
+            record.flags = readByte(data, size, pos);
+            record.coins = static_cast<int32_t>(readSignedVarint(data, size, pos));
+            record.couped_by = readSeat(data, size, pos, count, true);
+        }
+    }
+
+    // Decode one action record and apply it to the state
+    void TraceReader::readRecord(size_t& pos, GameSnapshot& state, Action& action) const {
+        const uint8_t head = readByte(data, size, pos);
+        const uint8_t type = head >> 4;
+        const uint8_t target_code = (head >> 1) & 0x7;
+
+        if (type >= ACTION_TYPE_COUNT) {
+            throw std::runtime_error("Trace record is invalid");
+        }
+
+        action.type = static_cast<ActionType>(type);
+        action.target = target_code == TRACE_NO_TARGET_CODE ? NO_TARGET : target_code;
+        action.actor = state.header.current_player_index;
+
+        const uint8_t count = state.header.player_count;
+        const uint8_t residual = (head & 1) ? readByte(data, size, pos) : 0;
+        if (residual & RESIDUAL_ACTOR) {
+            action.actor = readSeat(data, size, pos, count, false);
+        }
+
+        predictAction(state, action);
+        if (!residual) {
+            return;
+        }
+
+        if (residual & RESIDUAL_TURN) {
+            state.header.current_player_index = readSeat(data, size, pos, std::max<uint8_t>(count, 1), false);
+        }
+        if (residual & RESIDUAL_ARRESTED) state.header.last_arrested = readSeat(data, size, pos, count, true);
+        if (residual & RESIDUAL_STARTED) state.header.game_started = readByte(data, size, pos);
+
+        if (residual & RESIDUAL_COINS) {
+            const uint8_t mask = readByte(data, size, pos);
+            for (uint8_t seat = 0; seat < count; seat++) {
+                if (mask & (1 << seat)) {
+                    state.players[seat].coins += static_cast<int32_t>(readSignedVarint(data, size, pos));
+                }
+            }
+        }
+
+        if (residual & RESIDUAL_FLAGS) {
+            const uint8_t mask = readByte(data, size, pos);
+            for (uint8_t seat = 0; seat < count; seat++) {
+                if (mask & (1 << seat)) {
+                    state.players[seat].flags ^= readByte(data, size, pos);
+                }
+            }
+        }
+
+        if (residual & RESIDUAL_COUPED) {
+            const uint8_t mask = readByte(data, size, pos);
+            for (uint8_t seat = 0; seat < count; seat++) {
+                if (mask & (1 << seat)) {
+                    state.players[seat].couped_by = readSeat(data, size, pos, count, true);
+                }
+            }
+        }
+    }
+
+    // Seek to the nearest keyframe and decode forward
+    void TraceReader::stateAt(size_t step, GameSnapshot& out) const {
+        if (step > action_count) {
+            throw std::runtime_error("Step is past the end of the trace");
+        }
+
+        const size_t keyframe = std::min(step / keyframe_interval, keyframe_offsets.size() - 1);
+        size_t pos = keyframe_offsets[keyframe];
+        readKeyframe(pos, out);
+
+        Action action;
+        for (size_t index = keyframe * keyframe_interval; index < step; index++) {
+            readRecord(pos, out, action);
+        }
+    }
+
+    // Decode the action at index from the nearest keyframe
+    Action TraceReader::actionAt(size_t index) const {
+        if (index >= action_count) {
+            throw std::runtime_error("Action index is past the end of the trace");
+        }
+
+        GameSnapshot state;
+        const size_t keyframe = index / keyframe_interval;
+        size_t pos = keyframe_offsets[keyframe];
+        readKeyframe(pos, state);
+
+        Action action;
+        for (size_t i = keyframe * keyframe_interval; i <= index; i++) {
+            readRecord(pos, state, action);
+        }
+        return action;
+    }
+
+    // Sequential decode of the whole trace
+    void TraceReader::forEachAction(const std::function<void(size_t, const Action&, const GameSnapshot&)>& visit) const {
+        GameSnapshot state;
+        Action action;
+        size_t pos = keyframe_offsets[0];
+        readKeyframe(pos, state);
+
+        for (size_t index = 0; index < action_count; index++) {
+            if (index > 0 && index % keyframe_interval == 0) { // Skip over the keyframe, state is already current
+                GameSnapshot skipped;
+                readKeyframe(pos, skipped);
+            }
+            readRecord(pos, state, action);
+            visit(index, action, state);
+        }
+    }
+}
@@ -0,0 +1,201 @@
+// Email: razcohenp@gmail.com
+
+// BalanceSweep.cpp - Grid expansion and the parallel game batches
+
+#include "../../include/bots/BalanceSweep.hpp"
+#include "../../include/bots/HeuristicBot.hpp"
+#include "../../include/Player.hpp"
+
+#include <algorithm> // For std::min
+#include <atomic> // For the shared chunk counter
+#include <exception> // For passing thread failures to the caller
+#include <memory> // For rosters and bots
+#include <mutex> // For progress reports
+#include <random> // For role deals
+#include <stdexcept> // For exception handling
+#include <thread> // For worker threads
+
+namespace coup {
+    namespace {
+        const RuleParameter ALL_PARAMETERS[] = {RuleParameter::INVEST_PAYOUT, RuleParameter::TAX_BONUS,
+                                                RuleParameter::BLOCK_COUP_COST, RuleParameter::MERCHANT_THRESHOLD,
+                                                RuleParameter::JUDGE_SURCHARGE, RuleParameter::COUP_COST};
+
+        // Seed of one game from its grid point and number
+        uint32_t gameSeed(uint32_t seed, uint64_t point, uint64_t game) {
+            uint64_t z = (static_cast<uint64_t>(seed) << 40) ^ (point << 32) ^ game;
+            z += 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<uint32_t>(z ^ (z >> 31));
+        }
+
+        // Plays one game and adds it to the counts of its point
+        void playGame(const SweepConfig& config, SweepPoint& counts, uint32_t seed) {
+            std::mt19937 rng(seed);
+            Game game;
+            game.setRules(counts.rules);
+            std::vector<std::unique_ptr<Player>> roster;
+            std::vector<std::unique_ptr<Bot>> bots;
+            std::vector<Bot*> seats;
+            RoleType roles[6];
+            for (unsigned seat = 0; seat < config.players; seat++) {
+                roles[seat] = static_cast<RoleType>(rng() % SWEEP_ROLE_COUNT);
+                roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1), roles[seat]));
+                if (config.bots == SweepBots::HEURISTIC) {
+                    bots.emplace_back(new HeuristicBot(seed + seat));
+                }
+                else {
+                    bots.emplace_back(new RandomBot(seed + seat));
+                }
+                seats.push_back(bots.back().get());
+            }
+            game.startGame();
+
+            Match match(game, config.max_steps);
+            const int winner = playMatch(match, seats);
+            counts.games++;
+            for (unsigned seat = 0; seat < config.players; seat++) {
+                counts.dealt[static_cast<size_t>(roles[seat])]++;
+            }
+            if (winner >= 0) {
+                counts.wins[static_cast<size_t>(roles[winner])]++;
+            }
+            else {
+                counts.draws++;
+            }
+        }
+    }
+
+    std::string getRuleParameterName(RuleParameter parameter) {
+        switch (parameter) {
+            case RuleParameter::INVEST_PAYOUT: return "invest_payout";
+            case RuleParameter::TAX_BONUS: return "tax_bonus";
+            case RuleParameter::BLOCK_COUP_COST: return "block_coup_cost";
+            case RuleParameter::MERCHANT_THRESHOLD: return "merchant_threshold";
+            case RuleParameter::JUDGE_SURCHARGE: return "judge_surcharge";
+            case RuleParameter::COUP_COST: return "coup_cost";
+        }
+        return "unknown";
+    }
+
+    RuleParameter parseRuleParameter(const std::string& name) {
+        for (RuleParameter parameter : ALL_PARAMETERS) {
+            if (getRuleParameterName(parameter) == name) {
+                return parameter;
+            }
+        }
+        throw std::invalid_argument("Unknown rule parameter: " + name);
+    }
+
+    int& ruleField(GameRules& rules, RuleParameter parameter) {
+        switch (parameter) {
+            case RuleParameter::INVEST_PAYOUT: return rules.invest_payout;
+            case RuleParameter::TAX_BONUS: return rules.tax_bonus;
+            case RuleParameter::BLOCK_COUP_COST: return rules.block_coup_cost;
+            case RuleParameter::MERCHANT_THRESHOLD: return rules.merchant_threshold;
+            case RuleParameter::JUDGE_SURCHARGE: return rules.judge_surcharge;
+            case RuleParameter::COUP_COST: return rules.coup_cost;
+        }
+        throw std::invalid_argument("Unknown rule parameter");
+    }
+
+    double SweepPoint::winRate(RoleType role) const {
+        const size_t index = static_cast<size_t>(role);
+        if (index >= SWEEP_ROLE_COUNT || dealt[index] == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(wins[index]) / dealt[index];
+    }
+
+    std::vector<SweepPoint> runBalanceSweep(const SweepConfig& config,
+                                            const std::function<void(uint64_t, uint64_t)>& on_progress) {
+        if (config.players < 2 || config.players > 6) {
+            throw std::invalid_argument("Players must be between 2 and 6");
+        }
+        if (config.threads == 0 || config.chunk == 0) {
+            throw std::invalid_argument("Threads and chunk size must be positive");
+        }
+
+        // Expand the grid, last axis fastest; invalid rule sets fail here, before any game
+        size_t point_count = 1;
+        for (const SweepAxis& axis : config.axes) {
+            if (axis.values.empty()) {
+                throw std::invalid_argument("Axis " + getRuleParameterName(axis.parameter) + " has no values");
+            }
+            point_count *= axis.values.size();
+        }
+        std::vector<SweepPoint> points(point_count);
+        for (size_t p = 0; p < point_count; p++) {
+            SweepPoint& point = points[p];
+            point.rules = config.base;
+            point.values.resize(config.axes.size());
+            size_t rest = p;
+            for (size_t a = config.axes.size(); a-- > 0;) {
+                const SweepAxis& axis = config.axes[a];
+                point.values[a] = axis.values[rest % axis.values.size()];
+                ruleField(point.rules, axis.parameter) = point.values[a];
+                rest /= axis.values.size();
+            }
+            Game().setRules(point.rules);
+        }
+
+        const uint64_t chunks_per_point = (config.games_per_point + config.chunk - 1) / config.chunk;
+        const uint64_t total_chunks = chunks_per_point * point_count;
+        const uint64_t total_games = config.games_per_point * point_count;
+        std::atomic<uint64_t> next(0);
+        std::atomic<uint64_t> done(0);
+        std::mutex progress_mutex;
+        std::vector<std::vector<SweepPoint>> partial(config.threads, points); // Counts per thread, merged at the end
+        std::vector<std::exception_ptr> errors(config.threads);
+
+        auto work = [&](unsigned thread) {
+            try {
+                for (uint64_t item = next++; item < total_chunks; item = next++) {
+                    const uint64_t p = item / chunks_per_point;
+                    const uint64_t first = (item % chunks_per_point) * config.chunk;
+                    const uint64_t last = std::min<uint64_t>(first + config.chunk, config.games_per_point);
+                    for (uint64_t game = first; game < last; game++) {
+                        playGame(config, partial[thread][p], gameSeed(config.seed, p, game));
+                    }
+
+                    const uint64_t finished = done += last - first;
+                    if (on_progress) {
+                        std::lock_guard<std::mutex> lock(progress_mutex);
+                        on_progress(finished, total_games);
+                    }
+                }
+            }
+            catch (...) {
+                errors[thread] = std::current_exception();
+                next = total_chunks; // Stop the other workers early
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned thread = 1; thread < config.threads; thread++) {
+            workers.emplace_back(work, thread);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        for (const auto& counts : partial) {
+            for (size_t p = 0; p < point_count; p++) {
+                points[p].games += counts[p].games;
+                points[p].draws += counts[p].draws;
+                for (size_t role = 0; role < SWEEP_ROLE_COUNT; role++) {
+                    points[p].dealt[role] += counts[p].dealt[role];
+                    points[p].wins[role] += counts[p].wins[role];
+                }
+            }
+        }
+        return points;
+    }
+}
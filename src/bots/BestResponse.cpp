@@ -0,0 +1,272 @@
+// Email: razcohenp@gmail.com
+
+// BestResponse.cpp - Depth-limited expectimax against a fixed policy
+// Each worker owns a clone of the game; values are cached in a shared lock-free table
+
+#include "../../include/bots/BestResponse.hpp"
+#include "../../include/GameClone.hpp"
+
+#include <algorithm> // For std::max
+#include <chrono> // For timing
+#include <cstring> // For value bit casts
+#include <exception> // For passing thread failures to the caller
+#include <random> // For rollouts
+#include <stdexcept> // For exception handling
+#include <thread> // For root parallelism
+
+namespace coup {
+    namespace {
+        // One worker - a private clone and the move buffers of every search depth
+        class Searcher {
+        private:
+            const MovePolicy& policy; // Policy of the other seats
+            const BestResponseConfig& config; // Search settings
+            TranspositionTable& table; // Shared cache
+            uint8_t responder; // Seat searching for its best response
+            GameClone clone; // Private game
+            Match sim; // Decision sequence on the clone
+            std::vector<std::vector<Move>> moves; // Moves per depth
+            std::vector<std::vector<double>> probs; // Policy probabilities per depth
+            std::vector<Move> rollout_moves; // Rollout buffers
+            std::vector<double> rollout_probs;
+
+        public:
+            uint64_t nodes = 0; // Positions searched
+            uint64_t hits = 0; // Table hits
+
+            Searcher(const Match& root, const MovePolicy& policy, const BestResponseConfig& config,
+                     TranspositionTable& table, uint8_t responder)
+            : policy(policy), config(config), table(table), responder(responder), clone(root.getGame()),
+            sim(clone.game(), root.getState(), root.getMaxSteps()), moves(config.depth + 1), probs(config.depth + 1) {}
+
+            // Puts the clone on a position and plays one move from it
+            void enter(const GameSnapshot& position, const MatchState& state, const Move& move) {
+                clone.load(position);
+                sim.reset(state);
+                sim.apply(move);
+            }
+
+            // Index of a move sampled from the policy probabilities
+            size_t sample(const std::vector<double>& weights, std::mt19937& rng) {
+                double left = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                for (size_t i = 0; i < weights.size(); i++) {
+                    left -= weights[i];
+                    if (left <= 0.0) {
+                        return i;
+                    }
+                }
+                return weights.size() - 1;
+            }
+
+            // Policy self-play from the current position, seeded by the position
+            double leaf(uint64_t key) {
+                GameSnapshot position;
+                sim.getGame().saveSnapshot(position, false);
+                const MatchState state = sim.getState();
+                std::mt19937 rng(static_cast<uint32_t>(key ^ (key >> 32)) ^ config.seed);
+
+                double total = 0.0;
+                for (unsigned rollout = 0; rollout < config.leaf_rollouts; rollout++) {
+                    clone.load(position);
+                    sim.reset(state);
+                    for (uint32_t move = 0; move < config.max_rollout_moves && !sim.isOver(); move++) {
+                        sim.moves(rollout_moves);
+                        policy.probabilities(sim, rollout_moves, rollout_probs);
+                        sim.apply(rollout_moves[sample(rollout_probs, rng)]);
+                    }
+                    total += sim.reward(responder);
+                }
+                return config.leaf_rollouts > 0 ? total / config.leaf_rollouts : 0.0;
+            }
+
+            // Expectimax value for the responder; best selects max at its decisions
+            double search(unsigned depth, bool best) {
+                nodes++;
+                if (sim.isOver()) {
+                    return sim.reward(responder);
+                }
+
+                // Leaves are policy rollouts in both modes, so the modes share them and best never scores below the policy
+                const uint64_t key = sim.stateHash((static_cast<uint64_t>(depth) << 1) | (best && depth > 0 ? 1 : 0));
+                double value;
+                if (table.probe(key, value)) {
+                    hits++;
+                    return value;
+                }
+                if (depth == 0) {
+                    value = leaf(key);
+                    table.store(key, value);
+                    return value;
+                }
+
+                std::vector<Move>& options = moves[depth];
+                std::vector<double>& weights = probs[depth];
+                sim.moves(options);
+                const bool maximize = best && sim.decidingSeat() == responder;
+                if (!maximize) {
+                    policy.probabilities(sim, options, weights);
+                }
+
+                GameSnapshot position;
+                sim.getGame().saveSnapshot(position, false);
+                const MatchState state = sim.getState();
+                value = maximize ? -1.0 : 0.0;
+                for (size_t i = 0; i < options.size(); i++) {
+                    if (!maximize && weights[i] <= 0.0) continue;
+                    enter(position, state, options[i]);
+                    const double child = search(depth - 1, best);
+                    value = maximize ? std::max(value, child) : value + weights[i] * child;
+                }
+                table.store(key, value);
+                return value;
+            }
+        };
+    }
+
+    void UniformPolicy::probabilities(const Match& match, const std::vector<Move>& moves, std::vector<double>& out) const {
+        (void)match;
+        out.assign(moves.size(), moves.empty() ? 0.0 : 1.0 / moves.size());
+    }
+
+    void CfrMovePolicy::probabilities(const Match& match, const std::vector<Move>& moves, std::vector<double>& out) const {
+        AbstractMoves legal;
+        abstractMoves(match, moves, legal);
+        const uint8_t* weights = policy.row(abstractInfoSet(match));
+
+        // Same rule as CfrBot - untrained rows are uniform over the legal abstract actions
+        double total = 0.0;
+        double legal_count = 0.0;
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            if (legal.index[a] >= 0) {
+                total += weights[a];
+                legal_count += 1.0;
+            }
+        }
+
+        out.assign(moves.size(), 0.0);
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            if (legal.index[a] >= 0) {
+                out[legal.index[a]] = total > 0.0 ? weights[a] / total : 1.0 / legal_count;
+            }
+        }
+    }
+
+    TranspositionTable::TranspositionTable(size_t entries) {
+        size_t slots = 1;
+        while (slots < entries) {
+            slots <<= 1;
+        }
+        checks.reset(new std::atomic<uint64_t>[slots]);
+        values.reset(new std::atomic<uint64_t>[slots]);
+        for (size_t i = 0; i < slots; i++) {
+            checks[i].store(0, std::memory_order_relaxed);
+            values[i].store(0, std::memory_order_relaxed);
+        }
+        mask = slots - 1;
+    }
+
+    bool TranspositionTable::probe(uint64_t key, double& value) const {
+        const size_t slot = key & mask;
+        const uint64_t bits = values[slot].load(std::memory_order_relaxed);
+        const uint64_t check = checks[slot].load(std::memory_order_relaxed);
+        if ((check ^ bits) != key || key == 0) {
+            return false;
+        }
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    void TranspositionTable::store(uint64_t key, double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const size_t slot = key & mask;
+        values[slot].store(bits, std::memory_order_relaxed);
+        checks[slot].store(key ^ bits, std::memory_order_relaxed);
+    }
+
+    BestResponse::BestResponse(const MovePolicy& policy, const BestResponseConfig& config)
+    : policy(policy), config(config) {
+        if (config.threads == 0) {
+            throw std::invalid_argument("Search needs at least one thread");
+        }
+    }
+
+    BestResponseResult BestResponse::evaluate(const Match& match, uint8_t responder) const {
+        const auto start = std::chrono::steady_clock::now();
+        if (responder >= match.getGame().getPlayerCount()) {
+            throw std::invalid_argument("Invalid responder seat");
+        }
+
+        BestResponseResult result;
+        TranspositionTable table(config.table_entries);
+
+        std::vector<Move> root_moves;
+        std::vector<double> root_probs;
+        if (!match.isOver() && config.depth > 0) {
+            match.moves(root_moves);
+            policy.probabilities(match, root_moves, root_probs);
+        }
+
+        if (root_moves.empty()) { // Finished game or no search depth - score the position itself
+            Searcher root(match, policy, config, table, responder);
+            result.best_response = result.policy_value = root.search(0, true);
+            result.nodes = root.nodes;
+        }
+        else {
+            // Root moves are shared among the workers; every root move is searched in both modes
+            std::vector<double> best_values(root_moves.size());
+            std::vector<double> policy_values(root_moves.size());
+            std::atomic<size_t> next(0);
+            std::atomic<uint64_t> nodes(0);
+            std::atomic<uint64_t> hits(0);
+            std::vector<std::exception_ptr> errors(config.threads);
+            GameSnapshot position;
+            match.getGame().saveSnapshot(position, false);
+
+            auto work = [&](unsigned thread) {
+                try {
+                    Searcher searcher(match, policy, config, table, responder);
+                    for (size_t i = next++; i < root_moves.size(); i = next++) {
+                        for (int mode = 0; mode < 2; mode++) {
+                            searcher.enter(position, match.getState(), root_moves[i]);
+                            (mode == 0 ? best_values : policy_values)[i] = searcher.search(config.depth - 1, mode == 0);
+                        }
+                    }
+                    nodes += searcher.nodes;
+                    hits += searcher.hits;
+                }
+                catch (...) {
+                    errors[thread] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned thread = 1; thread < config.threads; thread++) {
+                workers.emplace_back(work, thread);
+            }
+            work(0);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            const bool maximize = match.decidingSeat() == responder;
+            result.best_response = maximize ? -1.0 : 0.0;
+            for (size_t i = 0; i < root_moves.size(); i++) {
+                result.best_response = maximize ? std::max(result.best_response, best_values[i])
+                                                : result.best_response + root_probs[i] * best_values[i];
+                result.policy_value += root_probs[i] * policy_values[i];
+            }
+            result.nodes = nodes.load() + 1;
+            result.table_hits = hits.load();
+        }
+
+        result.exploitability = result.best_response - result.policy_value;
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
@@ -0,0 +1,82 @@
+// Email: razcohenp@gmail.com
+
+// Bot.cpp - Random and scripted bots and the match loop shared by all bots
+
+#include "../../include/bots/Bot.hpp"
+#include "../../include/Game.hpp"
+#include "../../include/Player.hpp"
+
+#include <algorithm> // For std::find
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    DecisionLimit DecisionLimit::in(double milliseconds) {
+        DecisionLimit limit;
+        limit.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(milliseconds));
+        return limit;
+    }
+
+    bool DecisionLimit::expired() const {
+        return (stop && stop->load(std::memory_order_relaxed)) || std::chrono::steady_clock::now() >= deadline;
+    }
+
+    Move RandomBot::chooseMove(const Match& match) {
+        match.moves(options);
+        if (options.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+        return options[rng() % options.size()];
+    }
+
+    Move ScriptedBot::chooseMove(const Match& match) {
+        match.moves(options);
+        if (options.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+
+        const Game& game = match.getGame();
+        for (ActionType type : priorities) {
+            const Move* best = nullptr;
+            for (const Move& move : options) {
+                if (move.pass || move.action.type != type) continue;
+                if (best == nullptr || (move.action.target != NO_TARGET &&
+                    game.getPlayer(move.action.target)->coins() > game.getPlayer(best->action.target)->coins())) {
+                    best = &move;
+                }
+            }
+            if (best != nullptr) {
+                return *best;
+            }
+        }
+        return options[0]; // In a window the pass comes first
+    }
+
+    // Ask the bot of the deciding seat until the match ends
+    int playMatch(Match& match, const std::vector<Bot*>& seats) {
+        if (seats.size() != match.getGame().getPlayerCount()) {
+            throw std::invalid_argument("One bot per seat is required");
+        }
+
+        // Each distinct bot observes every move once
+        std::vector<Bot*> observers;
+        for (Bot* bot : seats) {
+            if (std::find(observers.begin(), observers.end(), bot) == observers.end()) {
+                observers.push_back(bot);
+            }
+        }
+
+        for (Bot* bot : observers) {
+            bot->start(match);
+        }
+
+        while (!match.isOver()) {
+            const Move move = seats[match.decidingSeat()]->chooseMove(match);
+            match.apply(move);
+            for (Bot* bot : observers) {
+                bot->observe(match, move);
+            }
+        }
+        return match.winner();
+    }
+}
@@ -0,0 +1,405 @@
+// Email: razcohenp@gmail.com
+
+// Cfr.cpp - Abstraction, lock-free MCCFR+ training and policy files
+// Each worker builds its own training games; only the regret and strategy tables are shared
+
+#include "../../include/bots/Cfr.hpp"
+#include "../../include/Game.hpp"
+#include "../../include/Player.hpp"
+
+#include <algorithm> // For std::min and std::max
+#include <cstdio> // For std::rename
+#include <exception> // For passing thread failures to the caller
+#include <fstream> // For checkpoint and policy files
+#include <random> // For sampling
+#include <stdexcept> // For exception handling
+#include <thread> // For worker threads
+
+namespace coup {
+    namespace {
+        size_t coinBucket(int coins) {
+            if (coins <= 0) return 0;
+            if (coins <= 2) return 1;
+            if (coins <= 4) return 2;
+            if (coins <= 6) return 3;
+            if (coins <= 9) return 4;
+            return 5;
+        }
+
+        // Adds delta to an atomic float, optionally flooring the result at zero
+        void atomicAdd(std::atomic<float>& value, float delta, bool floor_zero) {
+            float current = value.load(std::memory_order_relaxed);
+            float next;
+            do {
+                next = current + delta;
+                if (floor_zero && next < 0.0f) {
+                    next = 0.0f;
+                }
+            } while (!value.compare_exchange_weak(current, next, std::memory_order_relaxed));
+        }
+
+        void checkHeader(const CfrFileHeader& header, uint32_t magic) {
+            if (header.magic != magic || header.version != CFR_VERSION || header.header_size != sizeof(CfrFileHeader) ||
+                header.infosets != CFR_INFOSETS || header.actions != CFR_ACTIONS) {
+                throw std::runtime_error("CFR file format is not supported");
+            }
+        }
+
+        // One worker - owns its training games and random generator
+        class Traversal {
+        private:
+            CfrTrainer& trainer; // Shared tables
+            const CfrConfig& config; // Training settings
+            std::mt19937 rng; // Roles, prefixes and sampling
+            std::vector<Move> rollout_moves; // Move buffer of rollouts
+
+            size_t sample(const float* sigma, const AbstractMoves& legal) {
+                std::uniform_real_distribution<float> pick(0.0f, 1.0f);
+                float left = pick(rng);
+                size_t last = CFR_ACTIONS;
+                for (size_t a = 0; a < CFR_ACTIONS; a++) {
+                    if (legal.index[a] < 0) continue;
+                    last = a;
+                    left -= sigma[a];
+                    if (left <= 0.0f) {
+                        return a;
+                    }
+                }
+                return last; // Rounding leftovers go to the last legal action
+            }
+
+            // Plays one move of the deciding seat from the current strategy
+            void playStrategyMove(Match& match, std::vector<Move>& moves) {
+                AbstractMoves legal;
+                float sigma[CFR_ACTIONS];
+                match.moves(moves);
+                abstractMoves(match, moves, legal);
+                trainer.currentStrategy(abstractInfoSet(match), legal, sigma);
+                match.apply(moves[legal.index[sample(sigma, legal)]]);
+            }
+
+            double traverse(Match& match, uint8_t traverser, unsigned depth, float weight) {
+                if (depth == 0) { // Below the tree - finish with the current strategies
+                    while (!match.isOver()) {
+                        playStrategyMove(match, rollout_moves);
+                    }
+                    return match.reward(traverser);
+                }
+                if (match.isOver()) {
+                    return match.reward(traverser);
+                }
+
+                std::vector<Move> moves;
+                AbstractMoves legal;
+                float sigma[CFR_ACTIONS];
+                match.moves(moves);
+                abstractMoves(match, moves, legal);
+                const size_t infoset = abstractInfoSet(match);
+                trainer.currentStrategy(infoset, legal, sigma);
+
+                if (match.decidingSeat() != traverser) { // Sampled opponent node
+                    for (size_t a = 0; a < CFR_ACTIONS; a++) {
+                        if (legal.index[a] >= 0) {
+                            trainer.addStrategy(infoset, a, weight * sigma[a]);
+                        }
+                    }
+                    match.apply(moves[legal.index[sample(sigma, legal)]]);
+                    return traverse(match, traverser, depth, weight);
+                }
+
+                // Traverser node - every action is explored from the same position
+                Game& game = match.getGame();
+                GameSnapshot position;
+                game.saveSnapshot(position, false);
+                const MatchState state = match.getState();
+                double values[CFR_ACTIONS] = {};
+                double node_value = 0.0;
+                for (size_t a = 0; a < CFR_ACTIONS; a++) {
+                    if (legal.index[a] < 0) continue;
+                    game.loadSnapshot(position);
+                    match.reset(state);
+                    match.apply(moves[legal.index[a]]);
+                    values[a] = traverse(match, traverser, depth - 1, weight);
+                    node_value += sigma[a] * values[a];
+                }
+                for (size_t a = 0; a < CFR_ACTIONS; a++) {
+                    if (legal.index[a] >= 0) {
+                        trainer.addRegret(infoset, a, static_cast<float>(values[a] - node_value));
+                    }
+                }
+                return node_value;
+            }
+
+        public:
+            Traversal(CfrTrainer& trainer, const CfrConfig& config, uint32_t seed)
+            : trainer(trainer), config(config), rng(seed) {}
+
+            void iteration(uint64_t t) {
+                const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                          RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+                Game game;
+                std::vector<std::unique_ptr<Player>> roster;
+                for (unsigned seat = 0; seat < config.players; seat++) {
+                    roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1), roles[rng() % 6]));
+                }
+                game.startGame();
+                Match match(game, config.max_steps);
+
+                // Start from a position the current strategies would reach
+                const uint32_t prefix = rng() % (config.prefix_moves + 1);
+                for (uint32_t move = 0; move < prefix && !match.isOver(); move++) {
+                    playStrategyMove(match, rollout_moves);
+                }
+                if (!match.isOver()) {
+                    traverse(match, match.decidingSeat(), config.branch_depth, static_cast<float>(t));
+                }
+            }
+        };
+    }
+
+    size_t abstractInfoSet(const Match& match) {
+        const Game& game = match.getGame();
+        const uint8_t seat = match.decidingSeat();
+        const Player* self = game.getPlayer(seat);
+        const size_t count = game.getPlayerCount();
+
+        // Richest active opponent, first in turn order on ties
+        const Player* richest = nullptr;
+        size_t opponents = 0;
+        for (size_t offset = 1; offset < count; offset++) {
+            const Player* other = game.getPlayer((seat + offset) % count);
+            if (!other->isActive()) continue;
+            opponents++;
+            if (!richest || other->coins() > richest->coins()) {
+                richest = other;
+            }
+        }
+
+        size_t context = 0;
+        if (match.inReactionWindow()) {
+            switch (match.getState().window.trigger.type) {
+                case ActionType::TAX: context = 1; break;
+                case ActionType::BRIBE: context = 2; break;
+                default: context = 3; break;
+            }
+        }
+        const size_t flags = (self->isSanctioned() ? 1 : 0) | (self->isArrestAvailable() ? 2 : 0) | (self->isBribeUsed() ? 4 : 0);
+
+        size_t index = static_cast<size_t>(self->getRole());
+        index = index * CFR_COIN_BUCKETS + coinBucket(self->coins());
+        index = index * CFR_COIN_BUCKETS + (richest ? coinBucket(richest->coins()) : 0);
+        index = index * 7 + (richest ? static_cast<size_t>(richest->getRole()) : static_cast<size_t>(RoleType::PLAYER));
+        index = index * 5 + (opponents > 1 ? (opponents > 5 ? 4 : opponents - 1) : 0);
+        index = index * 4 + context;
+        return index * 8 + flags;
+    }
+
+    void abstractMoves(const Match& match, const std::vector<Move>& moves, AbstractMoves& out) {
+        const Game& game = match.getGame();
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            out.index[a] = -1;
+        }
+
+        for (size_t i = 0; i < moves.size(); i++) {
+            const Move& move = moves[i];
+            const size_t a = move.pass ? CFR_PASS : static_cast<size_t>(move.action.type);
+            if (out.index[a] < 0) {
+                out.index[a] = static_cast<int16_t>(i);
+            }
+            else if (!move.pass && move.action.target < game.getPlayerCount()) {
+                const Move& kept = moves[out.index[a]];
+                if (game.getPlayer(move.action.target)->coins() > game.getPlayer(kept.action.target)->coins()) {
+                    out.index[a] = static_cast<int16_t>(i); // Aim at the richest target
+                }
+            }
+        }
+    }
+
+    CfrTrainer::CfrTrainer(const CfrConfig& config)
+    : config(config), regrets(new std::atomic<float>[CFR_INFOSETS * CFR_ACTIONS]),
+    strategy_sums(new std::atomic<float>[CFR_INFOSETS * CFR_ACTIONS]), iterations(0) {
+        if (config.players < 2 || config.players > 6) {
+            throw std::invalid_argument("Training games need 2 to 6 players");
+        }
+        if (config.threads == 0) {
+            throw std::invalid_argument("Training needs at least one thread");
+        }
+        for (size_t i = 0; i < CFR_INFOSETS * CFR_ACTIONS; i++) {
+            regrets[i].store(0.0f, std::memory_order_relaxed);
+            strategy_sums[i].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+
+    void CfrTrainer::currentStrategy(size_t infoset, const AbstractMoves& legal, float* out) const {
+        const std::atomic<float>* row = &regrets[infoset * CFR_ACTIONS];
+        float total = 0.0f;
+        int legal_count = 0;
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            out[a] = legal.index[a] >= 0 ? row[a].load(std::memory_order_relaxed) : 0.0f;
+            total += out[a];
+            legal_count += legal.index[a] >= 0 ? 1 : 0;
+        }
+
+        // Regret matching, uniform over legal actions when no regret is positive
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            if (legal.index[a] < 0) {
+                out[a] = 0.0f;
+            }
+            else {
+                out[a] = total > 0.0f ? out[a] / total : 1.0f / legal_count;
+            }
+        }
+    }
+
+    void CfrTrainer::addRegret(size_t infoset, size_t action, float delta) {
+        atomicAdd(regrets[infoset * CFR_ACTIONS + action], delta, true);
+    }
+
+    void CfrTrainer::addStrategy(size_t infoset, size_t action, float delta) {
+        atomicAdd(strategy_sums[infoset * CFR_ACTIONS + action], delta, false);
+    }
+
+    void CfrTrainer::train(uint64_t count) {
+        const uint64_t target = iterations.load() + count;
+        while (iterations.load() < target) {
+            // Run up to the next checkpoint, then save while the workers are idle
+            uint64_t stop = target;
+            if (config.checkpoint_every > 0) {
+                stop = std::min(target, (iterations.load() / config.checkpoint_every + 1) * config.checkpoint_every);
+            }
+
+            const uint64_t round_start = iterations.load();
+            std::atomic<uint64_t> next(round_start);
+            std::vector<std::exception_ptr> errors(config.threads);
+            auto work = [&](unsigned thread) {
+                try {
+                    Traversal traversal(*this, config, config.seed + 7919u * thread + static_cast<uint32_t>(round_start) * 104729u);
+                    for (uint64_t t = next++; t < stop; t = next++) {
+                        traversal.iteration(t + 1);
+                        iterations++;
+                    }
+                }
+                catch (...) {
+                    errors[thread] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned thread = 1; thread < config.threads; thread++) {
+                workers.emplace_back(work, thread);
+            }
+            work(0);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            if (config.checkpoint_every > 0 && !config.checkpoint_path.empty()) {
+                saveCheckpoint(config.checkpoint_path);
+            }
+        }
+    }
+
+    void CfrTrainer::saveCheckpoint(const std::string& path) const {
+        CfrFileHeader header = {CFR_CHECKPOINT_MAGIC, CFR_VERSION, sizeof(CfrFileHeader),
+                                static_cast<uint32_t>(CFR_INFOSETS), static_cast<uint32_t>(CFR_ACTIONS), iterations.load()};
+        std::vector<float> values(CFR_INFOSETS * CFR_ACTIONS);
+
+        // Written next to the target and renamed, so a crash never leaves a torn checkpoint
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Cannot open checkpoint file " + temporary);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto* table : {&regrets, &strategy_sums}) {
+                for (size_t i = 0; i < values.size(); i++) {
+                    values[i] = (*table)[i].load(std::memory_order_relaxed);
+                }
+                out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+            }
+            if (!out) {
+                throw std::runtime_error("Failed to write checkpoint file " + temporary);
+            }
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Cannot replace checkpoint file " + path);
+        }
+    }
+
+    void CfrTrainer::loadCheckpoint(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open checkpoint file " + path);
+        }
+        CfrFileHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in) {
+            throw std::runtime_error("Checkpoint file is truncated");
+        }
+        checkHeader(header, CFR_CHECKPOINT_MAGIC);
+
+        std::vector<float> values(CFR_INFOSETS * CFR_ACTIONS * 2);
+        in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(float));
+        if (!in) {
+            throw std::runtime_error("Checkpoint file is truncated");
+        }
+        for (size_t i = 0; i < CFR_INFOSETS * CFR_ACTIONS; i++) {
+            regrets[i].store(values[i], std::memory_order_relaxed);
+            strategy_sums[i].store(values[CFR_INFOSETS * CFR_ACTIONS + i], std::memory_order_relaxed);
+        }
+        iterations.store(header.iterations);
+    }
+
+    void CfrTrainer::writePolicy(const std::string& path) const {
+        CfrFileHeader header = {CFR_POLICY_MAGIC, CFR_VERSION, sizeof(CfrFileHeader),
+                                static_cast<uint32_t>(CFR_INFOSETS), static_cast<uint32_t>(CFR_ACTIONS), iterations.load()};
+        std::vector<uint8_t> weights(CFR_INFOSETS * CFR_ACTIONS, 0);
+
+        // Average strategy quantized so the largest weight of each row is 255
+        for (size_t infoset = 0; infoset < CFR_INFOSETS; infoset++) {
+            const std::atomic<float>* row = &strategy_sums[infoset * CFR_ACTIONS];
+            float largest = 0.0f;
+            for (size_t a = 0; a < CFR_ACTIONS; a++) {
+                largest = std::max(largest, row[a].load(std::memory_order_relaxed));
+            }
+            if (largest <= 0.0f) continue;
+            for (size_t a = 0; a < CFR_ACTIONS; a++) {
+                weights[infoset * CFR_ACTIONS + a] = static_cast<uint8_t>(255.0f * row[a].load(std::memory_order_relaxed) / largest + 0.5f);
+            }
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open policy file " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(weights.data()), weights.size());
+        if (!out) {
+            throw std::runtime_error("Failed to write policy file " + path);
+        }
+    }
+
+    CfrPolicy::CfrPolicy(const std::string& path) : weights(CFR_INFOSETS * CFR_ACTIONS), iterations(0) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open policy file " + path);
+        }
+        CfrFileHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in) {
+            throw std::runtime_error("Policy file is truncated");
+        }
+        checkHeader(header, CFR_POLICY_MAGIC);
+        in.read(reinterpret_cast<char*>(weights.data()), weights.size());
+        if (!in) {
+            throw std::runtime_error("Policy file is truncated");
+        }
+        iterations = header.iterations;
+    }
+}
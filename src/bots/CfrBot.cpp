@@ -0,0 +1,41 @@
+// Email: razcohenp@gmail.com
+
+// CfrBot.cpp - Sampling from the quantized average strategy
+
+#include "../../include/bots/CfrBot.hpp"
+
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    Move CfrBot::chooseMove(const Match& match) {
+        match.moves(options);
+        if (options.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+
+        AbstractMoves legal;
+        abstractMoves(match, options, legal);
+        const uint8_t* weights = policy.row(abstractInfoSet(match));
+
+        // Untrained rows (or rows whose weight is all on illegal actions) play uniformly
+        uint32_t total = 0;
+        uint32_t legal_count = 0;
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            if (legal.index[a] >= 0) {
+                total += weights[a];
+                legal_count++;
+            }
+        }
+
+        uint32_t left = static_cast<uint32_t>(rng() % (total > 0 ? total : legal_count));
+        for (size_t a = 0; a < CFR_ACTIONS; a++) {
+            if (legal.index[a] < 0) continue;
+            const uint32_t weight = total > 0 ? weights[a] : 1;
+            if (left < weight) {
+                return options[legal.index[a]];
+            }
+            left -= weight;
+        }
+        return options[0]; // Unreachable - left is always below the total weight
+    }
+}
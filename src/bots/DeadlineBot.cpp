@@ -0,0 +1,183 @@
+// Email: razcohenp@gmail.com
+
+// DeadlineBot.cpp - Watchdog that enforces hard deadlines on a wrapped bot
+// The wrapped bot runs on a persistent worker thread; the caller never waits past the deadline
+
+#include "../../include/bots/DeadlineBot.hpp"
+#include "../../include/GameClone.hpp"
+
+#include <algorithm> // For std::min and std::max
+#include <stdexcept> // For exception handling
+#include <utility> // For std::move
+
+namespace coup {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::duration milliseconds(double value) {
+            return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(value));
+        }
+    }
+
+    DeadlineBot::DeadlineBot(std::unique_ptr<Bot> inner, double budget_ms, double margin_ms, uint32_t seed)
+    : inner(std::move(inner)), budget_ms(budget_ms), margin_ms(margin_ms), rng(seed),
+      busy(false), quit(false), task(0), answer(Move::decline(0)), stop(false) {
+        if (!this->inner) {
+            throw std::invalid_argument("DeadlineBot needs a bot to wrap");
+        }
+        if (budget_ms <= 0 || margin_ms < 0 || margin_ms >= budget_ms) {
+            throw std::invalid_argument("Turn budget must be positive and longer than the safety margin");
+        }
+        worker = std::thread(&DeadlineBot::workerLoop, this);
+    }
+
+    DeadlineBot::~DeadlineBot() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+            stop.store(true);
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+    void DeadlineBot::workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t seen = 0;
+        while (true) {
+            wake.wait(lock, [&] { return quit || task != seen; });
+            if (quit) {
+                return;
+            }
+            seen = task;
+            const DecisionLimit limit = task_limit;
+            lock.unlock();
+
+            // The position and the bot are not touched by the caller while busy is set
+            Move move = Move::decline(0);
+            std::exception_ptr failure;
+            try {
+                move = inner->chooseMoveWithin(*position, limit);
+            }
+            catch (...) {
+                failure = std::current_exception();
+            }
+
+            lock.lock();
+            answer = move;
+            error = failure;
+            busy = false;
+            done.notify_all();
+        }
+    }
+
+    void DeadlineBot::enqueue(const Match& match, const Move& move, bool start) {
+        PendingEvent event;
+        event.clone.reset(new GameClone(match.getGame()));
+        event.match.reset(new Match(event.clone->game(), match.getState(), match.getMaxSteps()));
+        event.move = move;
+        event.start = start;
+        pending.push_back(std::move(event));
+    }
+
+    void DeadlineBot::replayPending() {
+        while (!pending.empty()) {
+            const PendingEvent event = std::move(pending.front());
+            pending.pop_front();
+            if (event.start) {
+                inner->start(*event.match);
+            }
+            else {
+                inner->observe(*event.match, event.move);
+            }
+        }
+    }
+
+    bool DeadlineBot::waitIdle(std::unique_lock<std::mutex>& lock, Clock::time_point until) {
+        return done.wait_until(lock, until, [&] { return !busy; });
+    }
+
+    Move DeadlineBot::chooseMove(const Match& match) {
+        return chooseMoveWithin(match, DecisionLimit::in(budget_ms));
+    }
+
+    Move DeadlineBot::chooseMoveWithin(const Match& match, const DecisionLimit& limit) {
+        const auto entered = Clock::now();
+        const auto deadline = std::min(limit.deadline, entered + milliseconds(budget_ms));
+        const auto soft_deadline = deadline - milliseconds(margin_ms);
+        stats.decisions++;
+
+        match.moves(options);
+        if (options.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+
+        // The fallback is ready before the search starts, so the watchdog never has to compute anything late
+        Move chosen = options.size() == 1 ? options[0] : HeuristicBot::pick(match.getGame(), options, weights, rng);
+        bool searched = false;
+
+        if (options.size() > 1) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!waitIdle(lock, soft_deadline)) {
+                stats.skipped++; // A late search of an earlier turn still owns the worker
+            }
+            else {
+                replayPending(); // Events that arrived during a late search come before this decision
+                clone.reset(new GameClone(match.getGame()));
+                position.reset(new Match(clone->game(), match.getState(), match.getMaxSteps()));
+                task_limit.deadline = soft_deadline;
+                task_limit.stop = &stop;
+                stop.store(false);
+                busy = true;
+                task++;
+                wake.notify_one();
+
+                // Let the search finish on its own, then signal stop and wait out the margin
+                if (!waitIdle(lock, soft_deadline)) {
+                    stop.store(true);
+                    waitIdle(lock, deadline);
+                }
+                if (!busy) {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                    chosen = answer;
+                    searched = true;
+                }
+            }
+        }
+
+        if (searched || options.size() == 1) {
+            stats.searched++;
+        }
+        else {
+            stats.fallbacks++;
+        }
+        stats.max_latency_ms = std::max(stats.max_latency_ms,
+            std::chrono::duration<double, std::milli>(Clock::now() - entered).count());
+        return chosen;
+    }
+
+    void DeadlineBot::start(const Match& match) {
+        std::unique_lock<std::mutex> lock(mutex);
+        stop.store(true); // A search of the previous match is obsolete now
+        if (busy) {
+            pending.clear(); // So are the moves of that match still waiting
+            enqueue(match, Move::decline(0), true);
+            return;
+        }
+        replayPending();
+        inner->start(match);
+    }
+
+    void DeadlineBot::observe(const Match& match, const Move& move) {
+        std::unique_lock<std::mutex> lock(mutex);
+        stop.store(true); // A late search of the previous turn is obsolete now
+        if (busy) { // Never hold up the table for it
+            enqueue(match, move, false);
+            return;
+        }
+        replayPending();
+        inner->observe(match, move);
+    }
+}
@@ -0,0 +1,342 @@
+// Email: razcohenp@gmail.com
+
+// Evolution.cpp - Persistent evaluation workers, breeding and population checkpoints
+// Workers keep their clones and bots between generations; only weights and seeds change per game
+
+#include "../../include/bots/Evolution.hpp"
+#include "../../include/GameClone.hpp"
+#include "../../include/Player.hpp"
+
+#include <algorithm> // For sorting the population
+#include <atomic> // For the shared game counter
+#include <condition_variable> // For waking the workers
+#include <cstdio> // For std::rename
+#include <exception> // For passing worker failures to the caller
+#include <fstream> // For checkpoint files
+#include <functional> // For evaluation jobs
+#include <mutex> // For the job handoff
+#include <random> // For deals and mutations
+#include <stdexcept> // For exception handling
+#include <thread> // For the workers
+#include <unordered_map> // For clones by role deal
+
+namespace coup {
+    namespace {
+        // Seed of one game of one generation - the same for every candidate
+        uint32_t dealSeed(uint32_t seed, uint64_t generation, uint64_t game) {
+            uint64_t z = (static_cast<uint64_t>(seed) << 32) ^ (generation << 20) ^ game;
+            z += 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<uint32_t>(z ^ (z >> 31));
+        }
+
+        // Clone of one role deal with the state right after the start of the game
+        struct DealTable {
+            std::unique_ptr<GameClone> clone; // Reused game
+            std::unique_ptr<Match> match; // Decision sequence on the clone
+            GameSnapshot start; // Position every game starts from
+            MatchState initial; // Match bookkeeping at the start
+
+            explicit DealTable(const std::vector<RoleType>& roles, uint32_t max_steps) {
+                Game setup;
+                std::vector<std::unique_ptr<Player>> roster;
+                for (size_t seat = 0; seat < roles.size(); seat++) {
+                    roster.emplace_back(setup.createPlayerWithRole("P" + std::to_string(seat + 1), roles[seat]));
+                }
+                setup.startGame();
+                clone.reset(new GameClone(setup));
+                match.reset(new Match(clone->game(), max_steps));
+                clone->game().saveSnapshot(start, false);
+                initial = match->getState();
+            }
+        };
+    }
+
+    // Everything a worker reuses between games
+    struct EvaluationContext {
+        std::unordered_map<uint64_t, std::unique_ptr<DealTable>> tables; // Clones by role deal
+        std::vector<std::unique_ptr<HeuristicBot>> bots; // One bot per seat
+        std::vector<Bot*> seats; // Views of the bots
+        std::vector<RoleType> roles; // Deal buffer
+    };
+
+    // Threads that wait for a job, share its items and report back
+    class EvolutionTuner::Workers {
+    private:
+        std::vector<std::thread> threads; // Helpers (the caller is worker 0)
+        std::vector<std::unique_ptr<EvaluationContext>> contexts; // One per worker
+        std::mutex mutex; // Guards the job handoff
+        std::condition_variable wake; // Signals a new job or shutdown
+        std::condition_variable finished; // Signals the last helper is done
+        const std::function<void(EvaluationContext&, size_t)>* job = nullptr; // Current job
+        size_t items = 0; // Items of the current job
+        std::atomic<size_t> next{0}; // Next unclaimed item
+        unsigned running = 0; // Helpers still working on the job
+        uint64_t round = 0; // Jobs started
+        bool stopping = false; // Set by the destructor
+        std::exception_ptr error; // First failure of the job
+
+        void drain(EvaluationContext& context) {
+            try {
+                for (size_t item = next++; item < items; item = next++) {
+                    (*job)(context, item);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = items; // Stop the others early
+            }
+        }
+
+        void loop(size_t index) {
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return stopping || round != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = round;
+                lock.unlock();
+                drain(*contexts[index]);
+                lock.lock();
+                if (--running == 0) {
+                    finished.notify_one();
+                }
+            }
+        }
+
+    public:
+        explicit Workers(unsigned count) {
+            for (unsigned i = 0; i < count; i++) {
+                contexts.emplace_back(new EvaluationContext());
+            }
+            for (unsigned i = 1; i < count; i++) {
+                threads.emplace_back(&Workers::loop, this, i);
+            }
+        }
+
+        ~Workers() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        // Runs fn on every item and returns once all are done
+        void run(size_t count, const std::function<void(EvaluationContext&, size_t)>& fn) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = &fn;
+                items = count;
+                next = 0;
+                running = static_cast<unsigned>(threads.size());
+                error = nullptr;
+                round++;
+            }
+            wake.notify_all();
+            drain(*contexts[0]);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&]() { return running == 0; });
+            job = nullptr;
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    void weightsToGenes(const HeuristicWeights& weights, double* genes) {
+        for (size_t a = 0; a < ACTION_TYPE_COUNT; a++) {
+            genes[a] = weights.action[a];
+        }
+        genes[ACTION_TYPE_COUNT] = weights.pass;
+        genes[ACTION_TYPE_COUNT + 1] = weights.target_coins;
+        genes[ACTION_TYPE_COUNT + 2] = weights.target_threat;
+        genes[ACTION_TYPE_COUNT + 3] = weights.noise;
+    }
+
+    HeuristicWeights genesToWeights(const double* genes) {
+        HeuristicWeights weights;
+        for (size_t a = 0; a < ACTION_TYPE_COUNT; a++) {
+            weights.action[a] = genes[a];
+        }
+        weights.pass = genes[ACTION_TYPE_COUNT];
+        weights.target_coins = genes[ACTION_TYPE_COUNT + 1];
+        weights.target_threat = genes[ACTION_TYPE_COUNT + 2];
+        weights.noise = genes[ACTION_TYPE_COUNT + 3];
+        return weights;
+    }
+
+    EvolutionTuner::EvolutionTuner(const EvolutionConfig& config, const std::vector<HeuristicWeights>& pool)
+    : config(config), pool(pool) {
+        if (config.players < 2 || config.players > 6) {
+            throw std::invalid_argument("Players must be between 2 and 6");
+        }
+        if (config.population < 2 || config.elite >= config.population || config.tournament == 0) {
+            throw std::invalid_argument("Population must exceed the elite and hold at least two candidates");
+        }
+        if (config.threads == 0 || config.games == 0) {
+            throw std::invalid_argument("Threads and games must be positive");
+        }
+        if (this->pool.empty()) {
+            this->pool.push_back(HeuristicWeights());
+        }
+
+        // Default weights first, the rest are mutants of them
+        population.resize(config.population);
+        weightsToGenes(HeuristicWeights(), population[0].genes);
+        for (size_t i = 1; i < population.size(); i++) {
+            population[i] = population[0];
+        }
+        breed();
+        workers.reset(new Workers(config.threads));
+    }
+
+    EvolutionTuner::~EvolutionTuner() = default;
+
+    double EvolutionTuner::evaluate(const HeuristicWeights& weights) {
+        std::vector<double> scores(config.games);
+        const std::function<void(EvaluationContext&, size_t)> play = [&](EvaluationContext& context, size_t game) {
+            const uint32_t seed = dealSeed(config.seed, generation, game);
+            std::mt19937 rng(seed);
+            uint64_t key = 0;
+            context.roles.resize(config.players);
+            for (size_t seat = 0; seat < config.players; seat++) {
+                context.roles[seat] = static_cast<RoleType>(rng() % 6);
+                key = key * 8 + static_cast<uint64_t>(context.roles[seat]);
+            }
+
+            auto found = context.tables.find(key);
+            if (found == context.tables.end()) {
+                found = context.tables.emplace(key, std::unique_ptr<DealTable>(new DealTable(context.roles, config.max_steps))).first;
+            }
+            DealTable& table = *found->second;
+            table.clone->load(table.start);
+            table.match->reset(table.initial);
+
+            // The candidate rotates through the seats, opponents rotate through the pool
+            const size_t candidate_seat = game % config.players;
+            while (context.bots.size() < config.players) {
+                context.bots.emplace_back(new HeuristicBot());
+                context.seats.push_back(context.bots.back().get());
+            }
+            for (size_t seat = 0; seat < config.players; seat++) {
+                const HeuristicWeights& seat_weights = seat == candidate_seat ? weights
+                                                     : pool[(game / config.players + seat) % pool.size()];
+                context.bots[seat]->reset(seat_weights, seed + static_cast<uint32_t>(seat));
+            }
+            context.seats.resize(config.players);
+
+            playMatch(*table.match, context.seats);
+            scores[game] = table.match->reward(static_cast<uint8_t>(candidate_seat));
+        };
+        workers->run(config.games, play);
+
+        double total = 0.0;
+        for (double score : scores) {
+            total += score;
+        }
+        return total / config.games;
+    }
+
+    Candidate EvolutionTuner::step() {
+        for (Candidate& candidate : population) {
+            candidate.fitness = evaluate(genesToWeights(candidate.genes));
+        }
+        std::stable_sort(population.begin(), population.end(), [](const Candidate& a, const Candidate& b) {
+            return a.fitness > b.fitness;
+        });
+        const Candidate best = population[0];
+
+        generation++;
+        breed();
+        if (!config.checkpoint_path.empty()) {
+            saveCheckpoint(config.checkpoint_path);
+        }
+        return best;
+    }
+
+    // Elite survive, the rest are children of tournament winners (population sorted best first)
+    void EvolutionTuner::breed() {
+        std::mt19937 rng(config.seed * 2654435761u + static_cast<uint32_t>(generation));
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::normal_distribution<double> mutation(0.0, config.mutation_scale);
+        auto select = [&]() -> const Candidate& {
+            size_t best = rng() % population.size();
+            for (unsigned draw = 1; draw < config.tournament; draw++) {
+                best = std::min<size_t>(best, rng() % population.size());
+            }
+            return population[best];
+        };
+
+        std::vector<Candidate> children(population.begin(), population.begin() + config.elite);
+        while (children.size() < population.size()) {
+            const Candidate& mother = select();
+            const Candidate& father = select();
+            Candidate child;
+            for (size_t gene = 0; gene < HEURISTIC_GENES; gene++) {
+                child.genes[gene] = unit(rng) < 0.5 ? mother.genes[gene] : father.genes[gene];
+                if (unit(rng) < config.mutation_rate) {
+                    child.genes[gene] += mutation(rng);
+                }
+            }
+            child.genes[HEURISTIC_GENES - 1] = std::max(0.0, child.genes[HEURISTIC_GENES - 1]); // Noise bound
+            children.push_back(child);
+        }
+        population.swap(children);
+    }
+
+    void EvolutionTuner::saveCheckpoint(const std::string& path) const {
+        const EvolutionFileHeader header = {EVOLUTION_MAGIC, EVOLUTION_VERSION, sizeof(EvolutionFileHeader),
+                                            static_cast<uint32_t>(HEURISTIC_GENES),
+                                            static_cast<uint32_t>(population.size()), generation};
+
+        // Written next to the target and renamed, so a crash never leaves a torn checkpoint
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Cannot open checkpoint file " + temporary);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(population.data()), population.size() * sizeof(Candidate));
+            if (!out) {
+                throw std::runtime_error("Failed to write checkpoint file " + temporary);
+            }
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Cannot replace checkpoint file " + path);
+        }
+    }
+
+    void EvolutionTuner::loadCheckpoint(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open checkpoint file " + path);
+        }
+        EvolutionFileHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || header.magic != EVOLUTION_MAGIC || header.version != EVOLUTION_VERSION ||
+            header.header_size != sizeof(EvolutionFileHeader) || header.genes != HEURISTIC_GENES ||
+            header.population <= config.elite) {
+            throw std::runtime_error("Not a compatible population checkpoint: " + path);
+        }
+
+        std::vector<Candidate> loaded(header.population);
+        in.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(Candidate));
+        if (!in) {
+            throw std::runtime_error("Checkpoint file is truncated");
+        }
+        population.swap(loaded);
+        generation = header.generation;
+    }
+}
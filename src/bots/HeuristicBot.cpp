@@ -0,0 +1,67 @@
+// Email: razcohenp@gmail.com
+
+// HeuristicBot.cpp - Weighted move scoring
+
+#include "../../include/bots/HeuristicBot.hpp"
+#include "../../include/Game.hpp"
+#include "../../include/Player.hpp"
+
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    HeuristicWeights::HeuristicWeights() : pass(2.0), target_coins(0.3), target_threat(2.0), noise(1.0) {
+        action[static_cast<size_t>(ActionType::GATHER)] = 1.0;
+        action[static_cast<size_t>(ActionType::TAX)] = 2.0;
+        action[static_cast<size_t>(ActionType::BRIBE)] = 0.5;
+        action[static_cast<size_t>(ActionType::ARREST)] = 1.5;
+        action[static_cast<size_t>(ActionType::SANCTION)] = 1.0;
+        action[static_cast<size_t>(ActionType::COUP)] = 10.0;
+        action[static_cast<size_t>(ActionType::INVEST)] = 3.0;
+        action[static_cast<size_t>(ActionType::SPY_ON)] = 0.2;
+        action[static_cast<size_t>(ActionType::BLOCK_COUP)] = 6.0;
+        action[static_cast<size_t>(ActionType::BLOCK_BRIBE)] = 3.0;
+        action[static_cast<size_t>(ActionType::UNDO)] = 3.0;
+    }
+
+    HeuristicBot::HeuristicBot(uint32_t seed, const HeuristicWeights& weights) : weights(weights), rng(seed) {}
+
+    double HeuristicBot::score(const Game& game, const Move& move, const HeuristicWeights& weights) {
+        if (move.pass) {
+            return weights.pass;
+        }
+
+        double value = weights.action[static_cast<size_t>(move.action.type)];
+        if (actionHasTarget(move.action.type) && move.action.target < game.getPlayerCount()) {
+            const int coins = game.getPlayer(move.action.target)->coins();
+            value += weights.target_coins * coins;
+            if (coins >= game.getRules().coup_cost) {
+                value += weights.target_threat;
+            }
+        }
+        return value;
+    }
+
+    const Move& HeuristicBot::pick(const Game& game, const std::vector<Move>& moves,
+                                   const HeuristicWeights& weights, std::mt19937& rng) {
+        if (moves.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+
+        std::uniform_real_distribution<double> noise(0.0, weights.noise > 0 ? weights.noise : 0.0);
+        size_t best = 0;
+        double best_score = 0;
+        for (size_t i = 0; i < moves.size(); i++) {
+            double value = score(game, moves[i], weights) + (weights.noise > 0 ? noise(rng) : 0.0);
+            if (i == 0 || value > best_score) {
+                best = i;
+                best_score = value;
+            }
+        }
+        return moves[best];
+    }
+
+    Move HeuristicBot::chooseMove(const Match& match) {
+        match.moves(options);
+        return pick(match.getGame(), options, weights, rng);
+    }
+}
@@ -0,0 +1,318 @@
+// Email: razcohenp@gmail.com
+
+// IsmctsBot.cpp - Single-observer information-set MCTS with root parallelism
+// Each thread owns a tree, a cache of clones per sampled role assignment and its own random generator
+
+#include "../../include/bots/IsmctsBot.hpp"
+#include "../../include/GameClone.hpp"
+
+#include <algorithm> // For std::min
+#include <atomic> // For the stop flag
+#include <chrono> // For the time budget
+#include <cmath> // For the UCB formula
+#include <exception> // For passing thread failures to the caller
+#include <stdexcept> // For exception handling
+#include <thread> // For root parallelism
+#include <unordered_map> // For the clone cache
+
+namespace coup {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr size_t CLONE_CACHE_LIMIT = 256; // Role assignments kept per thread before the cache is rebuilt
+
+        // One node of the information-set tree - children form a sibling list
+        struct InfoNode {
+            Move move; // Move that leads to this node
+            int32_t parent; // Parent index, -1 for the root
+            int32_t first_child; // First child, -1 if none
+            int32_t next_sibling; // Next child of the parent, -1 if last
+            uint32_t visits; // Simulations through this node
+            uint32_t available; // Simulations in which the move was legal at its parent
+            double reward; // Sum of the mover's rewards
+        };
+
+        // Root statistics of one tree
+        struct InfoRootResult {
+            std::vector<Move> moves; // Root moves that were tried
+            std::vector<uint32_t> visits; // Visits per tried move
+            std::vector<double> reward; // Reward sum per tried move
+            uint64_t iterations = 0; // Simulations run
+            uint64_t nodes = 0; // Tree size
+        };
+
+        // Clone of one role assignment and the decision sequence on it
+        struct SampleTable {
+            GameClone clone;
+            Match sim;
+
+            SampleTable(const GameSnapshot& sample, const GameRules& rules, const MatchState& state, uint32_t max_steps)
+            : clone(sample, rules), sim(clone.game(), state, max_steps) {}
+        };
+
+        // Seat that makes a move (passes carry their seat in the actor field)
+        uint8_t moverOf(const Move& move) {
+            return move.action.actor;
+        }
+
+        // Tree of one search thread
+        class InfoSetSearch {
+        private:
+            const MctsConfig& config; // Search settings
+            const ObservationTracker& tracker; // Knowledge of the searching seat
+            MatchState root_match; // Public bookkeeping of the decision
+            GameRules rules; // Rules of the real game
+            uint32_t max_steps; // Draw cap of the match
+            std::unordered_map<uint64_t, std::unique_ptr<SampleTable>> tables; // Clones by role assignment
+            std::vector<InfoNode> nodes; // Tree storage, node 0 is the root
+            std::vector<Move> options; // Reused move buffer
+            std::vector<Move> untried; // Legal moves without a child
+            GameSnapshot sample; // Current determinization
+            std::mt19937 rng; // Sampling, expansion and rollout randomness
+
+            // Clone holding the roles of the current sample, loaded with it
+            Match& load() {
+                uint64_t key = 0;
+                for (uint8_t seat = 0; seat < sample.header.player_count; seat++) {
+                    key |= static_cast<uint64_t>(sample.players[seat].role) << (8 * seat);
+                }
+
+                auto found = tables.find(key);
+                if (found == tables.end()) {
+                    if (tables.size() >= CLONE_CACHE_LIMIT) {
+                        tables.clear();
+                    }
+                    found = tables.emplace(key, std::unique_ptr<SampleTable>(new SampleTable(sample, rules, root_match, max_steps))).first;
+                }
+                else {
+                    found->second->clone.load(sample);
+                }
+                found->second->sim.reset(root_match);
+                return found->second->sim;
+            }
+
+            int32_t addChild(int32_t index, const Move& move) {
+                const int32_t child = static_cast<int32_t>(nodes.size());
+                nodes.push_back({move, index, -1, nodes[index].first_child, 0, 1, 0.0});
+                nodes[index].first_child = child;
+                return child;
+            }
+
+            // Marks the children that are legal in this determinization and picks one by UCB.
+            // Returns -1 (and fills untried) when some legal move has no child yet.
+            int32_t select(int32_t index) {
+                untried.clear();
+                int32_t best = -1;
+                double best_value = -1.0;
+
+                for (const Move& move : options) {
+                    int32_t child = nodes[index].first_child;
+                    while (child >= 0 && nodes[child].move != move) {
+                        child = nodes[child].next_sibling;
+                    }
+                    if (child < 0) {
+                        untried.push_back(move);
+                        continue;
+                    }
+
+                    InfoNode& node = nodes[child];
+                    node.available++;
+                    const double value = node.reward / node.visits +
+                        config.exploration * std::sqrt(std::log(static_cast<double>(node.available)) / node.visits);
+                    if (value > best_value) {
+                        best_value = value;
+                        best = child;
+                    }
+                }
+                return untried.empty() ? best : -1;
+            }
+
+            // Finish the simulated game with the rollout policy
+            void rollout(Match& sim, double* rewards) {
+                for (uint32_t moves = 0; moves < config.max_rollout_moves && !sim.isOver(); moves++) {
+                    sim.moves(options);
+                    if (config.rollout == RolloutPolicy::HEURISTIC) {
+                        sim.apply(HeuristicBot::pick(sim.getGame(), options, config.weights, rng));
+                    }
+                    else {
+                        sim.apply(options[rng() % options.size()]);
+                    }
+                }
+                for (size_t seat = 0; seat < sim.getGame().getPlayerCount(); seat++) {
+                    rewards[seat] = sim.reward(static_cast<uint8_t>(seat));
+                }
+            }
+
+        public:
+            InfoSetSearch(const Match& root, const ObservationTracker& tracker, const MctsConfig& config, uint32_t seed)
+            : config(config), tracker(tracker), root_match(root.getState()), rules(root.getGame().getRules()), max_steps(root.getMaxSteps()), rng(seed) {
+                // Later responders of an open window depend on hidden roles - the samples decide them
+                if (root.inReactionWindow()) {
+                    root_match.window.responder_count = static_cast<uint8_t>(root_match.window.next_responder + 1);
+                }
+                nodes.reserve(1 << 14);
+                nodes.push_back({Move::decline(0), -1, -1, -1, 0, 0, 0.0});
+            }
+
+            void run(bool timed, Clock::time_point deadline, const std::atomic<bool>* stop, InfoRootResult& result) {
+                double rewards[SNAPSHOT_MAX_PLAYERS];
+                uint64_t iteration = 0;
+
+                for (; config.iterations == 0 || iteration < config.iterations; iteration++) {
+                    if ((iteration & 15) == 0 && ((stop && stop->load(std::memory_order_relaxed)) ||
+                                                  (timed && Clock::now() >= deadline))) {
+                        break;
+                    }
+
+                    tracker.determinize(rng, sample);
+                    Match& sim = load();
+
+                    // Selection within the moves of this determinization, then expansion of one untried move
+                    int32_t index = 0;
+                    while (!sim.isOver()) {
+                        sim.moves(options);
+                        const int32_t child = select(index);
+                        if (child < 0) {
+                            index = addChild(index, untried[rng() % untried.size()]);
+                            sim.apply(nodes[index].move);
+                            break;
+                        }
+                        index = child;
+                        sim.apply(nodes[index].move);
+                    }
+
+                    // Simulation and backpropagation
+                    rollout(sim, rewards);
+                    for (int32_t node = index; node > 0; node = nodes[node].parent) {
+                        nodes[node].visits++;
+                        nodes[node].reward += rewards[moverOf(nodes[node].move)];
+                    }
+                    nodes[0].visits++;
+                }
+
+                for (int32_t child = nodes[0].first_child; child >= 0; child = nodes[child].next_sibling) {
+                    result.moves.push_back(nodes[child].move);
+                    result.visits.push_back(nodes[child].visits);
+                    result.reward.push_back(nodes[child].reward);
+                }
+                result.iterations = iteration;
+                result.nodes = nodes.size();
+            }
+        };
+    }
+
+    IsmctsBot::IsmctsBot(uint8_t seat, const MctsConfig& config, const HiddenInfoRules& rules)
+    : seat(seat), config(config), rules(rules), decisions(0) {
+        if (config.iterations == 0 && config.time_budget_ms <= 0) {
+            throw std::invalid_argument("Search needs an iteration or time budget");
+        }
+        if (config.threads == 0) {
+            throw std::invalid_argument("Search needs at least one thread");
+        }
+    }
+
+    IsmctsBot::~IsmctsBot() = default;
+
+    void IsmctsBot::start(const Match& match) {
+        tracker.reset(new ObservationTracker(match.getGame(), seat, rules, match.getState().steps == 0));
+    }
+
+    void IsmctsBot::observe(const Match& match, const Move& move) {
+        if (!tracker) { // Joined mid-game - only public bounds are known
+            tracker.reset(new ObservationTracker(match.getGame(), seat, rules, false));
+            return;
+        }
+        tracker->update(match.getGame(), move);
+    }
+
+    Move IsmctsBot::chooseMove(const Match& match) {
+        return chooseMoveWithin(match, DecisionLimit());
+    }
+
+    Move IsmctsBot::chooseMoveWithin(const Match& match, const DecisionLimit& limit) {
+        const auto start = Clock::now();
+        stats = SearchStats();
+        decisions++;
+
+        if (match.decidingSeat() != seat) {
+            throw std::runtime_error("Not this bot's seat");
+        }
+        if (!tracker) {
+            tracker.reset(new ObservationTracker(match.getGame(), seat, rules, false));
+        }
+
+        std::vector<Move> root_moves;
+        match.moves(root_moves);
+        if (root_moves.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+        if (root_moves.size() == 1) { // Forced move - nothing to search
+            return root_moves[0];
+        }
+
+        // The configured budget, cut short by the caller's hard limit
+        const bool timed = config.time_budget_ms > 0 || limit.deadline != Clock::time_point::max();
+        auto deadline = limit.deadline;
+        if (config.time_budget_ms > 0) {
+            deadline = std::min(deadline, start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(config.time_budget_ms)));
+        }
+
+        // Root parallelism - independent trees over independent determinizations
+        std::vector<InfoRootResult> results(config.threads);
+        std::vector<std::exception_ptr> errors(config.threads);
+        auto search = [&](unsigned thread) {
+            try {
+                InfoSetSearch tree(match, *tracker, config, config.seed + 7919u * thread + 104729u * decisions);
+                tree.run(timed, deadline, limit.stop, results[thread]);
+            }
+            catch (...) {
+                errors[thread] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned thread = 1; thread < config.threads; thread++) {
+            workers.emplace_back(search, thread);
+        }
+        search(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Merge by move - only moves that are legal in the real position can be chosen
+        std::vector<uint64_t> visits(root_moves.size(), 0);
+        std::vector<double> reward(root_moves.size(), 0.0);
+        for (const InfoRootResult& result : results) {
+            for (size_t i = 0; i < result.moves.size(); i++) {
+                for (size_t j = 0; j < root_moves.size(); j++) {
+                    if (root_moves[j] == result.moves[i]) {
+                        visits[j] += result.visits[i];
+                        reward[j] += result.reward[i];
+                        break;
+                    }
+                }
+            }
+            stats.iterations += result.iterations;
+            stats.nodes += result.nodes;
+        }
+
+        // Most visited move, ties broken by average reward
+        size_t best = 0;
+        for (size_t i = 1; i < root_moves.size(); i++) {
+            const double average = visits[i] ? reward[i] / visits[i] : 0.0;
+            const double best_average = visits[best] ? reward[best] / visits[best] : 0.0;
+            if (visits[i] > visits[best] || (visits[i] == visits[best] && average > best_average)) {
+                best = i;
+            }
+        }
+
+        stats.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return root_moves[best];
+    }
+}
@@ -0,0 +1,173 @@
+// Email: razcohenp@gmail.com
+
+// Match.cpp - Implementation of the bot decision sequence
+// Turns the engine's free-form reactive abilities into the arbiter's reaction windows
+
+#include "../../include/bots/Match.hpp"
+#include "../../include/Game.hpp"
+#include "../../include/Player.hpp"
+
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    Match::Match(Game& game, uint32_t max_steps) : game(&game), state(), max_steps(max_steps), arbiter(game) {
+        if (!game.isGameStarted()) {
+            throw std::runtime_error("Game has not started yet");
+        }
+        state.window.trigger = {ActionType::GATHER, 0, NO_TARGET};
+        skipStuckPlayers();
+    }
+
+    Match::Match(Game& game, const MatchState& state, uint32_t max_steps)
+    : game(&game), state(state), max_steps(max_steps), arbiter(game) {}
+
+    uint8_t Match::decidingSeat() const {
+        if (inReactionWindow()) {
+            return state.window.responders[state.window.next_responder];
+        }
+        return static_cast<uint8_t>(game->getCurrentPlayerIndex());
+    }
+
+    bool Match::mayAnswer(uint8_t seat) const {
+        return inReactionWindow() ? ReactionArbiter::isWaitingOn(state.window, seat) : seat == decidingSeat();
+    }
+
+    // A player without legal turn actions (sanctioned, spied on and broke) loses the turn
+    void Match::skipStuckPlayers() {
+        for (size_t skipped = 0; skipped <= game->getPlayerCount() && !isOver(); skipped++) {
+            const uint8_t seat = static_cast<uint8_t>(game->getCurrentPlayerIndex());
+            legalActions(*game, seat, scratch);
+            for (const Action& action : scratch) {
+                if (!isReactiveAction(action.type)) {
+                    return;
+                }
+            }
+            game->nextTurn();
+            state.steps++;
+        }
+    }
+
+    void Match::moves(std::vector<Move>& out) const {
+        out.clear();
+        if (isOver()) {
+            return;
+        }
+
+        const uint8_t seat = decidingSeat();
+        if (inReactionWindow()) {
+            Action reaction;
+            out.push_back(Move::decline(seat));
+            ReactionArbiter::reactionFor(state.window.trigger, seat, reaction);
+            out.push_back(Move::play(reaction));
+            return;
+        }
+
+        // Turn actions only - reactive abilities are offered through the windows
+        legalActions(*game, seat, scratch);
+        for (const Action& action : scratch) {
+            if (!isReactiveAction(action.type)) {
+                out.push_back(Move::play(action));
+            }
+        }
+    }
+
+    void Match::apply(const Move& move) {
+        if (!mayAnswer(move.action.actor)) {
+            throw std::runtime_error("Not your decision");
+        }
+
+        if (inReactionWindow()) {
+            Action reaction;
+            ReactionArbiter::reactionFor(state.window.trigger, move.action.actor, reaction);
+            if (!move.pass && move.action != reaction) {
+                throw std::runtime_error("Only a reaction or a pass is allowed now");
+            }
+            if (arbiter.respond(*game, state.window, move.action.actor, !move.pass)) {
+                skipStuckPlayers();
+            }
+            return;
+        }
+
+        if (move.pass || isReactiveAction(move.action.type)) {
+            throw std::runtime_error("A turn action is required");
+        }
+
+        applyAction(*game, move.action);
+        state.steps++;
+        if (!arbiter.open(*game, state.window, move.action)) {
+            skipStuckPlayers();
+        }
+    }
+
+    void Match::expireWindow() {
+        if (inReactionWindow()) {
+            arbiter.expire(*game, state.window);
+            skipStuckPlayers();
+        }
+    }
+
+    bool Match::isOver() const {
+        return !inReactionWindow() && (isGameOver(*game) || state.steps >= max_steps);
+    }
+
+    int Match::winner() const {
+        if (inReactionWindow() || !isGameOver(*game)) {
+            return -1;
+        }
+
+        for (size_t seat = 0; seat < game->getPlayerCount(); seat++) {
+            if (game->getPlayer(seat)->isActive()) {
+                return static_cast<int>(seat);
+            }
+        }
+        return -1;
+    }
+
+    double Match::reward(uint8_t seat) const {
+        const int won = winner();
+        if (won >= 0) {
+            return won == seat ? 1.0 : 0.0;
+        }
+        if (!game->getPlayer(seat)->isActive()) {
+            return 0.0;
+        }
+        int active = 0;
+        for (size_t other = 0; other < game->getPlayerCount(); other++) {
+            active += game->getPlayer(other)->isActive() ? 1 : 0;
+        }
+        return 1.0 / active;
+    }
+
+    // FNV-1a over every field a replica must agree on; the RNG is left out (only role dealing draws from it)
+    uint64_t Match::stateHash(uint64_t salt) const {
+        GameSnapshot snapshot;
+        game->saveSnapshot(snapshot, false);
+        uint64_t hash = 0xCBF29CE484222325ull;
+        auto add = [&hash](uint64_t value) {
+            for (int byte = 0; byte < 8; byte++) {
+                hash ^= (value >> (8 * byte)) & 0xFF;
+                hash *= 0x100000001B3ull;
+            }
+        };
+        if (salt != 0) { // Unsalted hashes stay what replicas already exchange
+            add(salt);
+        }
+        add(snapshot.header.player_count | (snapshot.header.current_player_index << 8) |
+            (snapshot.header.last_arrested << 16) | (static_cast<uint64_t>(state.steps) << 32));
+        for (uint8_t seat = 0; seat < snapshot.header.player_count; seat++) {
+            const PlayerRecord& record = snapshot.players[seat];
+            add(static_cast<uint32_t>(record.coins) | (static_cast<uint64_t>(record.flags) << 32) |
+                (static_cast<uint64_t>(record.couped_by) << 40) | (static_cast<uint64_t>(record.role) << 48));
+        }
+        if (inReactionWindow()) {
+            const ReactionWindow& window = state.window;
+            add(static_cast<uint64_t>(window.trigger.type) | (window.trigger.actor << 8) | (window.trigger.target << 16) |
+                (static_cast<uint64_t>(window.next_responder) << 24) | (static_cast<uint64_t>(window.responder_count) << 32) |
+                (static_cast<uint64_t>(window.answered) << 40) | (static_cast<uint64_t>(window.reacted) << 48));
+            for (uint8_t i = 0; i < window.responder_count; i++) {
+                add(window.responders[i]);
+            }
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,249 @@
+// Email: razcohenp@gmail.com
+
+// MctsBot.cpp - UCT search with root parallelism
+// Each thread owns a game clone, a tree of decision nodes and its own random generator
+
+#include "../../include/bots/MctsBot.hpp"
+#include "../../include/GameClone.hpp"
+
+#include <algorithm> // For std::min
+#include <atomic> // For the stop flag
+#include <chrono> // For the time budget
+#include <cmath> // For the UCT formula
+#include <exception> // For passing thread failures to the caller
+#include <stdexcept> // For exception handling
+#include <thread> // For root parallelism
+
+namespace coup {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // One decision node - children of a node are stored contiguously
+        struct Node {
+            Move move; // Move that leads to this node
+            int32_t parent; // Parent index, -1 for the root
+            int32_t first_child; // Index of the first child
+            uint16_t child_count; // Number of children
+            bool expanded; // Children have been created
+            uint8_t mover; // Seat that chose the move (rewards are counted for this seat)
+            uint32_t visits; // Simulations through this node
+            double reward; // Sum of the mover's rewards
+        };
+
+        // Root statistics of one tree
+        struct RootResult {
+            std::vector<uint32_t> visits; // Visits per root move
+            std::vector<double> reward; // Reward sum per root move
+            uint64_t iterations = 0; // Simulations run
+            uint64_t nodes = 0; // Tree size
+        };
+
+        // Tree of one search thread
+        class TreeSearch {
+        private:
+            const MctsConfig& config; // Search settings
+            GameClone clone; // Private copy of the game
+            Match sim; // Decision sequence on the clone
+            GameSnapshot root_state; // Game state of the decision
+            MatchState root_match; // Match bookkeeping of the decision
+            std::vector<Node> nodes; // Tree storage, node 0 is the root
+            std::vector<Move> options; // Reused move buffer
+            std::mt19937 rng; // Expansion and rollout randomness
+
+            // Create the children of a node from the moves of the current simulated position
+            void expand(int32_t index) {
+                sim.moves(options);
+                const uint8_t mover = sim.decidingSeat();
+                const int32_t first = static_cast<int32_t>(nodes.size());
+                for (const Move& move : options) {
+                    nodes.push_back({move, index, -1, 0, false, mover, 0, 0.0});
+                }
+                nodes[index].first_child = first;
+                nodes[index].child_count = static_cast<uint16_t>(options.size());
+                nodes[index].expanded = true;
+            }
+
+            // UCT child selection, unvisited children first
+            int32_t select(int32_t index) const {
+                const Node& parent = nodes[index];
+                const double log_visits = std::log(static_cast<double>(parent.visits > 0 ? parent.visits : 1));
+                int32_t best = parent.first_child;
+                double best_value = -1.0;
+
+                for (int32_t child = parent.first_child; child < parent.first_child + parent.child_count; child++) {
+                    const Node& node = nodes[child];
+                    if (node.visits == 0) {
+                        return child;
+                    }
+                    double value = node.reward / node.visits + config.exploration * std::sqrt(log_visits / node.visits);
+                    if (value > best_value) {
+                        best_value = value;
+                        best = child;
+                    }
+                }
+                return best;
+            }
+
+            // Finish the simulated game with the rollout policy
+            void rollout(double* rewards) {
+                for (uint32_t moves = 0; moves < config.max_rollout_moves && !sim.isOver(); moves++) {
+                    sim.moves(options);
+                    if (config.rollout == RolloutPolicy::HEURISTIC) {
+                        sim.apply(HeuristicBot::pick(sim.getGame(), options, config.weights, rng));
+                    }
+                    else {
+                        sim.apply(options[rng() % options.size()]);
+                    }
+                }
+                for (size_t seat = 0; seat < sim.getGame().getPlayerCount(); seat++) {
+                    rewards[seat] = sim.reward(static_cast<uint8_t>(seat));
+                }
+            }
+
+        public:
+            TreeSearch(const Match& root, const MctsConfig& config, uint32_t seed)
+            : config(config), clone(root.getGame()), sim(clone.game(), root.getState(), root.getMaxSteps()),
+            root_match(root.getState()), rng(seed) {
+                root.getGame().saveSnapshot(root_state, false);
+                nodes.reserve(1 << 14);
+                nodes.push_back({Move::decline(0), -1, -1, 0, false, 0, 0, 0.0});
+                expand(0);
+            }
+
+            void run(bool timed, Clock::time_point deadline, const std::atomic<bool>* stop, RootResult& result) {
+                double rewards[SNAPSHOT_MAX_PLAYERS];
+                uint64_t iteration = 0;
+
+                for (; config.iterations == 0 || iteration < config.iterations; iteration++) {
+                    if ((iteration & 15) == 0 && ((stop && stop->load(std::memory_order_relaxed)) ||
+                                                  (timed && Clock::now() >= deadline))) {
+                        break;
+                    }
+
+                    clone.load(root_state);
+                    sim.reset(root_match);
+
+                    // Selection
+                    int32_t index = 0;
+                    while (nodes[index].expanded && nodes[index].child_count > 0) {
+                        index = select(index);
+                        sim.apply(nodes[index].move);
+                    }
+
+                    // Expansion of a leaf seen before
+                    if (!nodes[index].expanded && nodes[index].visits > 0 && !sim.isOver()) {
+                        expand(index);
+                        if (nodes[index].child_count > 0) {
+                            index = nodes[index].first_child + static_cast<int32_t>(rng() % nodes[index].child_count);
+                            sim.apply(nodes[index].move);
+                        }
+                    }
+
+                    // Simulation and backpropagation
+                    rollout(rewards);
+                    for (int32_t node = index; node >= 0; node = nodes[node].parent) {
+                        nodes[node].visits++;
+                        nodes[node].reward += rewards[nodes[node].mover];
+                    }
+                }
+
+                const Node& root = nodes[0];
+                result.visits.assign(root.child_count, 0);
+                result.reward.assign(root.child_count, 0.0);
+                for (uint16_t i = 0; i < root.child_count; i++) {
+                    result.visits[i] = nodes[root.first_child + i].visits;
+                    result.reward[i] = nodes[root.first_child + i].reward;
+                }
+                result.iterations = iteration;
+                result.nodes = nodes.size();
+            }
+        };
+    }
+
+    MctsBot::MctsBot(const MctsConfig& config) : config(config), decisions(0) {
+        if (config.iterations == 0 && config.time_budget_ms <= 0) {
+            throw std::invalid_argument("Search needs an iteration or time budget");
+        }
+        if (config.threads == 0) {
+            throw std::invalid_argument("Search needs at least one thread");
+        }
+    }
+
+    Move MctsBot::chooseMove(const Match& match) {
+        return chooseMoveWithin(match, DecisionLimit());
+    }
+
+    Move MctsBot::chooseMoveWithin(const Match& match, const DecisionLimit& limit) {
+        const auto start = Clock::now();
+        stats = SearchStats();
+        decisions++;
+
+        std::vector<Move> root_moves;
+        match.moves(root_moves);
+        if (root_moves.empty()) {
+            throw std::runtime_error("No moves available");
+        }
+        if (root_moves.size() == 1) { // Forced move - nothing to search
+            return root_moves[0];
+        }
+
+        // The configured budget, cut short by the caller's hard limit
+        const bool timed = config.time_budget_ms > 0 || limit.deadline != Clock::time_point::max();
+        auto deadline = limit.deadline;
+        if (config.time_budget_ms > 0) {
+            deadline = std::min(deadline, start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(config.time_budget_ms)));
+        }
+
+        // Root parallelism - independent trees, merged by visit counts
+        std::vector<RootResult> results(config.threads);
+        std::vector<std::exception_ptr> errors(config.threads);
+        auto search = [&](unsigned thread) {
+            try {
+                TreeSearch tree(match, config, config.seed + 7919u * thread + 104729u * decisions);
+                tree.run(timed, deadline, limit.stop, results[thread]);
+            }
+            catch (...) {
+                errors[thread] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned thread = 1; thread < config.threads; thread++) {
+            workers.emplace_back(search, thread);
+        }
+        search(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<uint64_t> visits(root_moves.size(), 0);
+        std::vector<double> reward(root_moves.size(), 0.0);
+        for (const RootResult& result : results) {
+            for (size_t i = 0; i < result.visits.size() && i < root_moves.size(); i++) {
+                visits[i] += result.visits[i];
+                reward[i] += result.reward[i];
+            }
+            stats.iterations += result.iterations;
+            stats.nodes += result.nodes;
+        }
+
+        // Most visited move, ties broken by average reward
+        size_t best = 0;
+        for (size_t i = 1; i < root_moves.size(); i++) {
+            const double average = visits[i] ? reward[i] / visits[i] : 0.0;
+            const double best_average = visits[best] ? reward[best] / visits[best] : 0.0;
+            if (visits[i] > visits[best] || (visits[i] == visits[best] && average > best_average)) {
+                best = i;
+            }
+        }
+
+        stats.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return root_moves[best];
+    }
+}
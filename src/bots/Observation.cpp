@@ -0,0 +1,221 @@
+// Email: razcohenp@gmail.com
+
+// Observation.cpp - Knowledge tracking and determinization under hidden information
+// Coin bounds follow the rules of every public action; roles are revealed by their abilities
+
+#include "../../include/bots/Observation.hpp"
+#include "../../include/Game.hpp"
+#include "../../include/Player.hpp"
+
+#include <algorithm> // For std::min and std::max
+#include <cstring> // For copying names
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    namespace {
+        constexpr int MAX_COINS = 30; // Upper bound used when nothing is known about a seat
+    }
+
+    ObservationTracker::ObservationTracker(const Game& game, uint8_t observer, const HiddenInfoRules& rules, bool from_start)
+    : rules(rules), current() {
+        if (observer >= game.getPlayerCount()) {
+            throw std::invalid_argument("Invalid observer seat");
+        }
+
+        current.observer = observer;
+        current.player_count = static_cast<uint8_t>(game.getPlayerCount());
+        for (uint8_t seat = 0; seat < current.player_count; seat++) {
+            SeatObservation& known = current.seats[seat];
+            known.role = ROLE_UNKNOWN;
+            known.coins_low = 0;
+            known.coins_high = from_start ? 0 : MAX_COINS;
+        }
+        syncPublic(game);
+    }
+
+    // Copy what everyone can see, plus the observer's own seat
+    void ObservationTracker::syncPublic(const Game& game) {
+        GameSnapshot snapshot;
+        game.saveSnapshot(snapshot, false);
+
+        current.current_player_index = snapshot.header.current_player_index;
+        current.last_arrested = snapshot.header.last_arrested;
+        for (uint8_t seat = 0; seat < current.player_count; seat++) {
+            const PlayerRecord& record = snapshot.players[seat];
+            SeatObservation& known = current.seats[seat];
+
+            std::memcpy(known.name, record.name, SNAPSHOT_NAME_SIZE);
+            known.flags = record.flags;
+            known.couped_by = record.couped_by;
+
+            const bool own = seat == current.observer;
+            if (own || !rules.hidden_roles) {
+                known.role = record.role;
+            }
+            if (own || !rules.hidden_coins) {
+                known.coins_low = known.coins_high = static_cast<int16_t>(record.coins);
+            }
+        }
+    }
+
+    void ObservationTracker::addCoins(uint8_t seat, int low, int high) {
+        SeatObservation& known = current.seats[seat];
+        known.coins_low = static_cast<int16_t>(std::max(0, known.coins_low + low));
+        known.coins_high = static_cast<int16_t>(std::max<int>(known.coins_low, known.coins_high + high));
+    }
+
+    // An action that costs coins proves the seat had at least that many
+    void ObservationTracker::requireCoins(uint8_t seat, int minimum) {
+        SeatObservation& known = current.seats[seat];
+        known.coins_low = static_cast<int16_t>(std::max<int>(known.coins_low, minimum));
+        known.coins_high = std::max(known.coins_high, known.coins_low);
+    }
+
+    // Any turn action except coup proves the seat was below the mandatory coup threshold
+    void ObservationTracker::capCoins(uint8_t seat, int maximum) {
+        SeatObservation& known = current.seats[seat];
+        known.coins_high = static_cast<int16_t>(std::min<int>(known.coins_high, maximum));
+        known.coins_low = std::min(known.coins_low, known.coins_high);
+    }
+
+    void ObservationTracker::revealRole(uint8_t seat, RoleType role) {
+        current.seats[seat].role = static_cast<uint8_t>(role);
+    }
+
+    bool ObservationTracker::roleIs(uint8_t seat, RoleType role) const {
+        return current.seats[seat].role == static_cast<uint8_t>(role);
+    }
+
+    bool ObservationTracker::roleMayBe(uint8_t seat, RoleType role) const {
+        return current.seats[seat].role == ROLE_UNKNOWN || roleIs(seat, role);
+    }
+
+    void ObservationTracker::update(const Game& game, const Move& move) {
+        const uint8_t previous_current = current.current_player_index;
+        const uint8_t a = move.action.actor;
+        const uint8_t t = move.action.target;
+        bool revealed_target = false;
+        const GameRules& game_rules = game.getRules();
+
+        if (!move.pass && a < current.player_count) {
+            const ActionType type = move.action.type;
+            const bool has_target = actionHasTarget(type) && t < current.player_count;
+
+            // Economic and targeting actions are illegal at 10+ coins unless bribed
+            if (type != ActionType::COUP && !isReactiveAction(type) && type != ActionType::SPY_ON &&
+                (current.seats[a].flags & FLAG_BRIBE_USED) == 0) {
+                capCoins(a, 9);
+            }
+
+            switch (type) {
+                case ActionType::GATHER:
+                    addCoins(a, 1, 1);
+                    break;
+                case ActionType::TAX:
+                    if (roleIs(a, RoleType::GOVERNOR)) addCoins(a, 2 + game_rules.tax_bonus, 2 + game_rules.tax_bonus);
+                    else if (roleMayBe(a, RoleType::GOVERNOR)) addCoins(a, 2, 2 + game_rules.tax_bonus);
+                    else addCoins(a, 2, 2);
+                    break;
+                case ActionType::BRIBE:
+                    requireCoins(a, 4);
+                    addCoins(a, -4, -4);
+                    break;
+                case ActionType::ARREST:
+                    if (!has_target || roleIs(t, RoleType::GENERAL) || current.seats[t].coins_high == 0) {
+                        break; // Generals and empty purses lose nothing
+                    }
+                    if (current.seats[t].coins_low >= 1 && !roleMayBe(t, RoleType::GENERAL)) {
+                        addCoins(t, -1, -1);
+                        addCoins(a, 1, 1);
+                    }
+                    else {
+                        addCoins(t, -1, 0);
+                        addCoins(a, 0, 1);
+                    }
+                    break;
+                case ActionType::SANCTION: {
+                    if (!has_target) break;
+                    const int high = roleMayBe(t, RoleType::JUDGE) ? 3 + game_rules.judge_surcharge : 3; // Judge fee
+                    const int low = roleIs(t, RoleType::JUDGE) ? 3 + game_rules.judge_surcharge : 3;
+                    requireCoins(a, low);
+                    addCoins(a, -high, -low);
+                    if (roleIs(t, RoleType::BARON)) addCoins(t, 1, 1); // Baron compensation
+                    else if (roleMayBe(t, RoleType::BARON)) addCoins(t, 0, 1);
+                    break;
+                }
+                case ActionType::COUP:
+                    requireCoins(a, game_rules.coup_cost);
+                    addCoins(a, -game_rules.coup_cost, -game_rules.coup_cost);
+                    break;
+                case ActionType::INVEST:
+                    revealRole(a, RoleType::BARON);
+                    requireCoins(a, 3);
+                    addCoins(a, game_rules.invest_payout - 3, game_rules.invest_payout - 3);
+                    break;
+                case ActionType::SPY_ON:
+                    revealRole(a, RoleType::SPY);
+                    revealed_target = has_target && a == current.observer; // Only the Spy sees the coins
+                    break;
+                case ActionType::BLOCK_COUP:
+                    revealRole(a, RoleType::GENERAL);
+                    requireCoins(a, game_rules.block_coup_cost);
+                    addCoins(a, -game_rules.block_coup_cost, -game_rules.block_coup_cost);
+                    break;
+                case ActionType::BLOCK_BRIBE:
+                    revealRole(a, RoleType::JUDGE);
+                    break;
+                case ActionType::UNDO:
+                    revealRole(a, RoleType::GOVERNOR);
+                    if (has_target) {
+                        requireCoins(t, 2);
+                        addCoins(t, -2, -2);
+                    }
+                    break;
+            }
+        }
+
+        syncPublic(game);
+
+        if (revealed_target) {
+            const int16_t coins = static_cast<int16_t>(game.getPlayer(t)->coins());
+            current.seats[t].coins_low = current.seats[t].coins_high = coins;
+        }
+
+        // A Merchant starting its turn with enough coins (3 by default) collects a bonus coin
+        const uint8_t seat = current.current_player_index;
+        if (seat != previous_current && seat != current.observer && rules.hidden_coins && roleMayBe(seat, RoleType::MERCHANT)) {
+            SeatObservation& known = current.seats[seat];
+            if (roleIs(seat, RoleType::MERCHANT) && known.coins_low >= game_rules.merchant_threshold) {
+                addCoins(seat, 1, 1);
+            }
+            else if (known.coins_high >= game_rules.merchant_threshold) {
+                addCoins(seat, 0, 1);
+            }
+        }
+    }
+
+    void ObservationTracker::determinize(std::mt19937& rng, GameSnapshot& out) const {
+        out.header.magic = SNAPSHOT_MAGIC;
+        out.header.version = SNAPSHOT_VERSION;
+        out.header.header_size = sizeof(SnapshotHeader);
+        out.header.total_size = sizeof(GameSnapshot);
+        out.header.rng_size = 0;
+        out.header.player_count = current.player_count;
+        out.header.game_started = 1;
+        out.header.current_player_index = current.current_player_index;
+        out.header.last_arrested = current.last_arrested;
+
+        for (uint8_t seat = 0; seat < current.player_count; seat++) {
+            const SeatObservation& known = current.seats[seat];
+            PlayerRecord& record = out.players[seat];
+
+            std::memcpy(record.name, known.name, SNAPSHOT_NAME_SIZE);
+            record.role = known.role != ROLE_UNKNOWN ? known.role
+                : static_cast<uint8_t>(rng() % static_cast<uint8_t>(RoleType::PLAYER)); // One of the six roles
+            record.flags = known.flags;
+            record.couped_by = known.couped_by;
+            record.coins = known.coins_low + static_cast<int32_t>(rng() % (known.coins_high - known.coins_low + 1));
+            std::memset(record.reserved, 0, sizeof(record.reserved));
+        }
+    }
+}
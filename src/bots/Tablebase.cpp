@@ -0,0 +1,566 @@
+// Email: razcohenp@gmail.com
+
+// Tablebase.cpp - Enumeration, retrograde solving and mmap lookup of endgame tables
+// Positions are packed into 51-bit keys; moves are generated by the Match on per-thread clones
+
+#include "../../include/bots/Tablebase.hpp"
+#include "../../include/GameClone.hpp"
+
+#include <chrono> // For build timing
+#include <cstring> // For names and header checks
+#include <deque> // For the retrograde queue
+#include <exception> // For passing thread failures to the caller
+#include <fstream> // For writing the table file
+#include <limits> // For the open step cap
+#include <memory> // For per-thread expanders
+#include <stdexcept> // For exception handling
+#include <thread> // For parallel enumeration and solving
+#include <unordered_map> // For position indexing during the build
+
+#include <fcntl.h> // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h> // For close
+
+namespace coup {
+    namespace {
+        // Key layout: 12 bits per seat (coins 4, flags 5, couped_by 2), then the turn and the window
+        constexpr int SEAT_BITS = 12;
+        constexpr int CURRENT_SHIFT = 36;
+        constexpr int ARRESTED_SHIFT = 38;
+        constexpr int TRIGGER_SHIFT = 40;
+        constexpr int ACTOR_SHIFT = 42;
+        constexpr int TARGET_SHIFT = 44;
+        constexpr int RESPONDERS_SHIFT = 46;
+        constexpr int NEXT_SHIFT = 49;
+        constexpr uint64_t NO_SEAT_CODE = 3; // Empty seat reference in 2 bits
+        constexpr uint64_t OCCUPIED = 1ull << 63; // Marks used hash slots (keys never use bit 63)
+        constexpr uint32_t OUTSIDE = std::numeric_limits<uint32_t>::max(); // Successor outside the table
+
+        constexpr int8_t OUTCOME_OPEN = -2; // Decision position
+        constexpr int8_t OUTCOME_STUCK = -1; // No moves - the cap ends the match as a draw
+
+        uint64_t seatCode(uint8_t seat) {
+            return seat == SNAPSHOT_NO_SEAT || seat == NO_TARGET ? NO_SEAT_CODE : seat;
+        }
+
+        uint8_t seatFromCode(uint64_t code, uint8_t none) {
+            return code == NO_SEAT_CODE ? none : static_cast<uint8_t>(code);
+        }
+
+        uint64_t hashKey(uint64_t key) {
+            const uint64_t mixed = key * 0x9E3779B97F4A7C15ull;
+            return mixed ^ (mixed >> 32); // Fold the well-mixed high bits into the slot bits
+        }
+
+        // Info word: 10 bits per focal seat - 2 bits of value and 8 bits of depth
+        uint32_t packInfo(uint8_t focal, TablebaseValue value, uint16_t depth) {
+            const uint32_t bits = static_cast<uint32_t>(value) | (static_cast<uint32_t>(depth > 255 ? 255 : depth) << 2);
+            return bits << (10 * focal);
+        }
+
+        bool packSnapshot(const GameSnapshot& snapshot, const MatchState& state, bool in_window,
+                          uint8_t coin_cap, uint64_t& key) {
+            const uint8_t count = snapshot.header.player_count;
+            if (count < 2 || count > TABLEBASE_MAX_PLAYERS) {
+                return false;
+            }
+
+            key = 0;
+            for (uint8_t seat = 0; seat < count; seat++) {
+                const PlayerRecord& record = snapshot.players[seat];
+                if (record.coins < 0 || record.coins > coin_cap) {
+                    return false;
+                }
+                const uint64_t bits = static_cast<uint64_t>(record.coins) | (static_cast<uint64_t>(record.flags & 0x1F) << 4) |
+                                      (seatCode(record.couped_by) << 9);
+                key |= bits << (SEAT_BITS * seat);
+            }
+            key |= static_cast<uint64_t>(snapshot.header.current_player_index) << CURRENT_SHIFT;
+            key |= seatCode(snapshot.header.last_arrested) << ARRESTED_SHIFT;
+
+            if (in_window) {
+                uint64_t trigger;
+                switch (state.window.trigger.type) {
+                    case ActionType::TAX: trigger = 1; break;
+                    case ActionType::BRIBE: trigger = 2; break;
+                    case ActionType::COUP: trigger = 3; break;
+                    default: return false;
+                }
+                uint64_t responders = 0;
+                for (uint8_t i = 0; i < state.window.responder_count; i++) {
+                    responders |= 1ull << state.window.responders[i];
+                }
+                key |= trigger << TRIGGER_SHIFT;
+                key |= static_cast<uint64_t>(state.window.trigger.actor) << ACTOR_SHIFT;
+                key |= seatCode(state.window.trigger.target) << TARGET_SHIFT;
+                key |= responders << RESPONDERS_SHIFT;
+                key |= static_cast<uint64_t>(state.window.next_responder) << NEXT_SHIFT;
+            }
+            return true;
+        }
+
+        // Writes the position of a key into a snapshot that already holds the names and roles
+        void unpackKey(uint64_t key, GameSnapshot& snapshot, MatchState& state) {
+            const uint8_t count = snapshot.header.player_count;
+            for (uint8_t seat = 0; seat < count; seat++) {
+                const uint64_t bits = key >> (SEAT_BITS * seat);
+                PlayerRecord& record = snapshot.players[seat];
+                record.coins = static_cast<int32_t>(bits & 0xF);
+                record.flags = static_cast<uint8_t>((bits >> 4) & 0x1F);
+                record.couped_by = seatFromCode((bits >> 9) & 3, SNAPSHOT_NO_SEAT);
+            }
+            snapshot.header.current_player_index = static_cast<uint8_t>((key >> CURRENT_SHIFT) & 3);
+            snapshot.header.last_arrested = seatFromCode((key >> ARRESTED_SHIFT) & 3, SNAPSHOT_NO_SEAT);
+
+            state = MatchState();
+            state.window.trigger = {ActionType::GATHER, 0, NO_TARGET};
+            const uint64_t trigger = (key >> TRIGGER_SHIFT) & 3;
+            if (trigger == 0) {
+                return;
+            }
+
+            const ActionType types[] = {ActionType::GATHER, ActionType::TAX, ActionType::BRIBE, ActionType::COUP};
+            state.window.trigger.type = types[trigger];
+            state.window.trigger.actor = static_cast<uint8_t>((key >> ACTOR_SHIFT) & 3);
+            state.window.trigger.target = seatFromCode((key >> TARGET_SHIFT) & 3, NO_TARGET);
+
+            // Responders are asked in seat order starting after the actor, as in ReactionArbiter::open
+            const uint64_t responders = (key >> RESPONDERS_SHIFT) & 7;
+            for (uint8_t offset = 1; offset < count; offset++) {
+                const uint8_t seat = static_cast<uint8_t>((state.window.trigger.actor + offset) % count);
+                if (responders & (1ull << seat)) {
+                    state.window.responders[state.window.responder_count++] = seat;
+                }
+            }
+            state.window.next_responder = static_cast<uint8_t>((key >> NEXT_SHIFT) & 3);
+        }
+
+        // Moves of one position
+        struct Expansion {
+            std::vector<uint64_t> successors; // Packed successor keys, OCCUPIED marks a move leaving the table
+            int8_t outcome; // Winner seat, OUTCOME_OPEN or OUTCOME_STUCK
+            uint8_t decider; // Deciding seat of an open position
+        };
+
+        // Generates moves on a private clone (one per thread)
+        class Expander {
+        private:
+            GameSnapshot position; // Names and roles of the table, state of the current key
+            GameClone clone; // Private game
+            Match sim; // Decision sequence on the clone
+            std::vector<Move> options; // Reused move buffer
+            uint8_t coin_cap; // Table coin cap
+
+        public:
+            Expander(const GameSnapshot& base, uint8_t coin_cap)
+            : position(base), clone(base), sim(clone.game(), MatchState(), std::numeric_limits<uint32_t>::max()),
+            coin_cap(coin_cap) {}
+
+            void expand(uint64_t key, Expansion& out) {
+                MatchState state;
+                unpackKey(key, position, state);
+                clone.load(position);
+                sim.reset(state);
+
+                out.successors.clear();
+                out.decider = 0;
+                if (sim.isOver()) {
+                    out.outcome = static_cast<int8_t>(sim.winner());
+                    return;
+                }
+
+                sim.moves(options);
+                out.outcome = options.empty() ? OUTCOME_STUCK : OUTCOME_OPEN;
+                out.decider = sim.decidingSeat();
+
+                GameSnapshot next;
+                for (const Move& move : options) {
+                    clone.load(position);
+                    sim.reset(state);
+                    sim.apply(move);
+
+                    uint64_t successor;
+                    clone.game().saveSnapshot(next, false);
+                    const bool inside = packSnapshot(next, sim.getState(), sim.inReactionWindow(), coin_cap, successor);
+                    out.successors.push_back(inside ? successor : OCCUPIED);
+                }
+            }
+        };
+
+        // Runs job(thread) on threads workers and rethrows the first failure
+        template <typename Job>
+        void runParallel(unsigned threads, Job job) {
+            std::vector<std::exception_ptr> errors(threads);
+            auto guarded = [&](unsigned thread) {
+                try {
+                    job(thread);
+                }
+                catch (...) {
+                    errors[thread] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned thread = 1; thread < threads; thread++) {
+                workers.emplace_back(guarded, thread);
+            }
+            guarded(0);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        // Position graph of a table in CSR form
+        struct PositionGraph {
+            std::vector<uint64_t> keys; // Key of every position
+            std::vector<int8_t> outcomes; // Winner seat, OUTCOME_OPEN or OUTCOME_STUCK
+            std::vector<uint8_t> deciders; // Deciding seat
+            std::vector<uint64_t> offsets; // Successor range of every position
+            std::vector<uint32_t> successors; // Successor indices, OUTSIDE for moves leaving the table
+        };
+
+        // Breadth-first enumeration from every fresh turn, one frontier at a time
+        void enumerate(const TablebaseConfig& config, const GameSnapshot& base, PositionGraph& graph) {
+            const uint8_t count = base.header.player_count;
+            std::unordered_map<uint64_t, uint32_t> index;
+            auto intern = [&](uint64_t key) {
+                auto found = index.find(key);
+                if (found != index.end()) {
+                    return found->second;
+                }
+                const uint32_t id = static_cast<uint32_t>(graph.keys.size());
+                index.emplace(key, id);
+                graph.keys.push_back(key);
+                return id;
+            };
+
+            // Seeds - every coin split with every seat to move and no pending effects
+            GameSnapshot seed = base;
+            uint32_t combos = 1;
+            for (uint8_t seat = 0; seat < count; seat++) {
+                combos *= config.coin_cap + 1u;
+            }
+            for (uint8_t current = 0; current < count; current++) {
+                for (uint32_t combo = 0; combo < combos; combo++) {
+                    uint32_t rest = combo;
+                    for (uint8_t seat = 0; seat < count; seat++) {
+                        seed.players[seat].coins = static_cast<int32_t>(rest % (config.coin_cap + 1u));
+                        seed.players[seat].flags = FLAG_ACTIVE | FLAG_ARREST_AVAILABLE;
+                        seed.players[seat].couped_by = SNAPSHOT_NO_SEAT;
+                        rest /= config.coin_cap + 1u;
+                    }
+                    seed.header.current_player_index = current;
+                    seed.header.last_arrested = SNAPSHOT_NO_SEAT;
+
+                    uint64_t key;
+                    packSnapshot(seed, MatchState(), false, config.coin_cap, key);
+                    intern(key);
+                }
+            }
+
+            std::vector<std::unique_ptr<Expander>> expanders;
+            for (unsigned thread = 0; thread < config.threads; thread++) {
+                expanders.emplace_back(new Expander(base, config.coin_cap));
+            }
+
+            std::vector<Expansion> frontier;
+            graph.offsets.push_back(0);
+            for (size_t begin = 0; begin < graph.keys.size();) {
+                const size_t end = graph.keys.size();
+                frontier.resize(end - begin);
+                runParallel(config.threads, [&](unsigned thread) {
+                    for (size_t i = begin + thread; i < end; i += config.threads) {
+                        expanders[thread]->expand(graph.keys[i], frontier[i - begin]);
+                    }
+                });
+
+                // Serial merge keeps the indices deterministic for any thread count
+                for (size_t i = begin; i < end; i++) {
+                    const Expansion& expansion = frontier[i - begin];
+                    graph.outcomes.push_back(expansion.outcome);
+                    graph.deciders.push_back(expansion.decider);
+                    for (uint64_t successor : expansion.successors) {
+                        graph.successors.push_back(successor == OCCUPIED ? OUTSIDE : intern(successor));
+                    }
+                    graph.offsets.push_back(graph.successors.size());
+                }
+                begin = end;
+            }
+        }
+
+        // Counting retrograde analysis for one focal seat (the other seats cooperate against it)
+        void solveFocal(const PositionGraph& graph, const std::vector<uint64_t>& pred_offsets,
+                        const std::vector<uint32_t>& predecessors, uint8_t focal,
+                        std::vector<uint8_t>& values, std::vector<uint16_t>& depths) {
+            const size_t positions = graph.keys.size();
+            std::vector<uint32_t> remaining(positions);
+            std::deque<uint32_t> queue;
+            values.assign(positions, static_cast<uint8_t>(TablebaseValue::DRAW));
+            depths.assign(positions, 0);
+
+            for (uint32_t p = 0; p < positions; p++) {
+                remaining[p] = static_cast<uint32_t>(graph.offsets[p + 1] - graph.offsets[p]);
+                if (graph.outcomes[p] >= 0) {
+                    values[p] = static_cast<uint8_t>(graph.outcomes[p] == focal ? TablebaseValue::WIN : TablebaseValue::LOSS);
+                    queue.push_back(p);
+                }
+            }
+
+            const uint8_t draw = static_cast<uint8_t>(TablebaseValue::DRAW);
+            while (!queue.empty()) {
+                const uint32_t child = queue.front();
+                queue.pop_front();
+                const bool child_wins = values[child] == static_cast<uint8_t>(TablebaseValue::WIN);
+
+                for (uint64_t i = pred_offsets[child]; i < pred_offsets[child + 1]; i++) {
+                    const uint32_t parent = predecessors[i];
+                    if (values[parent] != draw) {
+                        continue;
+                    }
+
+                    // The decider takes a good child at once and accepts a bad one only when nothing else is left
+                    const bool good = (graph.deciders[parent] == focal) == child_wins;
+                    if (good || --remaining[parent] == 0) {
+                        values[parent] = values[child];
+                        depths[parent] = static_cast<uint16_t>(depths[child] + 1);
+                        queue.push_back(parent);
+                    }
+                }
+            }
+            // An open position with a move leaving the table is left unresolved only for lack of that move's
+            // value, so it is unknown rather than a draw, and so is every unresolved position that can reach it
+            const uint8_t unknown = static_cast<uint8_t>(TablebaseValue::UNKNOWN);
+            for (uint32_t p = 0; p < positions; p++) {
+                if (values[p] != draw) {
+                    continue;
+                }
+                for (uint64_t i = graph.offsets[p]; i < graph.offsets[p + 1]; i++) {
+                    if (graph.successors[i] == OUTSIDE) {
+                        values[p] = unknown;
+                        queue.push_back(p);
+                        break;
+                    }
+                }
+            }
+            while (!queue.empty()) {
+                const uint32_t child = queue.front();
+                queue.pop_front();
+                for (uint64_t i = pred_offsets[child]; i < pred_offsets[child + 1]; i++) {
+                    const uint32_t parent = predecessors[i];
+                    if (values[parent] == draw) {
+                        values[parent] = unknown;
+                        queue.push_back(parent);
+                    }
+                }
+            }
+        }
+
+        size_t tableCapacity(size_t entries) {
+            size_t capacity = 16;
+            while (capacity < entries * 2) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+    }
+
+    bool packTablePosition(const Match& match, uint8_t coin_cap, uint64_t& key) {
+        GameSnapshot snapshot;
+        match.getGame().saveSnapshot(snapshot, false);
+        return packSnapshot(snapshot, match.getState(), match.inReactionWindow(), coin_cap, key);
+    }
+
+    TablebaseStats buildTablebase(const TablebaseConfig& config, const std::string& path) {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t count = config.roles.size();
+        if (count < 2 || count > TABLEBASE_MAX_PLAYERS) {
+            throw std::invalid_argument("Tablebases support 2 or 3 players");
+        }
+        if (config.coin_cap > TABLEBASE_MAX_COINS) {
+            throw std::invalid_argument("Coin cap is too large for the table layout");
+        }
+        if (config.threads == 0) {
+            throw std::invalid_argument("Build needs at least one thread");
+        }
+
+        // Names and roles of the table seats
+        GameSnapshot base;
+        std::memset(&base, 0, sizeof(base));
+        base.header.magic = SNAPSHOT_MAGIC;
+        base.header.version = SNAPSHOT_VERSION;
+        base.header.header_size = sizeof(SnapshotHeader);
+        base.header.total_size = sizeof(GameSnapshot);
+        base.header.player_count = static_cast<uint8_t>(count);
+        base.header.game_started = 1;
+        base.header.last_arrested = SNAPSHOT_NO_SEAT;
+        for (size_t seat = 0; seat < count; seat++) {
+            base.players[seat].name[0] = 'P';
+            base.players[seat].name[1] = static_cast<char>('1' + seat);
+            base.players[seat].role = static_cast<uint8_t>(config.roles[seat]);
+            base.players[seat].flags = FLAG_ACTIVE | FLAG_ARREST_AVAILABLE;
+            base.players[seat].couped_by = SNAPSHOT_NO_SEAT;
+        }
+
+        PositionGraph graph;
+        enumerate(config, base, graph);
+        const size_t positions = graph.keys.size();
+
+        // Reverse edges for the retrograde pass
+        std::vector<uint64_t> pred_offsets(positions + 1, 0);
+        for (uint32_t successor : graph.successors) {
+            if (successor != OUTSIDE) {
+                pred_offsets[successor + 1]++;
+            }
+        }
+        for (size_t p = 0; p < positions; p++) {
+            pred_offsets[p + 1] += pred_offsets[p];
+        }
+        std::vector<uint32_t> predecessors(pred_offsets[positions]);
+        std::vector<uint64_t> fill(pred_offsets.begin(), pred_offsets.end() - 1);
+        for (uint32_t p = 0; p < positions; p++) {
+            for (uint64_t i = graph.offsets[p]; i < graph.offsets[p + 1]; i++) {
+                if (graph.successors[i] != OUTSIDE) {
+                    predecessors[fill[graph.successors[i]]++] = p;
+                }
+            }
+        }
+
+        // Focal seats are independent - solve them in parallel
+        std::vector<std::vector<uint8_t>> values(count);
+        std::vector<std::vector<uint16_t>> depths(count);
+        runParallel(config.threads, [&](unsigned thread) {
+            for (size_t focal = thread; focal < count; focal += config.threads) {
+                solveFocal(graph, pred_offsets, predecessors, static_cast<uint8_t>(focal), values[focal], depths[focal]);
+            }
+        });
+
+        // Open-addressing table with linear probing
+        TablebaseHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = TABLEBASE_MAGIC;
+        header.version = TABLEBASE_VERSION;
+        header.header_size = sizeof(TablebaseHeader);
+        header.player_count = static_cast<uint8_t>(count);
+        for (size_t seat = 0; seat < count; seat++) {
+            header.roles[seat] = static_cast<uint8_t>(config.roles[seat]);
+        }
+        header.coin_cap = config.coin_cap;
+        header.capacity = tableCapacity(positions);
+        header.entry_count = positions;
+
+        TablebaseStats stats;
+        std::vector<uint64_t> slots(header.capacity, 0);
+        std::vector<uint32_t> infos(header.capacity, 0);
+        const uint64_t mask = header.capacity - 1;
+        for (uint32_t p = 0; p < positions; p++) {
+            uint64_t slot = hashKey(graph.keys[p]) & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = graph.keys[p] | OCCUPIED;
+            for (size_t focal = 0; focal < count; focal++) {
+                infos[slot] |= packInfo(static_cast<uint8_t>(focal), static_cast<TablebaseValue>(values[focal][p]), depths[focal][p]);
+            }
+
+            const TablebaseValue own = static_cast<TablebaseValue>(values[graph.deciders[p]][p]);
+            stats.wins += own == TablebaseValue::WIN ? 1 : 0;
+            stats.losses += own == TablebaseValue::LOSS ? 1 : 0;
+            stats.draws += own == TablebaseValue::DRAW ? 1 : 0;
+            stats.unknowns += own == TablebaseValue::UNKNOWN ? 1 : 0;
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open tablebase file " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(uint64_t));
+        out.write(reinterpret_cast<const char*>(infos.data()), infos.size() * sizeof(uint32_t));
+        if (!out) {
+            throw std::runtime_error("Failed to write tablebase file " + path);
+        }
+
+        stats.positions = positions;
+        stats.edges = graph.successors.size();
+        stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    EndgameTable::EndgameTable(const std::string& path)
+    : mapping(nullptr), mapping_size(0), header(nullptr), keys(nullptr), infos(nullptr) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open tablebase file " + path);
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TablebaseHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Tablebase file is truncated");
+        }
+
+        mapping_size = static_cast<size_t>(info.st_size);
+        mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // The mapping stays valid without the descriptor
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            throw std::runtime_error("Cannot map tablebase file " + path);
+        }
+
+        header = static_cast<const TablebaseHeader*>(mapping);
+        const uint64_t capacity = header->capacity;
+        const bool valid = header->magic == TABLEBASE_MAGIC && header->version == TABLEBASE_VERSION &&
+            header->header_size == sizeof(TablebaseHeader) && header->player_count >= 2 &&
+            header->player_count <= TABLEBASE_MAX_PLAYERS && capacity != 0 && (capacity & (capacity - 1)) == 0 &&
+            mapping_size == sizeof(TablebaseHeader) + capacity * (sizeof(uint64_t) + sizeof(uint32_t));
+        if (!valid) {
+            ::munmap(mapping, mapping_size);
+            throw std::runtime_error("Tablebase file format is not supported");
+        }
+
+        const unsigned char* bytes = static_cast<const unsigned char*>(mapping);
+        keys = reinterpret_cast<const uint64_t*>(bytes + sizeof(TablebaseHeader));
+        infos = reinterpret_cast<const uint32_t*>(bytes + sizeof(TablebaseHeader) + capacity * sizeof(uint64_t));
+    }
+
+    EndgameTable::~EndgameTable() {
+        if (mapping) {
+            ::munmap(mapping, mapping_size);
+        }
+    }
+
+    bool EndgameTable::covers(const Game& game) const {
+        if (game.getPlayerCount() != header->player_count || game.getRules() != GameRules()) { // Solved under the standard rules
+            return false;
+        }
+        for (size_t seat = 0; seat < game.getPlayerCount(); seat++) {
+            if (static_cast<uint8_t>(game.getPlayer(seat)->getRole()) != header->roles[seat]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    TablebaseProbe EndgameTable::probe(const Match& match, uint8_t focal) const {
+        uint64_t key;
+        if (focal >= header->player_count || !covers(match.getGame()) || !packTablePosition(match, header->coin_cap, key)) {
+            return {TablebaseValue::UNKNOWN, 0};
+        }
+
+        const uint64_t mask = header->capacity - 1;
+        const uint64_t stored = key | OCCUPIED;
+        for (uint64_t slot = hashKey(key) & mask; keys[slot] != 0; slot = (slot + 1) & mask) {
+            if (keys[slot] == stored) {
+                const uint32_t bits = infos[slot] >> (10 * focal);
+                return {static_cast<TablebaseValue>(bits & 3), static_cast<uint8_t>((bits >> 2) & 0xFF)};
+            }
+        }
+        return {TablebaseValue::UNKNOWN, 0};
+    }
+}
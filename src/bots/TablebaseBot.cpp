@@ -0,0 +1,74 @@
+// Email: razcohenp@gmail.com
+
+// TablebaseBot.cpp - One-move lookahead over the endgame table
+// Every move is applied on a clone and the resulting position is probed for the deciding seat
+
+#include "../../include/bots/TablebaseBot.hpp"
+
+namespace coup {
+    TablebaseBot::TablebaseBot(const EndgameTable& table, Bot& fallback, uint32_t seed)
+    : table(table), fallback(fallback), rng(seed), table_moves(0) {}
+
+    Move TablebaseBot::chooseMove(const Match& match) {
+        const uint8_t seat = match.decidingSeat();
+        uint64_t key;
+        if (!packTablePosition(match, table.getCoinCap(), key)) {
+            return fallback.chooseMove(match);
+        }
+
+        // The clone is rebuilt only when the roster changes
+        const Game& game = match.getGame();
+        if (!clone || clone->game().getPlayerCount() != game.getPlayerCount() || !table.covers(clone->game())) {
+            sim.reset();
+            clone.reset(new GameClone(game));
+            sim.reset(new Match(clone->game(), match.getState(), match.getMaxSteps()));
+        }
+
+        GameSnapshot position;
+        game.saveSnapshot(position, false);
+        match.moves(options);
+        candidates.clear();
+
+        // Fastest win, otherwise a drawing (or unsolved) move, otherwise the slowest loss
+        size_t win = options.size();
+        size_t loss = options.size();
+        size_t known = 0; // Moves with a solved value (positions near the cap may have none)
+        uint8_t win_depth = 0;
+        uint8_t loss_depth = 0;
+        for (size_t i = 0; i < options.size(); i++) {
+            clone->load(position);
+            sim->reset(match.getState());
+            sim->apply(options[i]);
+            const TablebaseProbe result = table.probe(*sim, seat);
+            known += result.value == TablebaseValue::UNKNOWN ? 0 : 1;
+
+            if (result.value == TablebaseValue::WIN) {
+                if (win == options.size() || result.depth < win_depth) {
+                    win = i;
+                    win_depth = result.depth;
+                }
+            }
+            else if (result.value == TablebaseValue::LOSS) {
+                if (loss == options.size() || result.depth > loss_depth) {
+                    loss = i;
+                    loss_depth = result.depth;
+                }
+            }
+            else {
+                candidates.push_back(options[i]);
+            }
+        }
+
+        if (known == 0) {
+            return fallback.chooseMove(match);
+        }
+        table_moves++;
+        if (win < options.size()) {
+            return options[win];
+        }
+        if (!candidates.empty()) {
+            return HeuristicBot::pick(game, candidates, weights, rng);
+        }
+        return options[loss];
+    }
+}
@@ -0,0 +1,269 @@
+// Email: razcohenp@gmail.com
+
+// Tournament.cpp - Scheduling, parallel tables and the rating updates
+
+#include "../../include/bots/Tournament.hpp"
+#include "../../include/Player.hpp"
+
+#include <algorithm> // For sorting and rotations
+#include <atomic> // For the shared table index
+#include <chrono> // For timing
+#include <cmath> // For the rating formulas
+#include <exception> // For passing thread failures to the caller
+#include <random> // For role deals
+#include <stdexcept> // For exception handling
+#include <thread> // For parallel tables
+
+namespace coup {
+    namespace {
+        const double GLICKO_Q = std::log(10.0) / 400.0;
+        const double PI = 3.14159265358979323846;
+
+        // Glicko attenuation of an opponent's rating deviation
+        double glickoG(double rd) {
+            return 1.0 / std::sqrt(1.0 + 3.0 * GLICKO_Q * GLICKO_Q * rd * rd / (PI * PI));
+        }
+
+        // Seed of one game, independent of the thread that plays it
+        uint32_t gameSeed(uint32_t seed, uint64_t game_number) {
+            uint64_t z = (static_cast<uint64_t>(seed) << 32) + game_number + 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<uint32_t>(z ^ (z >> 31));
+        }
+
+        // Score of seat a against seat b, or -1 when the game does not compare them
+        double pairScore(int winner, size_t a, size_t b) {
+            if (winner < 0) return 0.5;
+            if (static_cast<size_t>(winner) == a) return 1.0;
+            if (static_cast<size_t>(winner) == b) return 0.0;
+            return -1.0;
+        }
+    }
+
+    void RatingTable::update(const std::vector<size_t>& table, int winner, double elo_k) {
+        const size_t seats = table.size();
+        std::vector<double> elo_delta(seats, 0.0);
+        std::vector<double> glicko_sum(seats, 0.0);
+        std::vector<double> glicko_info(seats, 0.0);
+
+        // All seats are updated from the ratings before the game
+        for (size_t a = 0; a < seats; a++) {
+            const Rating& self = ratings.at(table[a]);
+            for (size_t b = 0; b < seats; b++) {
+                const double score = a == b ? -1.0 : pairScore(winner, a, b);
+                if (score < 0.0) continue;
+                const Rating& other = ratings.at(table[b]);
+
+                const double elo_expected = 1.0 / (1.0 + std::pow(10.0, (other.elo - self.elo) / 400.0));
+                elo_delta[a] += elo_k / (seats - 1) * (score - elo_expected);
+
+                const double g = glickoG(other.rd);
+                const double expected = 1.0 / (1.0 + std::pow(10.0, -g * (self.glicko - other.glicko) / 400.0));
+                glicko_sum[a] += g * (score - expected);
+                glicko_info[a] += g * g * expected * (1.0 - expected);
+            }
+        }
+
+        for (size_t a = 0; a < seats; a++) {
+            Rating& rating = ratings.at(table[a]);
+            rating.elo += elo_delta[a];
+            if (glicko_info[a] > 0.0) {
+                const double precision = 1.0 / (rating.rd * rating.rd) + GLICKO_Q * GLICKO_Q * glicko_info[a];
+                rating.glicko += GLICKO_Q / precision * glicko_sum[a];
+                rating.rd = std::sqrt(1.0 / precision);
+            }
+            rating.games++;
+            rating.wins += winner == static_cast<int>(a) ? 1 : 0;
+            rating.draws += winner < 0 ? 1 : 0;
+        }
+    }
+
+    std::vector<size_t> RatingTable::ranking() const {
+        std::vector<size_t> order(ratings.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return ratings[a].glicko > ratings[b].glicko;
+        });
+        return order;
+    }
+
+    Tournament::Tournament(const TournamentConfig& config) : config(config) {
+        if (config.seats < 2 || config.seats > 6) {
+            throw std::invalid_argument("Tables must have between 2 and 6 seats");
+        }
+        if (!config.roles.empty() && config.roles.size() != config.seats) {
+            throw std::invalid_argument("One role per seat is required");
+        }
+        if (config.threads == 0 || config.games_per_table == 0) {
+            throw std::invalid_argument("Threads and games per table must be positive");
+        }
+    }
+
+    void Tournament::addEntry(const std::string& name, BotFactory factory) {
+        if (!factory) {
+            throw std::invalid_argument("Entry needs a bot factory");
+        }
+        for (const Entry& entry : entries) {
+            if (entry.name == name) {
+                throw std::invalid_argument("Duplicate entry name: " + name);
+            }
+        }
+        entries.push_back({name, std::move(factory)});
+    }
+
+    std::vector<std::vector<size_t>> Tournament::schedule(unsigned round, const RatingTable& ratings) const {
+        const size_t seats = config.seats;
+        std::vector<std::vector<size_t>> groups;
+
+        if (config.format == TournamentFormat::ROUND_ROBIN) {
+            // Every combination of entrants, in lexicographic order
+            std::vector<size_t> group(seats);
+            for (size_t i = 0; i < seats; i++) {
+                group[i] = i;
+            }
+            while (true) {
+                groups.push_back(group);
+                size_t i = seats;
+                while (i > 0 && group[i - 1] == entries.size() - seats + i - 1) {
+                    i--;
+                }
+                if (i == 0) break;
+                group[i - 1]++;
+                for (size_t j = i; j < seats; j++) {
+                    group[j] = group[j - 1] + 1;
+                }
+            }
+        }
+        else {
+            // Neighbours in the current ranking share a table; byes go to the entrants with
+            // the most games so far (the lowest ranked of them first), so byes rotate
+            std::vector<size_t> order = ratings.ranking();
+            for (size_t byes = order.size() % seats; byes > 0; byes--) {
+                size_t bye = order.size() - 1;
+                for (size_t i = order.size(); i-- > 0;) {
+                    if (ratings.get(order[i]).games > ratings.get(order[bye]).games) {
+                        bye = i;
+                    }
+                }
+                order.erase(order.begin() + bye);
+            }
+            for (size_t start = 0; start + seats <= order.size(); start += seats) {
+                groups.emplace_back(order.begin() + start, order.begin() + start + seats);
+            }
+        }
+
+        // Seats rotate between the games of a table and between rounds
+        std::vector<std::vector<size_t>> tables;
+        tables.reserve(groups.size() * config.games_per_table);
+        for (const auto& group : groups) {
+            for (unsigned game = 0; game < config.games_per_table; game++) {
+                tables.push_back(group);
+                std::rotate(tables.back().begin(), tables.back().begin() + (round + game) % seats, tables.back().end());
+            }
+        }
+        return tables;
+    }
+
+    int Tournament::playGame(const std::vector<size_t>& table, uint64_t game_number) const {
+        const uint32_t seed = gameSeed(config.seed, game_number);
+        std::mt19937 rng(seed);
+        const RoleType deal[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                 RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+
+        Game game;
+        std::vector<std::unique_ptr<Player>> roster;
+        std::vector<std::unique_ptr<Bot>> bots;
+        std::vector<Bot*> seats;
+        for (size_t seat = 0; seat < table.size(); seat++) {
+            const RoleType role = config.roles.empty() ? deal[rng() % 6] : config.roles[seat];
+            roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1), role));
+            bots.push_back(entries[table[seat]].factory(seed + static_cast<uint32_t>(seat)));
+            if (!bots.back()) {
+                throw std::runtime_error("Bot factory of " + entries[table[seat]].name + " returned no bot");
+            }
+            seats.push_back(bots.back().get());
+        }
+        game.startGame();
+
+        Match match(game, config.max_steps);
+        return playMatch(match, seats);
+    }
+
+    TournamentResult Tournament::run(const std::function<void(unsigned, const RatingTable&)>& on_round) const {
+        const auto start = std::chrono::steady_clock::now();
+        if (entries.size() < config.seats) {
+            throw std::runtime_error("Not enough entries to fill a table");
+        }
+
+        TournamentResult result;
+        RatingTable ratings(entries.size());
+        std::vector<size_t> last_ranking = ratings.ranking();
+        unsigned unchanged = 0;
+
+        for (unsigned round = 0; round < config.max_rounds; round++) {
+            const std::vector<std::vector<size_t>> tables = schedule(round, ratings);
+            std::vector<int> winners(tables.size());
+            std::atomic<size_t> next(0);
+            std::vector<std::exception_ptr> errors(config.threads);
+
+            auto work = [&](unsigned thread) {
+                try {
+                    for (size_t i = next++; i < tables.size(); i = next++) {
+                        winners[i] = playGame(tables[i], result.games + i);
+                    }
+                }
+                catch (...) {
+                    errors[thread] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (unsigned thread = 1; thread < config.threads && thread < tables.size(); thread++) {
+                workers.emplace_back(work, thread);
+            }
+            work(0);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            // Schedule order keeps the ratings independent of the thread count
+            for (size_t i = 0; i < tables.size(); i++) {
+                ratings.update(tables[i], winners[i], config.elo_k);
+            }
+            result.games += tables.size();
+            result.rounds = round + 1;
+            if (on_round) {
+                on_round(round, ratings);
+            }
+
+            const std::vector<size_t> ranking = ratings.ranking();
+            unchanged = ranking == last_ranking ? unchanged + 1 : 0;
+            last_ranking = ranking;
+            if (result.rounds < config.min_rounds) continue;
+
+            double widest = 0.0;
+            for (size_t i = 0; i < ratings.size(); i++) {
+                widest = std::max(widest, ratings.get(i).rd);
+            }
+            if ((config.stable_rounds > 0 && unchanged >= config.stable_rounds) ||
+                (config.stop_rd > 0.0 && widest <= config.stop_rd)) {
+                result.converged = true;
+                break;
+            }
+        }
+
+        for (size_t entrant : ratings.ranking()) {
+            result.standings.push_back({entries[entrant].name, ratings.get(entrant)});
+        }
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
@@ -14,45 +14,35 @@ namespace coup {
     
     // Baron's special ability: Invest 3 coins to receive 6 coins (net gain of 3)
     // This powerful economic ability allows rapid wealth accumulation
-    void Baron::invest() {
-        // Verify game has begun before allowing investment actions
-        if (!game.isGameStarted()) {
-            throw std::runtime_error("Game has not started yet");
-        }
-        
-        // Confirm it's Baron's turn to act in the game sequence
-        if (!game.isPlayerTurn(this)) {
-            throw std::runtime_error("Not your turn");
-        }
-
-        // Check that Baron is still actively participating in the game
-        if (!isActive()) {
-            throw std::runtime_error("Player is eliminated");
+    ActionResult Baron::tryInvest() {
+        // Verify game has begun, it's Baron's turn and Baron is still in the game
+        ActionError error = checkTurnAction();
+        if (error != ActionError::NONE) {
+            return actionFailure(error);
         }
 
         // Enforce coup rule: players with 10+ coins must coup instead of other actions
         // This prevents excessive coin hoarding and maintains game balance
         if (coin_count >= 10 && !bribe_used) {
-            throw std::runtime_error("You have 10 or more coins, must perform coup");
+            return actionFailure(ActionError::MUST_COUP);
         }
         
         // Verify Baron has minimum 3 coins required for investment
         if (coin_count < 3) {
-            throw std::runtime_error("Not enough coins for investment");
+            return actionFailure(ActionError::NOT_ENOUGH_COINS_INVEST);
         }
         
-        addCoins(3); // Net gain of 3 coins (pay 3 to receive 6, total +3)
+        addCoins(game.getRules().invest_payout - 3); // Pay 3 to receive the payout (6 by default, net +3)
         
-        // Handle bribe mechanic: if bribe was used this turn, reset flag
-        // Otherwise advance to next player's turn normally
-        if(bribe_used) {
-            bribe_used = false; // Clear bribe flag to end additional turn
-        }
-        
-        // Standard turn progression when no bribe was used
-        else {
-            game.nextTurn(); // Pass control to next active player
-        }
+        // Handle bribe mechanic: a bribed extra action keeps the turn,
+        // otherwise advance to next player's turn normally
+        finishTurnAction();
+        return {};
+    }
+
+    // Throwing version of the investment
+    void Baron::invest() {
+        throwIfFailed(tryInvest());
     }
     
     // Override sanction handling to implement Baron's defensive bonus
@@ -14,32 +14,39 @@ namespace coup {
     
     // General's special ability: Block coup attempts on any player for 5 coins
     // This powerful defensive ability can save players from elimination
-    void General::block_coup(Player& target) {
+    ActionResult General::tryBlockCoup(Player& target) {
         // Verify game state before allowing coup blocking
         if (!game.isGameStarted()) {
-            throw std::runtime_error("Game has not started yet");
+            return actionFailure(ActionError::GAME_NOT_STARTED);
         }
         
         // Check if General has sufficient funds to block the coup
         // Blocking requires exactly 5 coins as payment
-        if (coin_count < 5) {
-            throw std::runtime_error("Not enough coins to block coup");
+        const int block_cost = game.getRules().block_coup_cost;
+        if (coin_count < block_cost) {
+            return actionFailure(ActionError::NOT_ENOUGH_COINS_BLOCK_COUP);
         }
 
         // Validate that target player is actually being couped
         // Cannot block coup on active players who aren't under attack
         if (target.isActive()) {
-            throw std::runtime_error("Target player is not couped");
+            return actionFailure(ActionError::TARGET_NOT_COUPED);
         }
 
         // Ensure coup is still blockable - timing is critical in Coup
         // Once coup resolution begins, it cannot be reversed
         if (target.getCoupedBy() == nullptr) {
-            throw std::runtime_error("Too late, you cannot block this coup anymore");
+            return actionFailure(ActionError::COUP_WINDOW_CLOSED);
         }
         
-        removeCoins(5); // Deduct the blocking fee from General's treasury
+        removeCoins(block_cost); // Deduct the blocking fee from General's treasury
         target.resetCoupedBy(); // Remove coup attacker reference from target
         target.setActivityStatus(true); // Restore target to active gameplay status
+        return {};
+    }
+
+    // Throwing version of the coup block
+    void General::block_coup(Player& target) {
+        throwIfFailed(tryBlockCoup(target));
     }
 }
\ No newline at end of file
@@ -18,37 +18,52 @@ namespace coup {
      * Enhanced tax action yields 3 coins instead of the standard 2.
      * Demonstrates the Governor's superior economic influence and power.
      */
-    void Governor::tax() {
-        Player::tax(); // Execute standard tax validation and award 2 coins
-        addCoins(1); // Governor bonus - award additional coin for total of 3
+    ActionResult Governor::tryTax() {
+        ActionResult result = Player::tryTax(); // Execute standard tax validation and award 2 coins
+        if (result) {
+            addCoins(game.getRules().tax_bonus); // Governor bonus - one additional coin (3 in total) by default
+        }
+        return result;
     }
     
     /**
      * Undo action reverses another player's tax action.
      * Removes 2 coins from target who used tax as their last action.
      */
-    void Governor::undo(Player& target) {
+    ActionResult Governor::tryUndo(Player& target) {
         if (!game.isGameStarted()) { // Ensure game is in progress
-            throw std::runtime_error("Game has not started yet");
+            return actionFailure(ActionError::GAME_NOT_STARTED);
         }
 
         if (!isActive()) { // Ensure Governor is still in the game
-            throw std::runtime_error("Player is eliminated");
+            return actionFailure(ActionError::PLAYER_ELIMINATED);
         }
 
         if (&target == this) { // Prevent self-targeting
-            throw std::runtime_error("An action against yourself is not allowed");
+            return actionFailure(ActionError::SELF_TARGET);
         }
 
         if (!target.isActive()) { // Ensure target is still in game
-            throw std::runtime_error("Target player is eliminated");
+            return actionFailure(ActionError::TARGET_ELIMINATED);
         }
 
         if (!target.usedTaxLastAction()) { // Verify target used tax recently
-            throw std::runtime_error("Target player did not use tax as his last action");
+            return actionFailure(ActionError::NO_TAX_TO_UNDO);
+        }
+
+        if (target.coins() < 2) { // Target may have spent the taxed coins already
+            return actionFailure(ActionError::TARGET_NOT_ENOUGH_COINS);
         }
         
         target.removeCoins(2); // Reverse the tax benefit by removing 2 coins
         target.resetUsedTaxLastAction(); // Clear tax tracking since action was undone
+        return {};
+    }
+
+    /**
+     * Throwing version of undo.
+     */
+    void Governor::undo(Player& target) {
+        throwIfFailed(tryUndo(target));
     }
 }
\ No newline at end of file
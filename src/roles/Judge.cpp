@@ -14,35 +14,41 @@ namespace coup {
     
     // Judge's special ability: Block another player's bribe attempt
     // This prevents corruption and maintains game integrity
-    void Judge::block_bribe(Player& target) {
+    ActionResult Judge::tryBlockBribe(Player& target) {
         // Verify game state before allowing bribe blocking
         if (!game.isGameStarted()) {
-            throw std::runtime_error("Game has not started yet");
+            return actionFailure(ActionError::GAME_NOT_STARTED);
         }
         
         // Confirm Judge is still active and able to intervene
         if (!isActive()) {
-            throw std::runtime_error("Player is eliminated");
+            return actionFailure(ActionError::PLAYER_ELIMINATED);
         }
 
         // Prevent self-targeting which would be nonsensical
         // Judge cannot block their own bribe attempts
         if (&target == this) {
-            throw std::runtime_error("An action against yourself is not allowed");
+            return actionFailure(ActionError::SELF_TARGET);
         }
 
         // Verify target is still participating in the game
         if (!target.isActive()) {
-            throw std::runtime_error("Target player is eliminated");
+            return actionFailure(ActionError::TARGET_ELIMINATED);
         }
 
         // Confirm there's actually a bribe action to block
         // Can only block if target recently used bribery
         if (!target.isBribeUsed()) {
-            throw std::runtime_error("Target player has not used bribe as a last action");
+            return actionFailure(ActionError::NO_BRIBE_TO_BLOCK);
         }
 
         // Execute the blocking action by nullifying the bribe
         target.resetBribeUsed(); // Remove bribe effect and deny extra turn
+        return {};
+    }
+
+    // Throwing version of the bribe block
+    void Judge::block_bribe(Player& target) {
+        throwIfFailed(tryBlockBribe(target));
     }
 }
\ No newline at end of file
@@ -15,32 +15,36 @@ namespace coup {
     
     // Spy's special ability: Conduct surveillance on target player
     // Reveals target's coin count and blocks their arrest capability
-    void Spy::spy_on(Player& target) {
+    Expected<int, ActionError> Spy::trySpyOn(Player& target) {
         // Verify game has begun before allowing spy operations
         if (!game.isGameStarted()) {
-            throw std::runtime_error("Game has not started yet");
+            return actionFailure(ActionError::GAME_NOT_STARTED);
         }
         
         // Confirm Spy is still active and operational
         if (!isActive()) {
-            throw std::runtime_error("Player is eliminated");
+            return actionFailure(ActionError::PLAYER_ELIMINATED);
         }
 
         // Prevent self-surveillance which would be meaningless
         // Spy already knows their own information
         if (&target == this) {
-            throw std::runtime_error("An action against yourself is not allowed");
+            return actionFailure(ActionError::SELF_TARGET);
         }
 
         // Verify target is still participating and can be spied upon
         if (!target.isActive()) {
-            throw std::runtime_error("Target player is eliminated");
+            return actionFailure(ActionError::TARGET_ELIMINATED);
         }
         
-        // Target's coin count revealed to Spy
-        // This information advantage is handled by the GUI interface
-
         target.setArrestAvailability(false); // Sabotage: disable target's arrest ability temporarily
         // No need to nextTurn() since spy_on doesn't consume a turn slot
+
+        return target.coins(); // Target's coin count revealed to Spy
+    }
+
+    // Throwing version - the revealed coins are shown by the GUI interface
+    void Spy::spy_on(Player& target) {
+        throwIfFailed(trySpyOn(target));
     }
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+// Email: razcohenp@gmail.com
+
+// GameServer.cpp - Listener setup and the shard threads of the game server
+
+#include "../../include/server/GameServer.hpp"
+
+#include <arpa/inet.h> // For inet_pton
+#include <cerrno> // For errno
+#include <cstring> // For std::strerror
+#include <exception> // For passing shard failures to the caller
+#include <netinet/in.h> // For sockaddr_in
+#include <pthread.h> // For pinning shard threads
+#include <sched.h> // For CPU sets
+#include <stdexcept> // For exception handling
+#include <sys/socket.h> // For sockets
+#include <sys/un.h> // For Unix sockets
+#include <thread> // For shard threads
+#include <unistd.h> // For close and unlink
+
+namespace coup {
+    namespace {
+        [[noreturn]] void throwSystemError(const std::string& what) {
+            throw std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        // Binds a TCP listener; with reuse_port every shard can bind the same port
+        int openTcpListener(const std::string& host, uint16_t port, bool reuse_port, uint16_t& bound) {
+            const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                throwSystemError("Cannot create TCP socket");
+            }
+            const int enable = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+            if (reuse_port) {
+                setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+            }
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+                ::close(fd);
+                throw std::runtime_error("Invalid TCP address: " + host);
+            }
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+                const int error = errno;
+                ::close(fd);
+                errno = error;
+                throwSystemError("Cannot listen on TCP port " + std::to_string(port));
+            }
+            socklen_t length = sizeof(address);
+            getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+            bound = ntohs(address.sin_port);
+            return fd;
+        }
+
+        int openUnixListener(const std::string& path) {
+            sockaddr_un address{};
+            if (path.size() >= sizeof(address.sun_path)) {
+                throw std::runtime_error("Unix socket path too long");
+            }
+            const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                throwSystemError("Cannot create Unix socket");
+            }
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            ::unlink(path.c_str()); // A stale socket file of an earlier run
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+                const int error = errno;
+                ::close(fd);
+                errno = error;
+                throwSystemError("Cannot listen on Unix socket " + path);
+            }
+            return fd;
+        }
+    }
+
+    GameServer::GameServer(const ServerConfig& config) : config(config), port(0), unix_bound(false) {
+        if (config.shards == 0 || config.shards > 255) {
+            throw std::invalid_argument("Shard count must be between 1 and 255");
+        }
+
+        const uint8_t count = static_cast<uint8_t>(config.shards);
+        for (uint8_t index = 0; index < count; index++) {
+            shards.emplace_back(new TableShard(this->config, index, count));
+        }
+        std::vector<TableShard*> all;
+        for (auto& shard : shards) {
+            all.push_back(shard.get());
+        }
+        for (auto& shard : shards) {
+            shard->connect(all);
+        }
+
+        // Recovered tables go to the shard their id maps to; the old generations go once the new checkpoints are durable
+        if (!config.wal_dir.empty()) {
+            std::vector<std::unique_ptr<Table>> recovered;
+            const uint32_t generation = TableLog::recover(config.wal_dir, recovered, recovery);
+            for (auto& table : recovered) {
+                const uint32_t id = table->getId();
+                shards[id % count]->host(std::move(table));
+            }
+            for (auto& shard : shards) {
+                shard->openLog(generation);
+            }
+            TableLog::removeGenerations(config.wal_dir, generation);
+        }
+
+        // Shards own their listeners from here on, so a failure below releases everything
+        if (config.tcp_port >= 0) {
+            port = static_cast<uint16_t>(config.tcp_port);
+            for (auto& shard : shards) {
+                shard->listen(openTcpListener(config.tcp_host, port, count > 1, port), false);
+            }
+        }
+        if (!config.unix_path.empty()) {
+            shards[0]->listen(openUnixListener(config.unix_path), count > 1);
+            unix_bound = true;
+        }
+    }
+
+    GameServer::~GameServer() {
+        shards.clear();
+        if (unix_bound) {
+            ::unlink(config.unix_path.c_str());
+        }
+    }
+
+    void GameServer::run() {
+        std::vector<std::exception_ptr> errors(shards.size());
+        auto serve = [&](size_t index) {
+            try {
+                shards[index]->run();
+            }
+            catch (...) {
+                errors[index] = std::current_exception();
+                stop();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t index = 1; index < shards.size(); index++) {
+            threads.emplace_back(serve, index);
+            if (config.pin_threads) {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(index % std::thread::hardware_concurrency(), &cpus);
+                pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpus), &cpus);
+            }
+        }
+        serve(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    void GameServer::stop() {
+        for (auto& shard : shards) {
+            shard->stop();
+        }
+    }
+
+    ServerStats GameServer::getStats() const {
+        ServerStats total;
+        for (const auto& shard : shards) {
+            const ServerStats& stats = shard->getStats();
+            total.accepted += stats.accepted;
+            total.closed += stats.closed;
+            total.requests += stats.requests;
+            total.rejected += stats.rejected;
+            total.moves += stats.moves;
+            total.games_finished += stats.games_finished;
+            total.forwarded += stats.forwarded;
+            total.queued += stats.queued;
+            total.backpressured += stats.backpressured;
+            total.timeouts += stats.timeouts;
+            total.spectator_frames += stats.spectator_frames;
+            total.resyncs += stats.resyncs;
+            total.rejoins += stats.rejoins;
+            total.logged += stats.logged;
+            total.log_syncs += stats.log_syncs;
+        }
+        return total;
+    }
+
+    size_t GameServer::tableCount() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            total += shard->tableCount();
+        }
+        return total;
+    }
+}
@@ -0,0 +1,83 @@
+// Email: razcohenp@gmail.com
+
+// Lockstep.cpp - Replaying a lockstep table from its setup and action stream
+// The replica mirrors Table::start and Table::play, so equal inputs give equal hashes
+
+#include "../../include/server/Lockstep.hpp"
+
+#include <exception> // For engine rejections
+#include <stdexcept> // For exception handling
+#include <string> // For seat names
+
+namespace coup {
+    LockstepReplica::LockstepReplica(const Message& setup) : table(setup.table), events(0) {
+        if (setup.type != MessageType::SETUP) {
+            throw std::invalid_argument("A replica starts from a SETUP message");
+        }
+        game.setRules(setup.rules);
+        game.getRandomGenerator().seed(setup.seed);
+        for (uint8_t seat = 0; seat < setup.seat_count; seat++) {
+            // Names are not part of the state hash; the server does not ship them
+            roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1),
+                                                          static_cast<RoleType>(setup.seats[seat].role)));
+        }
+        game.startGame();
+        match.reset(new Match(game, setup.max_steps));
+        hashes.push_back(match->stateHash());
+        verify(0, setup.hash);
+    }
+
+    bool LockstepReplica::apply(const Message& action) {
+        if (action.type != MessageType::ACTION || action.table != table) {
+            throw std::invalid_argument("Not an action of this table");
+        }
+        if (action.step != events + 1) {
+            throw std::invalid_argument("Gap in the action stream");
+        }
+
+        events++;
+        try {
+            if (action.expiry) {
+                match->expireWindow();
+            }
+            else {
+                match->apply(action.move);
+            }
+        }
+        catch (const std::exception&) {
+            // The server accepted what this engine rejects - the games already differ
+            if (!report.diverged) {
+                report.diverged = true;
+                report.detected_at = events;
+            }
+        }
+        hashes.push_back(match->stateHash());
+        if (action.has_hash) {
+            verify(events, action.hash);
+        }
+        return !report.diverged;
+    }
+
+    void LockstepReplica::verify(uint32_t event, uint64_t expected) {
+        if (report.diverged) {
+            return;
+        }
+        if (hashes[event] == expected) {
+            report.last_verified = event;
+        }
+        else {
+            report.diverged = true;
+            report.detected_at = event;
+        }
+    }
+
+    int64_t firstDivergence(const std::vector<uint64_t>& reference, const std::vector<uint64_t>& replica) {
+        const size_t shared = reference.size() < replica.size() ? reference.size() : replica.size();
+        for (size_t event = 0; event < shared; event++) {
+            if (reference[event] != replica[event]) {
+                return static_cast<int64_t>(event);
+            }
+        }
+        return -1;
+    }
+}
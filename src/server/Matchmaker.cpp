@@ -0,0 +1,169 @@
+// Email: razcohenp@gmail.com
+
+// Matchmaker.cpp - Rating ladders, widening rechecks and wait-time histograms of the matchmaking queue
+
+#include "../../include/server/Matchmaker.hpp"
+
+#include <algorithm> // For std::min and std::max
+#include <cmath> // For std::ceil and std::isnan
+#include <iterator> // For std::prev
+#include <limits> // For std::numeric_limits
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    void WaitHistogram::record(uint64_t wait_ms) {
+        unsigned bucket = 0;
+        if (wait_ms > 0) {
+            bucket = std::min(64u - static_cast<unsigned>(__builtin_clzll(wait_ms)), BUCKETS - 1);
+        }
+        counts[bucket]++;
+        total++;
+        sum_ms += wait_ms;
+        longest_ms = std::max(longest_ms, wait_ms);
+    }
+
+    uint64_t WaitHistogram::bucketLimit(unsigned bucket) {
+        if (bucket >= BUCKETS - 1) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return (uint64_t(1) << bucket) - 1;
+    }
+
+    uint64_t WaitHistogram::percentile(double quantile) const {
+        if (total == 0) {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * total)));
+        uint64_t seen = 0;
+        for (unsigned bucket = 0; bucket < BUCKETS; bucket++) {
+            seen += counts[bucket];
+            if (seen >= rank) {
+                return std::min(bucketLimit(bucket), longest_ms);
+            }
+        }
+        return longest_ms;
+    }
+
+    Matchmaker::Matchmaker(const MatchmakerConfig& config) : config(config) {
+        if (config.base_tolerance < 0 || config.widen_per_second < 0 || config.max_tolerance < 0) {
+            throw std::invalid_argument("Matchmaking tolerances cannot be negative");
+        }
+        if (config.widen_interval_ms == 0) {
+            throw std::invalid_argument("Widening interval must be at least 1 ms");
+        }
+    }
+
+    double Matchmaker::tolerance(const Entry& entry, uint64_t now_ms) const {
+        const uint64_t steps = (now_ms - entry.enqueued_ms) / config.widen_interval_ms;
+        const double widened = config.base_tolerance +
+                               config.widen_per_second * static_cast<double>(steps * config.widen_interval_ms) / 1000.0;
+        return std::min(widened, config.max_tolerance);
+    }
+
+    void Matchmaker::scheduleRecheck(uint64_t id, Entry& entry, uint64_t now_ms) {
+        entry.recheck_ms = 0;
+        if (config.widen_per_second <= 0 || tolerance(entry, now_ms) >= config.max_tolerance) {
+            return; // Only a newcomer within reach can seat it now
+        }
+        const uint64_t steps = (now_ms - entry.enqueued_ms) / config.widen_interval_ms + 1;
+        entry.recheck_ms = entry.enqueued_ms + steps * config.widen_interval_ms;
+        rechecks.emplace(entry.recheck_ms, id);
+    }
+
+    bool Matchmaker::tryMatch(uint64_t id, uint64_t now_ms, std::vector<MatchGroup>& formed) {
+        const Entry& entry = entries.find(id)->second;
+        std::set<Key>& ladder = ladders[entry.seats];
+        const double rating = entry.rating;
+        const double reach = tolerance(entry, now_ms);
+
+        // Grow the range [below, above) around the entry by the nearer neighbour until the table is full
+        auto below = ladder.find({rating, id});
+        auto above = std::next(below);
+        size_t taken = 1;
+        while (taken < entry.seats) {
+            const bool lower = below != ladder.begin() && rating - std::prev(below)->first <= reach;
+            const bool upper = above != ladder.end() && above->first - rating <= reach;
+            if (!lower && !upper) {
+                return false;
+            }
+            if (lower && (!upper || rating - std::prev(below)->first <= above->first - rating)) {
+                --below;
+            }
+            else {
+                ++above;
+            }
+            taken++;
+        }
+
+        MatchGroup table;
+        table.seats = entry.seats;
+        table.formed_ms = now_ms;
+        size_t seat = 0;
+        for (auto at = below; at != above; ++at, seat++) {
+            table.ids[seat] = at->second;
+            table.ratings[seat] = at->first;
+            auto found = entries.find(at->second);
+            const uint64_t wait = now_ms - found->second.enqueued_ms;
+            waits[table.seats].record(wait);
+            waits[0].record(wait);
+            if (found->second.recheck_ms) {
+                rechecks.erase({found->second.recheck_ms, at->second});
+            }
+            entries.erase(found);
+        }
+        ladder.erase(below, above);
+        formed.push_back(table);
+        return true;
+    }
+
+    void Matchmaker::erase(std::unordered_map<uint64_t, Entry>::iterator found) {
+        ladders[found->second.seats].erase({found->second.rating, found->first});
+        if (found->second.recheck_ms) {
+            rechecks.erase({found->second.recheck_ms, found->first});
+        }
+        entries.erase(found);
+    }
+
+    bool Matchmaker::enqueue(uint64_t id, double rating, uint8_t seats, uint64_t now_ms, std::vector<MatchGroup>& formed) {
+        if (seats < 2 || seats > SNAPSHOT_MAX_PLAYERS) {
+            throw std::invalid_argument("Tables have 2-6 seats");
+        }
+        if (std::isnan(rating)) {
+            throw std::invalid_argument("Rating must be a number");
+        }
+        auto inserted = entries.emplace(id, Entry{rating, seats, now_ms, 0});
+        if (!inserted.second) {
+            throw std::invalid_argument("Already queued");
+        }
+        ladders[seats].emplace(rating, id);
+        if (tryMatch(id, now_ms, formed)) {
+            return true;
+        }
+        scheduleRecheck(id, entries.find(id)->second, now_ms);
+        return false;
+    }
+
+    bool Matchmaker::cancel(uint64_t id) {
+        auto found = entries.find(id);
+        if (found == entries.end()) {
+            return false;
+        }
+        erase(found);
+        return true;
+    }
+
+    void Matchmaker::poll(uint64_t now_ms, std::vector<MatchGroup>& formed) {
+        while (!rechecks.empty() && rechecks.begin()->first <= now_ms) {
+            const uint64_t id = rechecks.begin()->second;
+            rechecks.erase(rechecks.begin());
+            entries.find(id)->second.recheck_ms = 0;
+            if (!tryMatch(id, now_ms, formed)) {
+                scheduleRecheck(id, entries.find(id)->second, now_ms);
+            }
+        }
+    }
+
+    uint64_t Matchmaker::nextPoll() const {
+        return rechecks.empty() ? std::numeric_limits<uint64_t>::max() : rechecks.begin()->first;
+    }
+}
@@ -0,0 +1,237 @@
+// Email: razcohenp@gmail.com
+
+// Protocol.cpp - Frame encoding and decoding of the server protocol
+// Bodies have a fixed layout per message type; decoding checks every length and enum value
+// and reads the frame in place (no copies, no allocation)
+
+#include "../../include/server/Protocol.hpp"
+#include "../../include/server/WireFormat.hpp"
+
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    void encodeMessage(const Message& message, std::vector<uint8_t>& out) {
+        const size_t start = out.size();
+        put16(out, 0); // Patched once the body is written
+        put8(out, PROTOCOL_VERSION);
+        put8(out, static_cast<uint8_t>(message.type));
+        put32(out, message.table);
+
+        switch (message.type) {
+            case MessageType::JOIN:
+                put8(out, static_cast<uint8_t>(message.role));
+                if (message.text.size() > MAX_NAME_LENGTH) {
+                    out.resize(start);
+                    throw std::invalid_argument("Player name too long");
+                }
+                putText(out, message.text, MAX_NAME_LENGTH);
+                break;
+            case MessageType::START:
+            case MessageType::WATCH:
+                break;
+            case MessageType::MOVE:
+                putMove(out, message.move);
+                break;
+            case MessageType::REJOIN:
+            case MessageType::JOINED:
+                put8(out, message.seat);
+                put64(out, message.token);
+                break;
+            case MessageType::GAME_OVER:
+                put8(out, message.seat);
+                break;
+            case MessageType::STATE:
+                if (message.seat_count > SNAPSHOT_MAX_PLAYERS || (message.changed >> message.seat_count)) {
+                    out.resize(start);
+                    throw std::invalid_argument("Too many seats");
+                }
+                put8(out, message.seat);
+                put32(out, message.step);
+                put8(out, message.window ? 1 : 0);
+                putMove(out, message.move);
+                put8(out, message.seat_count);
+                put8(out, message.changed);
+                for (uint8_t seat = 0; seat < message.seat_count; seat++) {
+                    if (message.changed & (1u << seat)) {
+                        put8(out, message.seats[seat].role);
+                        put8(out, message.seats[seat].active ? 1 : 0);
+                        put16(out, message.seats[seat].coins);
+                    }
+                }
+                break;
+            case MessageType::ERROR:
+                put8(out, static_cast<uint8_t>(message.error));
+                putText(out, message.text, 255);
+                break;
+            case MessageType::SETUP: {
+                GameRules rules = message.rules;
+                bool fits = message.seat_count <= SNAPSHOT_MAX_PLAYERS;
+                for (size_t field = 0; field < RULE_FIELDS; field++) {
+                    fits = fits && *ruleFields(rules, field) >= 0 && *ruleFields(rules, field) <= 0xFF;
+                }
+                if (!fits) {
+                    out.resize(start);
+                    throw std::invalid_argument("Setup does not fit the format");
+                }
+                put32(out, message.seed);
+                put32(out, message.max_steps);
+                put16(out, message.hash_interval);
+                for (size_t field = 0; field < RULE_FIELDS; field++) {
+                    put8(out, static_cast<uint8_t>(*ruleFields(rules, field)));
+                }
+                put64(out, message.hash);
+                put8(out, message.seat_count);
+                for (uint8_t seat = 0; seat < message.seat_count; seat++) {
+                    put8(out, message.seats[seat].role);
+                }
+                break;
+            }
+            case MessageType::ACTION:
+                put32(out, message.step);
+                put8(out, static_cast<uint8_t>((message.has_hash ? 1 : 0) | (message.expiry ? 2 : 0)));
+                putMove(out, message.move);
+                if (message.has_hash) {
+                    put64(out, message.hash);
+                }
+                break;
+            default:
+                out.resize(start);
+                throw std::invalid_argument("Unknown message type");
+        }
+
+        const size_t length = out.size() - start - FRAME_HEADER_SIZE;
+        if (length > UINT16_MAX) {
+            out.resize(start);
+            throw std::invalid_argument("Message too long");
+        }
+        out[start] = static_cast<uint8_t>(length);
+        out[start + 1] = static_cast<uint8_t>(length >> 8);
+    }
+
+    size_t decodeMessage(const uint8_t* data, size_t size, Message& out) {
+        if (size < FRAME_HEADER_SIZE) {
+            return 0;
+        }
+        if (data[2] != PROTOCOL_VERSION) { // Rejected before waiting for a body of unknown layout
+            throw std::invalid_argument("Unsupported protocol version");
+        }
+        const size_t length = static_cast<size_t>(data[0] | (data[1] << 8));
+        if (size < FRAME_HEADER_SIZE + length) {
+            return 0;
+        }
+
+        WireReader reader(data + FRAME_HEADER_SIZE, length, "message body");
+        out.text = {}; // A reused target must not keep a view into an earlier frame
+        out.type = static_cast<MessageType>(reader.get8());
+        out.table = reader.get32();
+
+        switch (out.type) {
+            case MessageType::JOIN: {
+                const uint8_t role = reader.get8();
+                if (role > static_cast<uint8_t>(RoleType::MERCHANT)) {
+                    throw std::invalid_argument("Invalid role");
+                }
+                out.role = static_cast<RoleType>(role);
+                out.text = reader.getText(MAX_NAME_LENGTH);
+                break;
+            }
+            case MessageType::START:
+            case MessageType::WATCH:
+                break;
+            case MessageType::MOVE:
+                out.move = reader.getMove();
+                break;
+            case MessageType::REJOIN:
+            case MessageType::JOINED:
+                out.seat = reader.get8();
+                out.token = reader.get64();
+                break;
+            case MessageType::GAME_OVER:
+                out.seat = reader.get8();
+                break;
+            case MessageType::STATE:
+                out.seat = reader.get8();
+                out.step = reader.get32();
+                out.window = reader.get8() != 0;
+                out.move = reader.getMove();
+                out.seat_count = reader.get8();
+                if (out.seat_count > SNAPSHOT_MAX_PLAYERS) {
+                    throw std::invalid_argument("Too many seats");
+                }
+                out.changed = reader.get8();
+                if (out.changed >> out.seat_count) {
+                    throw std::invalid_argument("Changed seat out of range");
+                }
+                for (uint8_t seat = 0; seat < out.seat_count; seat++) {
+                    if (out.changed & (1u << seat)) {
+                        out.seats[seat].role = reader.get8();
+                        out.seats[seat].active = reader.get8() != 0;
+                        out.seats[seat].coins = reader.get16();
+                    }
+                }
+                break;
+            case MessageType::ERROR: {
+                const uint8_t error = reader.get8();
+                if (error > static_cast<uint8_t>(ServerError::TABLE_BUSY)) {
+                    throw std::invalid_argument("Invalid error code");
+                }
+                out.error = static_cast<ServerError>(error);
+                out.text = reader.getText(255);
+                break;
+            }
+            case MessageType::SETUP:
+                out.seed = reader.get32();
+                out.max_steps = reader.get32();
+                out.hash_interval = reader.get16();
+                for (size_t field = 0; field < RULE_FIELDS; field++) {
+                    *ruleFields(out.rules, field) = reader.get8();
+                }
+                out.hash = reader.get64();
+                out.seat_count = reader.get8();
+                if (out.seat_count > SNAPSHOT_MAX_PLAYERS) {
+                    throw std::invalid_argument("Too many seats");
+                }
+                for (uint8_t seat = 0; seat < out.seat_count; seat++) {
+                    out.seats[seat].role = reader.get8();
+                    if (out.seats[seat].role > static_cast<uint8_t>(RoleType::MERCHANT)) {
+                        throw std::invalid_argument("Invalid role");
+                    }
+                }
+                break;
+            case MessageType::ACTION: {
+                out.step = reader.get32();
+                const uint8_t flags = reader.get8();
+                if (flags > 3) {
+                    throw std::invalid_argument("Invalid action flags");
+                }
+                out.has_hash = (flags & 1) != 0;
+                out.expiry = (flags & 2) != 0;
+                out.move = reader.getMove();
+                if (out.has_hash) {
+                    out.hash = reader.get64();
+                }
+                break;
+            }
+            default:
+                throw std::invalid_argument("Unknown message type");
+        }
+
+        reader.finish();
+        return FRAME_HEADER_SIZE + length;
+    }
+
+    const char* getServerErrorMessage(ServerError error) {
+        switch (error) {
+            case ServerError::NONE: return "No error";
+            case ServerError::MALFORMED: return "Malformed message";
+            case ServerError::UNKNOWN_TABLE: return "Unknown table";
+            case ServerError::TABLE_LIMIT: return "Table limit reached";
+            case ServerError::SEAT_UNAVAILABLE: return "No seat available at this table";
+            case ServerError::NOT_SEATED: return "Not seated at this table";
+            case ServerError::NOT_STARTED: return "Game has not started yet";
+            case ServerError::ILLEGAL_MOVE: return "Illegal move";
+            case ServerError::TABLE_BUSY: return "Table is busy, retry later";
+        }
+        return "Unknown error";
+    }
+}
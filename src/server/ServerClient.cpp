@@ -0,0 +1,175 @@
+// Email: razcohenp@gmail.com
+
+// ServerClient.cpp - Blocking protocol client over TCP or Unix sockets
+
+#include "../../include/server/ServerClient.hpp"
+
+#include <arpa/inet.h> // For inet_pton
+#include <cerrno> // For errno
+#include <cstring> // For std::strerror
+#include <netinet/in.h> // For sockaddr_in
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <poll.h> // For receive timeouts
+#include <stdexcept> // For exception handling
+#include <sys/socket.h> // For sockets
+#include <sys/un.h> // For Unix sockets
+#include <unistd.h> // For close
+
+namespace coup {
+    namespace {
+        [[noreturn]] void throwSystemError(const std::string& what) {
+            throw std::runtime_error(what + ": " + std::strerror(errno));
+        }
+    }
+
+    ServerClient::ServerClient() : fd(-1), input_offset(0) {}
+
+    ServerClient::~ServerClient() {
+        close();
+    }
+
+    void ServerClient::connectTcp(const std::string& host, uint16_t port) {
+        close();
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+            throw std::runtime_error("Invalid TCP address: " + host);
+        }
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throwSystemError("Cannot create TCP socket");
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close();
+            throwSystemError("Cannot connect to " + host);
+        }
+        const int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+
+    void ServerClient::connectUnix(const std::string& path) {
+        close();
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Unix socket path too long");
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throwSystemError("Cannot create Unix socket");
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close();
+            throwSystemError("Cannot connect to " + path);
+        }
+    }
+
+    void ServerClient::send(const Message& message) {
+        output.clear();
+        encodeMessage(message, output);
+        sendRaw(output.data(), output.size());
+    }
+
+    void ServerClient::sendRaw(const uint8_t* data, size_t size) {
+        if (fd < 0) {
+            throw std::runtime_error("Not connected");
+        }
+        while (size > 0) {
+            const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                throwSystemError("Connection lost");
+            }
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+    }
+
+    bool ServerClient::receive(Message& out, int timeout_ms) {
+        if (fd < 0) {
+            throw std::runtime_error("Not connected");
+        }
+        if (input_offset == input.size()) { // The previous message (and its text) is no longer needed
+            input.clear();
+            input_offset = 0;
+        }
+        while (true) {
+            const size_t used = decodeMessage(input.data() + input_offset, input.size() - input_offset, out);
+            if (used > 0) {
+                input_offset += used;
+                if (out.type == MessageType::STATE) {
+                    merge(out);
+                }
+                else if (out.type == MessageType::GAME_OVER) {
+                    for (size_t i = 0; i < views.size(); i++) {
+                        if (views[i].table == out.table) {
+                            views[i] = views.back();
+                            views.pop_back();
+                            break;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            pollfd ready{fd, POLLIN, 0};
+            const int events = ::poll(&ready, 1, timeout_ms);
+            if (events == 0) {
+                return false;
+            }
+            if (events < 0) {
+                if (errno == EINTR) continue;
+                throwSystemError("poll failed");
+            }
+
+            uint8_t chunk[16 * 1024];
+            const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received == 0) {
+                throw std::runtime_error("Connection closed by the server");
+            }
+            if (received < 0) {
+                if (errno == EINTR) continue;
+                throwSystemError("Connection lost");
+            }
+            if (input_offset > 0) { // Drop decoded bytes before growing the buffer
+                input.erase(input.begin(), input.begin() + input_offset);
+                input_offset = 0;
+            }
+            input.insert(input.end(), chunk, chunk + received);
+        }
+    }
+
+    void ServerClient::merge(Message& state) {
+        TableView* view = nullptr;
+        for (TableView& candidate : views) {
+            if (candidate.table == state.table) {
+                view = &candidate;
+                break;
+            }
+        }
+        if (!view) {
+            views.push_back(TableView{state.table, {}});
+            view = &views.back();
+        }
+        for (uint8_t seat = 0; seat < state.seat_count; seat++) {
+            if (state.changed & (1u << seat)) {
+                view->seats[seat] = state.seats[seat];
+            }
+            else {
+                state.seats[seat] = view->seats[seat];
+            }
+        }
+    }
+
+    void ServerClient::close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        input.clear();
+        input_offset = 0;
+        views.clear();
+    }
+}
@@ -0,0 +1,159 @@
+// Email: razcohenp@gmail.com
+
+// Table.cpp - A hosted game: seats, start and validated moves
+
+#include "../../include/server/Table.hpp"
+
+#include <algorithm> // For std::copy
+#include <stdexcept> // For exception handling
+
+namespace coup {
+    Table::Table(uint32_t id, uint32_t max_steps, const GameRules& rules, uint32_t seed)
+    : id(id), max_steps(max_steps), seed(seed), last_move(Move::decline(0)), events(0), last_expiry(false),
+      hashing(false), tokens(), published(), published_count(0) {
+        game.setRules(rules);
+        game.getRandomGenerator().seed(seed);
+    }
+
+    uint8_t Table::join(const std::string& name, RoleType role, uint64_t token) {
+        if (match) {
+            throw std::runtime_error("Game has already started");
+        }
+        // The player registers itself with the game, which rejects a seventh seat
+        roster.emplace_back(game.createPlayerWithRole(name, role));
+        tokens[roster.size() - 1] = token;
+        return static_cast<uint8_t>(roster.size() - 1);
+    }
+
+    void Table::start() {
+        if (match) {
+            throw std::runtime_error("Game has already started");
+        }
+        game.startGame();
+        match.reset(new Match(game, max_steps));
+        if (hashing) {
+            hashes.push_back(match->stateHash());
+        }
+    }
+
+    void Table::play(uint8_t seat, Move move) {
+        if (!match) {
+            throw std::runtime_error("Game has not started yet");
+        }
+        if (match->isOver()) {
+            throw std::runtime_error("Game is over");
+        }
+        move.action.actor = seat;
+        match->apply(move);
+        last_move = move;
+        last_expiry = false;
+        events++;
+        if (hashing) {
+            hashes.push_back(match->stateHash());
+        }
+    }
+
+    void Table::expireWindow() {
+        if (match && match->inReactionWindow()) {
+            match->expireWindow();
+            last_expiry = true;
+            events++;
+            if (hashing) {
+                hashes.push_back(match->stateHash());
+            }
+        }
+    }
+
+    void Table::restore(const GameSnapshot& snapshot, const MatchState& state, uint32_t events,
+                        const Move& last_move, bool last_expiry) {
+        if (!match) {
+            throw std::runtime_error("Game has not started yet");
+        }
+        game.loadSnapshot(snapshot); // Checks the roster against the seats
+        match->reset(state);
+        this->events = events;
+        this->last_move = last_move;
+        this->last_expiry = last_expiry;
+        published_count = 0; // The next STATE is a full one
+        if (hashing) {
+            hashes.assign(1, match->stateHash()); // The log restarts at the restored event
+        }
+    }
+
+    Move Table::defaultMove() const {
+        if (!match || match->isOver()) {
+            throw std::runtime_error("Game is not running");
+        }
+        const uint8_t seat = match->decidingSeat();
+        if (match->inReactionWindow()) {
+            return Move::decline(seat);
+        }
+        match->moves(options);
+        for (const Move& option : options) {
+            if (option.action.type == ActionType::GATHER) {
+                return option;
+            }
+        }
+        return options.empty() ? Move::decline(seat) : options.front();
+    }
+
+    uint8_t Table::winner() const {
+        const int seat = match ? match->winner() : -1;
+        return seat < 0 ? NO_WINNER : static_cast<uint8_t>(seat);
+    }
+
+    void Table::describe(Message& out) const {
+        out.type = MessageType::STATE;
+        out.table = id;
+        out.seat = match && !match->isOver() ? match->decidingSeat() : NO_WINNER;
+        out.step = match ? match->getState().steps : 0;
+        out.window = match && match->inReactionWindow();
+        out.move = last_move;
+        out.seat_count = static_cast<uint8_t>(roster.size());
+        out.changed = static_cast<uint8_t>((1u << roster.size()) - 1);
+        for (size_t seat = 0; seat < roster.size(); seat++) {
+            const Player* player = game.getPlayer(seat);
+            out.seats[seat].role = static_cast<uint8_t>(player->getRole());
+            out.seats[seat].active = player->isActive();
+            out.seats[seat].coins = static_cast<uint16_t>(player->coins());
+        }
+    }
+
+    void Table::describeChanges(Message& out) {
+        describe(out);
+        if (published_count == out.seat_count) {
+            out.changed = 0;
+            for (uint8_t seat = 0; seat < out.seat_count; seat++) {
+                if (out.seats[seat] != published[seat]) {
+                    out.changed |= static_cast<uint8_t>(1u << seat);
+                }
+            }
+        }
+        std::copy(out.seats, out.seats + out.seat_count, published);
+        published_count = out.seat_count;
+    }
+
+    void Table::describeSetup(Message& out, uint16_t hash_interval) const {
+        out.type = MessageType::SETUP;
+        out.table = id;
+        out.seed = seed;
+        out.max_steps = max_steps;
+        out.hash_interval = hash_interval;
+        out.rules = game.getRules();
+        out.hash = match ? match->stateHash() : 0;
+        out.seat_count = static_cast<uint8_t>(roster.size());
+        for (size_t seat = 0; seat < roster.size(); seat++) {
+            out.seats[seat].role = static_cast<uint8_t>(game.getPlayer(seat)->getRole());
+        }
+    }
+
+    void Table::describeEvent(Message& out, uint16_t hash_interval) const {
+        out.type = MessageType::ACTION;
+        out.table = id;
+        out.step = events;
+        out.move = last_move;
+        out.expiry = last_expiry;
+        out.has_hash = match && ((hash_interval > 0 && events % hash_interval == 0) || match->isOver());
+        out.hash = out.has_hash ? match->stateHash() : 0;
+    }
+}
@@ -0,0 +1,395 @@
+// Email: razcohenp@gmail.com
+
+// TableLog.cpp - Record encoding, group commit, checkpoints and recovery of the write-ahead log
+// A record is its length and checksum, a type byte and a fixed body; integers are little-endian
+
+#include "../../include/server/TableLog.hpp"
+#include "../../include/server/WireFormat.hpp"
+
+#include <algorithm> // For std::sort
+#include <cerrno> // For errno
+#include <cstddef> // For offsetof
+#include <cstdio> // For std::snprintf and std::sscanf
+#include <cstring> // For std::memcpy and std::strerror
+#include <dirent.h> // For listing the segments
+#include <fcntl.h> // For open
+#include <map> // For the tables under replay
+#include <stdexcept> // For exception handling
+#include <type_traits> // For std::is_trivially_copyable
+#include <unistd.h> // For write, fdatasync and unlink
+#include <unordered_set> // For tables whose replay failed
+
+namespace coup {
+    namespace {
+        enum RecordType : uint8_t {
+            SNAPSHOT = 1, // Full table: settings, seats, game and match state, last event
+            EVENT = 2, // One move or window expiry of a table
+            END = 3 // The table finished
+        };
+
+        constexpr size_t FILE_HEADER_SIZE = 8; // Magic, version, shard, reserved
+        constexpr size_t RECORD_HEADER_SIZE = 8; // Length of type and body, checksum
+        constexpr size_t GAME_BYTES = offsetof(GameSnapshot, rng); // The generator is only used before the start
+
+        static_assert(std::is_trivially_copyable<MatchState>::value, "MatchState must be memcpy-able");
+
+        [[noreturn]] void throwSystemError(const std::string& what) {
+            throw std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        // FNV-1a over the type and body of a record
+        uint32_t checksum(const uint8_t* data, size_t size) {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; i++) {
+                hash = (hash ^ data[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        struct Segment {
+            std::string name;
+            uint32_t generation;
+            unsigned shard;
+            uint32_t number;
+        };
+
+        // Segment files of a directory, in name order (generation, shard, segment)
+        std::vector<Segment> listSegments(const std::string& directory) {
+            DIR* listing = ::opendir(directory.c_str());
+            if (!listing) {
+                throwSystemError("Cannot open log directory " + directory);
+            }
+            std::vector<Segment> segments;
+            while (const dirent* entry = ::readdir(listing)) {
+                Segment segment{entry->d_name, 0, 0, 0};
+                char suffix[8] = {};
+                if (std::sscanf(entry->d_name, "g%8u-s%3u-%8u%7s", &segment.generation, &segment.shard,
+                                &segment.number, suffix) == 4 && std::string(suffix) == ".wal") {
+                    segments.push_back(segment);
+                }
+            }
+            ::closedir(listing);
+            std::sort(segments.begin(), segments.end(),
+                      [](const Segment& a, const Segment& b) { return a.name < b.name; });
+            return segments;
+        }
+
+        void syncDirectory(const std::string& directory) {
+            const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd >= 0) {
+                ::fsync(fd); // Makes the new segment's name durable
+                ::close(fd);
+            }
+        }
+
+        bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+            out.clear();
+            uint8_t chunk[1 << 16];
+            ssize_t got;
+            while ((got = ::read(fd, chunk, sizeof(chunk))) != 0) {
+                if (got < 0) {
+                    if (errno == EINTR) continue;
+                    ::close(fd);
+                    return false;
+                }
+                out.insert(out.end(), chunk, chunk + got);
+            }
+            ::close(fd);
+            return true;
+        }
+
+        // Replay state of all tables found so far
+        struct Replay {
+            std::map<uint32_t, std::unique_ptr<Table>> tables; // Rebuilt tables by id
+            std::unordered_set<uint32_t> broken; // Tables whose events stopped fitting, until their next snapshot
+            GameSnapshot snapshot; // Scratch
+        };
+
+        void applySnapshot(Replay& replay, WireReader& reader) {
+            const uint32_t id = reader.get32();
+            const uint32_t seed = reader.get32();
+            const uint32_t max_steps = reader.get32();
+            GameRules rules;
+            for (size_t field = 0; field < RULE_FIELDS; field++) {
+                *ruleFields(rules, field) = static_cast<int32_t>(reader.get32());
+            }
+            const uint32_t events = reader.get32();
+            const bool last_expiry = reader.get8() != 0;
+            const Move last_move = reader.getMove();
+            GameSnapshot& snapshot = replay.snapshot;
+            reader.getBytes(&snapshot, GAME_BYTES);
+            MatchState state;
+            reader.getBytes(&state, sizeof(state));
+            if (snapshot.header.player_count < 2 || snapshot.header.player_count > SNAPSHOT_MAX_PLAYERS ||
+                snapshot.header.rng_size != 0) {
+                throw std::invalid_argument("Invalid table snapshot");
+            }
+            uint64_t tokens[SNAPSHOT_MAX_PLAYERS] = {};
+            for (uint8_t seat = 0; seat < snapshot.header.player_count; seat++) {
+                tokens[seat] = reader.get64();
+            }
+
+            replay.tables.erase(id);
+            replay.broken.insert(id); // Until the table is rebuilt
+            std::unique_ptr<Table> table(new Table(id, max_steps, rules, seed));
+            try {
+                for (uint8_t seat = 0; seat < snapshot.header.player_count; seat++) {
+                    const PlayerRecord& record = snapshot.players[seat];
+                    const std::string name(record.name, strnlen(record.name, SNAPSHOT_NAME_SIZE));
+                    table->join(name, static_cast<RoleType>(record.role), tokens[seat]);
+                }
+                table->start();
+                table->restore(snapshot, state, events, last_move, last_expiry);
+            }
+            catch (const std::exception&) {
+                return; // Stays broken
+            }
+            replay.broken.erase(id);
+            replay.tables[id] = std::move(table);
+        }
+
+        void applyEvent(Replay& replay, WireReader& reader) {
+            const uint32_t id = reader.get32();
+            const uint32_t event = reader.get32();
+            const bool expiry = reader.get8() != 0;
+            const Move move = reader.getMove();
+            auto found = replay.tables.find(id);
+            if (found == replay.tables.end()) {
+                return; // Finished, broken, or started in a segment that is gone
+            }
+            Table& table = *found->second;
+            if (event <= table.eventCount()) {
+                return; // Already part of the snapshot
+            }
+            bool applied = event == table.eventCount() + 1;
+            if (applied) {
+                try {
+                    if (expiry) {
+                        applied = table.getMatch()->inReactionWindow();
+                        table.expireWindow();
+                    }
+                    else {
+                        table.play(move.action.actor, move);
+                    }
+                }
+                catch (const std::exception&) {
+                    applied = false;
+                }
+            }
+            if (!applied) {
+                replay.broken.insert(id);
+                replay.tables.erase(found);
+            }
+        }
+
+        // Replays one segment; returns false when it ended in a partial or corrupt record
+        bool replaySegment(Replay& replay, const std::vector<uint8_t>& data, RecoveryStats& stats) {
+            if (data.size() < FILE_HEADER_SIZE) {
+                return false;
+            }
+            WireReader header(data.data(), FILE_HEADER_SIZE, "log segment header");
+            if (header.get32() != TABLE_LOG_MAGIC || header.get16() != TABLE_LOG_VERSION) {
+                return false;
+            }
+            size_t offset = FILE_HEADER_SIZE;
+            while (offset < data.size()) {
+                if (data.size() - offset < RECORD_HEADER_SIZE) {
+                    return false;
+                }
+                WireReader frame(data.data() + offset, RECORD_HEADER_SIZE, "log record");
+                const uint32_t length = frame.get32();
+                const uint32_t sum = frame.get32();
+                const uint8_t* record = data.data() + offset + RECORD_HEADER_SIZE;
+                if (length == 0 || length > data.size() - offset - RECORD_HEADER_SIZE || checksum(record, length) != sum) {
+                    return false;
+                }
+                WireReader reader(record + 1, length - 1, "log record");
+                try {
+                    switch (record[0]) {
+                        case SNAPSHOT: applySnapshot(replay, reader); break;
+                        case EVENT: applyEvent(replay, reader); break;
+                        case END: {
+                            const uint32_t id = reader.get32();
+                            replay.tables.erase(id);
+                            replay.broken.erase(id);
+                            break;
+                        }
+                        default: return false;
+                    }
+                }
+                catch (const std::invalid_argument&) {
+                    return false;
+                }
+                stats.records++;
+                offset += RECORD_HEADER_SIZE + length;
+            }
+            return true;
+        }
+    }
+
+    TableLog::TableLog(const std::string& directory, uint8_t shard, uint32_t generation, size_t segment_limit, bool sync)
+    : directory(directory), shard(shard), generation(generation), segment_limit(segment_limit), sync(sync), fd(-1),
+      segment(0), logged_bytes(0), records(0), syncs(0) {}
+
+    TableLog::~TableLog() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    std::string TableLog::segmentPath(uint32_t number) const {
+        char name[40];
+        std::snprintf(name, sizeof(name), "g%08u-s%03u-%08u.wal", generation, static_cast<unsigned>(shard), number);
+        return directory + "/" + name;
+    }
+
+    size_t TableLog::beginRecord(uint8_t type) {
+        const size_t start = pending.size();
+        put32(pending, 0); // Length and checksum are patched by endRecord
+        put32(pending, 0);
+        put8(pending, type);
+        return start;
+    }
+
+    void TableLog::endRecord(size_t start) {
+        const size_t length = pending.size() - start - RECORD_HEADER_SIZE;
+        patch32(pending, start, static_cast<uint32_t>(length));
+        patch32(pending, start + 4, checksum(pending.data() + start + RECORD_HEADER_SIZE, length));
+        records++;
+    }
+
+    void TableLog::logSnapshot(const Table& table) {
+        const size_t start = beginRecord(SNAPSHOT);
+        put32(pending, table.getId());
+        put32(pending, table.getSeed());
+        put32(pending, table.getMaxSteps());
+        GameRules rules = table.getGame().getRules();
+        for (size_t field = 0; field < RULE_FIELDS; field++) {
+            put32(pending, static_cast<uint32_t>(*ruleFields(rules, field)));
+        }
+        put32(pending, table.eventCount());
+        put8(pending, table.lastWasExpiry() ? 1 : 0);
+        putMove(pending, table.getLastMove());
+        table.getGame().saveSnapshot(scratch, false);
+        putBytes(pending, &scratch, GAME_BYTES);
+        putBytes(pending, &table.getMatch()->getState(), sizeof(MatchState));
+        for (uint8_t seat = 0; seat < table.seatCount(); seat++) {
+            put64(pending, table.getToken(seat)); // Lets the original clients reclaim their seats after a restart
+        }
+        endRecord(start);
+    }
+
+    void TableLog::logEvent(const Table& table) {
+        const size_t start = beginRecord(EVENT);
+        put32(pending, table.getId());
+        put32(pending, table.eventCount());
+        put8(pending, table.lastWasExpiry() ? 1 : 0);
+        putMove(pending, table.getLastMove());
+        endRecord(start);
+    }
+
+    void TableLog::logEnd(uint32_t table) {
+        const size_t start = beginRecord(END);
+        put32(pending, table);
+        endRecord(start);
+    }
+
+    void TableLog::writePending(bool durable) {
+        if (fd < 0) {
+            throw std::runtime_error("Log has no segment before its first checkpoint");
+        }
+        size_t offset = 0;
+        while (offset < pending.size()) {
+            const ssize_t written = ::write(fd, pending.data() + offset, pending.size() - offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throwSystemError("Cannot write the table log");
+            }
+            offset += static_cast<size_t>(written);
+        }
+        if (durable && ::fdatasync(fd) < 0) {
+            throwSystemError("Cannot sync the table log");
+        }
+        logged_bytes += pending.size();
+        pending.clear();
+        syncs++;
+    }
+
+    bool TableLog::commit() {
+        if (pending.empty()) {
+            return false;
+        }
+        writePending(sync);
+        return true;
+    }
+
+    void TableLog::checkpoint(const std::vector<const Table*>& running) {
+        if (fd >= 0) {
+            commit();
+        }
+        const uint32_t previous = segment;
+        const int next = ::open(segmentPath(segment + 1).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (next < 0) {
+            throwSystemError("Cannot create table log segment in " + directory);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = next;
+        segment++;
+
+        pending.clear();
+        put32(pending, TABLE_LOG_MAGIC);
+        put16(pending, TABLE_LOG_VERSION);
+        put8(pending, shard);
+        put8(pending, 0);
+        for (const Table* table : running) {
+            logSnapshot(*table);
+        }
+        writePending(true); // Older segments are deleted next, so this one must reach the disk whatever sync says
+        logged_bytes = 0;
+        syncDirectory(directory);
+        if (previous > 0) {
+            ::unlink(segmentPath(previous).c_str()); // Everything in it is covered by the new snapshots
+        }
+    }
+
+    uint32_t TableLog::recover(const std::string& directory, std::vector<std::unique_ptr<Table>>& tables,
+                               RecoveryStats& stats) {
+        stats = RecoveryStats();
+        uint32_t last_generation = 0;
+        Replay replay;
+        std::vector<uint8_t> data;
+        for (const Segment& segment : listSegments(directory)) {
+            last_generation = std::max(last_generation, segment.generation);
+            if (!readFile(directory + "/" + segment.name, data)) {
+                throwSystemError("Cannot read table log segment " + segment.name);
+            }
+            stats.segments++;
+            if (!replaySegment(replay, data, stats)) {
+                stats.torn++;
+            }
+        }
+
+        for (auto& entry : replay.tables) {
+            if (!entry.second->isOver()) { // A finished table whose END was lost stays finished
+                tables.push_back(std::move(entry.second));
+                stats.tables++;
+            }
+        }
+        stats.dropped = replay.broken.size();
+        return last_generation + 1;
+    }
+
+    void TableLog::removeGenerations(const std::string& directory, uint32_t before) {
+        for (const Segment& segment : listSegments(directory)) {
+            if (segment.generation < before) {
+                ::unlink((directory + "/" + segment.name).c_str());
+            }
+        }
+    }
+}
@@ -0,0 +1,1185 @@
+// Email: razcohenp@gmail.com
+
+// TableShard.cpp - Per-thread event loop, table ownership, table queues and cross-shard forwarding
+// Sockets are non-blocking and level-triggered; EPOLLOUT is armed only while output is pending.
+// Spectator updates are shared frames written with sendmsg behind the connection's own output
+
+#include "../../include/server/TableShard.hpp"
+#include "../../include/server/GameServer.hpp"
+
+#include <algorithm> // For std::remove_if and std::min
+#include <cerrno> // For errno
+#include <climits> // For INT_MAX
+#include <cstring> // For std::strerror and std::memcpy
+#include <netinet/in.h> // For IPPROTO_TCP
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <stdexcept> // For exception handling
+#include <string> // For player names
+#include <sys/epoll.h> // For the event loop
+#include <sys/eventfd.h> // For waking the loop
+#include <sys/socket.h> // For sockets
+#include <sys/uio.h> // For iovec
+#include <unistd.h> // For close, read and write
+
+namespace coup {
+    namespace {
+        constexpr int MAX_EVENTS = 256; // Events taken per epoll_wait
+        constexpr size_t READ_CHUNK = 64 * 1024; // Bytes read per recv
+        constexpr size_t MAX_WRITE_PARTS = 64; // Buffers gathered per sendmsg
+
+        [[noreturn]] void throwSystemError(const std::string& what) {
+            throw std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        void watch(int epoll_fd, int fd, uint32_t events, int operation) {
+            epoll_event event{};
+            event.events = events;
+            event.data.fd = fd;
+            if (epoll_ctl(epoll_fd, operation, fd, &event) < 0) {
+                throwSystemError("epoll_ctl failed");
+            }
+        }
+    }
+
+    TableShard::TableShard(const ServerConfig& config, uint8_t index, uint8_t shard_count)
+    : config(config), index(index), shard_count(shard_count), overflow(shard_count), notify(shard_count, 0),
+      epoll_fd(-1), wake_fd(-1), handoff_fd(-1), next_handoff(0), running(true), generation(0),
+      epoch(std::chrono::steady_clock::now()), next_table(1) {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            throwSystemError("Cannot create epoll instance");
+        }
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd < 0) {
+            ::close(epoll_fd);
+            throwSystemError("Cannot create eventfd");
+        }
+        try {
+            watch(epoll_fd, wake_fd, EPOLLIN, EPOLL_CTL_ADD);
+        }
+        catch (...) {
+            ::close(wake_fd);
+            ::close(epoll_fd);
+            throw;
+        }
+        std::random_device device;
+        token_source.seed((static_cast<uint64_t>(device()) << 32) | device());
+    }
+
+    TableShard::~TableShard() {
+        // Drop the queue references still held here (the threads have stopped)
+        for (auto& entry : tables) {
+            if (entry.second.inbox) {
+                entry.second.inbox->release();
+            }
+        }
+        for (TableInbox* inbox : ready) {
+            inbox->release();
+        }
+        ShardMessage message;
+        for (uint8_t shard = 0; shard < outbox.size(); shard++) {
+            while (outbox[shard] && outbox[shard]->tryPop(message)) {
+                overflow[shard].push_back(message);
+            }
+            for (const ShardMessage& waiting : overflow[shard]) {
+                if (waiting.inbox) {
+                    waiting.inbox->release();
+                }
+                if (waiting.frame) {
+                    waiting.frame->release();
+                }
+            }
+        }
+
+        for (size_t fd = 0; fd < connections.size(); fd++) {
+            if (connections[fd]) {
+                for (const SeatEntry& entry : connections[fd]->seats) {
+                    if (entry.inbox) {
+                        entry.inbox->release();
+                    }
+                }
+                for (SharedFrame* frame : connections[fd]->frames) {
+                    frame->release();
+                }
+                ::close(static_cast<int>(fd));
+            }
+        }
+        for (int fd : listeners) {
+            ::close(fd);
+        }
+        ::close(wake_fd);
+        ::close(epoll_fd);
+    }
+
+    void TableShard::connect(const std::vector<TableShard*>& all) {
+        peers = all;
+        outbox.clear();
+        for (uint8_t shard = 0; shard < shard_count; shard++) {
+            outbox.emplace_back(shard == index ? nullptr : new SpscQueue<ShardMessage>(config.shard_queue_capacity));
+        }
+    }
+
+    void TableShard::listen(int fd, bool handoff) {
+        listeners.push_back(fd);
+        if (handoff) {
+            handoff_fd = fd;
+        }
+        watch(epoll_fd, fd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+
+    void TableShard::host(std::unique_ptr<Table> table) {
+        const uint32_t id = table->getId();
+        next_table = std::max(next_table, id / shard_count + 1); // New tables never reuse a recovered id
+        Hosted hosted;
+        hosted.table = std::move(table);
+        hosted.frozen = true; // No timeouts until its clients are back (armTimer skips frozen tables)
+        if (config.rejoin_grace_ms > 0) {
+            hosted.timer = timers.schedule(clock() + config.rejoin_grace_ms, id);
+        }
+        tables.emplace(id, std::move(hosted));
+    }
+
+    void TableShard::openLog(uint32_t generation) {
+        log.reset(new TableLog(config.wal_dir, index, generation, config.wal_segment_bytes, config.wal_sync));
+        checkpointLog();
+    }
+
+    void TableShard::stop() {
+        running.store(false);
+        wake();
+    }
+
+    void TableShard::wake() {
+        const uint64_t one = 1;
+        ssize_t written = ::write(wake_fd, &one, sizeof(one)); // Async-signal-safe
+        (void)written;
+    }
+
+    void TableShard::run() {
+        epoll_event events[MAX_EVENTS];
+        bool pending = false;
+        while (running.load()) {
+            const int count = epoll_wait(epoll_fd, events, MAX_EVENTS, waitTimeout(pending));
+            if (count < 0 && errno != EINTR) {
+                throwSystemError("epoll_wait failed");
+            }
+
+            for (int i = 0; i < count; i++) {
+                const int fd = events[i].data.fd;
+                const uint32_t flags = events[i].events;
+                if (fd == wake_fd) {
+                    uint64_t value;
+                    ssize_t drained = ::read(wake_fd, &value, sizeof(value));
+                    (void)drained;
+                    continue;
+                }
+                if (std::find(listeners.begin(), listeners.end(), fd) != listeners.end()) {
+                    acceptFrom(fd);
+                    continue;
+                }
+                if (static_cast<size_t>(fd) >= connections.size() || !connections[fd]) {
+                    continue; // Closed earlier in this round
+                }
+
+                if (flags & EPOLLIN) {
+                    readFrom(*connections[fd]);
+                }
+                else if (flags & (EPOLLERR | EPOLLHUP)) {
+                    close(fd);
+                    continue;
+                }
+                if ((flags & EPOLLOUT) && connections[fd]) {
+                    commitLog(); // Output queued earlier this round may describe logged events
+                    if (!flush(*connections[fd])) {
+                        close(fd);
+                    }
+                }
+            }
+
+            drainInbox();
+            expireTimers();
+            commitLog(); // Nothing this round described leaves before it is durable
+
+            // One write per client per round, however many messages it was sent
+            for (int fd : dirty) {
+                if (static_cast<size_t>(fd) >= connections.size() || !connections[fd]) {
+                    continue;
+                }
+                Connection& connection = *connections[fd];
+                connection.dirty = false;
+                const bool sent = flush(connection);
+                if (!sent || connection.closing) {
+                    close(fd);
+                }
+            }
+            dirty.clear();
+
+            // Spectators that lost updates and have drained watch again, starting from a full STATE
+            std::vector<int> drained;
+            drained.swap(resyncs);
+            for (int fd : drained) {
+                resync(fd);
+            }
+            pending = flushOutbox() || !dirty.empty();
+        }
+    }
+
+    void TableShard::adopt(int fd) {
+        const int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)); // Fails harmlessly on Unix sockets
+        if (static_cast<size_t>(fd) >= connections.size()) {
+            connections.resize(fd + 1);
+        }
+        connections[fd].reset(new Connection());
+        connections[fd]->fd = fd;
+        connections[fd]->generation = ++generation;
+        watch(epoll_fd, fd, EPOLLIN, EPOLL_CTL_ADD);
+        stats.accepted++;
+    }
+
+    void TableShard::acceptFrom(int listener) {
+        while (true) {
+            const int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return; // Nothing pending, or out of descriptors - retried on the next event
+            }
+            const uint8_t target = listener == handoff_fd ? next_handoff++ % shard_count : index;
+            if (target == index) {
+                adopt(fd);
+            }
+            else {
+                ShardMessage message;
+                message.kind = ShardMessage::ADOPT;
+                message.client.fd = fd;
+                post(target, message);
+            }
+        }
+    }
+
+    void TableShard::readFrom(Connection& connection) {
+        const int fd = connection.fd;
+        uint8_t chunk[READ_CHUNK];
+        while (true) {
+            const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received > 0) {
+                connection.input.insert(connection.input.end(), chunk, chunk + received);
+                if (static_cast<size_t>(received) < sizeof(chunk)) {
+                    break;
+                }
+                continue;
+            }
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            close(fd); // Orderly shutdown or a socket error
+            return;
+        }
+
+        size_t offset = 0;
+        try {
+            while (!connection.closing) {
+                const size_t used = decodeMessage(connection.input.data() + offset, connection.input.size() - offset, incoming);
+                if (used == 0) {
+                    break;
+                }
+                offset += used;
+                route(connection, incoming);
+            }
+        }
+        catch (const std::invalid_argument& e) {
+            replyError({index, connection.fd, connection.generation}, 0, ServerError::MALFORMED, e.what());
+            connection.closing = true;
+        }
+        connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    }
+
+    void TableShard::route(Connection& connection, const Message& message) {
+        if (message.type != MessageType::JOIN && message.type != MessageType::START && message.type != MessageType::MOVE &&
+            message.type != MessageType::WATCH && message.type != MessageType::REJOIN) {
+            throw std::invalid_argument("Server messages cannot be sent to the server");
+        }
+        stats.requests++;
+        if (message.type == MessageType::WATCH &&
+            std::find(connection.watching.begin(), connection.watching.end(), message.table) != connection.watching.end()) {
+            replyError({index, connection.fd, connection.generation}, message.table, ServerError::SEAT_UNAVAILABLE,
+                       "Already watching this table");
+            return;
+        }
+
+        envelope.kind = ShardMessage::REQUEST;
+        envelope.client = {index, connection.fd, connection.generation};
+        envelope.table = message.table;
+        envelope.type = message.type;
+        envelope.role = message.role;
+        envelope.move = message.move;
+        envelope.seat = message.seat;
+        envelope.token = message.token;
+        envelope.length = 0;
+        if (message.type == MessageType::JOIN) { // The only request that carries text
+            envelope.length = static_cast<uint8_t>(message.text.size());
+            std::memcpy(envelope.bytes, message.text.data(), message.text.size());
+        }
+
+        // New tables (id 0) are created where the client is, so its own games never cross shards
+        const uint8_t owner = message.table == 0 ? index : static_cast<uint8_t>(message.table % shard_count);
+        if (owner == index) {
+            process(envelope.client, envelope);
+        }
+        else if (!enqueue(connection, envelope)) {
+            post(owner, envelope);
+        }
+    }
+
+    bool TableShard::enqueue(Connection& connection, const ShardMessage& message) {
+        TableInbox* inbox = nullptr;
+        for (const SeatEntry& entry : connection.seats) {
+            if (entry.table == message.table && entry.inbox) {
+                inbox = entry.inbox;
+                break;
+            }
+        }
+        if (!inbox) {
+            return false; // Not seated there (yet) - the owner answers through the shard queues
+        }
+
+        TableCommand command;
+        command.client = message.client;
+        command.type = message.type;
+        command.role = message.role;
+        command.move = message.move;
+        command.seat = message.seat;
+        command.token = message.token;
+        command.length = message.length;
+        std::memcpy(command.name, message.bytes, message.length);
+        if (!inbox->commands.tryPush(command)) {
+            stats.backpressured++;
+            replyError(message.client, message.table, ServerError::TABLE_BUSY);
+            return true;
+        }
+        stats.queued++;
+
+        // Only the first command since the owner's last drain rings its doorbell
+        if (!inbox->scheduled.exchange(true)) {
+            inbox->retain();
+            ShardMessage doorbell;
+            doorbell.kind = ShardMessage::SCHEDULE;
+            doorbell.table = message.table;
+            doorbell.inbox = inbox;
+            post(static_cast<uint8_t>(message.table % shard_count), doorbell);
+        }
+        return true;
+    }
+
+    void TableShard::drainTable(TableInbox* inbox) {
+        inbox->scheduled.store(false); // Commands pushed from here on ring again
+        TableCommand command;
+        // One batch per round, so a flooded table cannot starve the rest of the shard
+        for (size_t taken = 0; taken < inbox->commands.capacity() && inbox->commands.tryPop(command); taken++) {
+            envelope.kind = ShardMessage::REQUEST;
+            envelope.client = command.client;
+            envelope.table = inbox->table;
+            envelope.type = command.type;
+            envelope.role = command.role;
+            envelope.move = command.move;
+            envelope.seat = command.seat;
+            envelope.token = command.token;
+            envelope.length = command.length;
+            std::memcpy(envelope.bytes, command.name, command.length);
+            process(command.client, envelope);
+        }
+        if (inbox->commands.size() > 0 && !inbox->scheduled.exchange(true)) {
+            ready.push_back(inbox); // Keeps the doorbell's reference for the next round
+            return;
+        }
+        inbox->release();
+    }
+
+    void TableShard::process(const ClientRef& client, const ShardMessage& message) {
+        switch (message.type) {
+            case MessageType::JOIN: processJoin(client, message); break;
+            case MessageType::START: processStart(client, message); break;
+            case MessageType::MOVE: processMove(client, message); break;
+            case MessageType::WATCH: processWatch(client, message); break;
+            case MessageType::REJOIN: processRejoin(client, message); break;
+            default: break; // Filtered by route()
+        }
+    }
+
+    void TableShard::processJoin(const ClientRef& client, const ShardMessage& message) {
+        uint32_t id = message.table;
+        auto found = tables.find(id);
+        const bool created = found == tables.end();
+        if (created) {
+            if (tables.size() * shard_count >= config.max_tables) { // The limit is split evenly among shards
+                replyError(client, id, ServerError::TABLE_LIMIT);
+                return;
+            }
+            if (id == 0) { // This shard picks one of its free ids
+                do {
+                    id = next_table++ * shard_count + index;
+                } while (id == 0 || tables.count(id));
+            }
+            Hosted hosted;
+            hosted.table.reset(new Table(id, config.max_steps, config.rules, config.seed ^ (id * 0x9E3779B9u)));
+            found = tables.emplace(id, std::move(hosted)).first;
+        }
+
+        Hosted& hosted = found->second;
+        uint64_t token;
+        do {
+            token = token_source();
+        } while (token == 0); // 0 never reclaims a seat
+        uint8_t seat;
+        try {
+            seat = hosted.table->join(std::string(reinterpret_cast<const char*>(message.bytes), message.length), message.role,
+                                      token);
+        }
+        catch (const std::exception& e) {
+            replyError(client, id, ServerError::SEAT_UNAVAILABLE, e.what());
+            if (created) {
+                tables.erase(found);
+            }
+            return;
+        }
+        hosted.seats[seat] = client;
+
+        outgoing.type = MessageType::JOINED;
+        outgoing.table = id;
+        outgoing.seat = seat;
+        outgoing.token = token;
+        reply(client, outgoing, ShardMessage::SEATED, id, seat, shareInbox(hosted, client));
+    }
+
+    void TableShard::processRejoin(const ClientRef& client, const ShardMessage& message) {
+        auto found = tables.find(message.table);
+        if (found == tables.end()) {
+            replyError(client, message.table, ServerError::UNKNOWN_TABLE);
+            return;
+        }
+        Hosted& hosted = found->second;
+        Table& table = *hosted.table;
+        if (!table.ownsSeat(message.seat, message.token)) {
+            replyError(client, message.table, ServerError::SEAT_UNAVAILABLE, "Wrong seat token");
+            return;
+        }
+        hosted.seats[message.seat] = client; // A connection that still held it keeps nothing but a stale seat entry
+        stats.rejoins++;
+
+        outgoing.type = MessageType::JOINED;
+        outgoing.table = message.table;
+        outgoing.seat = message.seat;
+        outgoing.token = message.token;
+        reply(client, outgoing, ShardMessage::SEATED, message.table, message.seat, shareInbox(hosted, client));
+        if (table.isStarted()) {
+            table.describe(outgoing); // Catches the client up on whatever it missed
+            reply(client, outgoing);
+        }
+
+        if (hosted.frozen) {
+            bool reclaimed = true;
+            for (size_t seat = 0; seat < table.seatCount(); seat++) {
+                reclaimed = reclaimed && hosted.seats[seat].fd >= 0;
+            }
+            if (reclaimed) { // Every client is back, so the game runs on its usual deadlines
+                hosted.frozen = false;
+                armTimer(hosted);
+            }
+        }
+    }
+
+    TableInbox* TableShard::shareInbox(Hosted& hosted, const ClientRef& client) {
+        // A client of another shard gets the table queue for its later commands
+        if (client.shard == index) {
+            return nullptr;
+        }
+        if (!hosted.inbox) {
+            hosted.inbox = new TableInbox(hosted.table->getId(), config.table_queue_capacity);
+        }
+        hosted.inbox->retain();
+        return hosted.inbox;
+    }
+
+    void TableShard::processStart(const ClientRef& client, const ShardMessage& message) {
+        auto found = tables.find(message.table);
+        if (found == tables.end()) {
+            replyError(client, message.table, ServerError::UNKNOWN_TABLE);
+            return;
+        }
+        Hosted& hosted = found->second;
+        bool seated = false;
+        for (size_t seat = 0; seat < hosted.table->seatCount(); seat++) {
+            seated = seated || hosted.seats[seat] == client;
+        }
+        if (!seated) {
+            replyError(client, message.table, ServerError::NOT_SEATED);
+            return;
+        }
+        try {
+            hosted.table->start();
+        }
+        catch (const std::exception& e) {
+            replyError(client, message.table, ServerError::ILLEGAL_MOVE, e.what());
+            return;
+        }
+        broadcastState(hosted);
+    }
+
+    void TableShard::processMove(const ClientRef& client, const ShardMessage& message) {
+        auto found = tables.find(message.table);
+        if (found == tables.end()) {
+            replyError(client, message.table, ServerError::UNKNOWN_TABLE);
+            return;
+        }
+        Hosted& hosted = found->second;
+        Table& table = *hosted.table;
+        if (!table.isStarted()) {
+            replyError(client, message.table, ServerError::NOT_STARTED);
+            return;
+        }
+
+        // A client may hold several seats - it acts for the deciding one, else for one still waiting in the window
+        int seat = -1;
+        const Match& match = *table.getMatch();
+        const uint8_t deciding = match.decidingSeat();
+        if (deciding < table.seatCount() && hosted.seats[deciding] == client) {
+            seat = deciding;
+        }
+        for (size_t other = 0; seat < 0 && other < table.seatCount(); other++) {
+            if (hosted.seats[other] == client && match.mayAnswer(static_cast<uint8_t>(other))) {
+                seat = static_cast<int>(other);
+            }
+        }
+        for (size_t other = 0; seat < 0 && other < table.seatCount(); other++) {
+            if (hosted.seats[other] == client) {
+                seat = static_cast<int>(other); // Rejected by the match with the reason
+            }
+        }
+        if (seat < 0) {
+            replyError(client, message.table, ServerError::NOT_SEATED);
+            return;
+        }
+
+        try {
+            table.play(static_cast<uint8_t>(seat), message.move);
+        }
+        catch (const std::exception& e) {
+            replyError(client, message.table, ServerError::ILLEGAL_MOVE, e.what());
+            return;
+        }
+        stats.moves++;
+        broadcastState(hosted);
+        if (table.isOver()) {
+            finishTable(message.table);
+        }
+    }
+
+    void TableShard::processWatch(const ClientRef& client, const ShardMessage& message) {
+        auto found = tables.find(message.table);
+        if (found == tables.end()) {
+            replyError(client, message.table, ServerError::UNKNOWN_TABLE);
+            return;
+        }
+        Hosted& hosted = found->second;
+        Table& table = *hosted.table;
+        if (!table.isStarted()) {
+            replyError(client, message.table, ServerError::NOT_STARTED);
+            return;
+        }
+        if (hosted.watchers.empty()) {
+            hosted.watchers.assign(shard_count, 0);
+        }
+        if (hosted.watcher_total == 0 && config.lockstep_interval > 0) {
+            table.describeChanges(outgoing); // Lockstep seats get no STATE, so spectator deltas start from here
+        }
+        hosted.watchers[client.shard]++;
+        hosted.watcher_total++;
+        table.describe(outgoing);
+        reply(client, outgoing, ShardMessage::WATCHING, message.table);
+    }
+
+    void TableShard::unwatch(uint32_t table, uint8_t shard) {
+        auto found = tables.find(table);
+        if (found != tables.end() && !found->second.watchers.empty() && found->second.watchers[shard] > 0) {
+            found->second.watchers[shard]--;
+            found->second.watcher_total--;
+        }
+    }
+
+    void TableShard::publish(Hosted& hosted, bool final) {
+        if (hosted.watcher_total == 0) {
+            return;
+        }
+        const uint32_t id = hosted.table->getId();
+        SharedFrame* shared = SharedFrame::create(frame.data(), frame.size());
+        for (uint8_t shard = 0; shard < shard_count; shard++) {
+            if (hosted.watchers[shard] == 0) {
+                continue;
+            }
+            if (shard == index) {
+                fanOut(id, shared, final);
+                continue;
+            }
+            shared->retain();
+            ShardMessage message;
+            message.kind = ShardMessage::FANOUT;
+            message.effect = final ? ShardMessage::FINAL : ShardMessage::NO_EFFECT;
+            message.table = id;
+            message.frame = shared;
+            post(shard, message);
+        }
+        shared->release();
+    }
+
+    void TableShard::fanOut(uint32_t table, SharedFrame* shared, bool final) {
+        auto found = spectating.find(table);
+        if (found == spectating.end()) {
+            return;
+        }
+        for (const Spectator& spectator : found->second) {
+            Connection* connection = find({index, spectator.fd, spectator.generation});
+            if (!connection) {
+                continue;
+            }
+            queueFrame(*connection, shared);
+            if (final) {
+                auto& list = connection->watching;
+                list.erase(std::remove(list.begin(), list.end(), table), list.end());
+            }
+        }
+        if (final) {
+            spectating.erase(found);
+        }
+    }
+
+    void TableShard::queueFrame(Connection& connection, SharedFrame* shared) {
+        if (connection.lagging || connection.closing) {
+            return;
+        }
+        if (connection.frames.size() >= config.max_spectator_frames) {
+            if (!connection.seats.empty()) {
+                connection.closing = true; // A player must get every message - drop it as too slow
+                markDirty(connection);
+                return;
+            }
+            // Keep only the frame already on its way and catch up with a full STATE once it is out
+            const size_t keep = connection.frame_offset > 0 ? 1 : 0;
+            while (connection.frames.size() > keep) {
+                connection.frames.back()->release();
+                connection.frames.pop_back();
+            }
+            connection.lagging = true;
+            markDirty(connection);
+            return;
+        }
+        shared->retain();
+        connection.frames.push_back(shared);
+        stats.spectator_frames++;
+        markDirty(connection);
+    }
+
+    void TableShard::stopWatching(Connection& connection) {
+        for (uint32_t table : connection.watching) {
+            auto found = spectating.find(table);
+            if (found != spectating.end()) {
+                auto& list = found->second;
+                const int fd = connection.fd;
+                list.erase(std::remove_if(list.begin(), list.end(),
+                    [fd](const Spectator& spectator) { return spectator.fd == fd; }), list.end());
+                if (list.empty()) {
+                    spectating.erase(found);
+                }
+            }
+            const uint8_t owner = static_cast<uint8_t>(table % shard_count);
+            if (owner == index) {
+                unwatch(table, index);
+            }
+            else {
+                ShardMessage message;
+                message.kind = ShardMessage::UNWATCH;
+                message.client = {index, connection.fd, connection.generation};
+                message.table = table;
+                post(owner, message);
+            }
+        }
+        connection.watching.clear();
+    }
+
+    void TableShard::resync(int fd) {
+        if (static_cast<size_t>(fd) >= connections.size() || !connections[fd] || !connections[fd]->lagging) {
+            return;
+        }
+        Connection& connection = *connections[fd];
+        connection.lagging = false;
+        const std::vector<uint32_t> tables_watched = connection.watching;
+        stopWatching(connection);
+        stats.resyncs++;
+        for (uint32_t table : tables_watched) {
+            envelope.kind = ShardMessage::REQUEST;
+            envelope.client = {index, fd, connection.generation};
+            envelope.table = table;
+            envelope.type = MessageType::WATCH;
+            envelope.length = 0;
+            const uint8_t owner = static_cast<uint8_t>(table % shard_count);
+            if (owner == index) {
+                processWatch(envelope.client, envelope);
+            }
+            else {
+                post(owner, envelope);
+            }
+        }
+    }
+
+    void TableShard::detach(uint32_t table, uint8_t seat, const ClientRef& client) {
+        auto found = tables.find(table);
+        if (found != tables.end() && found->second.seats[seat] == client) {
+            found->second.seats[seat] = ClientRef();
+        }
+    }
+
+    void TableShard::broadcastState(Hosted& hosted) {
+        Table& table = *hosted.table;
+        if (log) {
+            if (table.eventCount() == 0) {
+                log->logSnapshot(table);
+            }
+            else {
+                log->logEvent(table);
+            }
+        }
+        if (config.lockstep_interval == 0) {
+            hosted.table->describeChanges(outgoing);
+        }
+        else if (table.eventCount() == 0) {
+            table.describeSetup(outgoing, config.lockstep_interval);
+        }
+        else {
+            table.describeEvent(outgoing, config.lockstep_interval); // Replicas replay it; no state is sent
+        }
+        frame.clear();
+        encodeMessage(outgoing, frame);
+        replyToSeats(hosted, ShardMessage::NO_EFFECT);
+        if (hosted.watcher_total > 0) {
+            if (config.lockstep_interval > 0) { // Spectators get deltas, not the action stream
+                table.describeChanges(outgoing);
+                frame.clear();
+                encodeMessage(outgoing, frame);
+            }
+            publish(hosted, false);
+        }
+        armTimer(hosted);
+    }
+
+    void TableShard::armTimer(Hosted& hosted) {
+        if (hosted.frozen) {
+            return; // The grace timer stays until the seats are reclaimed
+        }
+        const Table& table = *hosted.table;
+        const bool window = table.isStarted() && table.getMatch()->inReactionWindow();
+        if (window && hosted.timing_window && hosted.timer) {
+            return; // One deadline covers the whole window, however many seats answer before it
+        }
+        if (hosted.timer) {
+            timers.cancel(hosted.timer);
+            hosted.timer = 0;
+        }
+        if (!table.isStarted() || table.isOver()) {
+            return;
+        }
+        const uint32_t limit = window ? config.reaction_timeout_ms : config.turn_timeout_ms;
+        if (limit > 0) {
+            hosted.timer = timers.schedule(clock() + limit, table.getId());
+            hosted.timing_window = window;
+        }
+    }
+
+    void TableShard::expireTimers() {
+        if (timers.size() == 0) {
+            return;
+        }
+        expired.clear();
+        timers.advance(clock(), expired);
+        for (uint64_t id : expired) {
+            auto found = tables.find(static_cast<uint32_t>(id));
+            if (found == tables.end()) {
+                continue;
+            }
+            Hosted& hosted = found->second;
+            Table& table = *hosted.table;
+            hosted.timer = 0;
+            if (hosted.frozen) { // The grace period is over; timeouts play the seats nobody reclaimed
+                hosted.frozen = false;
+                armTimer(hosted);
+                continue;
+            }
+            try {
+                if (table.getMatch()->inReactionWindow()) {
+                    table.expireWindow(); // Every silent seat passes at once
+                }
+                else {
+                    table.play(table.getMatch()->decidingSeat(), table.defaultMove());
+                }
+            }
+            catch (const std::exception&) {
+                continue; // No default move fits (cannot happen with Match's rules); the seat keeps waiting
+            }
+            stats.moves++;
+            stats.timeouts++;
+            broadcastState(hosted);
+            if (table.isOver()) {
+                finishTable(table.getId());
+            }
+        }
+    }
+
+    void TableShard::commitLog() {
+        if (!log || !log->commit()) {
+            return;
+        }
+        stats.logged = log->recordCount();
+        stats.log_syncs = log->syncCount();
+        if (log->needsCheckpoint()) {
+            checkpointLog();
+        }
+    }
+
+    void TableShard::checkpointLog() {
+        std::vector<const Table*> running;
+        running.reserve(tables.size());
+        for (const auto& entry : tables) {
+            const Table& table = *entry.second.table;
+            if (table.isStarted() && !table.isOver()) {
+                running.push_back(&table);
+            }
+        }
+        log->checkpoint(running);
+        stats.logged = log->recordCount();
+        stats.log_syncs = log->syncCount();
+    }
+
+    int TableShard::waitTimeout(bool pending) {
+        int timeout = pending ? 1 : -1;
+        if (timers.size() > 0) {
+            const uint64_t due = timers.now() + timers.ticksUntilNext();
+            const uint64_t now = clock();
+            const uint64_t wait = due > now ? std::min<uint64_t>(due - now, INT_MAX) : 0;
+            timeout = timeout < 0 ? static_cast<int>(wait) : std::min(timeout, static_cast<int>(wait));
+        }
+        return timeout;
+    }
+
+    uint64_t TableShard::clock() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    void TableShard::finishTable(uint32_t id) {
+        auto found = tables.find(id);
+        if (log) {
+            log->logEnd(id);
+        }
+        outgoing.type = MessageType::GAME_OVER;
+        outgoing.table = id;
+        outgoing.seat = found->second.table->winner();
+        frame.clear();
+        encodeMessage(outgoing, frame);
+        replyToSeats(found->second, ShardMessage::RELEASED);
+        publish(found->second, true);
+        if (found->second.timer) {
+            timers.cancel(found->second.timer);
+        }
+        if (found->second.inbox) {
+            found->second.inbox->release();
+        }
+        tables.erase(found);
+        stats.games_finished++;
+    }
+
+    void TableShard::replyToSeats(Hosted& hosted, ShardMessage::Effect effect) {
+        const size_t seats = hosted.table->seatCount();
+        for (size_t seat = 0; seat < seats; seat++) {
+            const ClientRef& client = hosted.seats[seat];
+            bool repeated = client.fd < 0;
+            for (size_t earlier = 0; earlier < seat && !repeated; earlier++) {
+                repeated = hosted.seats[earlier] == client;
+            }
+            if (!repeated) {
+                deliver(client, frame.data(), frame.size(), effect, hosted.table->getId(), static_cast<uint8_t>(seat));
+            }
+        }
+    }
+
+    void TableShard::reply(const ClientRef& client, const Message& message, ShardMessage::Effect effect,
+                           uint32_t table, uint8_t seat, TableInbox* inbox) {
+        frame.clear();
+        encodeMessage(message, frame);
+        deliver(client, frame.data(), frame.size(), effect, table, seat, inbox);
+    }
+
+    void TableShard::replyError(const ClientRef& client, uint32_t table, ServerError error, const char* text) {
+        stats.rejected++;
+        outgoing.type = MessageType::ERROR;
+        outgoing.table = table;
+        outgoing.error = error;
+        outgoing.text = text ? text : getServerErrorMessage(error);
+        reply(client, outgoing);
+    }
+
+    void TableShard::deliver(const ClientRef& client, const uint8_t* data, size_t size, ShardMessage::Effect effect,
+                             uint32_t table, uint8_t seat, TableInbox* inbox) {
+        if (client.shard != index) {
+            ShardMessage message;
+            message.kind = ShardMessage::REPLY;
+            message.effect = effect;
+            message.client = client;
+            message.table = table;
+            message.seat = seat;
+            message.size = static_cast<uint16_t>(size);
+            message.inbox = inbox;
+            std::memcpy(message.bytes, data, size);
+            post(client.shard, message);
+            return;
+        }
+
+        Connection* connection = find(client);
+        if (!connection || connection->closing) {
+            if (inbox) {
+                inbox->release();
+            }
+            if (effect == ShardMessage::WATCHING) { // Nobody is left to count as a spectator
+                const uint8_t owner = static_cast<uint8_t>(table % shard_count);
+                if (owner == index) {
+                    unwatch(table, index);
+                }
+                else {
+                    ShardMessage message;
+                    message.kind = ShardMessage::UNWATCH;
+                    message.client = client;
+                    message.table = table;
+                    post(owner, message);
+                }
+            }
+            return; // The client left while the reply was on its way
+        }
+        if (effect == ShardMessage::SEATED) {
+            connection->seats.push_back({table, seat, inbox});
+        }
+        else if (effect == ShardMessage::RELEASED) {
+            releaseSeats(*connection, table);
+        }
+        else if (effect == ShardMessage::WATCHING) {
+            spectating[table].push_back({connection->fd, connection->generation});
+            connection->watching.push_back(table);
+        }
+        if (!connection->frames.empty()) { // Stays behind the spectator updates already queued
+            connection->frames.push_back(SharedFrame::create(data, size));
+            markDirty(*connection);
+            return;
+        }
+        connection->output.insert(connection->output.end(), data, data + size);
+        if (connection->output.size() - connection->output_offset > config.max_output) {
+            connection->closing = true; // Not reading its messages - drop it instead of buffering forever
+        }
+        markDirty(*connection);
+    }
+
+    void TableShard::releaseSeats(Connection& connection, uint32_t table) {
+        auto& list = connection.seats;
+        for (const SeatEntry& entry : list) {
+            if (entry.table == table && entry.inbox) {
+                entry.inbox->release();
+            }
+        }
+        list.erase(std::remove_if(list.begin(), list.end(),
+            [table](const SeatEntry& entry) { return entry.table == table; }), list.end());
+    }
+
+    void TableShard::post(uint8_t shard, const ShardMessage& message) {
+        std::vector<ShardMessage>& waiting = overflow[shard];
+        // While log records are uncommitted everything waits, so no peer hears of an event before it is durable
+        if (!waiting.empty() || (log && log->hasPending()) || !outbox[shard]->tryPush(message)) {
+            waiting.push_back(message); // Keeps the order behind earlier overflow
+        }
+        notify[shard] = 1;
+        stats.forwarded++;
+    }
+
+    void TableShard::drainInbox() {
+        std::vector<TableInbox*> again;
+        again.swap(ready);
+        for (TableInbox* inbox : again) {
+            drainTable(inbox);
+        }
+
+        ShardMessage message;
+        for (uint8_t from = 0; from < shard_count; from++) {
+            if (from == index) continue;
+            SpscQueue<ShardMessage>& inbox = inboxFrom(from);
+            // Bounded per round so one busy peer cannot starve this shard's own clients
+            for (size_t taken = 0; taken < inbox.capacity() && inbox.tryPop(message); taken++) {
+                switch (message.kind) {
+                    case ShardMessage::ADOPT:
+                        adopt(message.client.fd);
+                        break;
+                    case ShardMessage::REQUEST:
+                        process(message.client, message);
+                        break;
+                    case ShardMessage::REPLY:
+                        deliver(message.client, message.bytes, message.size, message.effect, message.table, message.seat,
+                                message.inbox);
+                        break;
+                    case ShardMessage::DETACH:
+                        detach(message.table, message.seat, message.client);
+                        break;
+                    case ShardMessage::SCHEDULE:
+                        drainTable(message.inbox);
+                        break;
+                    case ShardMessage::FANOUT:
+                        fanOut(message.table, message.frame, message.effect == ShardMessage::FINAL);
+                        message.frame->release();
+                        break;
+                    case ShardMessage::UNWATCH:
+                        unwatch(message.table, message.client.shard);
+                        break;
+                }
+            }
+        }
+    }
+
+    bool TableShard::flushOutbox() {
+        bool pending = false;
+        for (uint8_t shard = 0; shard < shard_count; shard++) {
+            std::vector<ShardMessage>& waiting = overflow[shard];
+            if (!waiting.empty()) {
+                size_t pushed = 0;
+                while (pushed < waiting.size() && outbox[shard]->tryPush(waiting[pushed])) {
+                    pushed++;
+                }
+                waiting.erase(waiting.begin(), waiting.begin() + pushed);
+                pending = pending || !waiting.empty();
+            }
+            if (notify[shard]) {
+                notify[shard] = 0;
+                peers[shard]->wake();
+            }
+        }
+        // Peers may have queued more than one round takes
+        pending = pending || !ready.empty();
+        for (uint8_t from = 0; from < shard_count && !pending; from++) {
+            pending = from != index && inboxFrom(from).size() > 0;
+        }
+        return pending;
+    }
+
+    bool TableShard::flush(Connection& connection) {
+        std::vector<uint8_t>& output = connection.output;
+        std::deque<SharedFrame*>& frames = connection.frames;
+        iovec parts[MAX_WRITE_PARTS];
+        while (connection.output_offset < output.size() || !frames.empty()) {
+            // The connection's own bytes first, then the shared frames, in one call
+            size_t count = 0;
+            if (connection.output_offset < output.size()) {
+                parts[count++] = {output.data() + connection.output_offset, output.size() - connection.output_offset};
+            }
+            for (size_t i = 0; i < frames.size() && count < MAX_WRITE_PARTS; i++) {
+                const size_t skip = i == 0 ? connection.frame_offset : 0;
+                parts[count++] = {frames[i]->bytes + skip, frames[i]->size - skip};
+            }
+            msghdr header{};
+            header.msg_iov = parts;
+            header.msg_iovlen = count;
+            const ssize_t sent = ::sendmsg(connection.fd, &header, MSG_NOSIGNAL);
+            if (sent > 0) {
+                size_t left = static_cast<size_t>(sent);
+                const size_t own = std::min(left, output.size() - connection.output_offset);
+                connection.output_offset += own;
+                left -= own;
+                while (left > 0) {
+                    const size_t rest = frames.front()->size - connection.frame_offset;
+                    if (left < rest) {
+                        connection.frame_offset += left;
+                        break;
+                    }
+                    left -= rest;
+                    frames.front()->release();
+                    frames.pop_front();
+                    connection.frame_offset = 0;
+                }
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!connection.writing) {
+                    watch(epoll_fd, connection.fd, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+                    connection.writing = true;
+                }
+                if (connection.output_offset > output.size() / 2) { // Keep the pending tail at the front
+                    output.erase(output.begin(), output.begin() + connection.output_offset);
+                    connection.output_offset = 0;
+                }
+                return true;
+            }
+            return false;
+        }
+
+        output.clear();
+        connection.output_offset = 0;
+        if (connection.writing) {
+            watch(epoll_fd, connection.fd, EPOLLIN, EPOLL_CTL_MOD);
+            connection.writing = false;
+        }
+        if (connection.lagging) {
+            resyncs.push_back(connection.fd);
+        }
+        return true;
+    }
+
+    void TableShard::markDirty(Connection& connection) {
+        if (!connection.dirty) {
+            connection.dirty = true;
+            dirty.push_back(connection.fd);
+        }
+    }
+
+    void TableShard::close(int fd) {
+        std::unique_ptr<Connection>& slot = connections[fd];
+        const ClientRef client{index, fd, slot->generation};
+        for (const SeatEntry& entry : slot->seats) {
+            const uint8_t owner = static_cast<uint8_t>(entry.table % shard_count);
+            if (entry.inbox) {
+                entry.inbox->release();
+            }
+            if (owner == index) {
+                detach(entry.table, entry.seat, client);
+            }
+            else {
+                ShardMessage message;
+                message.kind = ShardMessage::DETACH;
+                message.client = client;
+                message.table = entry.table;
+                message.seat = entry.seat;
+                post(owner, message);
+            }
+        }
+        stopWatching(*slot);
+        for (SharedFrame* frame : slot->frames) {
+            frame->release();
+        }
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        slot.reset();
+        stats.closed++;
+    }
+
+    TableShard::Connection* TableShard::find(const ClientRef& client) {
+        if (client.fd < 0 || static_cast<size_t>(client.fd) >= connections.size()) {
+            return nullptr;
+        }
+        Connection* connection = connections[client.fd].get();
+        return connection && connection->generation == client.generation ? connection : nullptr;
+    }
+}
@@ -0,0 +1,161 @@
+// Email: razcohenp@gmail.com
+
+// TimerWheel.cpp - Slot placement, cascading and expiry of the hierarchical timing wheel
+
+#include "../../include/server/TimerWheel.hpp"
+
+#include <algorithm> // For std::max
+#include <limits> // For std::numeric_limits
+
+namespace coup {
+    TimerWheel::TimerWheel(uint64_t start) : free_head(NIL), current(start), count(0) {
+        for (unsigned slot = 0; slot <= OVERFLOW_SLOT; slot++) {
+            heads[slot] = NIL;
+            tails[slot] = NIL;
+        }
+        for (unsigned level = 0; level < LEVELS; level++) {
+            occupied[level] = 0;
+        }
+    }
+
+    TimerId TimerWheel::schedule(uint64_t due, uint64_t payload) {
+        uint32_t node = free_head;
+        if (node == NIL) {
+            node = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node{0, 0, NIL, NIL, 0, FREE});
+        }
+        else {
+            free_head = nodes[node].next;
+        }
+        Node& timer = nodes[node];
+        timer.due = due;
+        timer.payload = payload;
+        timer.generation++;
+        link(node);
+        count++;
+        return static_cast<TimerId>(timer.generation) << 32 | node;
+    }
+
+    bool TimerWheel::cancel(TimerId id) {
+        const uint32_t node = static_cast<uint32_t>(id);
+        if (node >= nodes.size() || nodes[node].slot == FREE || nodes[node].generation != static_cast<uint32_t>(id >> 32)) {
+            return false;
+        }
+        unlink(node);
+        nodes[node].next = free_head;
+        free_head = node;
+        count--;
+        return true;
+    }
+
+    void TimerWheel::advance(uint64_t now, std::vector<uint64_t>& expired) {
+        while (current <= now) {
+            if (count == 0) { // Nothing can expire, so no slot needs visiting
+                current = now + 1;
+                return;
+            }
+
+            // Every wrap of a level pulls the next slot of the levels above down
+            if ((current & (SLOTS - 1)) == 0) {
+                if ((current & ((uint64_t(1) << (SLOT_BITS * LEVELS)) - 1)) == 0) {
+                    cascade(LEVELS);
+                }
+                for (unsigned level = LEVELS - 1; level >= 1; level--) {
+                    if ((current & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+                        cascade(level);
+                    }
+                }
+            }
+
+            const unsigned index = static_cast<unsigned>(current & (SLOTS - 1));
+            while (heads[index] != NIL) {
+                const uint32_t node = heads[index];
+                expired.push_back(nodes[node].payload);
+                unlink(node);
+                nodes[node].next = free_head;
+                free_head = node;
+                count--;
+            }
+
+            // Skip straight to the next occupied slot or cascade point of the lowest level
+            const uint64_t ahead = index + 1 < SLOTS ? occupied[0] >> (index + 1) << (index + 1) : 0;
+            const uint64_t block = current & ~uint64_t(SLOTS - 1);
+            const uint64_t next = ahead ? block + static_cast<unsigned>(__builtin_ctzll(ahead)) : block + SLOTS;
+            current = std::min(next, now + 1);
+        }
+    }
+
+    uint64_t TimerWheel::ticksUntilNext() const {
+        if (count == 0) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        const unsigned index = static_cast<unsigned>(current & (SLOTS - 1));
+        const uint64_t ahead = occupied[0] >> index;
+        return ahead ? static_cast<unsigned>(__builtin_ctzll(ahead)) : SLOTS - index;
+    }
+
+    void TimerWheel::link(uint32_t node) {
+        Node& timer = nodes[node];
+        const uint64_t due = std::max(timer.due, current);
+
+        // The lowest level whose current span (one turn of the slots below it) contains the due tick
+        unsigned slot = OVERFLOW_SLOT;
+        for (unsigned level = 0; level < LEVELS; level++) {
+            const unsigned span = SLOT_BITS * (level + 1);
+            if (due >> span == current >> span) {
+                const unsigned index = static_cast<unsigned>(due >> (SLOT_BITS * level)) & (SLOTS - 1);
+                slot = level * SLOTS + index;
+                occupied[level] |= uint64_t(1) << index;
+                break;
+            }
+        }
+
+        timer.slot = static_cast<uint16_t>(slot);
+        timer.next = NIL;
+        timer.prev = tails[slot];
+        if (tails[slot] == NIL) {
+            heads[slot] = node;
+        }
+        else {
+            nodes[tails[slot]].next = node;
+        }
+        tails[slot] = node;
+    }
+
+    void TimerWheel::unlink(uint32_t node) {
+        Node& timer = nodes[node];
+        const unsigned slot = timer.slot;
+        if (timer.prev == NIL) {
+            heads[slot] = timer.next;
+        }
+        else {
+            nodes[timer.prev].next = timer.next;
+        }
+        if (timer.next == NIL) {
+            tails[slot] = timer.prev;
+        }
+        else {
+            nodes[timer.next].prev = timer.prev;
+        }
+        if (heads[slot] == NIL && slot < OVERFLOW_SLOT) {
+            occupied[slot / SLOTS] &= ~(uint64_t(1) << (slot % SLOTS));
+        }
+        timer.slot = FREE;
+    }
+
+    void TimerWheel::cascade(unsigned level) {
+        const unsigned slot = level == LEVELS ? OVERFLOW_SLOT
+                                              : level * SLOTS + (static_cast<unsigned>(current >> (SLOT_BITS * level)) & (SLOTS - 1));
+        uint32_t node = heads[slot];
+        heads[slot] = NIL;
+        tails[slot] = NIL;
+        if (slot < OVERFLOW_SLOT) {
+            occupied[level] &= ~(uint64_t(1) << (slot % SLOTS));
+        }
+        while (node != NIL) {
+            const uint32_t next = nodes[node].next;
+            link(node); // Lands in a lower level now that the wheel has reached its span
+            node = next;
+        }
+    }
+}
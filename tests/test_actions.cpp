@@ -0,0 +1,133 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the compact action helpers
+ * Covers enumeration and dispatch of actions by seat index:
+ * - legalActions lists turn actions only for the current player
+ * - Mandatory coup and sanction rules are respected
+ * - Reactive abilities (block coup, block bribe, undo) are listed outside the turn
+ * - Every listed action can be applied without exceptions
+ */
+
+#include "doctest.h"
+#include <stdexcept>
+#include <algorithm>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Merchant.hpp"
+
+using namespace coup;
+
+// Check if a specific action is in the list
+static bool contains(const std::vector<Action>& actions, ActionType type, uint8_t actor, uint8_t target = NO_TARGET) {
+    return std::find(actions.begin(), actions.end(), Action{type, actor, target}) != actions.end();
+}
+
+TEST_CASE("Legal Action Enumeration") {
+    Game game;
+    Governor gov(game, "Alice"); // Seat 0
+    General general(game, "Bob"); // Seat 1
+    Judge judge(game, "Charlie"); // Seat 2
+    game.startGame();
+    std::vector<Action> actions;
+
+    SUBCASE("Turn actions only for the current player") {
+        legalActions(game, 0, actions);
+        CHECK(contains(actions, ActionType::GATHER, 0));
+        CHECK(contains(actions, ActionType::TAX, 0));
+        CHECK(contains(actions, ActionType::ARREST, 0, 1));
+        CHECK_FALSE(contains(actions, ActionType::BRIBE, 0)); // Not enough coins
+        CHECK_FALSE(contains(actions, ActionType::COUP, 0, 1));
+
+        legalActions(game, 1, actions);
+        CHECK(actions.empty()); // Not Bob's turn and nothing to react to
+    }
+
+    SUBCASE("Mandatory coup leaves only coup") {
+        gov.addCoins(10);
+        legalActions(game, 0, actions);
+        CHECK(actions.size() == 2); // Coup on Bob or Charlie
+        CHECK(contains(actions, ActionType::COUP, 0, 1));
+        CHECK(contains(actions, ActionType::COUP, 0, 2));
+    }
+
+    SUBCASE("Sanctioned player cannot gather or tax") {
+        gov.setSanctionStatus(true);
+        legalActions(game, 0, actions);
+        CHECK_FALSE(contains(actions, ActionType::GATHER, 0));
+        CHECK_FALSE(contains(actions, ActionType::TAX, 0));
+    }
+
+    SUBCASE("Reactive abilities outside the turn") {
+        gov.tax(); // Bob's turn now, Alice used tax
+        legalActions(game, 2, actions);
+        CHECK(actions.empty()); // Judge has nothing to block
+
+        general.addCoins(4);
+        general.bribe();
+        legalActions(game, 2, actions);
+        CHECK(contains(actions, ActionType::BLOCK_BRIBE, 2, 1));
+
+        general.addCoins(7);
+        general.coup(judge); // Charlie couped by Bob, Bob's bribe is consumed
+        general.addCoins(5);
+        legalActions(game, 1, actions);
+        CHECK(contains(actions, ActionType::BLOCK_COUP, 1, 2));
+    }
+
+    SUBCASE("Governor may undo another player's tax") {
+        gov.gather(); // Bob's turn
+        general.tax(); // Bob used tax
+        legalActions(game, 0, actions);
+        CHECK(contains(actions, ActionType::UNDO, 0, 1));
+    }
+}
+
+TEST_CASE("Applying Actions by Seat") {
+    Game game;
+    Baron baron(game, "Alice");
+    Spy spy(game, "Bob");
+    game.startGame();
+
+    SUBCASE("Dispatch to role abilities") {
+        baron.addCoins(3);
+        applyAction(game, {ActionType::INVEST, 0, NO_TARGET});
+        CHECK(baron.coins() == 6);
+
+        applyAction(game, {ActionType::SPY_ON, 1, 0});
+        CHECK_FALSE(baron.isArrestAvailable());
+    }
+
+    SUBCASE("Illegal actions throw like the direct method calls") {
+        CHECK_THROWS_AS(applyAction(game, {ActionType::INVEST, 1, NO_TARGET}), std::runtime_error); // Spy cannot invest
+        CHECK_THROWS_AS(applyAction(game, {ActionType::GATHER, 1, NO_TARGET}), std::runtime_error); // Not Bob's turn
+        CHECK_THROWS_AS(applyAction(game, {ActionType::ARREST, 0, 7}), std::runtime_error); // Invalid seat
+    }
+
+    SUBCASE("Every listed action applies cleanly in random games") {
+        Game table;
+        Governor p1(table, "P1");
+        Spy p2(table, "P2");
+        Baron p3(table, "P3");
+        General p4(table, "P4");
+        Judge p5(table, "P5");
+        Merchant p6(table, "P6");
+        table.startGame();
+
+        std::mt19937 rng(7);
+        std::vector<Action> scratch;
+        Action chosen;
+        int steps = 0;
+        while (!isGameOver(table) && steps < 2000) {
+            CHECK_NOTHROW(playRandomAction(table, rng, scratch, chosen));
+            steps++;
+        }
+        CHECK(isGameOver(table)); // Random games terminate
+    }
+}
@@ -0,0 +1,141 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for configurable rules and the balance sweep
+ * Covers the rule parameters and the grid runs:
+ * - Every parameter changes the matching action in play and in move generation
+ * - Rules are fixed once the game starts and carried into clones; a coup may not cost more than 10
+ * - The grid is expanded with the last axis fastest
+ * - Counts are complete and do not depend on the thread count
+ */
+
+#include "doctest.h"
+#include <algorithm>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/bots/BalanceSweep.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Merchant.hpp"
+
+using namespace coup;
+
+TEST_CASE("Game Rules") {
+    Game game;
+    Governor governor(game, "Alice");
+    Baron baron(game, "Bob");
+    General general(game, "Charlie");
+    Judge judge(game, "Dana");
+    Merchant merchant(game, "Eve");
+
+    GameRules rules;
+    rules.tax_bonus = 2;
+    rules.invest_payout = 8;
+    rules.coup_cost = 5;
+    rules.block_coup_cost = 3;
+    rules.merchant_threshold = 1;
+    rules.judge_surcharge = 3;
+    CHECK(rules != GameRules());
+    rules.invest_payout = 2;
+    CHECK_THROWS_AS(game.setRules(rules), std::invalid_argument); // Investing would lose coins
+    rules.invest_payout = 8;
+    rules.coup_cost = 11;
+    CHECK_THROWS_AS(game.setRules(rules), std::invalid_argument); // 10 coins would force an unaffordable coup
+    rules.coup_cost = 5;
+    game.setRules(rules);
+    game.startGame();
+    CHECK_THROWS_AS(game.setRules(GameRules()), std::runtime_error);
+
+    governor.tax();
+    CHECK(governor.coins() == 4);
+
+    baron.addCoins(3);
+    baron.invest();
+    CHECK(baron.coins() == 8);
+
+    general.gather();
+    merchant.addCoins(1);
+    judge.gather();
+    merchant.gather(); // Bonus coin at 1 coin, then a gather
+    CHECK(merchant.coins() == 3);
+
+    governor.addCoins(1); // 5 coins - enough to coup under these rules
+    std::vector<Action> actions;
+    legalActions(game, 0, actions);
+    bool can_coup = false;
+    for (const Action& action : actions) {
+        can_coup |= action.type == ActionType::COUP;
+        if (action.type == ActionType::SANCTION && action.target == 3) {
+            FAIL("Sanctioning the Judge costs 6 under these rules");
+        }
+    }
+    CHECK(can_coup);
+
+    governor.coup(baron);
+    CHECK(governor.coins() == 0);
+    general.addCoins(2);
+    general.block_coup(baron); // 3 coins block under these rules
+    CHECK(general.coins() == 0);
+    CHECK(baron.isActive());
+
+    GameClone clone(game);
+    CHECK(clone.game().getRules() == game.getRules());
+}
+
+TEST_CASE("Balance Sweep") {
+    SweepConfig config;
+    config.players = 3;
+    config.games_per_point = 40;
+    config.chunk = 16;
+    config.bots = SweepBots::RANDOM;
+    config.axes.push_back({RuleParameter::COUP_COST, {6, 8}});
+    config.axes.push_back({RuleParameter::MERCHANT_THRESHOLD, {2, 3, 4}});
+
+    CHECK(parseRuleParameter("coup_cost") == RuleParameter::COUP_COST);
+    CHECK_THROWS_AS(parseRuleParameter("coup"), std::invalid_argument);
+
+    const std::vector<SweepPoint> single = runBalanceSweep(config);
+    REQUIRE(single.size() == 6);
+    CHECK(single[1].values == std::vector<int>{6, 3});
+    CHECK(single[1].rules.coup_cost == 6);
+    CHECK(single[1].rules.merchant_threshold == 3);
+    CHECK(single[5].rules.coup_cost == 8);
+
+    config.threads = 3;
+    uint64_t last_progress = 0;
+    const std::vector<SweepPoint> parallel = runBalanceSweep(config, [&](uint64_t done, uint64_t total) {
+        CHECK(total == 240);
+        last_progress = std::max(last_progress, done);
+    });
+    CHECK(last_progress == 240);
+
+    for (size_t p = 0; p < single.size(); p++) {
+        CHECK(single[p].games == 40);
+        uint64_t dealt = 0;
+        uint64_t wins = 0;
+        for (size_t role = 0; role < SWEEP_ROLE_COUNT; role++) {
+            dealt += single[p].dealt[role];
+            wins += single[p].wins[role];
+            CHECK(single[p].dealt[role] == parallel[p].dealt[role]);
+            CHECK(single[p].wins[role] == parallel[p].wins[role]);
+        }
+        CHECK(dealt == 120);
+        CHECK(wins + single[p].draws == 40);
+    }
+
+    config.axes.push_back({RuleParameter::INVEST_PAYOUT, {1}});
+    CHECK_THROWS_AS(runBalanceSweep(config), std::invalid_argument); // Rejected before any game
+
+    // Every seat has a move at the highest coup cost, and above it the grid is rejected up front
+    config.axes.assign(1, {RuleParameter::COUP_COST, {10}});
+    for (const SweepPoint& point : runBalanceSweep(config)) {
+        CHECK(point.games == 40);
+    }
+    config.axes[0].values.push_back(11);
+    CHECK_THROWS_AS(runBalanceSweep(config), std::invalid_argument);
+}
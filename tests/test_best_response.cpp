@@ -0,0 +1,107 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the best-response exploitability search
+ * Covers the values and the shared table:
+ * - The transposition table returns stored values and misses unknown keys
+ * - A coup that ends the game is found by the best response
+ * - The best response is never worth less than following the policy
+ * - Results do not depend on the number of threads, also close to the step cap
+ */
+
+#include "doctest.h"
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/BestResponse.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/General.hpp"
+
+using namespace coup;
+
+TEST_CASE("Transposition Table") {
+    TranspositionTable table(100); // Rounded up to 128 slots
+    double value = 0.0;
+    CHECK_FALSE(table.probe(42, value));
+
+    table.store(42, 0.75);
+    REQUIRE(table.probe(42, value));
+    CHECK(value == 0.75);
+
+    table.store(42 + 128, 0.25); // Same slot - replaces the older entry
+    CHECK_FALSE(table.probe(42, value));
+    REQUIRE(table.probe(42 + 128, value));
+    CHECK(value == 0.25);
+}
+
+TEST_CASE("Best Response") {
+    UniformPolicy uniform;
+    BestResponseConfig config;
+    config.depth = 2;
+    config.leaf_rollouts = 2;
+
+    SUBCASE("Winning coup is found") {
+        Game game;
+        Baron baron(game, "Alice");
+        Spy spy(game, "Bob");
+        game.startGame();
+        baron.addCoins(7);
+        Match match(game);
+
+        BestResponseResult result = BestResponse(uniform, config).evaluate(match, 0);
+        CHECK(result.best_response == 1.0);
+        CHECK(result.policy_value < 1.0); // Random play often skips the coup
+        CHECK(result.exploitability > 0.0);
+        CHECK(result.nodes > 1);
+    }
+
+    SUBCASE("Best response is at least the policy value") {
+        Game game;
+        Baron baron(game, "Alice");
+        General general(game, "Bob");
+        Spy spy(game, "Charlie");
+        game.startGame();
+        baron.addCoins(3);
+        general.addCoins(5);
+        Match match(game);
+
+        for (uint8_t seat = 0; seat < 3; seat++) {
+            BestResponseResult result = BestResponse(uniform, config).evaluate(match, seat);
+            CHECK(result.best_response >= result.policy_value - 1e-9);
+            CHECK(result.policy_value >= 0.0);
+            CHECK(result.best_response <= 1.0);
+        }
+        CHECK(baron.coins() == 3); // The searched game is untouched
+    }
+
+    SUBCASE("Thread count does not change the values") {
+        Game game;
+        Baron baron(game, "Alice");
+        General general(game, "Bob");
+        game.startGame();
+        baron.addCoins(4);
+        general.addCoins(6);
+        Match match(game);
+
+        config.depth = 3;
+        BestResponseResult single = BestResponse(uniform, config).evaluate(match, 1);
+        config.threads = 2;
+        BestResponseResult parallel = BestResponse(uniform, config).evaluate(match, 1);
+        CHECK(single.best_response == doctest::Approx(parallel.best_response));
+        CHECK(single.policy_value == doctest::Approx(parallel.policy_value));
+
+        // Near the step cap the same position is worth less with fewer steps left
+        Match capped(game, 4);
+        config.threads = 1;
+        single = BestResponse(uniform, config).evaluate(capped, 1);
+        config.threads = 4;
+        parallel = BestResponse(uniform, config).evaluate(capped, 1);
+        CHECK(single.best_response == doctest::Approx(parallel.best_response));
+        CHECK(single.policy_value == doctest::Approx(parallel.policy_value));
+
+        config.threads = 0;
+        CHECK_THROWS_AS(BestResponse(uniform, config), std::invalid_argument);
+    }
+}
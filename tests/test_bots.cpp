@@ -0,0 +1,240 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the bot framework
+ * Covers game clones, the decision sequence and the bots:
+ * - A clone copies the state and is independent of the source
+ * - Reaction windows offer undo, bribe block and coup block to the right seats
+ * - Rewards go to the winner, or are shared among the survivors of a drawn match
+ * - State hashes cover the step counter and a salt gives a separate key space
+ * - Random and heuristic bots finish whole matches with legal moves only
+ * - MCTS finds a winning coup and beats random opponents
+ */
+
+#include "doctest.h"
+#include <memory>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/Bot.hpp"
+#include "../include/bots/HeuristicBot.hpp"
+#include "../include/bots/MctsBot.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Merchant.hpp"
+
+using namespace coup;
+
+TEST_CASE("Game Clone") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    game.startGame();
+    gov.tax();
+
+    GameClone clone(game);
+    CHECK(clone.game().getPlayerCount() == 2);
+    CHECK(clone.game().getPlayer(0)->coins() == 3);
+    CHECK(clone.game().getPlayer(0)->getRole() == RoleType::GOVERNOR);
+    CHECK(clone.game().getCurrentPlayerIndex() == 1);
+
+    clone.game().getPlayer(1)->gather(); // Changes the clone only
+    CHECK(spy.coins() == 0);
+    CHECK(game.getCurrentPlayer() == &spy);
+
+    clone.copyFrom(game); // Back to the source position
+    CHECK(clone.game().getPlayer(1)->coins() == 0);
+    CHECK(clone.game().getCurrentPlayerIndex() == 1);
+}
+
+TEST_CASE("Match Reaction Windows") {
+    Game game;
+    Spy spy(game, "Alice"); // Seat 0
+    Governor gov(game, "Bob"); // Seat 1
+    Judge judge(game, "Charlie"); // Seat 2
+    General general(game, "Dana"); // Seat 3
+    game.startGame();
+    Match match(game);
+    std::vector<Move> moves;
+
+    SUBCASE("Governor may undo a tax") {
+        match.apply(Move::play({ActionType::TAX, 0, NO_TARGET}));
+        REQUIRE(match.inReactionWindow());
+        CHECK(match.decidingSeat() == 1);
+
+        match.moves(moves);
+        REQUIRE(moves.size() == 2);
+        CHECK(moves[0].pass);
+        CHECK(moves[1] == Move::play({ActionType::UNDO, 1, 0}));
+
+        match.apply(moves[1]);
+        CHECK_FALSE(match.inReactionWindow());
+        CHECK(spy.coins() == 0);
+        CHECK(match.decidingSeat() == 1); // Governor's own turn
+    }
+
+    SUBCASE("Judge may block a bribe") {
+        spy.addCoins(4);
+        match.apply(Move::play({ActionType::BRIBE, 0, NO_TARGET}));
+        REQUIRE(match.inReactionWindow());
+        CHECK(match.decidingSeat() == 2);
+        CHECK_THROWS(match.apply(Move::play({ActionType::GATHER, 0, NO_TARGET}))); // Judge decides first
+
+        match.apply(Move::decline(2));
+        CHECK_FALSE(match.inReactionWindow());
+        CHECK(match.decidingSeat() == 0); // Extra action of the Spy
+        CHECK(spy.isBribeUsed());
+    }
+
+    SUBCASE("Couped General may block its own coup") {
+        spy.addCoins(7);
+        general.addCoins(5);
+        match.apply(Move::play({ActionType::COUP, 0, 3}));
+        REQUIRE(match.inReactionWindow());
+        CHECK(match.decidingSeat() == 3);
+
+        match.apply(Move::play({ActionType::BLOCK_COUP, 3, 3}));
+        CHECK(general.isActive());
+        CHECK(general.coins() == 0);
+        CHECK(match.decidingSeat() == 1);
+    }
+
+    SUBCASE("Turn moves exclude reactive abilities") {
+        match.moves(moves);
+        for (const Move& move : moves) {
+            CHECK_FALSE(move.pass);
+            CHECK_FALSE(isReactiveAction(move.action.type));
+            CHECK(move.action.actor == 0);
+        }
+    }
+}
+
+TEST_CASE("Match Rewards") {
+    Game game;
+    Spy spy(game, "Alice"); // Seat 0
+    Governor gov(game, "Bob"); // Seat 1
+    Judge judge(game, "Charlie"); // Seat 2
+    game.startGame();
+
+    SUBCASE("Survivors share a draw") {
+        Match match(game, 2);
+        spy.addCoins(7);
+        match.apply(Move::play({ActionType::COUP, 0, 2}));
+        CHECK_FALSE(match.isOver());
+        match.apply(Move::play({ActionType::GATHER, 1, NO_TARGET}));
+        REQUIRE(match.isOver());
+        CHECK(match.winner() == -1);
+        CHECK(match.reward(0) == doctest::Approx(0.5));
+        CHECK(match.reward(1) == doctest::Approx(0.5));
+        CHECK(match.reward(2) == 0.0);
+    }
+
+    SUBCASE("The winner takes everything") {
+        Match match(game);
+        spy.addCoins(14);
+        match.apply(Move::play({ActionType::COUP, 0, 2}));
+        match.apply(Move::play({ActionType::GATHER, 1, NO_TARGET}));
+        match.apply(Move::play({ActionType::COUP, 0, 1}));
+        REQUIRE(match.isOver());
+        CHECK(match.winner() == 0);
+        CHECK(match.reward(0) == 1.0);
+        CHECK(match.reward(1) == 0.0);
+        CHECK(match.reward(2) == 0.0);
+    }
+}
+
+TEST_CASE("Match State Hash") {
+    Game game;
+    Spy spy(game, "Alice");
+    Baron baron(game, "Bob");
+    game.startGame();
+    Match match(game);
+
+    const uint64_t start = match.stateHash();
+    CHECK(match.stateHash(0) == start);
+    CHECK(match.stateHash(1) != start);
+    CHECK(match.stateHash(1) != match.stateHash(2));
+
+    MatchState later = match.getState();
+    later.steps += 2;
+    match.reset(later); // Same game, closer to the step cap
+    CHECK(match.stateHash() != start);
+}
+
+TEST_CASE("Bots Play Complete Matches") {
+    const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+    int finished = 0;
+
+    for (uint32_t seed = 0; seed < 40; seed++) {
+        Game game;
+        std::vector<std::unique_ptr<Player>> roster;
+        for (int i = 0; i < 6; i++) {
+            roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(i + 1), roles[(i + seed) % 6]));
+        }
+        game.startGame();
+
+        RandomBot random_bot(seed);
+        HeuristicBot heuristic_bot(seed);
+        std::vector<Bot*> seats = {&random_bot, &heuristic_bot, &random_bot, &heuristic_bot, &random_bot, &heuristic_bot};
+        Match match(game, 2000);
+        int winner = playMatch(match, seats);
+        CHECK(match.isOver());
+        if (winner >= 0) {
+            finished++;
+            CHECK(game.getPlayer(winner)->isActive());
+            CHECK(game.players().size() == 1);
+        }
+    }
+    CHECK(finished > 30);
+}
+
+TEST_CASE("MCTS Bot") {
+    SUBCASE("Finds the winning coup") {
+        Game game;
+        Baron baron(game, "Alice");
+        Merchant merchant(game, "Bob");
+        game.startGame();
+        baron.addCoins(7);
+        merchant.addCoins(6); // Would coup next turn
+
+        MctsConfig config;
+        config.iterations = 300;
+        config.time_budget_ms = 0;
+        MctsBot bot(config);
+        Match match(game);
+        Move move = bot.chooseMove(match);
+        CHECK(move == Move::play({ActionType::COUP, 0, 1}));
+        CHECK(bot.lastSearch().iterations == 300);
+    }
+
+    SUBCASE("Beats random opponents with root parallelism") {
+        int wins = 0;
+        for (uint32_t seed = 0; seed < 6; seed++) {
+            Game game;
+            Governor gov(game, "Alice");
+            General general(game, "Bob");
+            Judge judge(game, "Charlie");
+            game.startGame();
+
+            MctsConfig config;
+            config.iterations = 150;
+            config.time_budget_ms = 0;
+            config.threads = 2;
+            config.seed = seed;
+            MctsBot mcts(config);
+            RandomBot random_bot(seed + 100);
+            std::vector<Bot*> seats = {&mcts, &random_bot, &random_bot};
+            Match match(game, 500);
+            if (playMatch(match, seats) == 0) {
+                wins++;
+            }
+        }
+        CHECK(wins >= 4); // Random play would win about a third
+    }
+}
@@ -0,0 +1,160 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the CFR trainer and policy bot
+ * Covers the abstraction, the shared tables and the files:
+ * - Information sets are in range and targeted actions aim at the richest target
+ * - Concurrent regret updates are not lost and regrets never go negative
+ * - Checkpoints resume training exactly where it stopped
+ * - A briefly trained policy already beats random play
+ */
+
+#include "doctest.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/Bot.hpp"
+#include "../include/bots/Cfr.hpp"
+#include "../include/bots/CfrBot.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Judge.hpp"
+
+using namespace coup;
+
+namespace {
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST_CASE("CFR Abstraction") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    Judge judge(game, "Charlie");
+    game.startGame();
+    spy.addCoins(2);
+    judge.addCoins(5);
+    gov.addCoins(4); // Sanctioning the Judge costs 4
+    Match match(game);
+
+    std::vector<Move> moves;
+    match.moves(moves);
+    AbstractMoves legal;
+    abstractMoves(match, moves, legal);
+    CHECK(abstractInfoSet(match) < CFR_INFOSETS);
+    REQUIRE(legal.index[static_cast<size_t>(ActionType::SANCTION)] >= 0);
+    CHECK(moves[legal.index[static_cast<size_t>(ActionType::SANCTION)]].action.target == 2); // Richest target
+    CHECK(legal.index[static_cast<size_t>(ActionType::COUP)] < 0);
+    CHECK(legal.index[CFR_PASS] < 0); // No window is open
+
+    match.apply(Move::play({ActionType::GATHER, 0, NO_TARGET}));
+    match.apply(Move::play({ActionType::TAX, 1, NO_TARGET}));
+    REQUIRE(match.inReactionWindow()); // Governor may undo
+    const size_t window = abstractInfoSet(match);
+    match.moves(moves);
+    abstractMoves(match, moves, legal);
+    CHECK(legal.index[CFR_PASS] >= 0);
+    CHECK(legal.index[static_cast<size_t>(ActionType::UNDO)] >= 0);
+    CHECK(window != abstractInfoSet(Match(game)));
+}
+
+TEST_CASE("CFR Trainer") {
+    AbstractMoves legal;
+    for (size_t a = 0; a < CFR_ACTIONS; a++) {
+        legal.index[a] = a < 2 ? static_cast<int16_t>(a) : -1;
+    }
+    float sigma[CFR_ACTIONS];
+
+    SUBCASE("Lock-free updates from many threads") {
+        CfrTrainer trainer;
+        std::vector<std::thread> workers;
+        for (int thread = 0; thread < 4; thread++) {
+            workers.emplace_back([&trainer]() {
+                for (int i = 0; i < 5000; i++) {
+                    trainer.addRegret(7, 0, 1.0f);
+                    trainer.addRegret(7, 1, 3.0f);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        trainer.currentStrategy(7, legal, sigma);
+        CHECK(sigma[0] == doctest::Approx(0.25));
+        CHECK(sigma[1] == doctest::Approx(0.75));
+        CHECK(sigma[2] == 0.0f);
+
+        trainer.addRegret(8, 0, -5.0f); // Floored at zero (CFR+)
+        trainer.addRegret(8, 1, 1.0f);
+        trainer.currentStrategy(8, legal, sigma);
+        CHECK(sigma[1] == 1.0f);
+    }
+
+    SUBCASE("Checkpoints resume the same state") {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path();
+        const std::string checkpoint = (directory / "coup_cfr_test.cfc").string();
+        const std::string first = (directory / "coup_cfr_first.cfp").string();
+        const std::string second = (directory / "coup_cfr_second.cfp").string();
+
+        CfrConfig config;
+        config.threads = 2;
+        config.checkpoint_every = 100;
+        config.checkpoint_path = checkpoint;
+        CfrTrainer trainer(config);
+        trainer.train(250);
+        CHECK(trainer.getIterations() == 250);
+        trainer.writePolicy(first);
+
+        CfrTrainer resumed;
+        resumed.loadCheckpoint(checkpoint);
+        CHECK(resumed.getIterations() == 250);
+        resumed.writePolicy(second);
+        CHECK(readFile(first) == readFile(second));
+
+        CfrPolicy policy(second);
+        CHECK(policy.getIterations() == 250);
+        CHECK_THROWS_AS(CfrPolicy bad(checkpoint), std::runtime_error); // Not a policy file
+
+        std::filesystem::remove(checkpoint);
+        std::filesystem::remove(first);
+        std::filesystem::remove(second);
+    }
+
+    SUBCASE("Trained policy beats random play") {
+        const std::string path = (std::filesystem::temp_directory_path() / "coup_cfr_policy.cfp").string();
+        CfrTrainer trainer;
+        trainer.train(1500);
+        trainer.writePolicy(path);
+        CfrPolicy policy(path);
+
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+        int wins = 0;
+        for (uint32_t seed = 0; seed < 40; seed++) {
+            Game game;
+            std::vector<std::unique_ptr<Player>> roster;
+            roster.emplace_back(game.createPlayerWithRole("Alice", roles[seed % 6]));
+            roster.emplace_back(game.createPlayerWithRole("Bob", roles[(seed / 6) % 6]));
+            game.startGame();
+
+            CfrBot cfr(policy, seed);
+            RandomBot random_bot(seed);
+            std::vector<Bot*> seats = {&random_bot, &random_bot};
+            seats[seed % 2] = &cfr;
+            Match match(game, 300);
+            wins += playMatch(match, seats) == static_cast<int>(seed % 2) ? 1 : 0;
+        }
+        CHECK(wins > 20); // Random play would win about half
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,191 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for real-time decisions
+ * Covers decision limits and the DeadlineBot watchdog:
+ * - MCTS and ISMCTS stop at the caller's deadline or stop flag, whatever their own budget
+ * - The watchdog returns a legal fallback by the deadline when the wrapped bot hangs
+ * - Anytime bots answer through the watchdog, and whole matches can be played with it
+ * - A hung search never holds up the table: moves observed meanwhile are queued
+ */
+
+#include "doctest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/Bot.hpp"
+#include "../include/bots/MctsBot.hpp"
+#include "../include/bots/IsmctsBot.hpp"
+#include "../include/bots/DeadlineBot.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Baron.hpp"
+
+using namespace coup;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool isLegal(const Match& match, const Move& move) {
+        std::vector<Move> moves;
+        match.moves(moves);
+        return std::find(moves.begin(), moves.end(), move) != moves.end();
+    }
+
+    // Ignores every limit and blocks the worker for a fixed time
+    class SleepyBot : public Bot {
+    private:
+        int sleep_ms;
+
+    public:
+        explicit SleepyBot(int sleep_ms) : sleep_ms(sleep_ms) {}
+
+        Move chooseMove(const Match& match) override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+            std::vector<Move> moves;
+            match.moves(moves);
+            return moves.back();
+        }
+        std::string getName() const override { return "Sleepy"; }
+    };
+
+    // Plays random moves and notes when it sees each move of the table
+    class ClockBot : public RandomBot {
+    public:
+        std::vector<Clock::time_point> seen;
+
+        explicit ClockBot(uint32_t seed) : RandomBot(seed) {}
+
+        void observe(const Match& match, const Move& move) override {
+            (void)match;
+            (void)move;
+            seen.push_back(Clock::now());
+        }
+    };
+}
+
+TEST_CASE("Decision Limits Cut Searches Short") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    Baron baron(game, "Charlie");
+    game.startGame();
+    Match match(game);
+
+    MctsConfig config;
+    config.time_budget_ms = 60000; // Far beyond the caller's limit
+    config.seed = 3;
+
+    MctsBot mcts(config);
+    std::atomic<bool> stop(true);
+    DecisionLimit raised;
+    raised.stop = &stop;
+    Move move = mcts.chooseMoveWithin(match, raised);
+    CHECK(isLegal(match, move));
+    CHECK(mcts.lastSearch().iterations == 0); // Stopped before the first simulation
+
+    auto start = Clock::now();
+    move = mcts.chooseMoveWithin(match, DecisionLimit::in(20));
+    CHECK(elapsedMs(start) < 2000);
+    CHECK(isLegal(match, move));
+    CHECK(mcts.lastSearch().iterations > 0);
+
+    IsmctsBot ismcts(0, config);
+    start = Clock::now();
+    move = ismcts.chooseMoveWithin(match, DecisionLimit::in(20));
+    CHECK(elapsedMs(start) < 2000);
+    CHECK(isLegal(match, move));
+
+    CHECK_FALSE(DecisionLimit().expired());
+    CHECK(DecisionLimit::in(-1).expired());
+    CHECK(raised.expired());
+}
+
+TEST_CASE("Watchdog Falls Back When The Bot Hangs") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    game.startGame();
+    Match match(game);
+
+    CHECK_THROWS_AS(DeadlineBot(std::unique_ptr<Bot>(new SleepyBot(1)), 5, 5), std::invalid_argument);
+    CHECK_THROWS_AS(DeadlineBot(nullptr, 10), std::invalid_argument);
+
+    DeadlineBot bot(std::unique_ptr<Bot>(new SleepyBot(300)), 20, 5);
+    auto start = Clock::now();
+    Move move = bot.chooseMove(match);
+    CHECK(elapsedMs(start) < 250); // Never waits for the hung search
+    CHECK(isLegal(match, move));
+    CHECK(bot.getStats().fallbacks == 1);
+
+    // The worker is still busy with the first turn - the next turn falls back as well
+    move = bot.chooseMove(match);
+    CHECK(isLegal(match, move));
+    CHECK(bot.getStats().skipped == 1);
+    CHECK(bot.getStats().decisions == 2);
+    CHECK(bot.getStats().searched == 0);
+    CHECK(bot.getName() == "Sleepy");
+}
+
+TEST_CASE("Watchdog Plays Anytime Searches") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    Baron baron(game, "Charlie");
+    game.startGame();
+    Match match(game, 60);
+
+    MctsConfig config;
+    config.time_budget_ms = 60000;
+    config.seed = 5;
+    DeadlineBot bot(std::unique_ptr<Bot>(new MctsBot(config)), 15, 5);
+
+    auto start = Clock::now();
+    Move move = bot.chooseMove(match);
+    CHECK(elapsedMs(start) < 2000);
+    CHECK(isLegal(match, move));
+    REQUIRE(bot.getStats().searched == 1);
+    CHECK(static_cast<MctsBot&>(bot.getInner()).lastSearch().iterations > 0);
+
+    // A whole (capped) match with the watchdog in every seat
+    DeadlineBot second(std::unique_ptr<Bot>(new MctsBot(config)), 5, 2, 2);
+    DeadlineBot third(std::unique_ptr<Bot>(new MctsBot(config)), 5, 2, 3);
+    playMatch(match, {&bot, &second, &third});
+    CHECK(bot.getStats().decisions + second.getStats().decisions + third.getStats().decisions > 1);
+    CHECK(bot.getStats().searched + bot.getStats().fallbacks == bot.getStats().decisions);
+}
+
+TEST_CASE("Watchdog Never Holds Up The Table") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    game.startGame();
+    Match match(game, 30);
+
+    DeadlineBot sleepy(std::unique_ptr<Bot>(new SleepyBot(200)), 10, 3);
+    ClockBot clock(7);
+    const auto start = Clock::now();
+    playMatch(match, {&sleepy, &clock});
+    CHECK(match.isOver());
+
+    // Waiting for the sleeping search would take 200 ms per move
+    REQUIRE(clock.seen.size() > 4);
+    Clock::time_point previous = start;
+    for (const Clock::time_point& moment : clock.seen) {
+        CHECK(std::chrono::duration<double, std::milli>(moment - previous).count() < 100);
+        previous = moment;
+    }
+    CHECK(sleepy.getStats().max_latency_ms < 100);
+    CHECK(sleepy.getStats().skipped > 0); // Later turns found the worker still asleep
+    CHECK(sleepy.getStats().searched + sleepy.getStats().fallbacks == sleepy.getStats().decisions);
+}
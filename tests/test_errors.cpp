@@ -0,0 +1,155 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the no-throw action entry points
+ * Covers the try* methods of Player and the roles and tryApplyAction:
+ * - Rejected actions return the expected ActionError and leave the game unchanged
+ * - The throwing methods report the same rule through the exception message
+ * - Every legal action succeeds and random illegal probes never change the state
+ */
+
+#include "doctest.h"
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/ActionError.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Merchant.hpp"
+
+using namespace coup;
+
+// Compare two game states byte for byte (RNG excluded)
+static bool sameState(const Game& game, const GameSnapshot& expected) {
+    GameSnapshot current;
+    game.saveSnapshot(current, false);
+    return std::memcmp(&current.header, &expected.header, sizeof(current.header)) == 0 &&
+           std::memcmp(current.players, expected.players, sizeof(current.players)) == 0;
+}
+
+TEST_CASE("No-Throw Action Entry Points") {
+    Game game;
+    Governor gov(game, "Alice"); // Seat 0
+    Spy spy(game, "Bob"); // Seat 1
+    Baron baron(game, "Charlie"); // Seat 2
+    General general(game, "Dana"); // Seat 3
+    Judge judge(game, "Eve"); // Seat 4
+
+    SUBCASE("Errors before the game starts") {
+        ActionResult result = gov.tryGather();
+        CHECK_FALSE(result);
+        CHECK(result.error() == ActionError::GAME_NOT_STARTED);
+        CHECK(spy.trySpyOn(gov).error() == ActionError::GAME_NOT_STARTED);
+        CHECK_THROWS_WITH_AS(gov.gather(), "Game has not started yet", std::runtime_error);
+    }
+
+    game.startGame();
+    GameSnapshot before;
+
+    SUBCASE("Rejected turn actions leave the game unchanged") {
+        game.saveSnapshot(before, false);
+        CHECK(spy.tryGather().error() == ActionError::NOT_YOUR_TURN);
+        CHECK(gov.tryBribe().error() == ActionError::NOT_ENOUGH_COINS_BRIBE);
+        CHECK(gov.trySanction(spy).error() == ActionError::NOT_ENOUGH_COINS_SANCTION);
+        CHECK(gov.tryCoup(gov).error() == ActionError::SELF_TARGET);
+        CHECK(gov.tryCoup(spy).error() == ActionError::NOT_ENOUGH_COINS_COUP);
+        CHECK(sameState(game, before));
+
+        CHECK_THROWS_WITH_AS(spy.gather(), getActionErrorMessage(ActionError::NOT_YOUR_TURN), std::runtime_error);
+        CHECK_THROWS_WITH_AS(gov.coup(spy), "Not enough coins for coup", std::runtime_error);
+    }
+
+    SUBCASE("Successful actions match the throwing versions") {
+        CHECK(gov.tryTax());
+        CHECK(gov.coins() == 3); // Governor bonus through the virtual tryTax
+        CHECK(game.getCurrentPlayer() == &spy);
+
+        Expected<int, ActionError> revealed = spy.trySpyOn(gov);
+        REQUIRE(revealed);
+        CHECK(revealed.value() == 3);
+        CHECK_FALSE(gov.isArrestAvailable());
+
+        CHECK(spy.tryArrest(gov));
+        CHECK(spy.coins() == 1);
+        CHECK(baron.tryGather());
+        CHECK(general.tryGather());
+        CHECK(judge.tryGather());
+        CHECK(gov.tryArrest(spy).error() == ActionError::ARREST_UNAVAILABLE);
+    }
+
+    SUBCASE("Role abilities report their rules") {
+        judge.addCoins(4);
+        CHECK(judge.tryBlockBribe(gov).error() == ActionError::NO_BRIBE_TO_BLOCK);
+        CHECK(gov.tryUndo(spy).error() == ActionError::NO_TAX_TO_UNDO);
+        CHECK(general.tryBlockCoup(spy).error() == ActionError::NOT_ENOUGH_COINS_BLOCK_COUP);
+        general.addCoins(5);
+        CHECK(general.tryBlockCoup(spy).error() == ActionError::TARGET_NOT_COUPED);
+
+        baron.addCoins(2);
+        gov.gather(); // Turn passes to the Spy, then the Baron
+        spy.gather();
+        CHECK(baron.tryInvest().error() == ActionError::NOT_ENOUGH_COINS_INVEST);
+        baron.addCoins(1);
+        CHECK(baron.tryInvest());
+        CHECK(baron.coins() == 6);
+    }
+
+    SUBCASE("Seat-based dispatch") {
+        game.saveSnapshot(before, false);
+        CHECK(tryApplyAction(game, {ActionType::GATHER, 7, NO_TARGET}).error() == ActionError::INVALID_ACTOR);
+        CHECK(tryApplyAction(game, {ActionType::COUP, 0, 9}).error() == ActionError::INVALID_TARGET);
+        CHECK(tryApplyAction(game, {ActionType::INVEST, 0, NO_TARGET}).error() == ActionError::ROLE_REQUIRED);
+        CHECK(sameState(game, before));
+        CHECK_THROWS_AS(applyAction(game, {ActionType::INVEST, 0, NO_TARGET}), std::runtime_error);
+        CHECK(tryApplyAction(game, {ActionType::GATHER, 0, NO_TARGET}));
+    }
+}
+
+TEST_CASE("Random Probes Against the No-Throw Path") {
+    Game game;
+    Governor gov(game, "Alice");
+    Spy spy(game, "Bob");
+    Baron baron(game, "Charlie");
+    General general(game, "Dana");
+    Judge judge(game, "Eve");
+    Merchant merchant(game, "Frank");
+    game.startGame();
+
+    std::mt19937 rng(11);
+    std::vector<Action> legal;
+    Action chosen;
+    GameSnapshot before;
+    int rejected = 0;
+
+    for (int step = 0; step < 2000 && !isGameOver(game); step++) {
+        // Random probe - must either succeed or leave the state untouched
+        Action probe{static_cast<ActionType>(rng() % ACTION_TYPE_COUNT),
+                     static_cast<uint8_t>(rng() % 7), static_cast<uint8_t>(rng() % 7)};
+        game.saveSnapshot(before, false);
+        ActionResult result = tryApplyAction(game, probe);
+        if (!result) {
+            rejected++;
+            CHECK(sameState(game, before));
+            CHECK(result.error() != ActionError::NONE);
+        }
+
+        // Every legal action of the current player must be accepted
+        const uint8_t seat = static_cast<uint8_t>(game.getCurrentPlayerIndex());
+        legalActions(game, seat, legal);
+        if (legal.empty()) {
+            game.nextTurn();
+            continue;
+        }
+        chosen = legal[rng() % legal.size()];
+        CHECK(tryApplyAction(game, chosen));
+    }
+
+    CHECK(rejected > 0);
+}
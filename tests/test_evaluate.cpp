@@ -0,0 +1,91 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for batch what-if evaluation
+ * Covers Game::evaluateAllActions:
+ * - Every legal action is scored once and the game itself is untouched
+ * - Scores come from the evaluator applied to the position after the action
+ * - A mismatched scratch clone is rejected, the per-thread scratch follows roster changes
+ */
+
+#include "doctest.h"
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/ActionEvaluator.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Spy.hpp"
+
+using namespace coup;
+
+namespace {
+    // Coins of the acting seat after the action
+    class CoinEvaluator : public ActionEvaluator {
+    public:
+        double evaluate(const Game& after, const Action& action, uint8_t seat) const override {
+            (void)action;
+            return after.getPlayer(seat)->coins();
+        }
+    };
+}
+
+TEST_CASE("Evaluate All Actions") {
+    Game game;
+    Baron baron(game, "Alice");
+    General general(game, "Bob");
+    Spy spy(game, "Charlie");
+    game.startGame();
+    baron.addCoins(7);
+
+    std::vector<Action> legal;
+    legalActions(game, 0, legal);
+    GameSnapshot before;
+    game.saveSnapshot(before, false);
+
+    GameClone scratch(game);
+    std::vector<ActionScore> scores;
+    const size_t count = game.evaluateAllActions(scratch, CoinEvaluator(), scores);
+    REQUIRE(count == legal.size());
+    REQUIRE(scores.size() == legal.size());
+
+    for (size_t i = 0; i < scores.size(); i++) {
+        CHECK(scores[i].action == legal[i]);
+        switch (scores[i].action.type) {
+            case ActionType::GATHER: CHECK(scores[i].score == 8.0); break;
+            case ActionType::TAX: CHECK(scores[i].score == 9.0); break;
+            case ActionType::INVEST: CHECK(scores[i].score == 10.0); break;
+            case ActionType::COUP: CHECK(scores[i].score == 0.0); break;
+            default: break;
+        }
+    }
+
+    GameSnapshot after;
+    game.saveSnapshot(after, false);
+    CHECK(std::memcmp(&before.header, &after.header, sizeof(before.header)) == 0); // The real game never moves
+    CHECK(std::memcmp(before.players, after.players, sizeof(before.players)) == 0);
+
+    // Material evaluator prefers eliminating an opponent
+    game.evaluateAllActions(MaterialEvaluator(), scores);
+    const ActionScore* best = &scores[0];
+    for (const ActionScore& score : scores) {
+        if (score.score > best->score) best = &score;
+    }
+    CHECK(best->action.type == ActionType::COUP);
+
+    // Scratch clones must match the roster
+    Game other;
+    Baron other_baron(other, "Alice");
+    Spy other_spy(other, "Bob");
+    other.startGame();
+    CHECK_THROWS_AS(other.evaluateAllActions(scratch, CoinEvaluator(), scores), std::invalid_argument);
+    CHECK(other.evaluateAllActions(CoinEvaluator(), scores) > 0); // The per-thread scratch is rebuilt
+    CHECK(game.evaluateAllActions(CoinEvaluator(), scores) == legal.size());
+
+    Game idle;
+    CHECK(idle.evaluateAllActions(CoinEvaluator(), scores) == 0);
+}
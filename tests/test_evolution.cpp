@@ -0,0 +1,83 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the evolutionary weight tuner
+ * Covers the encoding, the evaluation and the checkpoints:
+ * - Weights survive the gene encoding
+ * - Fitness is the same with any number of workers and separates good from bad weights
+ * - A generation keeps the elite and writes a checkpoint that resumes the population
+ */
+
+#include "doctest.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "../include/bots/Evolution.hpp"
+
+using namespace coup;
+
+TEST_CASE("Evolution Tuner") {
+    EvolutionConfig config;
+    config.population = 6;
+    config.elite = 2;
+    config.games = 60;
+
+    SUBCASE("Gene encoding") {
+        HeuristicWeights weights;
+        weights.action[static_cast<size_t>(ActionType::TAX)] = 4.5;
+        weights.noise = 0.25;
+        double genes[HEURISTIC_GENES];
+        weightsToGenes(weights, genes);
+        const HeuristicWeights back = genesToWeights(genes);
+        CHECK(back.action[static_cast<size_t>(ActionType::TAX)] == 4.5);
+        CHECK(back.noise == 0.25);
+        CHECK(back.target_coins == weights.target_coins);
+    }
+
+    SUBCASE("Fitness is deterministic and meaningful") {
+        EvolutionTuner single(config);
+        config.threads = 3;
+        EvolutionTuner parallel(config);
+
+        const HeuristicWeights defaults;
+        const double a = single.evaluate(defaults);
+        CHECK(a == parallel.evaluate(defaults));
+        CHECK(a > 0.3);
+        CHECK(a < 0.7); // The default weights against themselves
+
+        HeuristicWeights passive = defaults; // Never coups, never taxes
+        passive.action[static_cast<size_t>(ActionType::COUP)] = -100.0;
+        passive.action[static_cast<size_t>(ActionType::TAX)] = -100.0;
+        CHECK(parallel.evaluate(passive) < a);
+    }
+
+    SUBCASE("Generations and checkpoints") {
+        const std::string path = (std::filesystem::temp_directory_path() / "coup_evolution_test.cev").string();
+        config.threads = 2;
+        config.checkpoint_path = path;
+        EvolutionTuner tuner(config);
+        const std::vector<Candidate> first = tuner.getPopulation();
+        CHECK(first.size() == 6);
+
+        const Candidate best = tuner.step();
+        CHECK(tuner.getGeneration() == 1);
+        CHECK(best.fitness > 0.0);
+        const std::vector<Candidate>& next = tuner.getPopulation();
+        for (size_t gene = 0; gene < HEURISTIC_GENES; gene++) {
+            CHECK(next[0].genes[gene] == best.genes[gene]); // Elite survives unchanged
+        }
+
+        EvolutionTuner resumed(config);
+        resumed.loadCheckpoint(path);
+        CHECK(resumed.getGeneration() == 1);
+        REQUIRE(resumed.getPopulation().size() == next.size());
+        for (size_t i = 0; i < next.size(); i++) {
+            CHECK(resumed.getPopulation()[i].genes[0] == next[i].genes[0]);
+        }
+        std::filesystem::remove(path);
+
+        CHECK_THROWS_AS(resumed.loadCheckpoint(path), std::runtime_error);
+        config.elite = 6;
+        CHECK_THROWS_AS(EvolutionTuner bad(config), std::invalid_argument);
+    }
+}
@@ -0,0 +1,115 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the columnar analytics exporter
+ * Covers the column files written for live games and recorded traces:
+ * - Every action column has one row per action and game columns one row per game
+ * - Coins before and after match the acting player
+ * - The winner column names the last active seat
+ * - A column file that cannot be written (full disk) fails loudly instead of truncating the export
+ */
+
+#include "doctest.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <filesystem>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/ColumnarExport.hpp"
+#include "../include/Trace.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/Baron.hpp"
+
+using namespace coup;
+
+// Read a whole column file as values of type T
+template <typename T>
+static std::vector<T> readColumn(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<T> values(bytes.size() / sizeof(T));
+    std::copy(bytes.begin(), bytes.begin() + values.size() * sizeof(T), reinterpret_cast<char*>(values.data()));
+    return values;
+}
+
+TEST_CASE("Columnar Export of Live Games and Traces") {
+    const std::string directory = (std::filesystem::temp_directory_path() / "coup_export_test").string();
+    std::filesystem::remove_all(directory);
+
+    Game game;
+    Governor gov(game, "Alice");
+    Baron baron(game, "Bob");
+    game.startGame();
+
+    TraceWriter writer;
+    {
+        ColumnarExporter exporter(directory, 2); // Tiny chunks to exercise buffered writes
+        CHECK(exporter.beginGame(game) == 0);
+        writer.begin(game);
+
+        // Alice taxes three times (0 -> 9), Bob gathers in between, then Alice coups Bob (9 -> 2)
+        const Action script[] = {
+            {ActionType::TAX, 0, NO_TARGET}, {ActionType::GATHER, 1, NO_TARGET},
+            {ActionType::TAX, 0, NO_TARGET}, {ActionType::GATHER, 1, NO_TARGET},
+            {ActionType::TAX, 0, NO_TARGET}, {ActionType::GATHER, 1, NO_TARGET},
+            {ActionType::COUP, 0, 1}
+        };
+        for (const Action& action : script) {
+            applyAction(game, action);
+            exporter.recordAction(action, game);
+            writer.record(action, game);
+        }
+        exporter.endGame(game);
+        writer.finish();
+
+        TraceReader reader(writer.data().data(), writer.data().size());
+        CHECK(exporter.exportTrace(reader) == 1); // Same game again, from the trace
+    }
+
+    CHECK(std::filesystem::exists(directory + "/schema.txt"));
+
+    auto game_ids = readColumn<uint32_t>(directory + "/actions.game_id.u32");
+    auto turns = readColumn<uint32_t>(directory + "/actions.turn.u32");
+    auto types = readColumn<uint8_t>(directory + "/actions.action.u8");
+    auto targets = readColumn<uint8_t>(directory + "/actions.target.u8");
+    auto before = readColumn<int16_t>(directory + "/actions.coins_before.i16");
+    auto after = readColumn<int16_t>(directory + "/actions.coins_after.i16");
+    REQUIRE(game_ids.size() == 14);
+    CHECK(game_ids[6] == 0);
+    CHECK(game_ids[7] == 1);
+    CHECK(turns[6] == 6);
+    CHECK(turns[13] == 6);
+    CHECK(types[6] == static_cast<uint8_t>(ActionType::COUP));
+    CHECK(targets[0] == NO_TARGET);
+    CHECK(targets[6] == 1);
+
+    const std::vector<int16_t> expected_before = {0, 0, 3, 1, 6, 2, 9};
+    const std::vector<int16_t> expected_after = {3, 1, 6, 2, 9, 3, 2};
+    CHECK(std::equal(expected_before.begin(), expected_before.end(), before.begin()));
+    CHECK(std::equal(expected_before.begin(), expected_before.end(), before.begin() + 7)); // Trace export matches
+    CHECK(std::equal(expected_after.begin(), expected_after.end(), after.begin()));
+    CHECK(std::equal(expected_after.begin(), expected_after.end(), after.begin() + 7));
+
+    auto winners = readColumn<uint8_t>(directory + "/games.winner_seat.u8");
+    auto winner_roles = readColumn<uint8_t>(directory + "/games.winner_role.u8");
+    auto action_counts = readColumn<uint32_t>(directory + "/games.action_count.u32");
+    CHECK(winners == std::vector<uint8_t>{0, 0});
+    CHECK(winner_roles[0] == static_cast<uint8_t>(RoleType::GOVERNOR));
+    CHECK(action_counts == std::vector<uint32_t>{7, 7});
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Column File Write Errors Are Reported") {
+    if (!std::filesystem::exists("/dev/full")) {
+        return; // Linux only: every write to /dev/full fails with ENOSPC
+    }
+    ColumnFile<uint32_t> column("/dev/full", 4);
+    column.push(1);
+    column.push(2);
+    column.push(3);
+    CHECK_THROWS_AS(column.push(4), std::runtime_error); // The chunk is written and refused
+    CHECK_THROWS_AS(column.flush(), std::runtime_error); // The stream stays failed
+}
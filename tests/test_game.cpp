@@ -342,3 +342,73 @@ TEST_CASE("Role Assignment and Factory Methods") {
         CHECK(judge->getRoleType() == "Judge");
     }
 }
+
+
+TEST_CASE("Binary Snapshot Save and Load") {
+    Game game; // Game that produces the snapshot
+    Governor gov(game, "Alice");
+    General general(game, "Bob");
+    Baron baron(game, "Charlie");
+    game.startGame();
+
+    // Build up some state: coins, a tax flag, an arrest and a pending coup
+    gov.tax(); // Alice: 3 coins
+    general.addCoins(7);
+    baron.addCoins(3);
+    general.coup(baron); // Charlie eliminated, couped by Bob
+    general.setArrestAvailability(false);
+    game.setLastArrestedPlayer(&gov);
+
+    std::vector<unsigned char> blob;
+    game.saveSnapshot(blob);
+    CHECK(blob.size() == sizeof(GameSnapshot)); // Fixed-size blob
+
+    SUBCASE("Restoring into the same game rolls back later changes") {
+        gov.addCoins(5);
+        general.addCoins(5);
+        general.block_coup(baron); // Charlie is restored after the snapshot was taken
+
+        game.loadSnapshot(blob);
+        CHECK(gov.coins() == 3);
+        CHECK(general.coins() == 0);
+        CHECK_FALSE(baron.isActive());
+        CHECK(baron.getCoupedBy() == &general);
+    }
+
+    SUBCASE("Restoring into a game with the same roster copies all state") {
+        Game other;
+        Governor gov2(other, "Alice");
+        General general2(other, "Bob");
+        Baron baron2(other, "Charlie");
+
+        other.loadSnapshot(blob);
+        CHECK(other.isGameStarted());
+        CHECK(other.getCurrentPlayer() == &gov2);
+        CHECK(gov2.coins() == 3);
+        CHECK(general2.coins() == 0);
+        CHECK_FALSE(general2.isArrestAvailable());
+        CHECK_FALSE(baron2.isActive());
+        CHECK(baron2.getCoupedBy() == &general2); // Coup link is remapped to the new roster
+        CHECK(other.getLastArrestedPlayer() == &gov2);
+
+        std::vector<unsigned char> again;
+        other.saveSnapshot(again);
+        CHECK(again == blob); // Round trip is byte-exact
+        CHECK(other.getRandomGenerator()() == game.getRandomGenerator()()); // RNG state is restored
+    }
+
+    SUBCASE("Mismatched or corrupted snapshots are rejected") {
+        Game other;
+        Governor gov2(other, "Alice");
+        Judge judge2(other, "Bob"); // Different role in seat 1
+        Baron baron2(other, "Charlie");
+        CHECK_THROWS_AS(other.loadSnapshot(blob), std::runtime_error);
+        CHECK(judge2.isActive()); // Failed restore leaves the game unchanged
+
+        CHECK_THROWS_AS(game.loadSnapshot(blob.data(), blob.size() - 1), std::runtime_error);
+
+        std::vector<unsigned char> corrupted = blob;
+        corrupted[0] ^= 0xFF; // Break the magic number
+        CHECK_THROWS_AS(game.loadSnapshot(corrupted), std::runtime_error);
+    }
+}
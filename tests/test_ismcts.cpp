@@ -0,0 +1,185 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for hidden-information play
+ * Covers the observation tracker and the ISMCTS bot:
+ * - Coin bounds always contain the true coins and revealed roles are correct
+ * - A Spy learns the exact coins of its target
+ * - Determinizations are loadable and keep every known fact
+ * - ISMCTS finds a winning coup and finishes matches without peeking
+ */
+
+#include "doctest.h"
+#include <memory>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/Bot.hpp"
+#include "../include/bots/Observation.hpp"
+#include "../include/bots/IsmctsBot.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Merchant.hpp"
+
+using namespace coup;
+
+namespace {
+    // Random player that also checks one tracker per seat after every move
+    class CheckingBot : public RandomBot {
+    public:
+        std::vector<ObservationTracker> trackers;
+        int violations = 0;
+        int revealed = 0;
+
+        explicit CheckingBot(uint32_t seed) : RandomBot(seed) {}
+
+        void start(const Match& match) override {
+            for (uint8_t seat = 0; seat < match.getGame().getPlayerCount(); seat++) {
+                trackers.emplace_back(match.getGame(), seat);
+            }
+        }
+
+        void observe(const Match& match, const Move& move) override {
+            const Game& game = match.getGame();
+            for (ObservationTracker& tracker : trackers) {
+                tracker.update(game, move);
+                for (uint8_t seat = 0; seat < game.getPlayerCount(); seat++) {
+                    const SeatObservation& known = tracker.view().seats[seat];
+                    const int coins = game.getPlayer(seat)->coins();
+                    if (coins < known.coins_low || coins > known.coins_high) {
+                        violations++;
+                    }
+                    if (known.role != ROLE_UNKNOWN) {
+                        revealed++;
+                        if (known.role != static_cast<uint8_t>(game.getPlayer(seat)->getRole())) {
+                            violations++;
+                        }
+                    }
+                }
+            }
+        }
+    };
+}
+
+TEST_CASE("Observation Tracker") {
+    SUBCASE("Bounds contain the true state in random games") {
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+        for (uint32_t seed = 0; seed < 20; seed++) {
+            Game game;
+            std::vector<std::unique_ptr<Player>> roster;
+            for (int i = 0; i < 6; i++) {
+                roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(i + 1), roles[(i + seed) % 6]));
+            }
+            game.startGame();
+
+            CheckingBot bot(seed);
+            std::vector<Bot*> seats(6, &bot);
+            Match match(game, 600);
+            playMatch(match, seats);
+            CHECK(bot.violations == 0);
+            CHECK(bot.revealed > 0);
+        }
+    }
+
+    SUBCASE("Spy sees the coins of its target") {
+        Game game;
+        Spy spy(game, "Alice");
+        Governor gov(game, "Bob");
+        game.startGame();
+        Match match(game);
+        ObservationTracker tracker(game, 0);
+
+        match.apply(Move::play({ActionType::GATHER, 0, NO_TARGET}));
+        tracker.update(game, Move::play({ActionType::GATHER, 0, NO_TARGET}));
+        match.apply(Move::play({ActionType::TAX, 1, NO_TARGET}));
+        tracker.update(game, Move::play({ActionType::TAX, 1, NO_TARGET}));
+        CHECK(tracker.view().seats[1].coins_low == 2);
+        CHECK(tracker.view().seats[1].coins_high == 3); // Bob may be a Governor
+        CHECK(tracker.view().seats[1].role == ROLE_UNKNOWN);
+
+        spy.spy_on(gov);
+        tracker.update(game, Move::play({ActionType::SPY_ON, 0, 1}));
+        CHECK(tracker.view().seats[1].coins_low == 3);
+        CHECK(tracker.view().seats[1].coins_high == 3);
+        CHECK(tracker.view().seats[0].role == static_cast<uint8_t>(RoleType::SPY)); // Own role
+    }
+
+    SUBCASE("Determinizations are loadable and keep known facts") {
+        Game game;
+        Baron baron(game, "Alice");
+        Merchant merchant(game, "Bob");
+        Governor gov(game, "Charlie");
+        game.startGame();
+        ObservationTracker tracker(game, 2);
+
+        baron.gather();
+        tracker.update(game, Move::play({ActionType::GATHER, 0, NO_TARGET}));
+        merchant.gather();
+        tracker.update(game, Move::play({ActionType::GATHER, 1, NO_TARGET}));
+        gov.tax();
+        tracker.update(game, Move::play({ActionType::TAX, 2, NO_TARGET}));
+        baron.gather();
+        tracker.update(game, Move::play({ActionType::GATHER, 0, NO_TARGET}));
+
+        std::mt19937 rng(5);
+        GameSnapshot sample;
+        for (int i = 0; i < 50; i++) {
+            tracker.determinize(rng, sample);
+            GameClone clone(sample);
+            CHECK(clone.game().getPlayer(0)->coins() == 2);
+            CHECK(clone.game().getPlayer(1)->coins() == 1);
+            CHECK(clone.game().getPlayer(2)->coins() == 3);
+            CHECK(clone.game().getPlayer(2)->getRole() == RoleType::GOVERNOR);
+            CHECK(clone.game().getCurrentPlayerIndex() == 1);
+        }
+    }
+}
+
+TEST_CASE("ISMCTS Bot") {
+    SUBCASE("Finds the winning coup") {
+        Game game;
+        Baron baron(game, "Alice");
+        Merchant merchant(game, "Bob");
+        game.startGame();
+        baron.addCoins(7);
+        merchant.addCoins(6);
+
+        MctsConfig config;
+        config.iterations = 300;
+        config.time_budget_ms = 0;
+        IsmctsBot bot(0, config);
+        Match match(game);
+        Move move = bot.chooseMove(match); // Joins mid-game with wide bounds
+        CHECK(move == Move::play({ActionType::COUP, 0, 1}));
+        CHECK(bot.lastSearch().iterations == 300);
+    }
+
+    SUBCASE("Plays complete matches") {
+        int finished = 0;
+        for (uint32_t seed = 0; seed < 4; seed++) {
+            Game game;
+            Governor gov(game, "Alice");
+            Spy spy(game, "Bob");
+            Baron baron(game, "Charlie");
+            game.startGame();
+
+            MctsConfig config;
+            config.iterations = 60;
+            config.time_budget_ms = 0;
+            config.threads = 2;
+            config.seed = seed;
+            IsmctsBot ismcts(0, config);
+            RandomBot random_bot(seed + 100);
+            std::vector<Bot*> seats = {&ismcts, &random_bot, &random_bot};
+            Match match(game, 400);
+            finished += playMatch(match, seats) >= 0 ? 1 : 0;
+            REQUIRE(ismcts.getTracker() != nullptr);
+            CHECK(ismcts.getTracker()->view().seats[0].role == static_cast<uint8_t>(RoleType::GOVERNOR));
+        }
+        CHECK(finished >= 3);
+    }
+}
@@ -0,0 +1,218 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for lockstep replication
+ * Covers Table events, LockstepReplica and the lockstep server mode:
+ * - A replica fed SETUP and ACTION frames reaches the table's hash after every event, window expiries included
+ * - A tampered replica is caught at the next hashed event, and the hash logs name the exact event
+ * - Streams with gaps or of other tables are refused
+ * - A lockstep server sends only the action stream, and clients play a full game from their replicas
+ */
+
+#include "doctest.h"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/server/Lockstep.hpp"
+#include "../include/server/GameServer.hpp"
+#include "../include/server/ServerClient.hpp"
+#include "../include/server/Table.hpp"
+
+using namespace coup;
+
+namespace {
+    // Encodes and decodes a message, as the wire would
+    Message overWire(const Message& message, size_t* frame_size = nullptr) {
+        static std::vector<uint8_t> buffer;
+        buffer.clear();
+        encodeMessage(message, buffer);
+        if (frame_size) {
+            *frame_size = buffer.size();
+        }
+        Message out;
+        REQUIRE(decodeMessage(buffer.data(), buffer.size(), out) == buffer.size());
+        return out;
+    }
+
+    void seatTable(Table& table) {
+        table.join("Alice", RoleType::GOVERNOR);
+        table.join("Bob", RoleType::GENERAL);
+        table.join("Carol", RoleType::JUDGE);
+        table.join("Dave", RoleType::BARON);
+        table.start();
+    }
+
+    // Plays one random event: a move of the deciding seat, or now and then the window deadline
+    void playEvent(Table& table, std::mt19937& rng, std::vector<Move>& moves) {
+        const Match& match = *table.getMatch();
+        if (match.inReactionWindow() && rng() % 4 == 0) {
+            table.expireWindow();
+            return;
+        }
+        match.moves(moves);
+        REQUIRE_FALSE(moves.empty());
+        table.play(match.decidingSeat(), moves[rng() % moves.size()]);
+    }
+
+    // Gathers, coups when affordable and passes every window
+    Move simpleMove(const Match& match) {
+        const Game& game = match.getGame();
+        const uint8_t seat = match.decidingSeat();
+        if (match.inReactionWindow()) {
+            return Move::decline(seat);
+        }
+        if (game.getPlayer(seat)->coins() >= game.getRules().coup_cost) {
+            for (uint8_t target = 0; target < game.getPlayerCount(); target++) {
+                if (target != seat && game.getPlayer(target)->isActive()) {
+                    return Move::play({ActionType::COUP, seat, target});
+                }
+            }
+        }
+        return Move::play({ActionType::GATHER, seat, NO_TARGET});
+    }
+}
+
+TEST_CASE("Lockstep Replica Follows A Table") {
+    std::mt19937 rng(5);
+    std::vector<Move> moves;
+    int expiries = 0;
+    for (int round = 0; round < 20; round++) {
+        GameRules rules;
+        rules.coup_cost = 6;
+        Table table(3, 300, rules, 77);
+        table.recordHashes();
+        seatTable(table);
+
+        Message message;
+        table.describeSetup(message, 4);
+        LockstepReplica replica(overWire(message));
+        CHECK(replica.getMatch().getGame().getRules() == rules);
+        CHECK_FALSE(replica.getReport().diverged);
+
+        while (!table.isOver()) {
+            playEvent(table, rng, moves);
+            table.describeEvent(message, 4);
+            expiries += message.expiry ? 1 : 0;
+            size_t frame_size = 0;
+            const Message action = overWire(message, &frame_size);
+            CHECK(frame_size == (action.has_hash ? 25u : 17u));
+            REQUIRE(replica.apply(action));
+        }
+        CHECK(replica.getHashes() == table.getHashes());
+        CHECK(replica.getReport().last_verified == table.eventCount()); // The last event always carries a hash
+        CHECK(replica.getMatch().winner() == (table.winner() == NO_WINNER ? -1 : table.winner()));
+    }
+    CHECK(expiries > 0);
+}
+
+TEST_CASE("Desync Detector Finds The First Diverging Event") {
+    std::mt19937 rng(9);
+    std::vector<Move> moves;
+    Table table(8, 300, GameRules(), 3);
+    table.recordHashes();
+    seatTable(table);
+
+    Message message;
+    table.describeSetup(message, 4);
+    LockstepReplica replica(message);
+
+    for (uint32_t event = 1; event <= 10; event++) {
+        playEvent(table, rng, moves);
+        table.describeEvent(message, 4);
+        REQUIRE(replica.apply(message));
+    }
+    replica.getMatch().getGame().getPlayer(2)->addCoins(1); // The replica drifts right after event 10
+
+    while (!table.isOver() && table.eventCount() < 12) {
+        playEvent(table, rng, moves);
+        table.describeEvent(message, 4);
+        replica.apply(message);
+    }
+    REQUIRE(table.eventCount() == 12);
+    const DesyncReport& report = replica.getReport();
+    CHECK(report.diverged);
+    CHECK(report.last_verified == 8);
+    CHECK(report.detected_at == 12);
+    CHECK(firstDivergence(table.getHashes(), replica.getHashes()) == 11);
+
+    // Streams must stay in order and on one table
+    playEvent(table, rng, moves);
+    table.describeEvent(message, 4);
+    message.step++;
+    CHECK_THROWS_AS(replica.apply(message), std::invalid_argument);
+    message.step--;
+    message.table++;
+    CHECK_THROWS_AS(replica.apply(message), std::invalid_argument);
+
+    std::vector<uint64_t> same = table.getHashes();
+    CHECK(firstDivergence(table.getHashes(), same) == -1);
+}
+
+TEST_CASE("Lockstep Server Streams Actions") {
+    ServerConfig config;
+    config.lockstep_interval = 3;
+    GameServer server(config);
+    std::thread loop([&] { server.run(); });
+
+    ServerClient alice;
+    ServerClient bob;
+    alice.connectTcp("127.0.0.1", server.getPort());
+    bob.connectTcp("127.0.0.1", server.getPort());
+
+    Message message;
+    message.type = MessageType::JOIN;
+    message.role = RoleType::MERCHANT;
+    message.text = "Alice";
+    alice.send(message);
+    REQUIRE(alice.receive(message, 5000));
+    REQUIRE(message.type == MessageType::JOINED);
+    const uint32_t table = message.table;
+    message.type = MessageType::JOIN;
+    message.role = RoleType::SPY;
+    message.text = "Bob";
+    bob.send(message);
+    REQUIRE(bob.receive(message, 5000));
+    REQUIRE(message.type == MessageType::JOINED);
+
+    message.type = MessageType::START;
+    message.table = table;
+    alice.send(message);
+
+    ServerClient* clients[] = {&alice, &bob};
+    std::vector<std::unique_ptr<LockstepReplica>> replicas;
+    for (ServerClient* client : clients) {
+        REQUIRE(client->receive(message, 5000));
+        REQUIRE(message.type == MessageType::SETUP);
+        CHECK(message.seat_count == 2);
+        replicas.emplace_back(new LockstepReplica(message));
+    }
+
+    int hashed = 0;
+    while (!replicas[0]->getMatch().isOver()) {
+        const Match& match = replicas[0]->getMatch();
+        Message move;
+        move.type = MessageType::MOVE;
+        move.table = table;
+        move.move = simpleMove(match);
+        clients[match.decidingSeat()]->send(move);
+        for (size_t seat = 0; seat < 2; seat++) {
+            REQUIRE(clients[seat]->receive(message, 5000));
+            REQUIRE(message.type == MessageType::ACTION); // No STATE in lockstep mode
+            hashed += message.has_hash ? 1 : 0;
+            REQUIRE(replicas[seat]->apply(message));
+        }
+        REQUIRE(replicas[0]->eventCount() < 300);
+    }
+
+    REQUIRE(alice.receive(message, 5000));
+    CHECK(message.type == MessageType::GAME_OVER);
+    CHECK(message.seat == replicas[0]->getMatch().winner());
+    CHECK(replicas[1]->getReport().last_verified == replicas[1]->eventCount());
+    CHECK(hashed >= 2 * static_cast<int>(replicas[0]->eventCount() / 3));
+
+    server.stop();
+    loop.join();
+    CHECK(server.getStats().games_finished == 1);
+}
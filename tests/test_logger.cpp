@@ -0,0 +1,100 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the asynchronous logger
+ * Covers deferred formatting and delivery through a custom sink:
+ * - Placeholders are filled from captured integer, text, bool and floating arguments
+ * - Messages from several threads all reach the sink after flush()
+ * - Levels below COUP_LOG_LEVEL are compiled out without evaluating their arguments
+ */
+
+#include "doctest.h"
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/Logger.hpp"
+
+using namespace coup;
+
+// Count occurrences of a substring
+static size_t countOf(const std::string& text, const std::string& part) {
+    size_t count = 0;
+    for (size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + part.size())) {
+        count++;
+    }
+    return count;
+}
+
+TEST_CASE("Asynchronous Logger") {
+    std::mutex output_mutex;
+    std::string output;
+    Logger& logger = Logger::instance();
+    logger.flush();
+    logger.setSink([&](const std::string& batch) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        output += batch;
+    });
+
+    SUBCASE("Deferred formatting of captured arguments") {
+        std::string name = "Alice";
+        COUP_LOG_INFO("{} gathered, now {} coins (sanctioned: {})", name, 3, false);
+        COUP_LOG_ERROR("Literal {} and unsigned {}", "text", 7u);
+        COUP_LOG_WARNING("Missing argument {} {}", 1);
+        logger.flush();
+
+        CHECK(output.find("[INFO] Alice gathered, now 3 coins (sanctioned: false)\n") != std::string::npos);
+        CHECK(output.find("[ERROR] Literal text and unsigned 7\n") != std::string::npos);
+        CHECK(output.find("[WARNING] Missing argument 1 {}\n") != std::string::npos);
+
+        LogRecord record{};
+        record.format = "{}";
+        record.arg_count = 1;
+        record.args[0].type = LogArg::DOUBLE;
+        record.args[0].d = 1.5;
+        CHECK(Logger::format(record) == "1.500000");
+    }
+
+    SUBCASE("Long strings are truncated, not overflowed") {
+        std::string long_name(200, 'x');
+        COUP_LOG_INFO("{}|{}", long_name, "tail");
+        logger.flush();
+
+        CHECK(output.find("[INFO] " + std::string(LOG_TEXT_SIZE, 'x') + "|\n") != std::string::npos);
+    }
+
+    SUBCASE("Messages from many threads are all written") {
+        const int threads = 4;
+        const int per_thread = 500;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([t]() {
+                for (int i = 0; i < per_thread; i++) {
+                    COUP_LOG_INFO("worker {} message {}", t, i);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        logger.flush();
+
+        std::lock_guard<std::mutex> lock(output_mutex);
+        CHECK(countOf(output, "[INFO] worker ") + logger.droppedCount() == static_cast<size_t>(threads * per_thread));
+        CHECK(output.find("worker 3 message 0\n") != std::string::npos);
+    }
+
+    SUBCASE("Disabled levels do not evaluate arguments") {
+        int evaluated = 0;
+        COUP_LOG_DEBUG("never {}", ++evaluated);
+        logger.flush();
+
+        if (COUP_LOG_LEVEL > 0) {
+            CHECK(evaluated == 0);
+            CHECK(output.find("never") == std::string::npos);
+        }
+    }
+
+    logger.setSink(nullptr);
+}
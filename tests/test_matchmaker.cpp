@@ -0,0 +1,183 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the matchmaking queue
+ * Covers Matchmaker and WaitHistogram:
+ * - Entries within the base tolerance are seated at once, nearest ratings first, by table size
+ * - Tolerance widens step by step with waiting time until its cap, and cancelled entries are never seated
+ * - On random queues every table holds entries of its size within reach, and no seatable pair is left waiting
+ * - Wait times land in the right log2 buckets and percentiles
+ */
+
+#include "doctest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../include/server/Matchmaker.hpp"
+
+using namespace coup;
+
+TEST_CASE("Matchmaker Seats Nearest Ratings") {
+    Matchmaker queue;
+    std::vector<MatchGroup> formed;
+
+    CHECK_FALSE(queue.enqueue(1, 1500, 2, 0, formed));
+    CHECK_FALSE(queue.enqueue(2, 1600, 2, 0, formed)); // Beyond the base tolerance of 50
+    CHECK_FALSE(queue.enqueue(3, 1540, 3, 0, formed)); // Wants another table size
+    CHECK(queue.size() == 3);
+    CHECK(queue.size(2) == 2);
+    CHECK_THROWS_AS(queue.enqueue(1, 1500, 2, 0, formed), std::invalid_argument);
+    CHECK_THROWS_AS(queue.enqueue(9, 1500, 7, 0, formed), std::invalid_argument);
+    CHECK_THROWS_AS(queue.enqueue(9, 1500, 1, 0, formed), std::invalid_argument);
+
+    CHECK(queue.enqueue(4, 1530, 2, 10, formed)); // 30 from entry 1, 70 from entry 2
+    REQUIRE(formed.size() == 1);
+    CHECK(formed[0].seats == 2);
+    CHECK(formed[0].ids[0] == 1);
+    CHECK(formed[0].ids[1] == 4);
+    CHECK(formed[0].ratings[1] == 1530);
+    CHECK_FALSE(queue.isQueued(1));
+    CHECK(queue.isQueued(2));
+
+    // A full table takes the nearest neighbours on both sides
+    formed.clear();
+    queue.enqueue(10, 1000, 4, 0, formed);
+    queue.enqueue(11, 1040, 4, 0, formed);
+    queue.enqueue(12, 960, 4, 0, formed);
+    queue.enqueue(13, 1049, 4, 0, formed);
+    CHECK(queue.enqueue(14, 1010, 4, 0, formed));
+    REQUIRE(formed.size() == 1);
+    CHECK(std::vector<uint64_t>(formed[0].ids, formed[0].ids + 4) == std::vector<uint64_t>{10, 14, 11, 13});
+    CHECK(queue.isQueued(12));
+
+    CHECK(queue.cancel(12));
+    CHECK_FALSE(queue.cancel(12));
+    CHECK(queue.size(4) == 0);
+    CHECK(queue.waitTimes(2).count() == 2);
+    CHECK(queue.waitTimes(4).count() == 4);
+    CHECK(queue.waitTimes().count() == 6);
+}
+
+TEST_CASE("Matchmaker Widens Tolerance Over Time") {
+    MatchmakerConfig config;
+    config.base_tolerance = 50;
+    config.widen_per_second = 50;
+    config.max_tolerance = 200;
+    config.widen_interval_ms = 500;
+    Matchmaker queue(config);
+    std::vector<MatchGroup> formed;
+
+    queue.enqueue(1, 1500, 2, 0, formed);
+    queue.enqueue(2, 1590, 2, 200, formed);
+    CHECK(queue.nextPoll() == 500);
+    queue.poll(499, formed);
+    CHECK(formed.empty());
+    queue.poll(500, formed); // Entry 1 reaches 75
+    CHECK(formed.empty());
+    queue.poll(1000, formed); // Entry 1 reaches 100 and seats entry 2
+    REQUIRE(formed.size() == 1);
+    CHECK(formed[0].formed_ms == 1000);
+    CHECK(queue.size() == 0);
+    CHECK(queue.nextPoll() == UINT64_MAX);
+    CHECK(queue.waitTimes(2).longest() == 1000);
+
+    // No widening past the cap, so nothing is left to recheck
+    formed.clear();
+    queue.enqueue(3, 1000, 2, 2000, formed);
+    queue.enqueue(4, 1500, 2, 2000, formed);
+    queue.poll(10000, formed);
+    CHECK(formed.empty());
+    CHECK(queue.nextPoll() == UINT64_MAX);
+    CHECK(queue.size() == 2);
+
+    // A cancelled entry is neither rechecked nor seated
+    queue.enqueue(5, 3000, 2, 10000, formed);
+    CHECK(queue.cancel(5));
+    CHECK(queue.nextPoll() == UINT64_MAX);
+    queue.enqueue(6, 3010, 2, 10000, formed);
+    CHECK(formed.empty());
+
+    CHECK_THROWS_AS(Matchmaker(MatchmakerConfig{-1, 0, 0, 1}), std::invalid_argument);
+    CHECK_THROWS_AS(Matchmaker(MatchmakerConfig{0, 0, 0, 0}), std::invalid_argument);
+}
+
+TEST_CASE("Matchmaker Keeps Its Invariants On Random Queues") {
+    struct Waiting {
+        uint64_t id;
+        double rating;
+        uint8_t seats;
+    };
+    MatchmakerConfig config;
+    Matchmaker queue(config);
+    std::mt19937 rng(21);
+    std::normal_distribution<double> ratings(1500, 200);
+    std::vector<Waiting> waiting;
+    std::vector<MatchGroup> formed;
+    uint64_t now = 0;
+    uint64_t seated = 0;
+
+    for (uint64_t id = 1; id <= 5000; id++) {
+        now += rng() % 20;
+        formed.clear();
+        if (rng() % 8 == 0 && !waiting.empty()) {
+            const size_t gone = rng() % waiting.size();
+            CHECK(queue.cancel(waiting[gone].id));
+            waiting.erase(waiting.begin() + static_cast<long>(gone));
+        }
+        const uint8_t seats = static_cast<uint8_t>(2 + rng() % 5);
+        waiting.push_back({id, ratings(rng), seats});
+        queue.enqueue(id, waiting.back().rating, seats, now, formed);
+        queue.poll(now, formed);
+
+        for (const MatchGroup& group : formed) {
+            // Every seated entry was queued for this table size and lies within the widest tolerance
+            REQUIRE(std::is_sorted(group.ratings, group.ratings + group.seats));
+            CHECK(group.ratings[group.seats - 1] - group.ratings[0] <= 2 * config.max_tolerance);
+            for (uint8_t seat = 0; seat < group.seats; seat++) {
+                auto found = std::find_if(waiting.begin(), waiting.end(),
+                                          [&](const Waiting& entry) { return entry.id == group.ids[seat]; });
+                REQUIRE(found != waiting.end());
+                CHECK(found->seats == group.seats);
+                CHECK(found->rating == group.ratings[seat]);
+                waiting.erase(found);
+            }
+            seated += group.seats;
+        }
+
+        // Two waiting entries within the base tolerance would have met when the later one queued
+        if (id % 500 == 0) {
+            for (const Waiting& entry : waiting) {
+                for (const Waiting& other : waiting) {
+                    if (entry.seats == 2 && other.seats == 2 && other.id != entry.id) {
+                        CHECK(std::abs(other.rating - entry.rating) > config.base_tolerance);
+                    }
+                }
+            }
+        }
+    }
+    CHECK(queue.size() == waiting.size());
+    CHECK(seated > 2500);
+    CHECK(queue.waitTimes().count() == seated);
+}
+
+TEST_CASE("Wait Histogram Buckets") {
+    WaitHistogram histogram;
+    CHECK(histogram.percentile(0.5) == 0);
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(3);
+    histogram.record(900);
+    CHECK(histogram.bucketCount(0) == 1);
+    CHECK(histogram.bucketCount(1) == 1);
+    CHECK(histogram.bucketCount(2) == 1);
+    CHECK(histogram.bucketCount(10) == 1);
+    CHECK(WaitHistogram::bucketLimit(10) == 1023);
+    CHECK(histogram.percentile(0.5) == 1);
+    CHECK(histogram.percentile(0.75) == 3);
+    CHECK(histogram.percentile(1.0) == 900); // Capped at the longest wait
+    CHECK(histogram.mean() == doctest::Approx(226.0));
+    histogram.record(UINT64_MAX / 2);
+    CHECK(histogram.bucketCount(WaitHistogram::BUCKETS - 1) == 1);
+}
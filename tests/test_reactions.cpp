@@ -0,0 +1,187 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for reaction-window arbitration
+ * Covers ReactionArbiter and its use by Match:
+ * - Windows list exactly the seats that may answer, in seat order after the actor
+ * - Answers arrive in any order; the first reaction in priority wins once the seats ahead passed
+ * - Expiry passes the silent seats, and a window resolves only once
+ * - Windows match a full legal-action scan of every seat over random games
+ */
+
+#include "doctest.h"
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/ReactionWindow.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Merchant.hpp"
+#include "../include/roles/Spy.hpp"
+
+using namespace coup;
+
+namespace {
+    std::vector<uint8_t> respondersOf(const ReactionWindow& window) {
+        return std::vector<uint8_t>(window.responders, window.responders + window.responder_count);
+    }
+}
+
+TEST_CASE("Reaction Window Arbitration") {
+    Game game;
+    Spy spy(game, "Alice"); // Seat 0
+    General first(game, "Bob"); // Seat 1
+    Judge judge(game, "Charlie"); // Seat 2
+    General second(game, "Dana"); // Seat 3
+    Governor gov(game, "Eve"); // Seat 4
+    game.startGame();
+    ReactionArbiter arbiter(game);
+    ReactionWindow window{};
+
+    SUBCASE("Only the answering role, in seat order after the actor") {
+        spy.tax();
+        REQUIRE(arbiter.open(game, window, {ActionType::TAX, 0, NO_TARGET}));
+        CHECK(respondersOf(window) == std::vector<uint8_t>{4});
+        CHECK_FALSE(arbiter.open(game, window, {ActionType::TAX, 4, NO_TARGET})); // The only Governor acted
+        CHECK_FALSE(arbiter.open(game, window, {ActionType::GATHER, 0, NO_TARGET}));
+        CHECK_FALSE(window.isOpen());
+    }
+
+    SUBCASE("Lower priority reaction waits for the seats ahead") {
+        spy.addCoins(7);
+        first.addCoins(5);
+        second.addCoins(5);
+        spy.coup(judge);
+        const Action coup{ActionType::COUP, 0, 2};
+        REQUIRE(arbiter.open(game, window, coup));
+        CHECK(respondersOf(window) == std::vector<uint8_t>{1, 3});
+
+        CHECK_FALSE(arbiter.respond(game, window, 3, true)); // Seat 1 may still react first
+        CHECK_FALSE(judge.isActive());
+        CHECK(ReactionArbiter::isWaitingOn(window, 1));
+        CHECK_FALSE(ReactionArbiter::isWaitingOn(window, 3));
+        CHECK_THROWS_AS(arbiter.respond(game, window, 3, false), std::runtime_error); // Answered already
+
+        CHECK(arbiter.respond(game, window, 1, false));
+        CHECK(judge.isActive());
+        CHECK(second.coins() == 0);
+        CHECK(first.coins() == 5);
+        CHECK_THROWS_AS(arbiter.respond(game, window, 1, true), std::runtime_error); // Resolved once
+    }
+
+    SUBCASE("Higher priority reaction wins at once") {
+        spy.addCoins(7);
+        first.addCoins(5);
+        second.addCoins(5);
+        spy.coup(judge);
+        REQUIRE(arbiter.open(game, window, {ActionType::COUP, 0, 2}));
+        CHECK(arbiter.respond(game, window, 1, true));
+        CHECK(judge.isActive());
+        CHECK(first.coins() == 0);
+        CHECK(second.coins() == 5);
+    }
+
+    SUBCASE("Expiry passes the silent seats") {
+        spy.addCoins(7);
+        first.addCoins(5);
+        second.addCoins(5);
+        spy.coup(judge);
+        REQUIRE(arbiter.open(game, window, {ActionType::COUP, 0, 2}));
+        arbiter.respond(game, window, 3, true);
+        arbiter.expire(game, window);
+        CHECK_FALSE(window.isOpen());
+        CHECK(judge.isActive()); // Seat 1 stayed silent, so seat 3's block stands
+        CHECK(second.coins() == 0);
+
+        game.nextTurn(); // Charlie's turn, after Bob's
+        judge.addCoins(7);
+        judge.coup(gov);
+        REQUIRE(arbiter.open(game, window, {ActionType::COUP, 2, 4}));
+        CHECK(respondersOf(window) == std::vector<uint8_t>{1}); // Dana cannot pay anymore
+        arbiter.expire(game, window);
+        CHECK_FALSE(gov.isActive());
+    }
+
+    SUBCASE("Priority wraps around the table") {
+        spy.addCoins(7);
+        first.addCoins(5);
+        second.addCoins(5);
+        game.nextTurn();
+        game.nextTurn(); // Charlie's turn
+        judge.addCoins(7);
+        judge.coup(spy);
+        REQUIRE(arbiter.open(game, window, {ActionType::COUP, 2, 0}));
+        CHECK(respondersOf(window) == std::vector<uint8_t>{3, 1});
+    }
+
+    SUBCASE("Match takes answers out of order") {
+        Match match(game);
+        spy.addCoins(7);
+        first.addCoins(5);
+        second.addCoins(5);
+        match.apply(Move::play({ActionType::COUP, 0, 2}));
+        REQUIRE(match.inReactionWindow());
+        CHECK(match.decidingSeat() == 1);
+        CHECK(match.mayAnswer(3));
+        CHECK_FALSE(match.mayAnswer(2));
+        CHECK_THROWS(match.apply(Move::play({ActionType::BLOCK_COUP, 3, 0}))); // Not the window's reaction
+
+        match.apply(Move::play({ActionType::BLOCK_COUP, 3, 2}));
+        CHECK(match.inReactionWindow());
+        CHECK(match.decidingSeat() == 1);
+        match.apply(Move::decline(1));
+        CHECK_FALSE(match.inReactionWindow());
+        CHECK(judge.isActive());
+        CHECK(match.decidingSeat() == 1); // Bob's turn
+    }
+}
+
+TEST_CASE("Reaction Windows Match A Full Scan") {
+    std::mt19937 rng(11);
+    std::vector<Move> moves;
+    std::vector<Action> legal;
+    int windows = 0;
+    for (int round = 0; round < 200; round++) {
+        Game game;
+        Governor gov(game, "Gov");
+        General general(game, "Gen");
+        Judge judge(game, "Judge");
+        General other(game, "Gen2");
+        Spy spy(game, "Spy");
+        Baron baron(game, "Baron");
+        game.startGame();
+        Match match(game, 300);
+
+        while (!match.isOver()) {
+            if (match.inReactionWindow() && match.getState().window.next_responder == 0) {
+                // Reference: every other seat in order after the actor whose legal actions hold the reaction
+                const ReactionWindow& window = match.getState().window;
+                std::vector<uint8_t> expected;
+                const size_t count = game.getPlayerCount();
+                for (size_t offset = 1; offset < count; offset++) {
+                    const uint8_t seat = static_cast<uint8_t>((window.trigger.actor + offset) % count);
+                    Action reaction;
+                    ReactionArbiter::reactionFor(window.trigger, seat, reaction);
+                    legalActions(game, seat, legal);
+                    for (const Action& action : legal) {
+                        if (action == reaction) {
+                            expected.push_back(seat);
+                        }
+                    }
+                }
+                CHECK(respondersOf(window) == expected);
+                windows++;
+            }
+            match.moves(moves);
+            REQUIRE_FALSE(moves.empty());
+            match.apply(moves[rng() % moves.size()]);
+        }
+    }
+    CHECK(windows > 100);
+}
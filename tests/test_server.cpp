@@ -0,0 +1,630 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the game server
+ * Covers the binary protocol and a live server on loopback sockets:
+ * - Every message type survives an encode/decode round trip, partial frames wait for more bytes
+ * - JOINED and REJOIN carry the seat token
+ * - STATE carries only the changed seats, decoding reads text in place from the frame
+ * - A reused decode target never keeps the text of an earlier frame
+ * - Malformed frames and other protocol versions are rejected, and the server drops the client that sent them
+ * - Clients join, start and play a full game over TCP; illegal requests get ERROR replies
+ * - Requests read after a JOIN, into a grown input buffer, carry no stale name
+ * - The Unix socket listener serves the same protocol
+ * - The SPSC and MPSC rings keep order across wrap-around and threads
+ * - Sharded servers forward requests and replies between shards, full table queues answer TABLE_BUSY
+ * - The timer wheel fires every timer exactly at its tick across all levels, cancelled ones never
+ * - Seats that run out of time get default moves until the game ends
+ */
+
+#include "doctest.h"
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../include/server/Protocol.hpp"
+#include "../include/server/GameServer.hpp"
+#include "../include/server/ServerClient.hpp"
+#include "../include/server/MpscQueue.hpp"
+#include "../include/server/SpscQueue.hpp"
+#include "../include/server/TimerWheel.hpp"
+
+using namespace coup;
+
+namespace {
+    Message join(uint32_t table, RoleType role, const std::string& name) {
+        Message message;
+        message.type = MessageType::JOIN;
+        message.table = table;
+        message.role = role;
+        message.text = name;
+        return message;
+    }
+
+    Message request(MessageType type, uint32_t table, const Move& move = Move::decline(0)) {
+        Message message;
+        message.type = type;
+        message.table = table;
+        message.move = move;
+        return message;
+    }
+
+    Message expect(ServerClient& client, MessageType type) {
+        Message message;
+        REQUIRE(client.receive(message, 5000));
+        if (message.type == MessageType::ERROR) {
+            INFO("Server error: " << message.text);
+            CHECK(type == MessageType::ERROR);
+        }
+        REQUIRE(message.type == type);
+        return message;
+    }
+
+    // Plays the simplest legal strategy: pass every window, coup when affordable, gather otherwise
+    Move simpleMove(const Message& state) {
+        if (state.window) {
+            return Move::decline(state.seat);
+        }
+        if (state.seats[state.seat].coins >= 7) {
+            for (uint8_t target = 0; target < state.seat_count; target++) {
+                if (target != state.seat && state.seats[target].active) {
+                    return Move::play({ActionType::COUP, state.seat, target});
+                }
+            }
+        }
+        return Move::play({ActionType::GATHER, state.seat, NO_TARGET});
+    }
+
+    // Plays the table to the end with one client per seat; returns the number of moves
+    int playOut(const std::vector<ServerClient*>& seats, uint32_t table, Message state, Message& over) {
+        int moves = 0;
+        while (true) {
+            seats[state.seat]->send(request(MessageType::MOVE, table, simpleMove(state)));
+            for (ServerClient* seat : seats) {
+                state = expect(*seat, MessageType::STATE);
+            }
+            moves++;
+            if (state.seat == NO_WINNER) { // The state after the last move is followed by GAME_OVER
+                for (ServerClient* seat : seats) {
+                    over = expect(*seat, MessageType::GAME_OVER);
+                }
+                return moves;
+            }
+            REQUIRE(moves < 300);
+        }
+    }
+}
+
+TEST_CASE("Protocol Round Trip") {
+    std::vector<uint8_t> buffer;
+    Message state;
+    state.type = MessageType::STATE;
+    state.table = 70000;
+    state.seat = 2;
+    state.step = 123456;
+    state.window = true;
+    state.move = Move::play({ActionType::COUP, 1, 2});
+    state.seat_count = 6;
+    state.changed = 0x3F;
+    for (uint8_t seat = 0; seat < 6; seat++) {
+        state.seats[seat] = {seat, seat % 2 == 0, static_cast<uint16_t>(seat * 300)};
+    }
+
+    encodeMessage(join(5, RoleType::JUDGE, "Alice"), buffer);
+    encodeMessage(request(MessageType::MOVE, 5, Move::decline(3)), buffer);
+    encodeMessage(state, buffer);
+    const size_t state_end = buffer.size();
+
+    Message error;
+    error.type = MessageType::ERROR;
+    error.table = 9;
+    error.error = ServerError::ILLEGAL_MOVE;
+    error.text = "Not your decision";
+    encodeMessage(error, buffer);
+
+    Message out;
+    size_t offset = decodeMessage(buffer.data(), buffer.size(), out);
+    CHECK(out.type == MessageType::JOIN);
+    CHECK(out.table == 5);
+    CHECK(out.role == RoleType::JUDGE);
+    CHECK(out.text == "Alice");
+    CHECK(reinterpret_cast<const uint8_t*>(out.text.data()) > buffer.data()); // Points into the frame
+
+    offset += decodeMessage(buffer.data() + offset, buffer.size() - offset, out);
+    CHECK(out.type == MessageType::MOVE);
+    CHECK(out.move == Move::decline(3));
+
+    const size_t state_start = offset;
+    offset += decodeMessage(buffer.data() + offset, buffer.size() - offset, out);
+    CHECK(offset - state_start == 44);
+    CHECK(out.type == MessageType::STATE);
+    CHECK(out.table == 70000);
+    CHECK(out.step == 123456);
+    CHECK(out.window);
+    CHECK(out.move == state.move);
+    CHECK(out.seat_count == 6);
+    CHECK(out.seats[5].coins == 1500);
+    CHECK(out.seats[4].active);
+    CHECK_FALSE(out.seats[3].active);
+
+    offset += decodeMessage(buffer.data() + offset, buffer.size() - offset, out);
+    CHECK(out.type == MessageType::ERROR);
+    CHECK(out.error == ServerError::ILLEGAL_MOVE);
+    CHECK(out.text == "Not your decision");
+    CHECK(offset == buffer.size());
+
+    // Partial frames are not consumed
+    for (size_t size = 0; size < state_end - state_start; size++) {
+        CHECK(decodeMessage(buffer.data() + state_start, size, out) == 0);
+    }
+
+    // A delta carries the changed seats only; the others keep what the caller had
+    buffer.clear();
+    state.changed = 0x12;
+    state.seats[1].coins = 9;
+    encodeMessage(state, buffer);
+    CHECK(buffer.size() == 28);
+    out.seats[1] = {};
+    out.seats[2] = {7, true, 77};
+    CHECK(decodeMessage(buffer.data(), buffer.size(), out) == buffer.size());
+    CHECK(out.changed == 0x12);
+    CHECK(out.seats[1].coins == 9);
+    CHECK(out.seats[4].coins == 1200);
+    CHECK(out.seats[2].coins == 77);
+
+    // JOINED hands out the seat token that REJOIN sends back
+    for (MessageType type : {MessageType::JOINED, MessageType::REJOIN}) {
+        buffer.clear();
+        Message seated;
+        seated.type = type;
+        seated.table = 12;
+        seated.seat = 3;
+        seated.token = 0x0123456789ABCDEFull;
+        encodeMessage(seated, buffer);
+        CHECK(buffer.size() == 17);
+        CHECK(decodeMessage(buffer.data(), buffer.size(), out) == buffer.size());
+        CHECK(out.type == type);
+        CHECK(out.seat == 3);
+        CHECK(out.token == seated.token);
+    }
+
+    // Malformed frames
+    const uint8_t unknown_type[] = {5, 0, PROTOCOL_VERSION, 0x7F, 1, 0, 0, 0};
+    CHECK_THROWS_AS(decodeMessage(unknown_type, sizeof(unknown_type), out), std::invalid_argument);
+    const uint8_t bad_role[] = {8, 0, PROTOCOL_VERSION, 0x01, 1, 0, 0, 0, 9, 1, 'A'};
+    CHECK_THROWS_AS(decodeMessage(bad_role, sizeof(bad_role), out), std::invalid_argument);
+    const uint8_t trailing[] = {6, 0, PROTOCOL_VERSION, 0x02, 1, 0, 0, 0, 0};
+    CHECK_THROWS_AS(decodeMessage(trailing, sizeof(trailing), out), std::invalid_argument);
+    const uint8_t bad_action[] = {9, 0, PROTOCOL_VERSION, 0x03, 1, 0, 0, 0, 0, 40, 0, 0};
+    CHECK_THROWS_AS(decodeMessage(bad_action, sizeof(bad_action), out), std::invalid_argument);
+    const uint8_t bad_changed[] = {17, 0, PROTOCOL_VERSION, 0x82, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0x04};
+    CHECK_THROWS_AS(decodeMessage(bad_changed, sizeof(bad_changed), out), std::invalid_argument);
+    const uint8_t unversioned_start[] = {5, 0, 0x02, 1, 0, 0, 0};
+    CHECK_THROWS_AS(decodeMessage(unversioned_start, 3, out), std::invalid_argument); // Before the body arrives
+    CHECK_THROWS_AS(encodeMessage(join(1, RoleType::SPY, "Much too long"), buffer), std::invalid_argument);
+
+    // The second frame has no text, so the target must not keep the view into the first
+    std::vector<uint8_t> first;
+    std::vector<uint8_t> second;
+    encodeMessage(join(3, RoleType::JUDGE, "Judy"), first);
+    encodeMessage(request(MessageType::START, 3), second);
+    Message reused;
+    REQUIRE(decodeMessage(first.data(), first.size(), reused) == first.size());
+    CHECK(reused.text == "Judy");
+    REQUIRE(decodeMessage(second.data(), second.size(), reused) == second.size());
+    CHECK(reused.type == MessageType::START);
+    CHECK(reused.text.empty());
+}
+
+TEST_CASE("Server Plays A Game Over TCP") {
+    GameServer server;
+    std::thread loop([&] { server.run(); });
+
+    ServerClient alice;
+    ServerClient bob;
+    alice.connectTcp("127.0.0.1", server.getPort());
+    bob.connectTcp("127.0.0.1", server.getPort());
+
+    alice.send(join(0, RoleType::GOVERNOR, "Alice"));
+    const Message joined = expect(alice, MessageType::JOINED);
+    const uint32_t table = joined.table;
+    CHECK(joined.seat == 0);
+    bob.send(join(table, RoleType::SPY, "Bob"));
+    CHECK(expect(bob, MessageType::JOINED).seat == 1);
+
+    bob.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 1, NO_TARGET})));
+    CHECK(expect(bob, MessageType::ERROR).error == ServerError::NOT_STARTED);
+    bob.send(request(MessageType::START, table + 1));
+    CHECK(expect(bob, MessageType::ERROR).error == ServerError::UNKNOWN_TABLE);
+
+    alice.send(request(MessageType::START, table));
+    Message state = expect(alice, MessageType::STATE);
+    CHECK(expect(bob, MessageType::STATE).seat == 0);
+    CHECK(state.seat_count == 2);
+    CHECK(state.seats[0].role == static_cast<uint8_t>(RoleType::GOVERNOR));
+
+    // Out of turn, then a real move validated by the Governor's tax
+    bob.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 1, NO_TARGET})));
+    const Message error = expect(bob, MessageType::ERROR);
+    CHECK(error.error == ServerError::ILLEGAL_MOVE);
+    CHECK(error.text == "Not your decision");
+    alice.send(request(MessageType::MOVE, table, Move::play({ActionType::TAX, 0, NO_TARGET})));
+    state = expect(alice, MessageType::STATE);
+    expect(bob, MessageType::STATE);
+    CHECK(state.seats[0].coins == 3);
+    CHECK(state.step == 1);
+
+    // Play the game out
+    Message over;
+    const int moves = playOut({&alice, &bob}, table, state, over);
+    CHECK(over.table == table);
+    CHECK(over.seat < 2);
+
+    // The finished table is gone
+    alice.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 0, NO_TARGET})));
+    CHECK(expect(alice, MessageType::ERROR).error == ServerError::UNKNOWN_TABLE);
+
+    server.stop();
+    loop.join();
+    CHECK(server.tableCount() == 0);
+    CHECK(server.getStats().games_finished == 1);
+    CHECK(server.getStats().moves == static_cast<uint64_t>(moves) + 1);
+    CHECK(server.getStats().accepted == 2);
+}
+
+TEST_CASE("Requests After A Join Carry No Stale Name") {
+    GameServer server;
+    std::thread loop([&] { server.run(); });
+
+    ServerClient alice;
+    alice.connectTcp("127.0.0.1", server.getPort());
+    alice.send(join(0, RoleType::GOVERNOR, "Alice"));
+    const uint32_t table = expect(alice, MessageType::JOINED).table;
+
+    // A separate read large enough to make the server grow (and move) its input buffer
+    std::vector<uint8_t> burst;
+    const int requests = 600;
+    for (int i = 0; i < requests; i++) {
+        encodeMessage(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 0, NO_TARGET})), burst);
+    }
+    alice.sendRaw(burst.data(), burst.size());
+    for (int i = 0; i < requests; i++) {
+        CHECK(expect(alice, MessageType::ERROR).error == ServerError::NOT_STARTED);
+    }
+
+    ServerClient bob;
+    bob.connectTcp("127.0.0.1", server.getPort());
+    bob.send(join(table, RoleType::SPY, "Bob"));
+    CHECK(expect(bob, MessageType::JOINED).seat == 1);
+
+    server.stop();
+    loop.join();
+}
+
+TEST_CASE("Server Over Unix Socket") {
+    const std::string path = "/tmp/coup_test_server_" + std::to_string(::getpid()) + ".sock";
+    ServerConfig config;
+    config.tcp_port = -1;
+    config.unix_path = path;
+    config.max_tables = 1;
+    GameServer server(config);
+    std::thread loop([&] { server.run(); });
+
+    ServerClient client;
+    client.connectUnix(path);
+    client.send(join(0, RoleType::BARON, "")); // The engine rejects empty names
+    CHECK(expect(client, MessageType::ERROR).error == ServerError::SEAT_UNAVAILABLE);
+
+    client.send(join(0, RoleType::BARON, "Carol"));
+    const uint32_t table = expect(client, MessageType::JOINED).table;
+    client.send(join(0, RoleType::JUDGE, "Dave"));
+    CHECK(expect(client, MessageType::ERROR).error == ServerError::TABLE_LIMIT);
+    client.send(request(MessageType::START, table));
+    CHECK(expect(client, MessageType::ERROR).text == "Need at least 2 players to start!");
+
+    // One client may hold several seats
+    client.send(join(table, RoleType::JUDGE, "Dave"));
+    CHECK(expect(client, MessageType::JOINED).seat == 1);
+    client.send(request(MessageType::START, table));
+    CHECK(expect(client, MessageType::STATE).seat == 0);
+
+    // Garbage closes the connection after an error reply
+    const uint8_t garbage[] = {3, 0, 0x55, 0, 0};
+    client.sendRaw(garbage, sizeof(garbage));
+    CHECK(expect(client, MessageType::ERROR).error == ServerError::MALFORMED);
+    Message message;
+    CHECK_THROWS_AS(client.receive(message, 5000), std::runtime_error);
+
+    server.stop();
+    loop.join();
+    CHECK(server.getStats().closed == 1);
+    CHECK(server.tableCount() == 1); // Seats of dropped clients stay until the game ends
+}
+
+TEST_CASE("SPSC Queue") {
+    SpscQueue<int> queue(5);
+    CHECK(queue.capacity() == 8);
+    int value = 0;
+    CHECK_FALSE(queue.tryPop(value));
+    for (int round = 0; round < 3; round++) { // Wraps around the ring
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.tryPush(round * 8 + i));
+        }
+        CHECK_FALSE(queue.tryPush(-1));
+        CHECK(queue.size() == 8);
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.tryPop(value));
+            CHECK(value == round * 8 + i);
+        }
+    }
+
+    // One producer thread, one consumer thread, everything arrives in order
+    SpscQueue<uint64_t> shared(64);
+    const uint64_t count = 200000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < count; i++) {
+            while (!shared.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t expected = 0;
+    bool ordered = true;
+    uint64_t received;
+    while (expected < count) {
+        if (shared.tryPop(received)) {
+            ordered = ordered && received == expected;
+            expected++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(shared.size() == 0);
+}
+
+TEST_CASE("MPSC Queue") {
+    MpscQueue<int> queue(1);
+    CHECK(queue.capacity() == 2);
+    int value = 0;
+    CHECK_FALSE(queue.tryPop(value));
+    for (int round = 0; round < 3; round++) { // Wraps around the ring
+        CHECK(queue.tryPush(round));
+        CHECK(queue.tryPush(round + 10));
+        CHECK_FALSE(queue.tryPush(-1));
+        CHECK(queue.tryPop(value));
+        CHECK(value == round);
+        CHECK(queue.tryPop(value));
+        CHECK(value == round + 10);
+        CHECK_FALSE(queue.tryPop(value));
+    }
+
+    // Several producers at once: nothing is lost and each producer's values stay in order
+    MpscQueue<uint64_t> shared(64);
+    const uint64_t producers = 4;
+    const uint64_t each = 50000;
+    std::vector<std::thread> threads;
+    for (uint64_t p = 0; p < producers; p++) {
+        threads.emplace_back([&shared, p, each] {
+            for (uint64_t i = 0; i < each; i++) {
+                while (!shared.tryPush(p << 32 | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<uint64_t> next(producers, 0);
+    bool ordered = true;
+    uint64_t received;
+    for (uint64_t total = 0; total < producers * each;) {
+        if (shared.tryPop(received)) {
+            const uint64_t p = received >> 32;
+            ordered = ordered && p < producers && (received & 0xFFFFFFFF) == next[p];
+            next[p]++;
+            total++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(ordered);
+    CHECK(shared.size() == 0);
+}
+
+TEST_CASE("Sharded Server Forwards Between Shards") {
+    const std::string path = "/tmp/coup_test_shards_" + std::to_string(::getpid()) + ".sock";
+    ServerConfig config;
+    config.unix_path = path;
+    config.shards = 3;
+    config.table_queue_capacity = 4;
+    GameServer server(config);
+    CHECK(server.shardCount() == 3);
+    std::thread loop([&] { server.run(); });
+
+    // Unix clients are handed to shards 0, 1 and 2 in turn
+    ServerClient first;
+    ServerClient second;
+    ServerClient third;
+    first.connectUnix(path);
+    second.connectUnix(path);
+    third.connectUnix(path);
+
+    // The table lives on the shard of the client that created it, the others reach it through queues
+    second.send(join(0, RoleType::GENERAL, "Gina"));
+    const Message joined = expect(second, MessageType::JOINED);
+    const uint32_t table = joined.table;
+    CHECK(table % 3 == 1);
+    first.send(join(table, RoleType::MERCHANT, "Max"));
+    CHECK(expect(first, MessageType::JOINED).seat == 1);
+    third.send(join(table, RoleType::BARON, "Ben"));
+    CHECK(expect(third, MessageType::JOINED).seat == 2);
+
+    // A new table with an explicit id is created on the shard that owns the id
+    third.send(join(9, RoleType::SPY, "Sam"));
+    CHECK(expect(third, MessageType::JOINED).table == 9);
+    second.send(request(MessageType::START, 9));
+    CHECK(expect(second, MessageType::ERROR).error == ServerError::NOT_SEATED);
+
+    // Seated clients of other shards push into the table queue; a burst overflows it
+    std::vector<uint8_t> burst;
+    for (int i = 0; i < 16; i++) {
+        encodeMessage(request(MessageType::MOVE, table), burst);
+    }
+    first.sendRaw(burst.data(), burst.size());
+    int busy = 0;
+    for (int i = 0; i < 16; i++) {
+        const ServerError error = expect(first, MessageType::ERROR).error;
+        CHECK((error == ServerError::NOT_STARTED || error == ServerError::TABLE_BUSY));
+        busy += error == ServerError::TABLE_BUSY;
+    }
+    CHECK(busy > 0);
+
+    first.send(request(MessageType::START, table));
+    Message state = expect(first, MessageType::STATE);
+    expect(second, MessageType::STATE);
+    expect(third, MessageType::STATE);
+    CHECK(state.seat_count == 3);
+
+    Message over;
+    const int moves = playOut({&second, &first, &third}, table, state, over);
+    CHECK(over.table == table);
+    CHECK(over.seat < 3);
+
+    // TCP clients work too, whichever shard the kernel picks
+    ServerClient remote;
+    remote.connectTcp("127.0.0.1", server.getPort());
+    remote.send(request(MessageType::START, table));
+    CHECK(expect(remote, MessageType::ERROR).error == ServerError::UNKNOWN_TABLE);
+
+    server.stop();
+    loop.join();
+    const ServerStats stats = server.getStats();
+    CHECK(stats.games_finished == 1);
+    CHECK(stats.moves == static_cast<uint64_t>(moves));
+    CHECK(stats.forwarded > 0);
+    CHECK(stats.queued > 0);
+    CHECK(stats.backpressured == static_cast<uint64_t>(busy));
+    CHECK(stats.accepted == 4);
+    CHECK(server.tableCount() == 1); // Table 9 is still waiting for players
+}
+
+TEST_CASE("Timer Wheel") {
+    TimerWheel wheel(5);
+    std::vector<uint64_t> expired;
+    CHECK(wheel.ticksUntilNext() == UINT64_MAX);
+
+    // Same-tick timers fire in scheduling order, past due ones on the next tick
+    const TimerId first = wheel.schedule(7, 1);
+    wheel.schedule(7, 2);
+    wheel.schedule(2, 3);
+    CHECK(wheel.ticksUntilNext() == 0);
+    wheel.advance(6, expired);
+    CHECK(expired == std::vector<uint64_t>{3});
+    CHECK(wheel.ticksUntilNext() == 0); // Tick 7 is the next to process
+    wheel.advance(7, expired);
+    CHECK(expired == std::vector<uint64_t>{3, 1, 2});
+    CHECK_FALSE(wheel.cancel(first)); // Already fired
+    CHECK(wheel.size() == 0);
+
+    // Random timers across every level and past the wheel's range, half of them cancelled
+    std::mt19937_64 random(42);
+    const uint64_t start = wheel.now();
+    std::vector<uint64_t> due;
+    std::vector<TimerId> ids;
+    std::vector<bool> cancelled;
+    for (uint64_t i = 0; i < 20000; i++) {
+        const uint64_t range = i % 10 == 0 ? (uint64_t(1) << 26) : (i % 3 == 0 ? 300000 : 5000);
+        due.push_back(start + random() % range);
+        ids.push_back(wheel.schedule(due.back(), i));
+        cancelled.push_back(false);
+    }
+    size_t live = ids.size();
+    for (size_t i = 0; i < ids.size(); i += 2) {
+        CHECK(wheel.cancel(ids[i]));
+        CHECK_FALSE(wheel.cancel(ids[i]));
+        cancelled[i] = true;
+        live--;
+    }
+    CHECK(wheel.size() == live);
+
+    std::vector<bool> fired(ids.size(), false);
+    bool exact = true;
+    uint64_t previous = wheel.now() - 1;
+    while (wheel.size() > 0) {
+        CHECK(wheel.ticksUntilNext() <= 64);
+        const uint64_t now = previous + 1 + random() % 20000;
+        expired.clear();
+        wheel.advance(now, expired);
+        uint64_t last_due = 0;
+        for (uint64_t payload : expired) {
+            exact = exact && !cancelled[payload] && !fired[payload] && due[payload] > previous &&
+                    due[payload] <= now && due[payload] >= last_due;
+            fired[payload] = true;
+            last_due = due[payload];
+        }
+        previous = now;
+    }
+    CHECK(exact);
+    for (size_t i = 0; i < ids.size(); i++) {
+        CHECK(fired[i] != cancelled[i]);
+    }
+
+    // Handles of recycled nodes stay dead
+    const TimerId reused = wheel.schedule(previous + 10, 7);
+    CHECK_FALSE(wheel.cancel(ids[0]));
+    CHECK(wheel.cancel(reused));
+}
+
+TEST_CASE("Server Plays Default Moves On Timeout") {
+    ServerConfig config;
+    config.turn_timeout_ms = 15;
+    config.reaction_timeout_ms = 2;
+    GameServer server(config);
+    std::thread loop([&] { server.run(); });
+
+    ServerClient alice;
+    ServerClient bob;
+    alice.connectTcp("127.0.0.1", server.getPort());
+    bob.connectTcp("127.0.0.1", server.getPort());
+    alice.send(join(0, RoleType::GOVERNOR, "Alice"));
+    const uint32_t table = expect(alice, MessageType::JOINED).table;
+    bob.send(join(table, RoleType::GENERAL, "Bob"));
+    expect(bob, MessageType::JOINED);
+    alice.send(request(MessageType::START, table));
+    Message state = expect(alice, MessageType::STATE);
+    expect(bob, MessageType::STATE);
+
+    // One move of its own, then nobody answers and the server plays every decision
+    alice.send(request(MessageType::MOVE, table, simpleMove(state)));
+    int moves = 0;
+    bool windows = false;
+    while (true) {
+        state = expect(alice, MessageType::STATE);
+        CHECK(expect(bob, MessageType::STATE).step == state.step);
+        moves++;
+        windows = windows || state.window;
+        if (state.seat == NO_WINNER) {
+            break;
+        }
+        REQUIRE(moves < 300);
+    }
+    const Message over = expect(alice, MessageType::GAME_OVER);
+    expect(bob, MessageType::GAME_OVER);
+    CHECK(over.seat < 2);
+    CHECK(windows); // Alice's forced coup opens Bob's General window, which times out as a pass
+
+    server.stop();
+    loop.join();
+    const ServerStats stats = server.getStats();
+    CHECK(stats.moves == static_cast<uint64_t>(moves));
+    CHECK(stats.timeouts == static_cast<uint64_t>(moves - 1));
+    CHECK(server.tableCount() == 0);
+}
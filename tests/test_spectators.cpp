@@ -0,0 +1,181 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for spectators
+ * Covers WATCH and the shared-frame fan-out of the server:
+ * - Spectators on the owner shard and on other shards get a full STATE, every update and the GAME_OVER
+ * - Their merged views match the players' views, and watching twice or too early is refused
+ * - A spectator that falls behind loses the queued updates and catches up from one fresh full STATE
+ */
+
+#include "doctest.h"
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../include/server/GameServer.hpp"
+#include "../include/server/ServerClient.hpp"
+
+using namespace coup;
+
+namespace {
+    Message join(uint32_t table, RoleType role, const std::string& name) {
+        Message message;
+        message.type = MessageType::JOIN;
+        message.table = table;
+        message.role = role;
+        message.text = name;
+        return message;
+    }
+
+    Message request(MessageType type, uint32_t table, const Move& move = Move::decline(0)) {
+        Message message;
+        message.type = type;
+        message.table = table;
+        message.move = move;
+        return message;
+    }
+
+    Message expect(ServerClient& client, MessageType type) {
+        Message message;
+        REQUIRE(client.receive(message, 5000));
+        if (message.type == MessageType::ERROR) {
+            INFO("Server error: " << std::string(message.text));
+            CHECK(type == MessageType::ERROR);
+        }
+        REQUIRE(message.type == type);
+        return message;
+    }
+
+    void checkSameView(const Message& a, const Message& b) {
+        REQUIRE(a.seat_count == b.seat_count);
+        CHECK(a.step == b.step);
+        CHECK(a.seat == b.seat);
+        for (uint8_t seat = 0; seat < a.seat_count; seat++) {
+            CHECK(a.seats[seat] == b.seats[seat]);
+        }
+    }
+}
+
+TEST_CASE("Spectators Follow A Table Across Shards") {
+    const std::string path = "/tmp/coup_test_spectators_" + std::to_string(::getpid()) + ".sock";
+    ServerConfig config;
+    config.unix_path = path;
+    config.shards = 2;
+    GameServer server(config);
+    std::thread loop([&] { server.run(); });
+
+    // Unix clients are handed to shards 0 and 1 in turn
+    ServerClient alice;
+    ServerClient bob;
+    ServerClient near;
+    ServerClient far;
+    alice.connectUnix(path);
+    bob.connectUnix(path);
+    near.connectUnix(path);
+    far.connectUnix(path);
+
+    alice.send(join(0, RoleType::GENERAL, "Alice"));
+    const uint32_t table = expect(alice, MessageType::JOINED).table;
+    CHECK(table % 2 == 0);
+    bob.send(join(table, RoleType::MERCHANT, "Bob"));
+    expect(bob, MessageType::JOINED);
+
+    near.send(request(MessageType::WATCH, table));
+    CHECK(expect(near, MessageType::ERROR).error == ServerError::NOT_STARTED);
+    far.send(request(MessageType::WATCH, table + 2));
+    CHECK(expect(far, MessageType::ERROR).error == ServerError::UNKNOWN_TABLE);
+
+    alice.send(request(MessageType::START, table));
+    Message state = expect(alice, MessageType::STATE);
+    expect(bob, MessageType::STATE);
+
+    // The first STATE of a spectator is the full table, then it gets what the seats get
+    near.send(request(MessageType::WATCH, table));
+    far.send(request(MessageType::WATCH, table));
+    checkSameView(expect(near, MessageType::STATE), state);
+    checkSameView(expect(far, MessageType::STATE), state);
+    near.send(request(MessageType::WATCH, table));
+    CHECK(expect(near, MessageType::ERROR).error == ServerError::SEAT_UNAVAILABLE);
+
+    ServerClient* seats[] = {&alice, &bob};
+    int moves = 0;
+    while (state.seat != NO_WINNER) {
+        Move move = Move::play({ActionType::GATHER, state.seat, NO_TARGET});
+        if (state.window) {
+            move = Move::decline(state.seat);
+        }
+        else if (state.seats[state.seat].coins >= 7) {
+            move = Move::play({ActionType::COUP, state.seat, static_cast<uint8_t>(1 - state.seat)});
+        }
+        seats[state.seat]->send(request(MessageType::MOVE, table, move));
+        state = expect(alice, MessageType::STATE);
+        expect(bob, MessageType::STATE);
+        checkSameView(expect(near, MessageType::STATE), state);
+        checkSameView(expect(far, MessageType::STATE), state);
+        moves++;
+        REQUIRE(moves < 300);
+    }
+    const Message over = expect(alice, MessageType::GAME_OVER);
+    expect(bob, MessageType::GAME_OVER);
+    CHECK(expect(near, MessageType::GAME_OVER).seat == over.seat);
+    CHECK(expect(far, MessageType::GAME_OVER).seat == over.seat);
+
+    // The finished table is gone, so watching it again is refused rather than a duplicate
+    near.send(request(MessageType::WATCH, table));
+    CHECK(expect(near, MessageType::ERROR).error == ServerError::UNKNOWN_TABLE);
+
+    server.stop();
+    loop.join();
+    const ServerStats stats = server.getStats();
+    CHECK(stats.games_finished == 1);
+    CHECK(stats.spectator_frames == 2 * static_cast<uint64_t>(moves + 1));
+    CHECK(stats.resyncs == 0);
+}
+
+TEST_CASE("Slow Spectator Resyncs From A Full State") {
+    ServerConfig config;
+    config.max_spectator_frames = 2;
+    GameServer server(config);
+    std::thread loop([&] { server.run(); });
+
+    // One client holds both seats, so it can send a burst of legal moves in one write
+    ServerClient owner;
+    ServerClient viewer;
+    owner.connectTcp("127.0.0.1", server.getPort());
+    viewer.connectTcp("127.0.0.1", server.getPort());
+    owner.send(join(0, RoleType::GENERAL, "Alice"));
+    const uint32_t table = expect(owner, MessageType::JOINED).table;
+    owner.send(join(table, RoleType::SPY, "Bob"));
+    expect(owner, MessageType::JOINED);
+    owner.send(request(MessageType::START, table));
+    Message state = expect(owner, MessageType::STATE);
+    viewer.send(request(MessageType::WATCH, table));
+    checkSameView(expect(viewer, MessageType::STATE), state);
+
+    // Ten updates in one loop pass overflow the spectator's queue of two
+    std::vector<uint8_t> burst;
+    for (int i = 0; i < 10; i++) {
+        encodeMessage(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, static_cast<uint8_t>(i % 2),
+                                                                    NO_TARGET})), burst);
+    }
+    owner.sendRaw(burst.data(), burst.size());
+    for (int i = 0; i < 10; i++) {
+        state = expect(owner, MessageType::STATE);
+    }
+    CHECK(state.seats[0].coins == 5);
+    checkSameView(expect(viewer, MessageType::STATE), state);
+    Message extra;
+    CHECK_FALSE(viewer.receive(extra, 200));
+
+    // Back in sync, the spectator gets deltas again
+    owner.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 0, NO_TARGET})));
+    state = expect(owner, MessageType::STATE);
+    checkSameView(expect(viewer, MessageType::STATE), state);
+
+    server.stop();
+    loop.join();
+    const ServerStats stats = server.getStats();
+    CHECK(stats.resyncs == 1);
+    CHECK(stats.spectator_frames == 3);
+}
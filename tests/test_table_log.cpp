@@ -0,0 +1,363 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the write-ahead table log
+ * Covers TableLog and the server's recovery:
+ * - Random games logged with group commits and checkpoints recover to the state of their last commit
+ * - Finished tables and uncommitted events are not recovered, and a torn tail ends its segment
+ * - A restarted server hosts the logged tables again, watchable with their state, and drops old generations
+ * - After a restart the original clients reclaim their seats with their tokens and play on; the
+ *   table plays no timeouts until then
+ */
+
+#include "doctest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../include/server/GameServer.hpp"
+#include "../include/server/ServerClient.hpp"
+#include "../include/server/TableLog.hpp"
+
+using namespace coup;
+
+namespace {
+    std::string makeDirectory() {
+        char path[] = "/tmp/coup_test_wal_XXXXXX";
+        REQUIRE(::mkdtemp(path) != nullptr);
+        return path;
+    }
+
+    std::vector<std::string> segmentFiles(const std::string& directory) {
+        std::vector<std::string> names;
+        DIR* listing = ::opendir(directory.c_str());
+        REQUIRE(listing != nullptr);
+        while (const dirent* entry = ::readdir(listing)) {
+            const std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".wal") == 0) {
+                names.push_back(name);
+            }
+        }
+        ::closedir(listing);
+        return names;
+    }
+
+    void removeDirectory(const std::string& directory) {
+        TableLog::removeGenerations(directory, UINT32_MAX);
+        ::rmdir(directory.c_str());
+    }
+
+    Message request(MessageType type, uint32_t table, const Move& move = Move::decline(0)) {
+        Message message;
+        message.type = type;
+        message.table = table;
+        message.move = move;
+        return message;
+    }
+
+    Message expect(ServerClient& client, MessageType type) {
+        Message message;
+        REQUIRE(client.receive(message, 5000));
+        REQUIRE(message.type == type);
+        return message;
+    }
+
+    // State of a table as of the last commit
+    struct Committed {
+        uint64_t hash;
+        uint32_t events;
+    };
+}
+
+TEST_CASE("Table Log Recovers The Last Commit") {
+    const std::string directory = makeDirectory();
+    const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+    std::mt19937 rng(50);
+    GameRules rules;
+    rules.coup_cost = 8; // Recovered tables must keep their own rules
+    std::map<uint32_t, std::unique_ptr<Table>> live;
+    std::map<uint32_t, Committed> committed;
+    size_t finished = 0;
+    {
+        TableLog log(directory, 3, 1, 2048, false);
+        log.checkpoint({});
+        for (uint32_t id = 1; id <= 40; id++) {
+            std::unique_ptr<Table> table(new Table(id, 300, rules, id * 7919));
+            const size_t seats = 2 + rng() % 5;
+            for (size_t seat = 0; seat < seats; seat++) {
+                table->join("P" + std::to_string(seat), roles[(id + seat) % 6]);
+            }
+            table->start();
+            log.logSnapshot(*table);
+            live[id].swap(table);
+        }
+
+        std::vector<Move> moves;
+        for (int round = 0; round < 400 && !live.empty(); round++) {
+            for (auto it = live.begin(); it != live.end();) {
+                Table& table = *it->second;
+                if (rng() % 3 != 0) { // Not every table moves every round
+                    ++it;
+                    continue;
+                }
+                if (table.getMatch()->inReactionWindow() && rng() % 4 == 0) {
+                    table.expireWindow();
+                }
+                else {
+                    table.getMatch()->moves(moves);
+                    const Move move = moves[rng() % moves.size()];
+                    table.play(move.action.actor, move);
+                }
+                log.logEvent(table);
+                if (table.isOver()) {
+                    log.logEnd(table.getId());
+                    it = live.erase(it);
+                    finished++;
+                }
+                else {
+                    ++it;
+                }
+            }
+            if (round == 399 || rng() % 4 != 0) {
+                continue; // Left uncommitted, so lost by the crash below
+            }
+            REQUIRE(log.commit());
+            committed.clear(); // Tables that ended before the commit are gone for good
+            for (const auto& entry : live) {
+                committed[entry.first] = {entry.second->getMatch()->stateHash(), entry.second->eventCount()};
+            }
+            if (log.needsCheckpoint()) {
+                std::vector<const Table*> running;
+                for (const auto& entry : live) {
+                    running.push_back(entry.second.get());
+                }
+                log.checkpoint(running);
+            }
+        }
+        CHECK(log.syncCount() > 10);
+        CHECK(log.hasPending());
+        REQUIRE_FALSE(live.empty());
+        log.logEvent(*live.begin()->second); // One more record after the last round, never committed
+    }
+    CHECK(finished > 0);
+    REQUIRE(segmentFiles(directory).size() == 1); // Checkpoints dropped the older segments
+
+    // A crash in the middle of the next commit leaves half a record behind
+    const std::string segment = directory + "/" + segmentFiles(directory)[0];
+    FILE* file = std::fopen(segment.c_str(), "ab");
+    REQUIRE(file != nullptr);
+    const unsigned char torn[] = {40, 0, 0, 0, 0xEF, 0xBE};
+    std::fwrite(torn, 1, sizeof(torn), file);
+    std::fclose(file);
+
+    std::vector<std::unique_ptr<Table>> recovered;
+    RecoveryStats stats;
+    CHECK(TableLog::recover(directory, recovered, stats) == 2);
+    CHECK(stats.segments == 1);
+    CHECK(stats.torn == 1);
+    CHECK(stats.dropped == 0);
+    REQUIRE(recovered.size() == committed.size());
+    CHECK(stats.tables == committed.size());
+    uint32_t previous = 0;
+    for (const auto& table : recovered) {
+        CHECK(table->getId() > previous); // In id order
+        previous = table->getId();
+        auto found = committed.find(table->getId());
+        REQUIRE(found != committed.end());
+        CHECK(table->eventCount() == found->second.events);
+        CHECK(table->getMatch()->stateHash() == found->second.hash);
+        CHECK(table->getGame().getRules().coup_cost == 8);
+        CHECK(table->getSeed() == table->getId() * 7919);
+    }
+
+    // A recovered table plays on like the original
+    std::vector<Move> moves;
+    Table& resumed = *recovered.front();
+    const uint32_t events = resumed.eventCount();
+    resumed.getMatch()->moves(moves);
+    REQUIRE_FALSE(moves.empty());
+    resumed.play(moves[0].action.actor, moves[0]);
+    CHECK(resumed.eventCount() == events + 1);
+
+    removeDirectory(directory);
+    CHECK_THROWS_AS(TableLog::recover(directory, recovered, stats), std::runtime_error);
+}
+
+TEST_CASE("Restarted Server Resumes Logged Tables") {
+    const std::string directory = makeDirectory();
+    ServerConfig config;
+    config.wal_dir = directory;
+    uint32_t table = 0;
+    Message state;
+    {
+        GameServer server(config);
+        CHECK(server.getRecovery().tables == 0);
+        std::thread loop([&] { server.run(); });
+        ServerClient owner;
+        owner.connectTcp("127.0.0.1", server.getPort());
+        Message join;
+        join.type = MessageType::JOIN;
+        join.role = RoleType::GENERAL;
+        join.text = "Alice";
+        owner.send(join);
+        table = expect(owner, MessageType::JOINED).table;
+        join.table = table;
+        join.role = RoleType::SPY;
+        join.text = "Bob";
+        owner.send(join);
+        expect(owner, MessageType::JOINED);
+        join.table = 0;
+        join.text = "Carol";
+        owner.send(join); // A table that never starts is not logged
+        expect(owner, MessageType::JOINED);
+        owner.send(request(MessageType::START, table));
+        state = expect(owner, MessageType::STATE);
+        for (uint8_t i = 0; i < 4; i++) {
+            owner.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, static_cast<uint8_t>(i % 2), NO_TARGET})));
+            state = expect(owner, MessageType::STATE);
+        }
+        server.stop();
+        loop.join();
+        CHECK(server.getStats().logged == 5);
+        CHECK(server.getStats().log_syncs >= 2);
+    }
+
+    GameServer server(config);
+    CHECK(server.getRecovery().tables == 1);
+    CHECK(server.getRecovery().torn == 0);
+    CHECK(server.tableCount() == 1);
+    const std::vector<std::string> files = segmentFiles(directory);
+    REQUIRE(files.size() == 1);
+    CHECK(files[0].compare(0, 10, "g00000002-") == 0); // The first run's generation is gone
+    std::thread loop([&] { server.run(); });
+
+    ServerClient viewer;
+    viewer.connectTcp("127.0.0.1", server.getPort());
+    viewer.send(request(MessageType::WATCH, table));
+    const Message resumed = expect(viewer, MessageType::STATE);
+    CHECK(resumed.step == 4);
+    REQUIRE(resumed.seat_count == state.seat_count);
+    CHECK(resumed.seat == state.seat);
+    for (uint8_t seat = 0; seat < state.seat_count; seat++) {
+        CHECK(resumed.seats[seat] == state.seats[seat]);
+    }
+
+    // Its seats are vacant and the game started, so nobody can take them
+    Message join;
+    join.type = MessageType::JOIN;
+    join.table = table;
+    join.role = RoleType::BARON;
+    join.text = "Dave";
+    viewer.send(join);
+    CHECK(expect(viewer, MessageType::ERROR).error == ServerError::SEAT_UNAVAILABLE);
+
+    server.stop();
+    loop.join();
+    removeDirectory(directory);
+}
+
+TEST_CASE("Original Clients Reclaim Their Seats After A Restart") {
+    const std::string directory = makeDirectory();
+    ServerConfig config;
+    config.wal_dir = directory;
+    uint32_t table = 0;
+    Message alice_joined;
+    Message bob_joined;
+    {
+        GameServer server(config);
+        std::thread loop([&] { server.run(); });
+        ServerClient alice;
+        ServerClient bob;
+        alice.connectTcp("127.0.0.1", server.getPort());
+        bob.connectTcp("127.0.0.1", server.getPort());
+        Message join;
+        join.type = MessageType::JOIN;
+        join.role = RoleType::GENERAL;
+        join.text = "Alice";
+        alice.send(join);
+        alice_joined = expect(alice, MessageType::JOINED);
+        table = alice_joined.table;
+        join.table = table;
+        join.role = RoleType::SPY;
+        join.text = "Bob";
+        bob.send(join);
+        bob_joined = expect(bob, MessageType::JOINED);
+        CHECK(alice_joined.token != 0);
+        CHECK(bob_joined.token != alice_joined.token);
+        alice.send(request(MessageType::START, table));
+        expect(alice, MessageType::STATE);
+        expect(bob, MessageType::STATE);
+        for (uint8_t i = 0; i < 4; i++) {
+            ServerClient& mover = i % 2 == 0 ? alice : bob;
+            mover.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, static_cast<uint8_t>(i % 2), NO_TARGET})));
+            expect(alice, MessageType::STATE);
+            expect(bob, MessageType::STATE);
+        }
+        server.stop();
+        loop.join();
+    }
+
+    config.turn_timeout_ms = 30;
+    config.rejoin_grace_ms = 0; // Frozen until both seats are back
+    GameServer server(config);
+    REQUIRE(server.tableCount() == 1);
+    std::thread loop([&] { server.run(); });
+
+    ServerClient viewer;
+    viewer.connectTcp("127.0.0.1", server.getPort());
+    viewer.send(request(MessageType::WATCH, table));
+    CHECK(expect(viewer, MessageType::STATE).step == 4);
+
+    ServerClient alice;
+    alice.connectTcp("127.0.0.1", server.getPort());
+    Message rejoin;
+    rejoin.type = MessageType::REJOIN;
+    rejoin.table = table;
+    rejoin.seat = alice_joined.seat;
+    rejoin.token = bob_joined.token; // Bob's token does not open Alice's seat
+    alice.send(rejoin);
+    CHECK(expect(alice, MessageType::ERROR).error == ServerError::SEAT_UNAVAILABLE);
+    rejoin.token = alice_joined.token;
+    alice.send(rejoin);
+    const Message back = expect(alice, MessageType::JOINED);
+    CHECK(back.seat == alice_joined.seat);
+    CHECK(back.token == alice_joined.token);
+    const Message caught_up = expect(alice, MessageType::STATE);
+    CHECK(caught_up.step == 4);
+    CHECK(caught_up.seat == alice_joined.seat);
+
+    // Alice moves while Bob is still away; his turn is not played by the timeout
+    alice.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 0, NO_TARGET})));
+    CHECK(expect(alice, MessageType::STATE).step == 5);
+    CHECK(expect(viewer, MessageType::STATE).step == 5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    Message idle;
+    CHECK_FALSE(viewer.receive(idle, 0));
+
+    ServerClient bob;
+    bob.connectTcp("127.0.0.1", server.getPort());
+    rejoin.seat = bob_joined.seat;
+    rejoin.token = bob_joined.token;
+    bob.send(rejoin);
+    expect(bob, MessageType::JOINED);
+    CHECK(expect(bob, MessageType::STATE).step == 5);
+    bob.send(request(MessageType::MOVE, table, Move::play({ActionType::GATHER, 1, NO_TARGET})));
+    CHECK(expect(bob, MessageType::STATE).step == 6);
+
+    // With every seat back the deadlines run again: Alice's silent turn times out
+    CHECK(expect(alice, MessageType::STATE).step == 6);
+    CHECK(expect(alice, MessageType::STATE).step == 7);
+
+    server.stop();
+    loop.join();
+    CHECK(server.getStats().rejoins == 2);
+    removeDirectory(directory);
+}
@@ -0,0 +1,199 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the endgame tablebase
+ * Covers building, mapping and playing from a 2-player table:
+ * - Forced coups are wins in one and the victim's probe agrees
+ * - A General facing a coup blocks it instead of passing
+ * - Every stored value is consistent with the values of its moves
+ * - Positions near the coin cap whose moves leave the table are unknown, never false draws
+ * - The table bot converts won positions against any opponent
+ */
+
+#include "doctest.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/GameClone.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/Bot.hpp"
+#include "../include/bots/Tablebase.hpp"
+#include "../include/bots/TablebaseBot.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/General.hpp"
+
+using namespace coup;
+
+namespace {
+    // Checks that the stored value of the deciding seat follows from its moves
+    bool consistent(const EndgameTable& table, const Match& match) {
+        const uint8_t seat = match.decidingSeat();
+        const TablebaseProbe result = table.probe(match, seat);
+        if (result.value == TablebaseValue::UNKNOWN || match.isOver()) {
+            return true;
+        }
+
+        GameClone clone(match.getGame());
+        Match sim(clone.game(), match.getState(), match.getMaxSteps());
+        GameSnapshot position;
+        match.getGame().saveSnapshot(position, false);
+        std::vector<Move> moves;
+        match.moves(moves);
+
+        bool fast_win = false;
+        bool all_lost = true;
+        bool any_unknown = false;
+        for (const Move& move : moves) {
+            clone.load(position);
+            sim.reset(match.getState());
+            sim.apply(move);
+            const TablebaseProbe child = table.probe(sim, seat);
+            fast_win = fast_win || (child.value == TablebaseValue::WIN && child.depth + 1 == result.depth);
+            all_lost = all_lost && child.value == TablebaseValue::LOSS;
+            any_unknown = any_unknown || child.value == TablebaseValue::UNKNOWN;
+        }
+
+        switch (result.value) {
+            case TablebaseValue::WIN: return fast_win;
+            case TablebaseValue::LOSS: return all_lost;
+            default: return !all_lost && !any_unknown; // A draw never rests on an unknown move
+        }
+    }
+}
+
+TEST_CASE("Endgame Tablebase") {
+    const std::string path = (std::filesystem::temp_directory_path() / "coup_tablebase_test.ctb").string();
+    TablebaseConfig config;
+    config.roles = {RoleType::BARON, RoleType::GENERAL};
+    config.coin_cap = 12;
+    config.threads = 2;
+    const TablebaseStats stats = buildTablebase(config, path);
+    REQUIRE(stats.positions > 0);
+    CHECK(stats.wins + stats.losses + stats.draws + stats.unknowns == stats.positions);
+
+    EndgameTable table(path);
+    CHECK(table.size() == stats.positions);
+    CHECK(table.getPlayerCount() == 2);
+    CHECK(table.getRole(1) == RoleType::GENERAL);
+
+    Game game;
+    Baron baron(game, "Alice");
+    General general(game, "Bob");
+    game.startGame();
+    CHECK(table.covers(game));
+
+    SUBCASE("Forced coup is a win in one") {
+        baron.addCoins(7);
+        Match match(game);
+        TablebaseProbe result = table.probe(match, 0);
+        CHECK(result.value == TablebaseValue::WIN);
+        CHECK(result.depth == 1);
+        CHECK(table.probe(match, 1).value == TablebaseValue::LOSS);
+    }
+
+    SUBCASE("General blocks the coup that would end the game") {
+        baron.addCoins(7);
+        general.addCoins(5);
+        Match match(game);
+        match.apply(Move::play({ActionType::COUP, 0, 1}));
+        REQUIRE(match.inReactionWindow());
+        CHECK(game.canGeneralPreventGameEnd() == false); // Engine view: the General is already out
+        CHECK(table.probe(match, 1).value != TablebaseValue::LOSS); // Blocking keeps the General in the game
+
+        RandomBot random_bot(1);
+        TablebaseBot bot(table, random_bot);
+        CHECK(bot.chooseMove(match) == Move::play({ActionType::BLOCK_COUP, 1, 1}));
+        CHECK(bot.tableMoves() == 1);
+    }
+
+    SUBCASE("Stored values follow from the moves") {
+        int checked = 0;
+        for (uint32_t seed = 0; seed < 30; seed++) {
+            Game random_game;
+            Baron first(random_game, "Alice");
+            General second(random_game, "Bob");
+            random_game.startGame();
+            Match match(random_game, 300);
+            RandomBot random_bot(seed);
+            while (!match.isOver()) {
+                CHECK(consistent(table, match));
+                checked++;
+                match.apply(random_bot.chooseMove(match));
+            }
+        }
+        CHECK(checked > 100);
+    }
+
+    SUBCASE("Table bot converts won positions") {
+        for (uint32_t seed = 0; seed < 5; seed++) {
+            Game won_game;
+            Baron first(won_game, "Alice");
+            General second(won_game, "Bob");
+            won_game.startGame();
+            first.addCoins(6);
+            second.addCoins(2);
+            Match match(won_game, 300);
+            REQUIRE(table.probe(match, 0).value == TablebaseValue::WIN);
+
+            RandomBot random_bot(seed);
+            TablebaseBot bot(table, random_bot, seed);
+            std::vector<Bot*> seats = {&bot, &random_bot};
+            CHECK(playMatch(match, seats) == 0);
+        }
+    }
+
+    SUBCASE("Rejects malformed files") {
+        const std::string bad = path + ".bad";
+        std::ofstream(bad, std::ios::binary) << "not a table";
+        CHECK_THROWS_AS(EndgameTable table_bad(bad), std::runtime_error);
+        CHECK_THROWS_AS(EndgameTable missing(path + ".missing"), std::runtime_error);
+        std::filesystem::remove(bad);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tablebase Leaves Positions At The Coin Cap Unknown") {
+    const std::string path = (std::filesystem::temp_directory_path() / "coup_tablebase_cap_test.ctb").string();
+    TablebaseConfig config;
+    config.roles = {RoleType::BARON, RoleType::GENERAL};
+    config.coin_cap = 4; // Most games quickly gather past it
+    const TablebaseStats stats = buildTablebase(config, path);
+    CHECK(stats.unknowns > 0);
+    CHECK(stats.wins + stats.losses + stats.draws + stats.unknowns == stats.positions);
+    EndgameTable table(path);
+
+    // Both seats at the cap: every gather, tax and invest leaves the table, so nothing here is a known draw
+    Game game;
+    Baron baron(game, "Alice");
+    General general(game, "Bob");
+    game.startGame();
+    baron.addCoins(4);
+    general.addCoins(4);
+    Match match(game, 300);
+    uint64_t key;
+    REQUIRE(packTablePosition(match, config.coin_cap, key));
+    CHECK(table.probe(match, 0).value == TablebaseValue::UNKNOWN);
+    CHECK(table.probe(match, 1).value == TablebaseValue::UNKNOWN);
+
+    // Wherever a random game stays inside the table, stored draws and results follow from known moves
+    int checked = 0;
+    for (uint32_t seed = 0; seed < 30; seed++) {
+        Game random_game;
+        Baron first(random_game, "Alice");
+        General second(random_game, "Bob");
+        random_game.startGame();
+        Match random_match(random_game, 300);
+        RandomBot random_bot(seed);
+        while (!random_match.isOver() && packTablePosition(random_match, config.coin_cap, key)) {
+            CHECK(consistent(table, random_match));
+            checked++;
+            random_match.apply(random_bot.chooseMove(random_match));
+        }
+    }
+    CHECK(checked > 30);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,151 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the tournament runner
+ * Covers the ratings, the schedules and the parallel runs:
+ * - Winners gain rating, losers lose it and deviations shrink with every game
+ * - A scripted player follows its priority list
+ * - Round-robin meets every group once per round, Swiss leaves byes out
+ * - Results are the same with one or several threads
+ * - A clearly stronger bot ends on top and convergence stops the run early
+ */
+
+#include "doctest.h"
+#include <memory>
+#include <vector>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/Bot.hpp"
+#include "../include/bots/HeuristicBot.hpp"
+#include "../include/bots/Tournament.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Spy.hpp"
+
+using namespace coup;
+
+namespace {
+    BotFactory randomFactory() {
+        return [](uint32_t seed) { return std::unique_ptr<Bot>(new RandomBot(seed)); };
+    }
+
+    BotFactory heuristicFactory() {
+        return [](uint32_t seed) { return std::unique_ptr<Bot>(new HeuristicBot(seed)); };
+    }
+}
+
+TEST_CASE("Rating Table") {
+    RatingTable ratings(3);
+    ratings.update({0, 1, 2}, 0, 16.0);
+    CHECK(ratings.get(0).elo > 1500.0);
+    CHECK(ratings.get(1).elo < 1500.0);
+    CHECK(ratings.get(1).elo == doctest::Approx(ratings.get(2).elo)); // Losers are not compared
+    CHECK(ratings.get(0).glicko > 1500.0);
+    CHECK(ratings.get(0).rd < 350.0);
+    CHECK(ratings.get(0).wins == 1);
+    CHECK(ratings.ranking()[0] == 0);
+
+    const double rd = ratings.get(1).rd;
+    ratings.update({1, 2}, -1, 16.0);
+    CHECK(ratings.get(1).draws == 1);
+    CHECK(ratings.get(1).rd < rd);
+    CHECK(ratings.get(1).low() < ratings.get(1).glicko);
+}
+
+TEST_CASE("Scripted Bot") {
+    Game game;
+    Baron baron(game, "Alice");
+    Spy spy(game, "Bob");
+    game.startGame();
+    Match match(game);
+
+    ScriptedBot taxer({ActionType::COUP, ActionType::TAX, ActionType::GATHER}, "Taxer");
+    CHECK(taxer.getName() == "Taxer");
+    CHECK(taxer.chooseMove(match) == Move::play({ActionType::TAX, 0, NO_TARGET}));
+
+    baron.addCoins(7);
+    CHECK(taxer.chooseMove(match) == Move::play({ActionType::COUP, 0, 1}));
+}
+
+TEST_CASE("Tournament") {
+    TournamentConfig config;
+    config.max_rounds = 4;
+
+    SUBCASE("Round-robin meets every group") {
+        config.seats = 3;
+        Tournament tournament(config);
+        for (const char* name : {"A", "B", "C", "D"}) {
+            tournament.addEntry(name, randomFactory());
+        }
+        CHECK_THROWS_AS(tournament.addEntry("A", randomFactory()), std::invalid_argument);
+
+        TournamentResult result = tournament.run([&](unsigned round, const RatingTable& ratings) {
+            uint64_t seats = 0;
+            for (size_t i = 0; i < ratings.size(); i++) {
+                seats += ratings.get(i).games;
+            }
+            CHECK(seats == 3 * 4 * (round + 1)); // Four groups of three per round
+        });
+        CHECK(result.games == 16);
+        CHECK(result.rounds == 4);
+        CHECK(result.standings.size() == 4);
+        for (const TournamentStanding& standing : result.standings) {
+            CHECK(standing.rating.games == 12);
+        }
+    }
+
+    SUBCASE("Swiss gives a bye to the odd entrant") {
+        config.format = TournamentFormat::SWISS;
+        config.games_per_table = 2;
+        Tournament tournament(config);
+        for (const char* name : {"A", "B", "C"}) {
+            tournament.addEntry(name, randomFactory());
+        }
+        TournamentResult result = tournament.run();
+        CHECK(result.games == 8); // One table of two games per round
+    }
+
+    SUBCASE("Thread count does not change the ratings") {
+        config.games_per_table = 8;
+        config.threads = 1;
+        Tournament single(config);
+        config.threads = 3;
+        Tournament parallel(config);
+        for (Tournament* tournament : {&single, &parallel}) {
+            tournament->addEntry("Heuristic", heuristicFactory());
+            tournament->addEntry("Random", randomFactory());
+        }
+        TournamentResult a = single.run();
+        TournamentResult b = parallel.run();
+        REQUIRE(a.standings.size() == b.standings.size());
+        for (size_t i = 0; i < a.standings.size(); i++) {
+            CHECK(a.standings[i].name == b.standings[i].name);
+            CHECK(a.standings[i].rating.elo == b.standings[i].rating.elo);
+            CHECK(a.standings[i].rating.glicko == b.standings[i].rating.glicko);
+        }
+    }
+
+    SUBCASE("Stronger bot wins and the run converges") {
+        config.max_rounds = 50;
+        config.games_per_table = 10;
+        config.stable_rounds = 3;
+        config.threads = 2;
+        Tournament tournament(config);
+        tournament.addEntry("Random", randomFactory());
+        tournament.addEntry("Heuristic", heuristicFactory());
+        TournamentResult result = tournament.run();
+        CHECK(result.converged);
+        CHECK(result.rounds < 50);
+        CHECK(result.standings[0].name == "Heuristic");
+        CHECK(result.standings[0].rating.low() > result.standings[1].rating.glicko);
+    }
+
+    SUBCASE("Invalid settings are rejected") {
+        config.seats = 7;
+        CHECK_THROWS_AS(Tournament bad(config), std::invalid_argument);
+        config.seats = 3;
+        Tournament tournament(config);
+        tournament.addEntry("A", randomFactory());
+        CHECK_THROWS_AS(tournament.run(), std::runtime_error);
+    }
+}
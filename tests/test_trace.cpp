@@ -0,0 +1,155 @@
+// Email: razcohenp@gmail.com
+
+/**
+ * Tests for the compact trace format
+ * Covers recording and reconstruction of games:
+ * - Every step of a random game is reconstructed exactly from the nearest keyframe
+ * - Actions are decoded with the correct actor and target
+ * - Out-of-turn reactions and state changes outside actions are stored as residuals
+ * - Corrupted or truncated traces are rejected
+ */
+
+#include "doctest.h"
+#include <stdexcept>
+#include <cstring>
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Trace.hpp"
+#include "../include/roles/Governor.hpp"
+#include "../include/roles/General.hpp"
+#include "../include/roles/Judge.hpp"
+#include "../include/roles/Baron.hpp"
+#include "../include/roles/Spy.hpp"
+#include "../include/roles/Merchant.hpp"
+
+using namespace coup;
+
+// Compare the parts of two snapshots that traces carry (everything but the RNG)
+static bool sameState(const GameSnapshot& a, const GameSnapshot& b) {
+    return std::memcmp(&a.header, &b.header, sizeof(a.header)) == 0 &&
+        std::memcmp(a.players, b.players, sizeof(a.players)) == 0;
+}
+
+TEST_CASE("Trace Round Trip of Random Games") {
+    Game game;
+    Governor p1(game, "P1");
+    Spy p2(game, "P2");
+    Baron p3(game, "P3");
+    General p4(game, "P4");
+    Judge p5(game, "P5");
+    Merchant p6(game, "P6");
+    game.startGame();
+
+    GameSnapshot initial;
+    game.saveSnapshot(initial);
+    std::mt19937 rng(2024);
+    std::vector<Action> scratch;
+
+    for (int round = 0; round < 5; round++) { // Several games on the same table
+        game.loadSnapshot(initial);
+        TraceWriter writer(8); // Small interval to exercise many keyframes
+
+        std::vector<GameSnapshot> states(1);
+        std::vector<Action> actions;
+        game.saveSnapshot(states[0], false);
+        writer.begin(game);
+
+        Action chosen;
+        while (!isGameOver(game) && actions.size() < 2000) {
+            if (!playRandomAction(game, rng, scratch, chosen)) {
+                continue; // Passed turns are carried by the next record's residual
+            }
+            writer.record(chosen, game);
+            actions.push_back(chosen);
+            states.emplace_back();
+            game.saveSnapshot(states.back(), false);
+        }
+        writer.finish();
+
+        TraceReader reader(writer.data().data(), writer.data().size());
+        REQUIRE(reader.actionCount() == actions.size());
+        CHECK(reader.playerCount() == 6);
+
+        GameSnapshot decoded;
+        bool all_match = true;
+        for (size_t step = 0; step < states.size(); step++) { // Random access from keyframes
+            reader.stateAt(step, decoded);
+            all_match = all_match && sameState(decoded, states[step]);
+        }
+        CHECK(all_match);
+
+        bool actions_match = true;
+        reader.forEachAction([&](size_t index, const Action& action, const GameSnapshot& after) {
+            actions_match = actions_match && action == actions[index] && sameState(after, states[index + 1]);
+        });
+        CHECK(actions_match);
+        CHECK(reader.actionAt(actions.size() - 1) == actions.back());
+
+        // Reconstructed states load back into the table
+        reader.stateAt(actions.size() / 2, decoded);
+        CHECK_NOTHROW(game.loadSnapshot(decoded));
+    }
+}
+
+TEST_CASE("Trace Residuals and Compactness") {
+    Game game;
+    Governor gov(game, "Alice");
+    General general(game, "Bob");
+    game.startGame();
+
+    TraceWriter writer(4); // Exactly one keyframe interval of actions below
+    writer.begin(game);
+    const size_t header_size = writer.data().size();
+
+    gov.gather();
+    writer.record({ActionType::GATHER, 0, NO_TARGET}, game);
+    CHECK(writer.data().size() == header_size + 1); // Predicted action takes a single byte
+
+    general.tax();
+    writer.record({ActionType::TAX, 1, NO_TARGET}, game);
+    gov.undo(general); // Out-of-turn reaction
+    writer.record({ActionType::UNDO, 0, 1}, game);
+    general.addCoins(5); // State change outside any action, carried as a residual
+    gov.gather();
+    writer.record({ActionType::GATHER, 0, NO_TARGET}, game);
+    writer.finish();
+
+    TraceReader reader(writer.data().data(), writer.data().size());
+    GameSnapshot state;
+    reader.stateAt(4, state);
+    CHECK(state.players[0].coins == 2);
+    CHECK(state.players[1].coins == 5);
+    CHECK(reader.actionAt(2) == Action{ActionType::UNDO, 0, 1});
+
+    SUBCASE("Invalid traces are rejected") {
+        std::vector<unsigned char> data = writer.data();
+        CHECK_THROWS_AS(TraceReader(data.data(), data.size() - 1), std::runtime_error);
+        data[0] ^= 0xFF;
+        CHECK_THROWS_AS(TraceReader(data.data(), data.size()), std::runtime_error);
+        CHECK_THROWS_AS(reader.stateAt(5, state), std::runtime_error);
+    }
+
+    SUBCASE("Seats outside the roster are rejected") {
+        // Keyframe after the 9-byte header and two roster entries: started, turn, last arrested, then per seat
+        // flags, coins (one varint byte here) and couped-by
+        const size_t keyframe = 9 + 2 * (SNAPSHOT_NAME_SIZE + 1);
+        const size_t seat_bytes[] = {keyframe + 1, keyframe + 2, keyframe + 5};
+        for (size_t at : seat_bytes) {
+            std::vector<unsigned char> data = writer.data();
+            data[at] = 200;
+            TraceReader corrupt(data.data(), data.size());
+            CHECK_THROWS_WITH_AS(corrupt.stateAt(0, state), "Trace record is invalid", std::runtime_error);
+        }
+
+        // The last record carries a coin residual; claiming a turn residual reads the coin mask (seat 1 = 2) as the turn
+        std::vector<unsigned char> data = writer.data();
+        const size_t last = header_size + 3;
+        REQUIRE((data[last] & 1) == 1);
+        REQUIRE(data[last + 1] == 0x08); // RESIDUAL_COINS
+        REQUIRE(data[last + 2] == 0x02);
+        data[last + 1] |= 0x02; // RESIDUAL_TURN
+        TraceReader corrupt(data.data(), data.size());
+        corrupt.stateAt(3, state);
+        CHECK_THROWS_WITH_AS(corrupt.stateAt(4, state), "Trace record is invalid", std::runtime_error);
+    }
+}
@@ -0,0 +1,102 @@
+// Email: razcohenp@gmail.com
+
+// balance_sweep.cpp - Role win rates over a grid of rule parameters
+// Usage: ./balance_sweep [options] <parameter>=<v1,v2,...> ...
+// Options: --games N (per point), --players N, --threads N, --bots random|heuristic, --csv <file>
+// Parameters: invest_payout, tax_bonus, block_coup_cost, merchant_threshold, judge_surcharge, coup_cost
+// Example: ./balance_sweep --games 20000 merchant_threshold=2,3,4 coup_cost=6,7,8
+
+#include "../include/bots/BalanceSweep.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    const RoleType ROLES[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                              RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+
+    // "name=1,2,3" into an axis
+    SweepAxis parseAxis(const std::string& text) {
+        const size_t equals = text.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Expected <parameter>=<values>, got " + text);
+        }
+        SweepAxis axis{parseRuleParameter(text.substr(0, equals)), {}};
+        std::stringstream values(text.substr(equals + 1));
+        std::string value;
+        while (std::getline(values, value, ',')) {
+            axis.values.push_back(std::stoi(value));
+        }
+        return axis;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        SweepConfig config;
+        std::string csv_path;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "--games" && has_value) config.games_per_point = std::stoull(argv[++i]);
+            else if (arg == "--players" && has_value) config.players = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (arg == "--threads" && has_value) config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (arg == "--bots" && has_value) config.bots = std::string(argv[++i]) == "random" ? SweepBots::RANDOM : SweepBots::HEURISTIC;
+            else if (arg == "--csv" && has_value) csv_path = argv[++i];
+            else config.axes.push_back(parseAxis(arg));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<SweepPoint> points = runBalanceSweep(config);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        uint64_t games = 0;
+        for (const SweepPoint& point : points) {
+            games += point.games;
+        }
+        std::cout << points.size() << " points, " << games << " games in " << seconds << " s ("
+                  << games / seconds << " games/s), fair share " << 100.0 / config.players << "%\n";
+
+        std::ostringstream table;
+        for (const SweepAxis& axis : config.axes) {
+            table << getRuleParameterName(axis.parameter) << ",";
+        }
+        table << "games,draws";
+        Game names;
+        for (RoleType role : ROLES) {
+            table << "," << names.getRoleName(role);
+        }
+        table << "\n" << std::fixed << std::setprecision(4);
+        for (const SweepPoint& point : points) {
+            for (int value : point.values) {
+                table << value << ",";
+            }
+            table << point.games << "," << point.draws;
+            for (RoleType role : ROLES) {
+                table << "," << point.winRate(role);
+            }
+            table << "\n";
+        }
+
+        std::cout << table.str();
+        if (!csv_path.empty()) {
+            std::ofstream csv(csv_path);
+            if (!csv) {
+                throw std::runtime_error("Cannot write " + csv_path);
+            }
+            csv << table.str();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Email: razcohenp@gmail.com
+
+// bot_match.cpp - Plays an MCTS bot (seat rotates) against heuristic bots
+// Usage: ./bot_match [games] [players] [threads] [budget_ms] [deadline_ms]
+// Reports the MCTS win rate and its decision latency; with deadline_ms the bot plays behind
+// the DeadlineBot watchdog and the fallbacks forced by the hard deadline are reported too
+
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/HeuristicBot.hpp"
+#include "../include/bots/MctsBot.hpp"
+#include "../include/bots/DeadlineBot.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+namespace {
+    // Wraps the MCTS bot to record the time of every searched decision
+    class TimedBot : public Bot {
+    private:
+        MctsBot& bot;
+
+    public:
+        std::vector<double> latencies_ms;
+
+        explicit TimedBot(MctsBot& bot) : bot(bot) {}
+
+        Move chooseMove(const Match& match) override {
+            return chooseMoveWithin(match, DecisionLimit());
+        }
+
+        Move chooseMoveWithin(const Match& match, const DecisionLimit& limit) override {
+            Move move = bot.chooseMoveWithin(match, limit);
+            if (bot.lastSearch().iterations > 0) { // Forced moves are not searched
+                latencies_ms.push_back(bot.lastSearch().elapsed_ms);
+            }
+            return move;
+        }
+
+        std::string getName() const override { return bot.getName(); }
+    };
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const int games = argc > 1 ? std::stoi(argv[1]) : 20;
+        const int players = argc > 2 ? std::stoi(argv[2]) : 4;
+        const unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 2;
+        const double budget_ms = argc > 4 ? std::stod(argv[4]) : 40.0;
+        const double deadline_ms = argc > 5 ? std::stod(argv[5]) : 0.0;
+
+        if (players < 2 || players > 6) {
+            std::cerr << "Players must be between 2 and 6\n";
+            return 1;
+        }
+
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+        MctsConfig config;
+        config.threads = threads;
+        config.time_budget_ms = budget_ms;
+        MctsBot mcts(config);
+        TimedBot* timed = new TimedBot(mcts);
+        std::unique_ptr<Bot> owned(timed);
+        std::unique_ptr<DeadlineBot> watchdog;
+        if (deadline_ms > 0) {
+            watchdog.reset(new DeadlineBot(std::move(owned), deadline_ms, std::min(2.0, deadline_ms / 4)));
+        }
+        Bot* searcher = watchdog ? static_cast<Bot*>(watchdog.get()) : timed;
+        HeuristicBot heuristic(7);
+
+        int wins = 0;
+        int draws = 0;
+        for (int g = 0; g < games; g++) {
+            Game game;
+            std::vector<std::unique_ptr<Player>> roster;
+            for (int seat = 0; seat < players; seat++) {
+                roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1), roles[(seat + g) % 6]));
+            }
+            game.startGame();
+
+            const int mcts_seat = g % players;
+            std::vector<Bot*> seats(players, &heuristic);
+            seats[mcts_seat] = searcher;
+
+            Match match(game);
+            const int winner = playMatch(match, seats);
+            wins += winner == mcts_seat ? 1 : 0;
+            draws += winner < 0 ? 1 : 0;
+        }
+
+        std::vector<double>& latencies = timed->latencies_ms;
+        std::sort(latencies.begin(), latencies.end());
+        double total = 0;
+        for (double latency : latencies) {
+            total += latency;
+        }
+
+        std::cout << "MCTS (" << threads << " threads, " << budget_ms << " ms) vs " << players - 1
+                  << " heuristic bots over " << games << " games\n";
+        std::cout << "  wins: " << wins << " (" << 100.0 * wins / games << "%, fair share "
+                  << 100.0 / players << "%), draws: " << draws << "\n";
+        if (!latencies.empty()) {
+            std::cout << "  decisions: " << latencies.size() << ", mean " << total / latencies.size()
+                      << " ms, p99 " << latencies[latencies.size() * 99 / 100]
+                      << " ms, max " << latencies.back() << " ms\n";
+        }
+        if (watchdog) {
+            const DeadlineStats& stats = watchdog->getStats();
+            std::cout << "  watchdog (" << deadline_ms << " ms turns): " << stats.decisions << " decisions, "
+                      << stats.fallbacks << " fallbacks (" << stats.skipped << " with a busy worker), max latency "
+                      << stats.max_latency_ms << " ms\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
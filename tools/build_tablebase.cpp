@@ -0,0 +1,55 @@
+// Email: razcohenp@gmail.com
+
+// build_tablebase.cpp - Solves the endgame table of one 2- or 3-player roster
+// Usage: ./build_tablebase <output_file> <coin_cap> <threads> <role> <role> [role]
+// Roles are given by name (Governor, Spy, Baron, General, Judge, Merchant)
+
+#include "../include/Game.hpp"
+#include "../include/bots/Tablebase.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+int main(int argc, char* argv[]) {
+    if (argc < 6 || argc > 7) {
+        std::cerr << "Usage: " << argv[0] << " <output_file> <coin_cap> <threads> <role> <role> [role]\n";
+        return 1;
+    }
+
+    try {
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+        Game names; // Only used for role names
+
+        TablebaseConfig config;
+        config.coin_cap = static_cast<uint8_t>(std::stoi(argv[2]));
+        config.threads = static_cast<unsigned>(std::stoul(argv[3]));
+        for (int arg = 4; arg < argc; arg++) {
+            bool found = false;
+            for (RoleType role : roles) {
+                if (names.getRoleName(role) == argv[arg]) {
+                    config.roles.push_back(role);
+                    found = true;
+                }
+            }
+            if (!found) {
+                std::cerr << "Unknown role " << argv[arg] << "\n";
+                return 1;
+            }
+        }
+
+        const TablebaseStats stats = buildTablebase(config, argv[1]);
+        std::cout << "Solved " << stats.positions << " positions (" << stats.edges << " moves) in "
+                  << stats.elapsed_ms << " ms\n";
+        std::cout << "  to move: " << stats.wins << " wins, " << stats.losses << " losses, "
+                  << stats.draws << " draws, " << stats.unknowns << " unknown (moves leave the cap)\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
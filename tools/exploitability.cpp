@@ -0,0 +1,109 @@
+// Email: razcohenp@gmail.com
+
+// exploitability.cpp - Measures how much a best responder gains against a fixed policy
+// Usage: ./exploitability <policy_file|uniform> [positions] [players] [depth] [threads]
+// Positions are reached by policy self-play from random role deals; the responder rotates
+
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/bots/Match.hpp"
+#include "../include/bots/BestResponse.hpp"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <policy_file|uniform> [positions] [players] [depth] [threads]\n";
+        return 1;
+    }
+
+    try {
+        const std::string source = argv[1];
+        const int positions = argc > 2 ? std::stoi(argv[2]) : 20;
+        const int players = argc > 3 ? std::stoi(argv[3]) : 2;
+        BestResponseConfig config;
+        config.depth = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 3;
+        config.threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 1;
+
+        if (players < 2 || players > 6) {
+            std::cerr << "Players must be between 2 and 6\n";
+            return 1;
+        }
+
+        std::unique_ptr<CfrPolicy> trained;
+        std::unique_ptr<MovePolicy> policy;
+        if (source == "uniform") {
+            policy.reset(new UniformPolicy());
+        }
+        else {
+            trained.reset(new CfrPolicy(source));
+            policy.reset(new CfrMovePolicy(*trained));
+        }
+        const BestResponse search(*policy, config);
+
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+        std::mt19937 rng(config.seed);
+        std::vector<Move> moves;
+        std::vector<double> probs;
+        double best_total = 0.0;
+        double policy_total = 0.0;
+        double elapsed_ms = 0.0;
+        uint64_t nodes = 0;
+        uint64_t hits = 0;
+        int evaluated = 0;
+
+        for (int position = 0; position < positions; position++) {
+            Game game;
+            std::vector<std::unique_ptr<Player>> roster;
+            for (int seat = 0; seat < players; seat++) {
+                roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1), roles[rng() % 6]));
+            }
+            game.startGame();
+
+            // Walk a random number of policy moves into the game
+            Match match(game, 300);
+            const int walk = static_cast<int>(rng() % 30);
+            for (int step = 0; step < walk && !match.isOver(); step++) {
+                match.moves(moves);
+                policy->probabilities(match, moves, probs);
+                double left = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                size_t pick = 0;
+                while (pick + 1 < moves.size() && (left -= probs[pick]) > 0.0) {
+                    pick++;
+                }
+                match.apply(moves[pick]);
+            }
+            if (match.isOver()) continue;
+
+            const BestResponseResult result = search.evaluate(match, static_cast<uint8_t>(position % players));
+            best_total += result.best_response;
+            policy_total += result.policy_value;
+            elapsed_ms += result.elapsed_ms;
+            nodes += result.nodes;
+            hits += result.table_hits;
+            evaluated++;
+        }
+
+        if (evaluated == 0) {
+            std::cerr << "No positions evaluated\n";
+            return 1;
+        }
+        std::cout << "Positions: " << evaluated << ", depth " << config.depth << ", threads " << config.threads << "\n"
+                  << "Best response value: " << best_total / evaluated << "\n"
+                  << "Policy value: " << policy_total / evaluated << "\n"
+                  << "Exploitability: " << (best_total - policy_total) / evaluated << "\n"
+                  << "Nodes: " << nodes << " (" << hits << " table hits), " << nodes / (elapsed_ms / 1000.0) << " nodes/s\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
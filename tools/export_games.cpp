@@ -0,0 +1,72 @@
+// Email: razcohenp@gmail.com
+
+// export_games.cpp - Runs a batch of random games and writes columnar analytics files
+// Usage: ./export_games <output_dir> [games] [players] [seed]
+// Replaces scraping console output of example-style runs
+
+#include "../include/Game.hpp"
+#include "../include/Player.hpp"
+#include "../include/Action.hpp"
+#include "../include/ColumnarExport.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace coup;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output_dir> [games] [players] [seed]\n";
+        return 1;
+    }
+
+    try {
+        const std::string directory = argv[1];
+        const long games = argc > 2 ? std::stol(argv[2]) : 10000;
+        const int players = argc > 3 ? std::stoi(argv[3]) : 6;
+        const unsigned seed = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 1;
+
+        if (players < 2 || players > 6) {
+            std::cerr << "Players must be between 2 and 6\n";
+            return 1;
+        }
+
+        const RoleType roles[] = {RoleType::GOVERNOR, RoleType::SPY, RoleType::BARON,
+                                  RoleType::GENERAL, RoleType::JUDGE, RoleType::MERCHANT};
+        std::mt19937 rng(seed);
+        std::vector<Action> scratch;
+        Action chosen;
+        ColumnarExporter exporter(directory);
+
+        for (long g = 0; g < games; g++) {
+            // Fresh table with random roles for every game
+            Game game;
+            std::vector<std::unique_ptr<Player>> roster;
+            for (int seat = 0; seat < players; seat++) {
+                roster.emplace_back(game.createPlayerWithRole("P" + std::to_string(seat + 1), roles[rng() % 6]));
+            }
+            game.startGame();
+
+            exporter.beginGame(game);
+            int steps = 0;
+            while (!isGameOver(game) && steps++ < 5000) {
+                if (playRandomAction(game, rng, scratch, chosen)) {
+                    exporter.recordAction(chosen, game);
+                }
+            }
+            exporter.endGame(game);
+        }
+
+        exporter.flush();
+        std::cout << "Exported " << games << " games to " << directory << "\n";
+    }
+
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Email: razcohenp@gmail.com
+
+// tournament.cpp - Rates the built-in bots against each other
+// Usage: ./tournament [rounds] [seats] [threads] [roundrobin|swiss] [games_per_table]
+// Entrants: heuristic, random, two scripted players and a small fixed-iteration MCTS
+
+#include "../include/bots/Tournament.hpp"
+#include "../include/bots/HeuristicBot.hpp"
+#include "../include/bots/MctsBot.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace coup;
+
+int main(int argc, char* argv[]) {
+    try {
+        TournamentConfig config;
+        config.max_rounds = argc > 1 ? static_cast<unsigned>(std::stoul(argv[1])) : 50;
+        config.seats = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 2;
+        config.threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 2;
+        config.format = argc > 4 && std::string(argv[4]) == "swiss" ? TournamentFormat::SWISS
+                                                                      : TournamentFormat::ROUND_ROBIN;
+        config.games_per_table = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 20;
+        config.stable_rounds = 5;
+        config.stop_rd = 15.0;
+
+        Tournament tournament(config);
+        tournament.addEntry("Heuristic", [](uint32_t seed) { return std::unique_ptr<Bot>(new HeuristicBot(seed)); });
+        tournament.addEntry("Random", [](uint32_t seed) { return std::unique_ptr<Bot>(new RandomBot(seed)); });
+        tournament.addEntry("Taxer", [](uint32_t) {
+            return std::unique_ptr<Bot>(new ScriptedBot({ActionType::COUP, ActionType::TAX, ActionType::GATHER}, "Taxer"));
+        });
+        tournament.addEntry("Gatherer", [](uint32_t) {
+            return std::unique_ptr<Bot>(new ScriptedBot({ActionType::COUP, ActionType::GATHER}, "Gatherer"));
+        });
+        tournament.addEntry("MCTS", [](uint32_t seed) {
+            MctsConfig mcts;
+            mcts.iterations = 64;
+            mcts.time_budget_ms = 0;
+            mcts.seed = seed;
+            return std::unique_ptr<Bot>(new MctsBot(mcts));
+        });
+
+        const TournamentResult result = tournament.run();
+        std::cout << result.games << " games in " << result.rounds << " rounds, " << result.elapsed_ms / 1000.0
+                  << " s (" << result.games / (result.elapsed_ms / 1000.0) << " games/s)"
+                  << (result.converged ? ", converged" : "") << "\n";
+        std::cout << std::fixed << std::setprecision(0);
+        for (const TournamentStanding& standing : result.standings) {
+            const Rating& rating = standing.rating;
+            std::cout << "  " << std::left << std::setw(10) << standing.name << std::right
+                      << " glicko " << rating.glicko << " [" << rating.low() << ", " << rating.high() << "]"
+                      << "  elo " << rating.elo << "  games " << rating.games << "  wins " << rating.wins
+                      << "  draws " << rating.draws << "\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+// Email: razcohenp@gmail.com
+
+// train_cfr.cpp - Trains an MCCFR+ policy and writes the policy file
+// Usage: ./train_cfr <policy_file> [iterations] [players] [threads] [checkpoint_file]
+// An existing checkpoint file is resumed; checkpoints are written every tenth of the run
+
+#include "../include/bots/Cfr.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace coup;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <policy_file> [iterations] [players] [threads] [checkpoint_file]\n";
+        return 1;
+    }
+
+    try {
+        const uint64_t iterations = argc > 2 ? std::stoull(argv[2]) : 10000;
+        CfrConfig config;
+        config.players = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 2;
+        config.threads = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 1;
+        if (argc > 5) {
+            config.checkpoint_path = argv[5];
+            config.checkpoint_every = iterations >= 10 ? iterations / 10 : 1;
+        }
+
+        CfrTrainer trainer(config);
+        if (!config.checkpoint_path.empty() && std::ifstream(config.checkpoint_path)) {
+            trainer.loadCheckpoint(config.checkpoint_path);
+            std::cout << "Resumed at iteration " << trainer.getIterations() << "\n";
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        trainer.train(iterations);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        trainer.writePolicy(argv[1]);
+
+        std::cout << "Trained " << iterations << " iterations (" << trainer.getIterations() << " total) in "
+                  << seconds << " s, " << iterations / seconds << " iterations/s\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
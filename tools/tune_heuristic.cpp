@@ -0,0 +1,61 @@
+// Email: razcohenp@gmail.com
+
+// tune_heuristic.cpp - Evolves HeuristicBot weights against the default weights
+// Usage: ./tune_heuristic <checkpoint_file> [generations] [population] [games] [threads] [players]
+// An existing checkpoint is resumed; the checkpoint is rewritten after every generation
+
+#include "../include/bots/Evolution.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace coup;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <checkpoint_file> [generations] [population] [games] [threads] [players]\n";
+        return 1;
+    }
+
+    try {
+        EvolutionConfig config;
+        config.checkpoint_path = argv[1];
+        const unsigned generations = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 10;
+        config.population = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 24;
+        config.games = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 400;
+        config.threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 2;
+        config.players = argc > 6 ? static_cast<unsigned>(std::stoul(argv[6])) : 2;
+
+        EvolutionTuner tuner(config);
+        if (std::ifstream(config.checkpoint_path)) {
+            tuner.loadCheckpoint(config.checkpoint_path);
+            std::cout << "Resumed at generation " << tuner.getGeneration() << "\n";
+        }
+
+        Candidate best;
+        for (unsigned g = 0; g < generations; g++) {
+            const auto start = std::chrono::steady_clock::now();
+            best = tuner.step();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "Generation " << tuner.getGeneration() << ": best fitness " << best.fitness << " ("
+                      << config.population * config.games / seconds << " games/s)\n";
+        }
+
+        if (generations > 0) {
+            const HeuristicWeights weights = genesToWeights(best.genes);
+            std::cout << "Best weights:";
+            for (size_t a = 0; a < ACTION_TYPE_COUNT; a++) {
+                std::cout << " " << getActionName(static_cast<ActionType>(a)) << "=" << weights.action[a];
+            }
+            std::cout << " pass=" << weights.pass << " target_coins=" << weights.target_coins
+                      << " target_threat=" << weights.target_threat << " noise=" << weights.noise << "\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}